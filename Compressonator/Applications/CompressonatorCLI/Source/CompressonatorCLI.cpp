@@ -16,9 +16,6 @@
 //#include <vld.h>   Enable to check for code leaks
 #endif
 
-// #define USE_AMD_BMP
-// #define USE_AMD_PNG
-
 #include <windows.h>
 #include "cmdline.h"
 #include "PluginManager.h"
@@ -27,30 +24,25 @@
 // Our Static Plugin Interfaces
 #pragma comment(lib,"ASTC.lib")
 #pragma comment(lib,"BoxFilter.lib")
+#pragma comment(lib,"CTB.lib")
 #pragma comment(lib,"DDS.lib")
 #pragma comment(lib,"EXR.lib")
 #pragma comment(lib,"KTX.lib")
 #pragma comment(lib,"TGA.lib")
+#pragma comment(lib,"WIC.lib")
 #pragma comment(lib,"IMGAnalysis.lib")
 
 extern void *make_Plugin_ASTC();
 extern void *make_Plugin_BoxFilter();
+extern void *make_Plugin_CTB();
 extern void *make_Plugin_DDS();
 extern void *make_Plugin_EXR();
 extern void *make_Plugin_KTX();
+extern void *make_Plugin_KTX2();
 extern void *make_Plugin_TGA();
+extern void *make_Plugin_WIC();
 extern void *make_Plugin_CAnalysis();
 
-#ifdef USE_AMD_PNG
-#pragma comment(lib,"PNG.lib")
-extern void *make_Plugin_PNG();
-#endif
-
-#ifdef USE_AMD_BMP
-#pragma comment(lib,"BMP.lib")
-extern void *make_Plugin_BMP();
-#endif
-
 extern int          RunInfo();
 extern bool         CompressionCallback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2);
 extern void         LocalPrintF(char *buff);
@@ -59,11 +51,6 @@ PluginManager       g_pluginManager;
 bool                g_bAbortCompression = false;
 CMIPS*              g_CMIPS;                                // Global MIPS functions shared between app and all IMAGE plugins
 
-#ifdef USE_QT_IMAGELOAD
-#include <QCoreApplication>
-#include <qdebug.h>
-#endif
-
 
 bool ProgressCallback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2)
 {
@@ -72,32 +59,28 @@ bool ProgressCallback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2)
 
 int main(int argc,  char* argv[])
 {
-#ifdef USE_QT_IMAGELOAD
-    QCoreApplication app(argc, argv);
-#endif
-
     g_pluginManager.registerStaticPlugin("IMAGE","ASTC", make_Plugin_ASTC);
+    g_pluginManager.registerStaticPlugin("IMAGE","CTB", make_Plugin_CTB);
     g_pluginManager.registerStaticPlugin("IMAGE","DDS", make_Plugin_DDS);
     g_pluginManager.registerStaticPlugin("IMAGE","EXR", make_Plugin_EXR);
     g_pluginManager.registerStaticPlugin("IMAGE","KTX", make_Plugin_KTX);
+    g_pluginManager.registerStaticPlugin("IMAGE","KTX2", make_Plugin_KTX2);
     g_pluginManager.registerStaticPlugin("IMAGE","TGA", make_Plugin_TGA);  // Use for load only, Qt will be used for Save
     g_pluginManager.registerStaticPlugin("IMAGE", "ANALYSIS", make_Plugin_CAnalysis);
-    
-#ifdef USE_AMD_PNG
-    g_pluginManager.registerStaticPlugin("IMAGE", "PNG", make_Plugin_PNG);
-#endif
 
-#ifdef USE_AMD_BMP
-    g_pluginManager.registerStaticPlugin("IMAGE", "BMP", make_Plugin_BMP);
-#endif
+    // Windows Imaging Component codecs, Qt is only used for the formats these do not cover
+    g_pluginManager.registerStaticPlugin("IMAGE","BMP", make_Plugin_WIC);
+    g_pluginManager.registerStaticPlugin("IMAGE","JPEG", make_Plugin_WIC);
+    g_pluginManager.registerStaticPlugin("IMAGE","JPG", make_Plugin_WIC);
+    g_pluginManager.registerStaticPlugin("IMAGE","PNG", make_Plugin_WIC);
+    g_pluginManager.registerStaticPlugin("IMAGE","TIF", make_Plugin_WIC);
+    g_pluginManager.registerStaticPlugin("IMAGE","TIFF", make_Plugin_WIC);
 
     g_pluginManager.registerStaticPlugin("FILTERS","BOXFILTER", make_Plugin_BoxFilter);
     g_pluginManager.getPluginList("\\Plugins");
 
-#ifdef USE_QT_IMAGELOAD
-    QString dirPath = QCoreApplication::applicationDirPath();
-    QCoreApplication::addLibraryPath(dirPath + "./plugins/imageformats");
-#endif
+    // Qt5Core, Qt5Gui and Qt5Widgets are delay loaded, InitQtImageLoad creates the QCoreApplication
+    // only when an image falls back to Qt or -analysis runs
 
     // Check if print status line has been assigned
     // if not get it a default to printf
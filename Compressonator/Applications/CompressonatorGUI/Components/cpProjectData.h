@@ -37,6 +37,7 @@
 #include "cpImageLoader.h"
 #include "ATIFormats.h"
 #include "TextureIO.h"
+#include "TexturePrefetch.h"
 #include "Common.h"
 
 #define    TREETYPE_ADD_IMAGE_NODE               0
@@ -1060,6 +1061,8 @@ class C_Application_Options :public QObject
         Q_PROPERTY(bool             Reload_image_views_on_selection         READ getUseNewImageViews        WRITE setUseNewImageViews)
         Q_PROPERTY(bool             Close_all_image_views_prior_to_process  READ getCloseAllImageViews      WRITE setCloseAllImageViews)
         Q_PROPERTY(bool             Load_recent_project_on_startup          READ getLoadRecentFile          WRITE setLoadRecentFile)
+        Q_PROPERTY(int              Prefetch_source_images                  READ getPrefetchDepth           WRITE setPrefetchDepth)
+        Q_PROPERTY(int              Prefetch_memory_budget_MB               READ getPrefetchBudget          WRITE setPrefetchBudget)
 
 public:
     // Keep order of list as its ref is saved in CompressSettings.ini
@@ -1094,6 +1097,8 @@ public:
         m_useNewImageViews   = true;
         m_refreshCurrentView = false;
         m_closeAllDocuments  = true;
+        m_prefetchDepth      = PREFETCH_DEFAULT_DEPTH;
+        m_prefetchBudget     = PREFETCH_DEFAULT_BUDGET_MB;
     }
 
     void setImageViewDecode(ImageDecodeWith decodewith)
@@ -1148,6 +1153,28 @@ public:
         return m_useNewImageViews;
     }
 
+    // Number of source images loaded ahead of the one being compressed, 0 loads each one when it is processed
+    void setPrefetchDepth(int depth)
+    {
+        m_prefetchDepth = depth < 0 ? 0 : depth;
+    }
+
+    int getPrefetchDepth() const
+    {
+        return m_prefetchDepth;
+    }
+
+    // Memory the source images loaded ahead may hold
+    void setPrefetchBudget(int budget)
+    {
+        m_prefetchBudget = budget < 1 ? 1 : budget;
+    }
+
+    int getPrefetchBudget() const
+    {
+        return m_prefetchBudget;
+    }
+
     ImageDecodeWith m_ImageViewDecode;
 #ifdef USE_COMPUTE
     ImageEncodeWith m_ImageEncode;
@@ -1155,6 +1182,8 @@ public:
     bool            m_closeAllDocuments;
     bool            m_loadRecentFile;
     bool            m_refreshCurrentView;
+    int             m_prefetchDepth;
+    int             m_prefetchBudget;
 
 signals:
     void ImageViewDecodeChanged(QVariant &);
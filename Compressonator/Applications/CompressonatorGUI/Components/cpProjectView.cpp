@@ -843,7 +843,10 @@ bool ProjectView::saveImageAs()
                     PluginInterface_Image *plugin_Image;
                     plugin_Image = reinterpret_cast<PluginInterface_Image *>(g_pluginManager.GetPlugin("IMAGE", "DDS"));
                     imgFileName.append(".dds");
-                    
+
+                    // The same supercompression as the compressed destinations when saved as .ktx2
+                    data->m_MipImages->mipset->m_nSupercompressionLevel = g_CmdPrams.ZstdLevel;
+
                     if (AMDSaveMIPSTextureImage(filePathName.toStdString().c_str(), data->m_MipImages->mipset, false) != 0)
                     {
                         if (m_CompressStatusDialog)
@@ -2278,6 +2281,65 @@ void ProjectView::AddSettingtoEmptyTree()
 
 }
 
+// Compression setting items that CompressFiles processes: checked or selected, or flagged by the user
+static bool IsItemToCompress(ProjectView *ProjectView, QTreeWidgetItem *Imageitem, C_Destination_Options *data)
+{
+    bool testitem = false;
+
+    //Compression setting and item is checked
+    if (ProjectView->m_EnableCheckedItemsView)
+    {
+        //qDebug() << "override checked item using m_EnableCheckedItemsView";
+        testitem = (Imageitem->checkState(0) == Qt::Checked);
+    }
+    else
+    {
+        //qDebug() << "override checked item is selected";
+        testitem = Imageitem->isSelected();
+    }
+
+    if (data)
+    {
+        if (!testitem)
+            testitem = data->m_isselected;
+    }
+
+    return (data && testitem);
+}
+
+// Source images that are not loaded yet and have a compression setting to process,
+// in the order CompressFiles reaches them
+static void GetSourceFilesToLoad(ProjectView *ProjectView, std::vector<std::string> &SourceFiles, QMap<C_Source_Image *, int> &SourceIndex)
+{
+    QTreeWidgetItemIterator it(ProjectView->m_projectTreeView);
+    while (*it)
+    {
+        QVariant v = (*it)->data(0, Qt::UserRole);
+        if (v.toInt() == TREETYPE_IMAGEFILE_DATA)
+        {
+            C_Source_Image *m_data = (*it)->data(1, Qt::UserRole).value<C_Source_Image *>();
+            if (m_data && !(m_data->m_MipImages && m_data->m_MipImages->mipset))
+            {
+                for (int i = 0; i < (*it)->childCount(); i++)
+                {
+                    QTreeWidgetItem *Imageitem = (*it)->child(i);
+                    if (Imageitem->data(0, Qt::UserRole).toInt() != TREETYPE_COMPRESSION_DATA)
+                        continue;
+
+                    C_Destination_Options *data = Imageitem->data(1, Qt::UserRole).value<C_Destination_Options *>();
+                    if (IsItemToCompress(ProjectView, Imageitem, data))
+                    {
+                        SourceIndex[m_data] = (int)SourceFiles.size();
+                        SourceFiles.push_back(m_data->m_Full_Path.toStdString());
+                        break;
+                    }
+                }
+            }
+        }
+        ++it;
+    }
+}
+
 void CompressFiles(
     QFile                *file,
     ProjectView          *ProjectView
@@ -2309,6 +2371,20 @@ void CompressFiles(
     int NumberOfItemsSkipped = 0;
     int childcount = 0;
     MipSet *sourceImageMipSet;
+    double CompressionTime = 0;
+
+    //==================================================
+    // Load the next source images while one compresses
+    //==================================================
+    CTexturePrefetcher *prefetcher = NULL;
+    QMap<C_Source_Image *, int> prefetchIndex;
+    if ((file == NULL) && (g_Application_Options.m_prefetchDepth > 0))
+    {
+        std::vector<std::string> SourceFiles;
+        GetSourceFilesToLoad(ProjectView, SourceFiles, prefetchIndex);
+        if (SourceFiles.size() > 1)
+            prefetcher = new CTexturePrefetcher(SourceFiles, g_Application_Options.m_prefetchDepth, (unsigned long long)g_Application_Options.m_prefetchBudget * 1024 * 1024);
+    }
 
     // Parse the Project view tree
     QTreeWidgetItemIterator it(ProjectView->m_projectTreeView);
@@ -2340,6 +2416,10 @@ void CompressFiles(
                 }
             }
 
+            // Images that failed to load ahead are loaded again by ProcessCMDLine, which reports the error
+            if ((sourceImageMipSet == NULL) && prefetcher && prefetchIndex.contains(m_data))
+                sourceImageMipSet = prefetcher->Acquire(prefetchIndex.value(m_data));
+
             // Image with a setting, childcount will be at least 2 as the "add compress setting" node is counted as 1 child
             if (childcount > 1)
             {
@@ -2379,28 +2459,8 @@ void CompressFiles(
                         {
                             v = Imageitem->data(1, Qt::UserRole);
                             C_Destination_Options *data = v.value<C_Destination_Options *>();
-                            bool testitem = false;
-
-                            //Compression setting and item is checked
-                            if (ProjectView->m_EnableCheckedItemsView)
-                            {
-                                //qDebug() << "override checked item using m_EnableCheckedItemsView";
-                                testitem = (Imageitem->checkState(0) == Qt::Checked);
-                            }
-                            else
-                            {
-                                //qDebug() << "override checked item is selected";
-                                testitem = Imageitem->isSelected();
-                            }
-
-                            if (data)
-                            {
-                                if (!testitem)
-                                    testitem = data->m_isselected;
-                            }
 
-                            //qDebug() << "testitem " << testitem;
-                            if (data && testitem)
+                            if (IsItemToCompress(ProjectView, Imageitem, data))
                             {
                                 //qDebug() << " valid Data";
                                 // Reset force compression use flag
@@ -2982,6 +3042,7 @@ void CompressFiles(
                                                     if (g_CmdPrams.conversion_fDuration > 0)
                                                     {
                                                         data->m_CompressionTime = g_CmdPrams.conversion_fDuration;
+                                                        CompressionTime += g_CmdPrams.conversion_fDuration;
                                                         double CompressionRatio = data->m_SourceImageSize / (double)data->m_FileSize;
                                                         char buffer[128];
                                                         sprintf(buffer, "%2.2f", CompressionRatio);
@@ -3048,6 +3109,28 @@ void CompressFiles(
     g_bCompressing = false;
     ProjectView->m_processFromContext = false;
 
+    // I/O stalls are the time compression waited for an image the I/O threads had not loaded yet
+    if (prefetcher)
+    {
+        if (ProjectView->m_CompressStatusDialog && (prefetcher->GetLoadCount() > 0))
+        {
+            QString Msg;
+            Msg.append("Source images: ");
+            Msg.append(QString::number(prefetcher->GetLoadCount()));
+            Msg.append(" loaded ahead in ");
+            Msg.append(QString::number(prefetcher->GetLoadTime(), 'f', 3));
+            Msg.append(" Sec, I/O stalls ");
+            Msg.append(QString::number(prefetcher->GetStallTime(), 'f', 3));
+            Msg.append(" Sec, compression ");
+            Msg.append(QString::number(CompressionTime, 'f', 3));
+            Msg.append(" Sec");
+            ProjectView->m_CompressStatusDialog->appendText(Msg);
+        }
+
+        delete prefetcher;
+        prefetcher = NULL;
+    }
+
     if (ProjectView->m_CompressStatusDialog && (file == NULL) && (!g_bAbortCompression))
     {
         if ((NumberOfItemCompressed == 0) && (NumberOfItemCompressedFailed == 0))
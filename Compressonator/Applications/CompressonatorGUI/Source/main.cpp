@@ -31,6 +31,7 @@
 // Our Static Plugin Interfaces
 #pragma comment(lib,"ASTC.lib")
 #pragma comment(lib,"BoxFilter.lib")
+#pragma comment(lib,"CTB.lib")
 #pragma comment(lib,"DDS.lib")
 #pragma comment(lib,"EXR.lib")
 #pragma comment(lib,"KTX.lib")
@@ -39,9 +40,11 @@
 
 extern void *make_Plugin_ASTC();
 extern void *make_Plugin_BoxFilter();
+extern void *make_Plugin_CTB();
 extern void *make_Plugin_DDS();
 extern void *make_Plugin_EXR();
 extern void *make_Plugin_KTX();
+extern void *make_Plugin_KTX2();
 extern void *make_Plugin_TGA();
 extern void *make_Plugin_CAnalysis();
 
@@ -124,9 +127,11 @@ int main(int argc, char **argv)
         //----------------------------------
     
         g_pluginManager.registerStaticPlugin("IMAGE",  "ASTC",      make_Plugin_ASTC);
+        g_pluginManager.registerStaticPlugin("IMAGE",  "CTB",       make_Plugin_CTB);
         g_pluginManager.registerStaticPlugin("IMAGE",  "DDS",       make_Plugin_DDS);
         g_pluginManager.registerStaticPlugin("IMAGE",  "EXR",       make_Plugin_EXR);
         g_pluginManager.registerStaticPlugin("IMAGE",  "KTX",       make_Plugin_KTX);
+        g_pluginManager.registerStaticPlugin("IMAGE",  "KTX2",      make_Plugin_KTX2);
 
         // TGA is supported by Qt to some extent if it fails we will try to load it using our custom code
         g_pluginManager.registerStaticPlugin("IMAGE",  "TGA",       make_Plugin_TGA);
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include "Compressonator.h"
 #include "cExr.h"
+#include "CMP_Trace.h"
 
 // File system
 #include <boost/filesystem.hpp>
@@ -596,6 +597,7 @@ bool Plugin_Canalysis::psnr(QImage *src, QImage *dest, REPORT_DATA &myReport, CM
 
 int Plugin_Canalysis::TC_ImageDiff(const char * in1, const char * in2, const char *out, char *resultsFile, void *pluginManager, void **cmipImages, CMP_Feedback_Proc pFeedbackProc)
 {
+    CMP_TRACE_SCOPE("Analysis", "ImageDiff");
     if (pluginManager == NULL) return -1;
 
     MY_REPORT_DATA report;
@@ -840,6 +842,7 @@ int Plugin_Canalysis::TC_ImageDiff(const char * in1, const char * in2, const cha
 
 int Plugin_Canalysis::TC_PSNR_MSE(const char * in1, const char * in2,  char *resultsFile, void *pluginManager, CMP_Feedback_Proc pFeedbackProc)
 {
+    CMP_TRACE_SCOPE("Analysis", "PSNR_MSE");
     if (pluginManager == NULL) return -1;
 
     MY_REPORT_DATA report;
@@ -912,6 +915,7 @@ int Plugin_Canalysis::TC_PSNR_MSE(const char * in1, const char * in2,  char *res
 
 int Plugin_Canalysis::TC_SSIM(const char * in1, const char * in2, char *resultsFile, void *pluginManager, CMP_Feedback_Proc pFeedbackProc)
 {
+    CMP_TRACE_SCOPE("Analysis", "SSIM");
     if (pluginManager == NULL) return -1;
 
     MY_REPORT_DATA report;
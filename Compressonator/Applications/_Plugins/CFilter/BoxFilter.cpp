@@ -33,6 +33,7 @@
 #include "MIPS.h"
 #include "Compressonator.h"
 #include "Texture.h"
+#include "CMP_Trace.h"
 
 CMIPS *CMips;
 
@@ -77,6 +78,7 @@ int Plugin_BoxFilter::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
 //nMinSize : The size in pixels used to determine how many mip levels to generate. Once all dimensions are less than or equal to nMinSize your mipper should generate no more mip levels.
 int Plugin_BoxFilter::TC_GenerateMIPLevels(MipSet *pMipSet, int nMinSize)
 {
+    CMP_TRACE_SCOPE("Mip", "BoxFilter");
     assert(pMipSet);
     assert(pMipSet->m_nMipLevels);
 
@@ -582,6 +582,11 @@ DXGI_FORMAT GPU_DirectX::CMP2DXGIFormat(CMP_FORMAT cmp_format)
     case CMP_FORMAT_DXT5_xGxR:
     case CMP_FORMAT_ETC_RGB:
     case CMP_FORMAT_ETC2_RGB:
+    case CMP_FORMAT_ETC2_RGBA:
+    case CMP_FORMAT_EAC_R11:
+    case CMP_FORMAT_EAC_R11_SIGNED:
+    case CMP_FORMAT_EAC_RG11:
+    case CMP_FORMAT_EAC_RG11_SIGNED:
     case CMP_FORMAT_GT:
     // -----------------------------------
     case CMP_FORMAT_Unknown:
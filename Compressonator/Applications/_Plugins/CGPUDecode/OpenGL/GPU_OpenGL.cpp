@@ -132,6 +132,21 @@ GLenum GPU_OpenGL::MIP2OLG_Format(const CMP_Texture* pSourceTexture)
     case CMP_FORMAT_ETC2_RGB:
         m_GLnum = GL_COMPRESSED_RGB8_ETC2;
         break;
+    case CMP_FORMAT_ETC2_RGBA:
+        m_GLnum = GL_COMPRESSED_RGBA8_ETC2_EAC;
+        break;
+    case CMP_FORMAT_EAC_R11:
+        m_GLnum = GL_COMPRESSED_R11_EAC;
+        break;
+    case CMP_FORMAT_EAC_R11_SIGNED:
+        m_GLnum = GL_COMPRESSED_SIGNED_R11_EAC;
+        break;
+    case CMP_FORMAT_EAC_RG11:
+        m_GLnum = GL_COMPRESSED_RG11_EAC;
+        break;
+    case CMP_FORMAT_EAC_RG11_SIGNED:
+        m_GLnum = GL_COMPRESSED_SIGNED_RG11_EAC;
+        break;
     case CMP_FORMAT_ASTC:  
         if ((pSourceTexture->nBlockWidth == 4) && (pSourceTexture->nBlockHeight == 4))
             m_GLnum = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
@@ -272,7 +287,7 @@ CMP_ERROR WINAPI GPU_OpenGL::Decompress(
 
     if (pDestTexture)
     {
-        if (pSourceTexture->format == CMP_FORMAT_ETC_RGB || pSourceTexture->format == CMP_FORMAT_ETC2_RGB)
+        if (pSourceTexture->format == CMP_FORMAT_ETC_RGB || pSourceTexture->format == CMP_FORMAT_ETC2_RGB || pSourceTexture->format == CMP_FORMAT_ETC2_RGBA)
             glReadPixels(0, 0, pDestTexture->dwWidth, pDestTexture->dwHeight, GL_BGRA_EXT, GL_UNSIGNED_BYTE, pDestTexture->pData);
         else
         {
@@ -855,6 +855,21 @@ VkFormat GPU_Vulkan::MIP2VK_Format(const CMP_Texture* pSourceTexture)
     case CMP_FORMAT_ETC2_RGB:
         m_VKnum = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
         break;
+    case CMP_FORMAT_ETC2_RGBA:
+        m_VKnum = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+        break;
+    case CMP_FORMAT_EAC_R11:
+        m_VKnum = VK_FORMAT_EAC_R11_UNORM_BLOCK;
+        break;
+    case CMP_FORMAT_EAC_R11_SIGNED:
+        m_VKnum = VK_FORMAT_EAC_R11_SNORM_BLOCK;
+        break;
+    case CMP_FORMAT_EAC_RG11:
+        m_VKnum = VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
+        break;
+    case CMP_FORMAT_EAC_RG11_SIGNED:
+        m_VKnum = VK_FORMAT_EAC_R11G11_SNORM_BLOCK;
+        break;
     case CMP_FORMAT_ASTC:
         if ((pSourceTexture->nBlockWidth == 4) && (pSourceTexture->nBlockHeight == 4))
             m_VKnum = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
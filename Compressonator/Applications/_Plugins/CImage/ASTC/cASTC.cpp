@@ -28,6 +28,7 @@
 #include "MIPS.h"
 
 #include "cASTC.h"
+#include "CMP_Trace.h"
 
 #ifdef BUILD_AS_PLUGIN_DLL
 DECLARE_PLUGIN(Plugin_ASTC)
@@ -87,6 +88,7 @@ int Plugin_ASTC::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture
 
 int Plugin_ASTC::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "ASTC Load");
     FILE* pFile = NULL;
     if(_tfopen_s(&pFile, pszFilename, _T("rb")) != 0 || pFile == NULL)
     {
@@ -191,6 +193,7 @@ int Plugin_ASTC::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMip
 
 int Plugin_ASTC::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "ASTC Save");
     assert(pszFilename);
     assert(pMipSet);
 
@@ -31,7 +31,7 @@
 static const GUID g_GUID = 
 { 0x3c9d75e9, 0xd2cb, 0x43f2, { 0xb3, 0x71, 0xd8, 0xd3, 0x8f, 0xc8, 0xf3, 0x6 } };
 
-CMIPS *ASTC_CMips = NULL;
+thread_local CMIPS *ASTC_CMips = NULL;
 
 #define TC_PLUGIN_VERSION_MAJOR    1
 #define TC_PLUGIN_VERSION_MINOR    0
@@ -0,0 +1,158 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TC_PluginAPI.h"
+#include "TC_PluginInternal.h"
+#include "MIPS.h"
+#include "CTB.h"
+#include "TextureBundle.h"
+#include "CMP_Trace.h"
+
+#include <string>
+
+thread_local CMIPS *CTB_CMips = NULL;
+
+#ifdef BUILD_AS_PLUGIN_DLL
+DECLARE_PLUGIN(Plugin_CTB)
+SET_PLUGIN_TYPE("IMAGE")
+SET_PLUGIN_NAME("CTB")
+#else
+void *make_Plugin_CTB() { return new Plugin_CTB; }
+#endif
+
+Plugin_CTB::Plugin_CTB()
+{
+}
+
+Plugin_CTB::~Plugin_CTB()
+{
+}
+
+int Plugin_CTB::TC_PluginSetSharedIO(void* Shared)
+{
+    if (Shared)
+    {
+        CTB_CMips = static_cast<CMIPS *>(Shared);
+        return 0;
+    }
+    return 1;
+}
+
+int Plugin_CTB::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
+{
+    pPluginVersion->guid                    = g_GUID_CTB;
+    pPluginVersion->dwAPIVersionMajor       = TC_API_VERSION_MAJOR;
+    pPluginVersion->dwAPIVersionMinor       = TC_API_VERSION_MINOR;
+    pPluginVersion->dwPluginVersionMajor    = TC_PLUGIN_CTB_VERSION_MAJOR;
+    pPluginVersion->dwPluginVersionMinor    = TC_PLUGIN_CTB_VERSION_MINOR;
+    return 0;
+}
+
+int Plugin_CTB::TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    return -1;
+}
+
+int Plugin_CTB::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    return -1;
+}
+
+// File name without folder or extension, the entry name of a texture saved without m_pszEntryName
+static std::string CTBDefaultEntryName(const TCHAR* pszFilename)
+{
+    const char* pszName = pszFilename;
+    for (const char* p = pszFilename; *p; p++)
+        if ((*p == '\\') || (*p == '/') || (*p == ':'))
+            pszName = p + 1;
+
+    const char* pszExt = strrchr(pszName, '.');
+    return pszExt ? std::string(pszName, pszExt - pszName) : std::string(pszName);
+}
+
+int Plugin_CTB::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "CTB Load");
+    assert(pszFilename);
+    assert(pMipSet);
+
+    CTextureBundleReader reader;
+    if (!reader.Open(pszFilename))
+    {
+        if (CTB_CMips)
+            CTB_CMips->PrintError(_T("Error(%d): CTB Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_CTB_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    // Only the table of contents and the one entry are read
+    int nEntry = pMipSet->m_pszEntryName ? reader.FindEntry(pMipSet->m_pszEntryName) : 0;
+    if ((nEntry < 0) || (nEntry >= reader.GetEntryCount()))
+    {
+        if (CTB_CMips)
+            CTB_CMips->PrintError(_T("Error(%d): CTB Plugin ID(%d) %s has no entry %s\n"), EL_Error, IDS_ERROR_CTB_ENTRY_NOT_FOUND, pszFilename,
+                                  pMipSet->m_pszEntryName ? pMipSet->m_pszEntryName : "");
+        return -1;
+    }
+
+    if (!reader.LoadEntry(nEntry, pMipSet, CTB_CMips))
+    {
+        if (CTB_CMips)
+            CTB_CMips->PrintError(_T("Error(%d): CTB Plugin ID(%d) reading entry %s of %s\n"), EL_Error, IDS_ERROR_CTB_ALLOCATEMIPSET,
+                                  reader.GetEntryName(nEntry).c_str(), pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
+
+int Plugin_CTB::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "CTB Save");
+    assert(pszFilename);
+    assert(pMipSet);
+
+    // Adds the texture to the bundle, an entry of the same name is replaced
+    std::string name = pMipSet->m_pszEntryName ? pMipSet->m_pszEntryName : CTBDefaultEntryName(pszFilename);
+
+    CTextureBundleWriter writer;
+    if (!writer.Open(pszFilename))
+    {
+        if (CTB_CMips)
+            CTB_CMips->PrintError(_T("Error(%d): CTB Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_CTB_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    // Closed even when the entry fails, so the bundle keeps its older entries
+    bool bAdded = writer.AddEntry(name.c_str(), pMipSet, CTB_CMips);
+    if (!writer.Close() || !bAdded)
+    {
+        if (CTB_CMips)
+            CTB_CMips->PrintError(_T("Error(%d): CTB Plugin ID(%d) writing entry %s of %s\n"), EL_Error, IDS_ERROR_CTB_WRITE, name.c_str(), pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
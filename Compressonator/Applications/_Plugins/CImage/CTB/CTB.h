@@ -0,0 +1,67 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _PLUGIN_IMAGE_CTB_H
+#define _PLUGIN_IMAGE_CTB_H
+
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN        // Exclude rarely-used stuff from Windows headers
+#include <assert.h>
+#include <tchar.h>
+
+#include "PluginInterface.h"
+
+// ---------------- CTB Plugin ------------------------
+// Texture bundles, many compressed textures in one file with a hashed table of contents.
+// MipSet::m_pszEntryName picks the entry to load or the name to save under.
+
+// {3D7A9C15-E84B-4F26-9A3D-51B0C6E2F7A8}
+static const GUID g_GUID_CTB =
+{ 0x3d7a9c15, 0xe84b, 0x4f26, { 0x9a, 0x3d, 0x51, 0xb0, 0xc6, 0xe2, 0xf7, 0xa8 } };
+
+#define TC_PLUGIN_CTB_VERSION_MAJOR    1
+#define TC_PLUGIN_CTB_VERSION_MINOR    0
+
+class Plugin_CTB : public PluginInterface_Image
+{
+    public:
+        Plugin_CTB();
+        virtual ~Plugin_CTB();
+
+        int TC_PluginSetSharedIO(void* Shared);
+        int TC_PluginGetVersion(TC_PluginVersion* pPluginVersion);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+};
+
+#define IDS_ERROR_CTB_FILE_OPEN             1
+#define IDS_ERROR_CTB_ENTRY_NOT_FOUND       2
+#define IDS_ERROR_CTB_ALLOCATEMIPSET        3
+#define IDS_ERROR_CTB_WRITE                 4
+
+extern void *make_Plugin_CTB();
+
+#endif
@@ -39,9 +39,10 @@
 #include "DDS_File.h"
 #include "DDS_DX10.h"
 #include "DDS_Helpers.h"
+#include "CMP_Trace.h"
 
 
-CMIPS *DDS_CMips = NULL;
+thread_local CMIPS *DDS_CMips = NULL;
 const TCHAR* g_pszFilename;
 
 #ifdef BUILD_AS_PLUGIN_DLL
@@ -153,6 +154,7 @@ int Plugin_DDS::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *
 
 int Plugin_DDS::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "DDS Load");
 
 #ifdef USE_DIRECTXTEX
     // Process command line
@@ -277,9 +279,21 @@ int Plugin_DDS::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
 
 int Plugin_DDS::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "DDS Save");
    assert(pszFilename);
    assert(pMipSet);
 
+   // ETC2 RGBA and EAC have no DXGI format and no registered FourCC, save them as KTX or KTX2
+   if( (pMipSet->m_format == CMP_FORMAT_ETC2_RGBA)      ||
+       (pMipSet->m_format == CMP_FORMAT_EAC_R11)        ||
+       (pMipSet->m_format == CMP_FORMAT_EAC_R11_SIGNED) ||
+       (pMipSet->m_format == CMP_FORMAT_EAC_RG11)       ||
+       (pMipSet->m_format == CMP_FORMAT_EAC_RG11_SIGNED) )
+   {
+       DDS_CMips->PrintError("Error [%x]: DDS Plugin cannot store this format, use a KTX or KTX2 file %s\n",IDS_ERROR_UNSUPPORTED_TYPE,pszFilename);
+       return PE_Unknown;
+   }
+
 #ifdef USE_DIRECTXTEX
    // New codecs - with faked FourCC's
    if( (pMipSet->m_format == CMP_FORMAT_BC1) || 
@@ -65,7 +65,8 @@ class Plugin_DDS : public PluginInterface_Image
 
 };
 
-extern CMIPS *DDS_CMips;
+// Per thread, TC_PluginSetSharedIO is called on each thread that loads or saves
+extern thread_local CMIPS *DDS_CMips;
 extern void *make_Plugin_DDS();
 
 
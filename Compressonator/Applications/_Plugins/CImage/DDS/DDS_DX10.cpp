@@ -449,10 +449,18 @@ TC_PluginError SaveDDS_DX10(FILE* pFile, const MipSet* pMipSet)
 
     fwrite(&HeaderDDS10, sizeof(HeaderDDS10), 1, pFile);
 
-    int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : MaxFacesOrSlices(pMipSet, 0);
-    for(int nSlice = 0; nSlice < nSlices; nSlice++)
-        for(int nMipLevel = 0 ; nMipLevel < pMipSet->m_nMipLevels ; nMipLevel++)
-            fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+    // A chain carved from an arena in DDS order is written in one go
+    CMP_BYTE* pChain;
+    size_t    nChainSize;
+    if(DDS_CMips->GetMipSetArenaData(pMipSet, &pChain, &nChainSize))
+        fwrite(pChain, nChainSize, 1, pFile);
+    else
+    {
+        int nSlices = (pMipSet->m_TextureType == TT_2D) ? 1 : MaxFacesOrSlices(pMipSet, 0);
+        for(int nSlice = 0; nSlice < nSlices; nSlice++)
+            for(int nMipLevel = 0 ; nMipLevel < pMipSet->m_nMipLevels ; nMipLevel++)
+                fwrite(DDS_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, DDS_CMips->GetMipLevel(pMipSet, nMipLevel)->m_dwLinearSize, 1, pFile);
+    }
 
     fclose(pFile);
 
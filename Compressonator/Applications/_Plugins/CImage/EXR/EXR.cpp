@@ -64,6 +64,7 @@ IMath.lib;Half.lib;IlmImf.lib;IlmThread.lib;Iex.lib;zlibstatic_d.lib;
 
 #include <string> 
 #include "cExr.h"
+#include "CMP_Trace.h"
 #include <ImfTiledRgbaFile.h>
 #include <ImfHeader.h>
 #include <ImfMultiPartInputFile.h>
@@ -84,7 +85,7 @@ IMath.lib;Half.lib;IlmImf.lib;IlmThread.lib;Iex.lib;zlibstatic_d.lib;
 #include <boost/filesystem/path.hpp>
 #include <boost/algorithm/string.hpp> 
 
-CMIPS *EXR_CMips = NULL;
+thread_local CMIPS *EXR_CMips = NULL;
 
 #ifdef BUILD_AS_PLUGIN_DLL
 DECLARE_PLUGIN(Plugin_EXR)
@@ -148,24 +149,36 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *
 
     if (!boost::filesystem::exists( pszFilename )) return -1;
 
-    int width, height;
-    string inf = pszFilename;
-
-    Array2D<Rgba> pixels;
-    int w, h;
-
-    Exr::fileinfo(inf, width, height);
-    Exr::readRgba(inf, pixels, w, h);
-
-    srcTexture->dwSize            = sizeof(CMP_Texture);
-    srcTexture->dwWidth           = width;
-    srcTexture->dwHeight          = height;
-    srcTexture->dwPitch           = 0;
-    srcTexture->format            = CMP_FORMAT_ARGB_16F;
-    srcTexture->dwDataSize        = 4*width*height*sizeof(CMP_HALF);
-    srcTexture->pData             = (CMP_BYTE*) malloc(srcTexture->dwDataSize);
-
-    Rgba2Texture(pixels,(CMP_HALF *)srcTexture->pData,width,height);
+    srcTexture->pData = NULL;
+    try
+    {
+        RgbaInputFile file(pszFilename, ExrThreadCount());
+        Box2i dw = file.dataWindow();
+        int width  = dw.max.x - dw.min.x + 1;
+        int height = dw.max.y - dw.min.y + 1;
+
+        srcTexture->dwSize            = sizeof(CMP_Texture);
+        srcTexture->dwWidth           = width;
+        srcTexture->dwHeight          = height;
+        srcTexture->dwPitch           = 0;
+        srcTexture->format            = CMP_FORMAT_ARGB_16F;
+        srcTexture->dwDataSize        = 4*width*height*sizeof(CMP_HALF);
+        srcTexture->pData             = (CMP_BYTE*) malloc(srcTexture->dwDataSize);
+        if (!srcTexture->pData)
+            return -1;
+
+        // Decode straight into the texture, Rgba has the same layout as CMP_FORMAT_ARGB_16F
+        file.setFrameBuffer((Rgba *)srcTexture->pData - dw.min.x - dw.min.y * width, 1, width);
+        file.readPixels(dw.min.y, dw.max.y);
+    }
+    catch (const exception &e)
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError(e.what());
+        free(srcTexture->pData);
+        srcTexture->pData = NULL;
+        return -1;
+    }
     return 0;
 }
 
@@ -233,124 +246,57 @@ loadImage(const char fileName[],
     Header &header,
     Array<Rgba> &pixels, MipSet* pMipSet)
 {
-    MultiPartInputFile inmaster(fileName);
-    InputPart in(inmaster, 0);
+    // RgbaInputFile converts luminance / chroma files to RGBA and fills missing channels,
+    // R G B with 0 and A with 1, so it reads every kind of scanline file
+    RgbaInputFile in(fileName, ExrThreadCount());
     header = in.header();
 
-    ChannelList ch = header.channels();
-    
-    if (ch.findChannel("Y"))
-    {
-        //load as RGBA using array2D
-        Array2D<Rgba> pixels;
-        int width, height;
-        int w, h;
-
-        Exr::fileinfo(fileName, width, height);
-        Exr::readRgba(fileName, pixels, w, h);
-
-        CMP_Texture srcTexture;
-        srcTexture.dwSize = sizeof(CMP_Texture);
-        srcTexture.dwWidth = width;
-        srcTexture.dwHeight = height;
-        srcTexture.dwPitch = 0;
-        srcTexture.format = CMP_FORMAT_ARGB_16F;
-        srcTexture.dwDataSize = 4 * width*height * sizeof(CMP_HALF);
-        srcTexture.pData = (CMP_BYTE*)malloc(srcTexture.dwDataSize);
-
-        Rgba2Texture(pixels, (CMP_HALF*)srcTexture.pData, width, height);
-
-
-        if (!EXR_CMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, width, height, 1))
-        {
-            if (EXR_CMips)
-                EXR_CMips->PrintError("Error(0): EXR Plugin ID(5)\n");
-            return PE_Unknown;
-        }
+    Box2i dataWindow = in.dataWindow();
+    int dw = dataWindow.max.x - dataWindow.min.x + 1;
+    int dh = dataWindow.max.y - dataWindow.min.y + 1;
+    int dx = dataWindow.min.x;
+    int dy = dataWindow.min.y;
 
-        // Allocate the permanent buffer and unpack the bitmap data into it
-        if (!EXR_CMips->AllocateMipLevelData(EXR_CMips->GetMipLevel(pMipSet, 0), width, height, CF_Float16, pMipSet->m_TextureDataType))
-        {
-            if (EXR_CMips)
-                EXR_CMips->PrintError("Error(0): EXR Plugin ID(6)\n");
-            return PE_Unknown;
-        }
+    if (!EXR_CMips->AllocateMipSet(pMipSet, CF_Float16, TDT_ARGB, TT_2D, dw, dh, 1))
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError("Error(0): EXR Plugin ID(5)\n");
+        return PE_Unknown;
+    }
 
-        // MIPS structure defaults
-        pMipSet->m_dwFourCC = 0;
-        pMipSet->m_dwFourCC2 = 0;
-        pMipSet->m_nMipLevels = 1;
+    // Allocate the permanent buffer and decode the scanlines straight into it
+    if (!EXR_CMips->AllocateMipLevelData(EXR_CMips->GetMipLevel(pMipSet, 0), dw, dh, CF_Float16, pMipSet->m_TextureDataType))
+    {
+        if (EXR_CMips)
+            EXR_CMips->PrintError("Error(0): EXR Plugin ID(6)\n");
+        return PE_Unknown;
+    }
 
-        BYTE *MipData = EXR_CMips->GetMipLevel(pMipSet, 0)->m_pbData;
+    // MIPS structure defaults
+    pMipSet->m_dwFourCC = 0;
+    pMipSet->m_dwFourCC2 = 0;
+    pMipSet->m_nMipLevels = 1;
 
-        memcpy(MipData, srcTexture.pData, srcTexture.dwDataSize);
+    // Rgba has the same layout as CF_Float16 ARGB, so the line buffers that the OpenEXR
+    // thread pool decompresses are converted into the level without an Rgba copy
+    Rgba *base = (Rgba *)EXR_CMips->GetMipLevel(pMipSet, 0)->m_phfData - dx - dy * dw;
+    in.setFrameBuffer(base, 1, dw);
 
-        free(srcTexture.pData);
+    try
+    {
+        in.readPixels(dataWindow.min.y, dataWindow.max.y);
     }
-    else
+    catch (const exception &e)
     {
-        Box2i &dataWindow = header.dataWindow();
-        int dw = dataWindow.max.x - dataWindow.min.x + 1;
-        int dh = dataWindow.max.y - dataWindow.min.y + 1;
-        int dx = dataWindow.min.x;
-        int dy = dataWindow.min.y;
-
-        pixels.resizeErase(dw * dh);
-        memset(pixels, 0, (dw * dh) * (sizeof(Rgba)));
-
-        size_t xs = 1 * sizeof(Rgba);
-        size_t ys = dw * sizeof(Rgba);
-
-        FrameBuffer fb;
-        Rgba *base = pixels - dx - dy * dw;
-
-        fb.insert("R",
-            Slice(HALF,
-            (char *)&base[0].r,
-                xs, ys,
-                1, 1,     // xSampling, ySampling
-                0.0));    // fillValue
-
-        fb.insert("G",
-            Slice(HALF,
-            (char *)&base[0].g,
-                xs, ys,
-                1, 1,     // xSampling, ySampling
-                0.0));    // fillValue
-
-        fb.insert("B",
-            Slice(HALF,
-            (char *)&base[0].b,
-                xs, ys,
-                1, 1,     // xSampling, ySampling
-                0.0));    // fillValue
-
-        fb.insert("A",
-            Slice(HALF,
-            (char *)&base[0].a,
-                xs, ys,
-                1, 1,             // xSampling, ySampling
-                1.0));    // fillValue
-        in.setFrameBuffer(fb);
-
-
-        try
-        {
-            in.readPixels(dataWindow.min.y, dataWindow.max.y);
-            if (!allocateMipSet(pixels, pMipSet, dw, dh))
-                return PE_Unknown;
-        }
-        catch (const exception &e)
-        {
-            //
-            // If some of the pixels in the file cannot be read,
-            // print an error message, and return a partial image
-            // to the caller.
-            //
+        //
+        // If some of the pixels in the file cannot be read,
+        // print an error message, and return a partial image
+        // to the caller.
+        //
 
-            cerr << e.what() << endl;
-        }
+        cerr << e.what() << endl;
     }
+    return PE_OK;
 }
 
 int
@@ -1120,6 +1066,7 @@ loadDeepTileImage(MultiPartInputFile &inmaster,
 
 int Plugin_EXR::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "EXR Load");
     if (!boost::filesystem::exists( pszFilename )) return -1;
 
     // uncomment the flag below to disable EXR mipmap loading / load only level 0
@@ -1143,7 +1090,7 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
     //handle mipmap exr load using Tile File
     if (((isTile)) && (!(pMipSet->m_Flags & MS_FLAG_DisableMipMapping)))
     {
-        TiledRgbaInputFile file(pszFilename);
+        TiledRgbaInputFile file(pszFilename, ExrThreadCount());
 
         if (!file.isComplete())
             return PE_Unknown;
@@ -1170,17 +1117,25 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
 
             dwWidth = file.levelWidth(i);
             dwHeight = file.levelHeight(i);
-            Array2D<Rgba> pixels(dwHeight, dwWidth);
-            pixels.resizeErase(dwHeight, dwWidth);
-
-            file.setFrameBuffer(pixels[0], 1, dwWidth);
-            file.readTiles(0, file.numXTiles(i) - 1, 0, file.numYTiles(i) - 1, i);
 
-            // Allocate the permanent buffer and unpack the bitmap data into it
-            if (!EXR_CMips->AllocateMipLevelData(EXR_CMips->GetMipLevel(pMipSet, i), dwWidth, dwHeight, CF_Float16, pMipSet->m_TextureDataType))
+            // Allocate the permanent buffer, the tiles are decoded in parallel straight into it
+            MipLevel *pMipLevel = EXR_CMips->GetMipLevel(pMipSet, i);
+            if (!EXR_CMips->AllocateMipLevelData(pMipLevel, dwWidth, dwHeight, CF_Float16, pMipSet->m_TextureDataType))
                 return PE_Unknown;
 
-            Rgba2Texture(pixels, (CMP_HALF* )EXR_CMips->GetMipLevel(pMipSet, i)->m_pbData, dwWidth, dwHeight);
+            Box2i dataWindow = file.dataWindowForLevel(i);
+            file.setFrameBuffer((Rgba *)pMipLevel->m_phfData - dataWindow.min.x - dataWindow.min.y * (int)dwWidth, 1, dwWidth);
+
+            try
+            {
+                file.readTiles(0, file.numXTiles(i) - 1, 0, file.numYTiles(i) - 1, i);
+            }
+            catch (const exception &e)
+            {
+                if (EXR_CMips)
+                    EXR_CMips->PrintError(e.what());
+                return PE_Unknown;
+            }
         }
         return PE_OK;
     } // Tiled file
@@ -1266,6 +1221,7 @@ int Plugin_EXR::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
 
 int Plugin_EXR::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "EXR Save");
     if(!TC_PluginFileSupportsFormat(NULL, pMipSet))
     {
         if (EXR_CMips)
@@ -30,6 +30,7 @@
 #include "TC_PluginAPI.h"
 #include "TC_PluginInternal.h"
 #include "MIPS.h"
+#include "CMP_Trace.h"
 
 #include "softfloat.h"
 
@@ -40,7 +41,7 @@
 #pragma comment(lib, "Glu32.lib")           // Glu 
 #pragma comment(lib, "glew32.lib")          // glew 1.13.0
 
-CMIPS *KTX_CMips;
+thread_local CMIPS *KTX_CMips;
 
 #ifdef BUILD_AS_PLUGIN_DLL
 DECLARE_PLUGIN(Plugin_KTX)
@@ -242,6 +243,21 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *
         case GL_COMPRESSED_RGB8_ETC2:
             srcTexture->format = CMP_FORMAT_ETC2_RGB;
             break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            srcTexture->format = CMP_FORMAT_ETC2_RGBA;
+            break;
+        case GL_COMPRESSED_R11_EAC:
+            srcTexture->format = CMP_FORMAT_EAC_R11;
+            break;
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+            srcTexture->format = CMP_FORMAT_EAC_R11_SIGNED;
+            break;
+        case GL_COMPRESSED_RG11_EAC:
+            srcTexture->format = CMP_FORMAT_EAC_RG11;
+            break;
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            srcTexture->format = CMP_FORMAT_EAC_RG11_SIGNED;
+            break;
         case COMPRESSED_FORMAT_DXT5_RxBG:
             srcTexture->format = CMP_FORMAT_DXT5_RxBG;
             break;
@@ -412,6 +428,11 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *
     case  CMP_FORMAT_DXT5_xGxR:
     case  CMP_FORMAT_ETC_RGB:
     case  CMP_FORMAT_ETC2_RGB:
+    case  CMP_FORMAT_ETC2_RGBA:
+    case  CMP_FORMAT_EAC_R11:
+    case  CMP_FORMAT_EAC_R11_SIGNED:
+    case  CMP_FORMAT_EAC_RG11:
+    case  CMP_FORMAT_EAC_RG11_SIGNED:
     case  CMP_FORMAT_ASTC:
     case  CMP_FORMAT_GT:
         isCompressed = true;
@@ -490,6 +511,21 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *
         case CMP_FORMAT_ETC2_RGB:
             textureinfo.glInternalFormat = GL_COMPRESSED_RGB8_ETC2;
             break;
+        case CMP_FORMAT_ETC2_RGBA:
+            textureinfo.glInternalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+            break;
+        case CMP_FORMAT_EAC_R11:
+            textureinfo.glInternalFormat = GL_COMPRESSED_R11_EAC;
+            break;
+        case CMP_FORMAT_EAC_R11_SIGNED:
+            textureinfo.glInternalFormat = GL_COMPRESSED_SIGNED_R11_EAC;
+            break;
+        case CMP_FORMAT_EAC_RG11:
+            textureinfo.glInternalFormat = GL_COMPRESSED_RG11_EAC;
+            break;
+        case CMP_FORMAT_EAC_RG11_SIGNED:
+            textureinfo.glInternalFormat = GL_COMPRESSED_SIGNED_RG11_EAC;
+            break;
         case CMP_FORMAT_DXT5_xGBR:
             textureinfo.glInternalFormat = COMPRESSED_FORMAT_DXT5_xGBR;
             break;
@@ -804,6 +840,7 @@ static void copy_scanline(void *dst, const void *src, int pixels, int method)
 
 int Plugin_KTX::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "KTX Load");
     FILE* pFile = NULL;
     if (_tfopen_s(&pFile, pszFilename, _T("rb")) != 0 || pFile == NULL)
     {
@@ -989,6 +1026,26 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
             pMipSet->m_format = CMP_FORMAT_ETC2_RGB;
             pMipSet->m_TextureDataType = TDT_ARGB;
             break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            pMipSet->m_format = CMP_FORMAT_ETC2_RGBA;
+            pMipSet->m_TextureDataType = TDT_ARGB;
+            break;
+        case GL_COMPRESSED_R11_EAC:
+            pMipSet->m_format = CMP_FORMAT_EAC_R11;
+            pMipSet->m_TextureDataType = TDT_ARGB;
+            break;
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+            pMipSet->m_format = CMP_FORMAT_EAC_R11_SIGNED;
+            pMipSet->m_TextureDataType = TDT_ARGB;
+            break;
+        case GL_COMPRESSED_RG11_EAC:
+            pMipSet->m_format = CMP_FORMAT_EAC_RG11;
+            pMipSet->m_TextureDataType = TDT_ARGB;
+            break;
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            pMipSet->m_format = CMP_FORMAT_EAC_RG11_SIGNED;
+            pMipSet->m_TextureDataType = TDT_ARGB;
+            break;
         case COMPRESSED_FORMAT_DXT5_RxBG :
             pMipSet->m_format = CMP_FORMAT_DXT5_RxBG;
             pMipSet->m_TextureDataType = TDT_ARGB;
@@ -1225,6 +1282,7 @@ int Plugin_KTX::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
 
 int Plugin_KTX::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "KTX Save");
     assert(pszFilename);
     assert(pMipSet);
 
@@ -1345,6 +1403,11 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipS
     case  CMP_FORMAT_DXT5_xGxR :               
     case  CMP_FORMAT_ETC_RGB :                 
     case  CMP_FORMAT_ETC2_RGB:
+    case  CMP_FORMAT_ETC2_RGBA:
+    case  CMP_FORMAT_EAC_R11:
+    case  CMP_FORMAT_EAC_R11_SIGNED:
+    case  CMP_FORMAT_EAC_RG11:
+    case  CMP_FORMAT_EAC_RG11_SIGNED:
     case  CMP_FORMAT_ASTC :
     case  CMP_FORMAT_GT:
         isCompressed            = true;
@@ -1505,6 +1568,21 @@ int Plugin_KTX::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipS
             case CMP_FORMAT_ETC2_RGB:
                 textureinfo.glInternalFormat = GL_COMPRESSED_RGB8_ETC2;
                 break;
+            case CMP_FORMAT_ETC2_RGBA:
+                textureinfo.glInternalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC;
+                break;
+            case CMP_FORMAT_EAC_R11:
+                textureinfo.glInternalFormat = GL_COMPRESSED_R11_EAC;
+                break;
+            case CMP_FORMAT_EAC_R11_SIGNED:
+                textureinfo.glInternalFormat = GL_COMPRESSED_SIGNED_R11_EAC;
+                break;
+            case CMP_FORMAT_EAC_RG11:
+                textureinfo.glInternalFormat = GL_COMPRESSED_RG11_EAC;
+                break;
+            case CMP_FORMAT_EAC_RG11_SIGNED:
+                textureinfo.glInternalFormat = GL_COMPRESSED_SIGNED_RG11_EAC;
+                break;
             case CMP_FORMAT_DXT5_xGBR:
                 textureinfo.glInternalFormat = COMPRESSED_FORMAT_DXT5_xGBR;
                 break;
@@ -0,0 +1,678 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "stdafx.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cKTX2.h"
+
+#include "TC_PluginAPI.h"
+#include "TC_PluginInternal.h"
+#include "MIPS.h"
+#include "CMP_Trace.h"
+
+#include "zstd.h"
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#pragma comment(lib, "libzstd_static.lib")  // zstd 1.3.2
+
+thread_local CMIPS *KTX2_CMips;
+
+// The plugin DLL build exports the KTX plugin only, KTX2 is registered by the static builds
+#ifndef BUILD_AS_PLUGIN_DLL
+void *make_Plugin_KTX2() { return new Plugin_KTX2; }
+#endif
+
+static const uint8_t KTX2FileIdentifier[12] = {
+   0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+// Written to the KTXwriter key so files can be traced back to the tool that made them
+static const char KTX2WriterKey[]   = "KTXwriter";
+static const char KTX2WriterValue[] = "Compressonator";
+
+struct KTX2Sample
+{
+    uint16_t    bitOffset;
+    uint8_t     bitLength;
+    uint8_t     channelType;        // Channel id with the KHR_DF_SAMPLE_ qualifiers
+    uint32_t    lower;
+    uint32_t    upper;
+};
+
+struct KTX2FormatInfo
+{
+    CMP_FORMAT      format;
+    uint32_t        vkFormat;       // 0 for ASTC, the block size picks the VkFormat
+    uint32_t        typeSize;
+    uint8_t         colorModel;
+    uint8_t         bytesPerBlock;  // Bytes per block, or per pixel for uncompressed formats
+    ChannelFormat   channelFormat;
+    int             nSamples;
+    KTX2Sample      samples[4];
+};
+
+#define KTX2_UNORM      0, 0xFFFFFFFF
+#define KTX2_SNORM      0x80000000, 0x7FFFFFFF
+#define KTX2_UFLOAT     0, 0x3F800000
+#define KTX2_SFLOAT     0xBF800000, 0x3F800000
+
+// Formats are matched in order, so the first entry for a VkFormat is the one loaded
+static const KTX2FormatInfo KTX2Formats[] =
+{
+    { CMP_FORMAT_ARGB_8888,         VK_FORMAT_R8G8B8A8_UNORM,               1, KHR_DF_MODEL_RGBSDA,  4, CF_8bit,
+        4, { { 0, 8, KHR_DF_CHANNEL_RED, 0, 255 }, { 8, 8, KHR_DF_CHANNEL_GREEN, 0, 255 }, { 16, 8, KHR_DF_CHANNEL_BLUE, 0, 255 }, { 24, 8, KHR_DF_CHANNEL_ALPHA, 0, 255 } } },
+    { CMP_FORMAT_ARGB_16F,          VK_FORMAT_R16G16B16A16_SFLOAT,          2, KHR_DF_MODEL_RGBSDA,  8, CF_Float16,
+        4, { { 0,  16, KHR_DF_CHANNEL_RED   | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 16, 16, KHR_DF_CHANNEL_GREEN | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 32, 16, KHR_DF_CHANNEL_BLUE  | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 48, 16, KHR_DF_CHANNEL_ALPHA | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT } } },
+    { CMP_FORMAT_ARGB_32F,          VK_FORMAT_R32G32B32A32_SFLOAT,          4, KHR_DF_MODEL_RGBSDA, 16, CF_Float32,
+        4, { { 0,  32, KHR_DF_CHANNEL_RED   | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 32, 32, KHR_DF_CHANNEL_GREEN | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 64, 32, KHR_DF_CHANNEL_BLUE  | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT },
+             { 96, 32, KHR_DF_CHANNEL_ALPHA | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT } } },
+    { CMP_FORMAT_BC1,               VK_FORMAT_BC1_RGBA_UNORM_BLOCK,         1, KHR_DF_MODEL_BC1A,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_BC1A_ALPHA, KTX2_UNORM } } },
+    { CMP_FORMAT_DXT1,              VK_FORMAT_BC1_RGBA_UNORM_BLOCK,         1, KHR_DF_MODEL_BC1A,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_BC1A_ALPHA, KTX2_UNORM } } },
+    { CMP_FORMAT_BC2,               VK_FORMAT_BC2_UNORM_BLOCK,              1, KHR_DF_MODEL_BC2,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_ALPHA, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_DXT3,              VK_FORMAT_BC2_UNORM_BLOCK,              1, KHR_DF_MODEL_BC2,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_ALPHA, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_BC3,               VK_FORMAT_BC3_UNORM_BLOCK,              1, KHR_DF_MODEL_BC3,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_ALPHA, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_DXT5,              VK_FORMAT_BC3_UNORM_BLOCK,              1, KHR_DF_MODEL_BC3,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_ALPHA, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_BC4,               VK_FORMAT_BC4_UNORM_BLOCK,              1, KHR_DF_MODEL_BC4,     8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM } } },
+    { CMP_FORMAT_ATI1N,             VK_FORMAT_BC4_UNORM_BLOCK,              1, KHR_DF_MODEL_BC4,     8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM } } },
+    { CMP_FORMAT_BC5,               VK_FORMAT_BC5_UNORM_BLOCK,              1, KHR_DF_MODEL_BC5,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_GREEN, KTX2_UNORM } } },
+    { CMP_FORMAT_ATI2N_XY,          VK_FORMAT_BC5_UNORM_BLOCK,              1, KHR_DF_MODEL_BC5,    16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_GREEN, KTX2_UNORM } } },
+    { CMP_FORMAT_BC6H,              VK_FORMAT_BC6H_UFLOAT_BLOCK,            1, KHR_DF_MODEL_BC6H,   16, CF_Compressed,
+        1, { { 0, 128, KHR_DF_CHANNEL_COLOR | KHR_DF_SAMPLE_FLOAT, KTX2_UFLOAT } } },
+    { CMP_FORMAT_BC6H_SF,           VK_FORMAT_BC6H_SFLOAT_BLOCK,            1, KHR_DF_MODEL_BC6H,   16, CF_Compressed,
+        1, { { 0, 128, KHR_DF_CHANNEL_COLOR | KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED, KTX2_SFLOAT } } },
+    { CMP_FORMAT_BC7,               VK_FORMAT_BC7_UNORM_BLOCK,              1, KHR_DF_MODEL_BC7,    16, CF_Compressed,
+        1, { { 0, 128, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_ETC2_RGB,          VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,      1, KHR_DF_MODEL_ETC2,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_ETC2_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_ETC_RGB,           VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,      1, KHR_DF_MODEL_ETC1,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_ETC2_RGBA,         VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,    1, KHR_DF_MODEL_ETC2,   16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_ALPHA, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_ETC2_COLOR, KTX2_UNORM } } },
+    { CMP_FORMAT_EAC_R11,           VK_FORMAT_EAC_R11_UNORM_BLOCK,          1, KHR_DF_MODEL_ETC2,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM } } },
+    { CMP_FORMAT_EAC_R11_SIGNED,    VK_FORMAT_EAC_R11_SNORM_BLOCK,          1, KHR_DF_MODEL_ETC2,    8, CF_Compressed,
+        1, { { 0, 64, KHR_DF_CHANNEL_RED | KHR_DF_SAMPLE_SIGNED, KTX2_SNORM } } },
+    { CMP_FORMAT_EAC_RG11,          VK_FORMAT_EAC_R11G11_UNORM_BLOCK,       1, KHR_DF_MODEL_ETC2,   16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_RED, KTX2_UNORM }, { 64, 64, KHR_DF_CHANNEL_GREEN, KTX2_UNORM } } },
+    { CMP_FORMAT_EAC_RG11_SIGNED,   VK_FORMAT_EAC_R11G11_SNORM_BLOCK,       1, KHR_DF_MODEL_ETC2,   16, CF_Compressed,
+        2, { { 0, 64, KHR_DF_CHANNEL_RED | KHR_DF_SAMPLE_SIGNED, KTX2_SNORM }, { 64, 64, KHR_DF_CHANNEL_GREEN | KHR_DF_SAMPLE_SIGNED, KTX2_SNORM } } },
+    { CMP_FORMAT_ASTC,              0,                                      1, KHR_DF_MODEL_ASTC,   16, CF_Compressed,
+        1, { { 0, 128, KHR_DF_CHANNEL_COLOR, KTX2_UNORM } } },
+};
+
+// ASTC block sizes in VkFormat order, each has a UNORM and an SRGB VkFormat
+static const uint8_t KTX2ASTCBlocks[][2] =
+{
+    { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 }, { 8, 8 },
+    { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+};
+
+#define KTX2_NUM_FORMATS        (sizeof(KTX2Formats) / sizeof(KTX2Formats[0]))
+#define KTX2_NUM_ASTC_BLOCKS    (sizeof(KTX2ASTCBlocks) / sizeof(KTX2ASTCBlocks[0]))
+
+static const KTX2FormatInfo* KTX2FindFormat(CMP_FORMAT format)
+{
+    for (int i = 0; i < (int)KTX2_NUM_FORMATS; i++)
+    {
+        if (KTX2Formats[i].format == format)
+            return &KTX2Formats[i];
+    }
+    return NULL;
+}
+
+// ETC1 shares its VkFormat with ETC2 RGB, the DFD color model tells them apart
+static const KTX2FormatInfo* KTX2FindVkFormat(uint32_t vkFormat, uint32_t colorModel, int& nBlockWidth, int& nBlockHeight)
+{
+    nBlockWidth  = 4;
+    nBlockHeight = 4;
+
+    if (vkFormat >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && vkFormat < VK_FORMAT_ASTC_4x4_UNORM_BLOCK + 2 * KTX2_NUM_ASTC_BLOCKS)
+    {
+        int nBlock = (vkFormat - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2;
+        nBlockWidth  = KTX2ASTCBlocks[nBlock][0];
+        nBlockHeight = KTX2ASTCBlocks[nBlock][1];
+        return KTX2FindFormat(CMP_FORMAT_ASTC);
+    }
+
+    const KTX2FormatInfo* pFound = NULL;
+    for (int i = 0; i < (int)KTX2_NUM_FORMATS; i++)
+    {
+        if (KTX2Formats[i].vkFormat != vkFormat)
+            continue;
+        if (KTX2Formats[i].colorModel == colorModel)
+            return &KTX2Formats[i];
+        if (pFound == NULL)
+            pFound = &KTX2Formats[i];
+    }
+
+    if (pFound && pFound->channelFormat != CF_Compressed)
+    {
+        nBlockWidth  = 1;
+        nBlockHeight = 1;
+    }
+    return pFound;
+}
+
+static uint32_t KTX2VkFormat(const KTX2FormatInfo* pInfo, int nBlockWidth, int nBlockHeight)
+{
+    if (pInfo->format != CMP_FORMAT_ASTC)
+        return pInfo->vkFormat;
+
+    for (int i = 0; i < (int)KTX2_NUM_ASTC_BLOCKS; i++)
+    {
+        if (KTX2ASTCBlocks[i][0] == nBlockWidth && KTX2ASTCBlocks[i][1] == nBlockHeight)
+            return VK_FORMAT_ASTC_4x4_UNORM_BLOCK + 2 * i;
+    }
+    return 0;
+}
+
+// Basic data format descriptor, preceded by dfdTotalSize
+static void KTX2BuildDFD(const KTX2FormatInfo* pInfo, int nBlockWidth, int nBlockHeight, std::vector<uint32_t>& dfd)
+{
+    uint32_t dwBlockSize = 24 + 16 * pInfo->nSamples;
+
+    dfd.clear();
+    dfd.push_back(4 + dwBlockSize);
+    dfd.push_back(0);                                                   // Khronos vendor, basic descriptor type
+    dfd.push_back(KHR_DF_VERSIONNUMBER_1_3 | (dwBlockSize << 16));
+    dfd.push_back(pInfo->colorModel | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+    dfd.push_back((nBlockWidth - 1) | ((nBlockHeight - 1) << 8));       // Texel block dimensions are stored minus one
+    dfd.push_back(pInfo->bytesPerBlock);                                // bytesPlane0
+    dfd.push_back(0);
+
+    for (int i = 0; i < pInfo->nSamples; i++)
+    {
+        const KTX2Sample& sample = pInfo->samples[i];
+        dfd.push_back(sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+        dfd.push_back(0);                                               // Sample position
+        dfd.push_back(sample.lower);
+        dfd.push_back(sample.upper);
+    }
+}
+
+// Runs Process(nLevel) for each level on up to one thread per core, largest level first
+template <class T>
+static void KTX2ForEachLevel(int nLevels, T Process)
+{
+    std::atomic<int> nNextLevel(0);
+    auto Worker = [&]()
+    {
+        for (int nLevel = nNextLevel++; nLevel < nLevels; nLevel = nNextLevel++)
+            Process(nLevel);
+    };
+
+    int nThreads = (int)std::thread::hardware_concurrency();
+    if (nThreads > nLevels)
+        nThreads = nLevels;
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nThreads; i++)
+        threads.push_back(std::thread(Worker));
+    Worker();
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+// Size of the data zstd compressed as one level of a KTX2 file at nLevel, 0 if compression failed
+size_t KTX2_SupercompressedSize(const void* pData, size_t nSize, int nLevel)
+{
+    std::vector<uint8_t> compressed(ZSTD_compressBound(nSize));
+    size_t nResult = ZSTD_compress(&compressed[0], compressed.size(), pData, nSize, nLevel);
+    return ZSTD_isError(nResult) ? 0 : nResult;
+}
+
+Plugin_KTX2::Plugin_KTX2()
+{
+}
+
+Plugin_KTX2::~Plugin_KTX2()
+{
+}
+
+int Plugin_KTX2::TC_PluginSetSharedIO(void* Shared)
+{
+    if (Shared)
+    {
+        KTX2_CMips = static_cast<CMIPS *>(Shared);
+        return 0;
+    }
+    return 1;
+}
+
+int Plugin_KTX2::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
+{
+    pPluginVersion->guid                    = g_GUID_KTX2;
+    pPluginVersion->dwAPIVersionMajor       = TC_API_VERSION_MAJOR;
+    pPluginVersion->dwAPIVersionMinor       = TC_API_VERSION_MINOR;
+    pPluginVersion->dwPluginVersionMajor    = TC_PLUGIN_KTX2_VERSION_MAJOR;
+    pPluginVersion->dwPluginVersionMinor    = TC_PLUGIN_KTX2_VERSION_MINOR;
+    return 0;
+}
+
+// As with the KTX plugin, single level CMP_Texture IO is not supported
+int Plugin_KTX2::TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    UNREFERENCED_PARAMETER(pszFilename);
+    UNREFERENCED_PARAMETER(srcTexture);
+    return -1;
+}
+
+int Plugin_KTX2::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    UNREFERENCED_PARAMETER(pszFilename);
+    UNREFERENCED_PARAMETER(srcTexture);
+    return -1;
+}
+
+int Plugin_KTX2::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "KTX2 Load");
+    FILE* pFile = NULL;
+    if (_tfopen_s(&pFile, pszFilename, _T("rb")) != 0 || pFile == NULL)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_KTX2_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    ktx2_header header;
+    if (fread(&header, sizeof(header), 1, pFile) != 1 || memcmp(header.identifier, KTX2FileIdentifier, sizeof(KTX2FileIdentifier)) != 0)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) invalid KTX2 header. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_NOT_KTX2, pszFilename);
+        fclose(pFile);
+        return -1;
+    }
+
+    int nLevels = header.levelCount ? header.levelCount : 1;
+    int nFaces  = header.faceCount  ? header.faceCount  : 1;
+    if ((header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE && header.supercompressionScheme != KTX2_SUPERCOMPRESSION_ZSTD) ||
+        header.layerCount > 1 || (nFaces != 1 && nFaces != 6) || header.pixelHeight == 0 || (nFaces == 6 && header.pixelDepth > 1))
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) unsupported KTX2 layout. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_UNSUPPORTED_TYPE, pszFilename);
+        fclose(pFile);
+        return -1;
+    }
+
+    // levelCount sizes the level index, a chain never has more levels than halving the largest dimension gives
+    uint32_t nMaxDimension = header.pixelWidth > header.pixelHeight ? header.pixelWidth : header.pixelHeight;
+    if (header.pixelDepth > nMaxDimension)
+        nMaxDimension = header.pixelDepth;
+    uint32_t nMaxLevels = 1;
+    while (nMaxDimension >>= 1)
+        nMaxLevels++;
+    if (header.levelCount > nMaxLevels)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) invalid KTX2 level count. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_NOT_KTX2, pszFilename);
+        fclose(pFile);
+        return -1;
+    }
+
+    std::vector<ktx2_level_index> levelIndex(nLevels);
+    if (fread(&levelIndex[0], sizeof(ktx2_level_index), nLevels, pFile) != (size_t)nLevels)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) invalid KTX2 level index. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_NOT_KTX2, pszFilename);
+        fclose(pFile);
+        return -1;
+    }
+
+    // The color model is the low byte of the third word after dfdTotalSize
+    uint32_t dfdHead[4] = { 0, 0, 0, 0 };
+    if (header.dfdByteLength >= sizeof(dfdHead))
+    {
+        if (fseek(pFile, header.dfdByteOffset, SEEK_SET) != 0 || fread(dfdHead, sizeof(dfdHead), 1, pFile) != 1)
+            memset(dfdHead, 0, sizeof(dfdHead));
+    }
+
+    int nBlockWidth, nBlockHeight;
+    const KTX2FormatInfo* pInfo = KTX2FindVkFormat(header.vkFormat, dfdHead[3] & 0xFF, nBlockWidth, nBlockHeight);
+    if (pInfo == NULL)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) unsupported VkFormat %d\n"), EL_Error, IDS_ERROR_KTX2_UNSUPPORTED_TYPE, header.vkFormat);
+        fclose(pFile);
+        return -1;
+    }
+
+    pMipSet->m_format           = pInfo->format;
+    pMipSet->m_compressed       = (pInfo->channelFormat == CF_Compressed);
+    pMipSet->m_ChannelFormat    = pInfo->channelFormat;
+    pMipSet->m_TextureDataType  = TDT_ARGB;
+    pMipSet->m_nBlockWidth      = nBlockWidth;
+    pMipSet->m_nBlockHeight     = nBlockHeight;
+    pMipSet->m_nBlockDepth      = 1;
+
+    int nDepth = 1;
+    if (nFaces == 6)
+    {
+        pMipSet->m_TextureType = TT_CubeMap;
+        nDepth = 6;
+    }
+    else if (header.pixelDepth > 1)
+    {
+        pMipSet->m_TextureType = TT_VolumeTexture;
+        nDepth = header.pixelDepth;
+    }
+    else
+        pMipSet->m_TextureType = TT_2D;
+
+    if (!KTX2_CMips->AllocateMipSet(pMipSet, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType, pMipSet->m_TextureType,
+                                    header.pixelWidth, header.pixelHeight, nDepth))
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) allocating MipSet. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_ALLOCATEMIPSET, pszFilename);
+        fclose(pFile);
+        return -1;
+    }
+    if (nLevels > pMipSet->m_nMaxMipLevels)
+        nLevels = pMipSet->m_nMaxMipLevels;
+    pMipSet->m_nMipLevels = nLevels;
+
+    // Read every level as stored and allocate the MipLevels, then undo the supercompression level by level in parallel
+    std::vector< std::vector<uint8_t> > levelData(nLevels);
+    int w = pMipSet->m_nWidth;
+    int h = pMipSet->m_nHeight;
+    for (int nMipLevel = 0; nMipLevel < nLevels; nMipLevel++)
+    {
+        const ktx2_level_index& index = levelIndex[nMipLevel];
+        int nSlices = MaxFacesOrSlices(pMipSet, nMipLevel);
+        bool bReadOK = (nSlices > 0) && (index.uncompressedByteLength % nSlices == 0) &&
+                       (index.byteLength == (size_t)index.byteLength) &&
+                       (header.supercompressionScheme != KTX2_SUPERCOMPRESSION_NONE || index.byteLength == index.uncompressedByteLength);
+        if (bReadOK)
+        {
+            levelData[nMipLevel].resize((size_t)index.byteLength);
+            bReadOK = (_fseeki64(pFile, (__int64)index.byteOffset, SEEK_SET) == 0) &&
+                      (index.byteLength == 0 || fread(&levelData[nMipLevel][0], 1, (size_t)index.byteLength, pFile) == index.byteLength);
+        }
+        if (!bReadOK)
+        {
+            if (KTX2_CMips)
+                KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) Read image data failed. Format %x\n"), EL_Error, IDS_ERROR_KTX2_UNSUPPORTED_TYPE, header.vkFormat);
+            fclose(pFile);
+            return -1;
+        }
+
+        DWORD dwSliceSize = (DWORD)(index.uncompressedByteLength / nSlices);
+        for (int nSlice = 0; nSlice < nSlices; nSlice++)
+        {
+            MipLevel* pMipLevel = KTX2_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice);
+            bool bAllocated = pMipSet->m_compressed ? KTX2_CMips->AllocateCompressedMipLevelData(pMipLevel, w, h, dwSliceSize)
+                                                    : KTX2_CMips->AllocateMipLevelData(pMipLevel, w, h, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType);
+            if (!bAllocated || pMipLevel->m_dwLinearSize != dwSliceSize)
+            {
+                if (KTX2_CMips)
+                    KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) allocating MipLevel data. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_ALLOCATEMIPSLEVELDATA, pszFilename);
+                fclose(pFile);
+                return -1;
+            }
+        }
+
+        w = (w > 1) ? (w >> 1) : 1;
+        h = (h > 1) ? (h >> 1) : 1;
+    }
+    fclose(pFile);
+
+    // KTX2_CMips is per thread and not set on the level workers
+    CMIPS* pCMips = KTX2_CMips;
+    std::atomic<bool> bOK(true);
+    KTX2ForEachLevel(nLevels, [&](int nMipLevel)
+    {
+        CMP_TRACE_SCOPE("IO", "KTX2 Load Level");
+        size_t nSize = (size_t)levelIndex[nMipLevel].uncompressedByteLength;
+        int nSlices = MaxFacesOrSlices(pMipSet, nMipLevel);
+        size_t nSliceSize = nSize / nSlices;
+
+        // A single slice is expanded straight into its MipLevel
+        std::vector<uint8_t> expanded;
+        const uint8_t* pLevel = levelData[nMipLevel].empty() ? NULL : &levelData[nMipLevel][0];
+        if (header.supercompressionScheme == KTX2_SUPERCOMPRESSION_ZSTD)
+        {
+            uint8_t* pDst = pCMips->GetMipLevel(pMipSet, nMipLevel, 0)->m_pbData;
+            if (nSlices > 1)
+            {
+                expanded.resize(nSize);
+                pDst = &expanded[0];
+            }
+
+            size_t nResult = ZSTD_decompress(pDst, nSize, pLevel, levelData[nMipLevel].size());
+            if (ZSTD_isError(nResult) || nResult != nSize)
+            {
+                bOK = false;
+                return;
+            }
+            if (nSlices == 1)
+                return;
+            pLevel = pDst;
+        }
+
+        for (int nSlice = 0; nSlice < nSlices; nSlice++)
+            memcpy(pCMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, pLevel + nSlice * nSliceSize, nSliceSize);
+    });
+
+    if (!bOK)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) zstd decompression failed. Filename = %s \n"), EL_Error, IDS_ERROR_KTX2_SUPERCOMPRESSION, pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
+
+int Plugin_KTX2::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "KTX2 Save");
+    assert(pszFilename);
+    assert(pMipSet);
+
+    if (pMipSet->m_pMipLevelTable == NULL || KTX2_CMips->GetMipLevel(pMipSet, 0) == NULL)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_KTX2_ALLOCATEMIPSET, pszFilename);
+        return -1;
+    }
+
+    const KTX2FormatInfo* pInfo = KTX2FindFormat(pMipSet->m_format);
+    int nBlockWidth  = 1;
+    int nBlockHeight = 1;
+    if (pInfo && pInfo->channelFormat == CF_Compressed)
+    {
+        nBlockWidth  = (pInfo->format == CMP_FORMAT_ASTC && pMipSet->m_nBlockWidth)  ? pMipSet->m_nBlockWidth  : 4;
+        nBlockHeight = (pInfo->format == CMP_FORMAT_ASTC && pMipSet->m_nBlockHeight) ? pMipSet->m_nBlockHeight : 4;
+    }
+
+    uint32_t vkFormat = pInfo ? KTX2VkFormat(pInfo, nBlockWidth, nBlockHeight) : 0;
+    if (vkFormat == 0)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) unsupported format %x saving file = %s "), EL_Error, IDS_ERROR_KTX2_UNSUPPORTED_TYPE, pMipSet->m_format, pszFilename);
+        return -1;
+    }
+
+    int nLevels      = pMipSet->m_nMipLevels > 0 ? pMipSet->m_nMipLevels : 1;
+    int nZstdLevel   = pMipSet->m_nSupercompressionLevel;
+    if (nZstdLevel > ZSTD_maxCLevel())
+        nZstdLevel = ZSTD_maxCLevel();
+    uint32_t dwScheme = (nZstdLevel > 0) ? KTX2_SUPERCOMPRESSION_ZSTD : KTX2_SUPERCOMPRESSION_NONE;
+
+    // Each level is stored as one run of its faces or slices. Levels with more than one are gathered
+    // first, then all levels are supercompressed in parallel as separate zstd frames.
+    struct KTX2Level
+    {
+        const uint8_t*          pData;
+        size_t                  nSize;
+        std::vector<uint8_t>    gathered;
+        std::vector<uint8_t>    compressed;
+    };
+    std::vector<KTX2Level> levels(nLevels);
+    for (int nMipLevel = 0; nMipLevel < nLevels; nMipLevel++)
+    {
+        KTX2Level& level = levels[nMipLevel];
+        int nSlices = MaxFacesOrSlices(pMipSet, nMipLevel);
+        if (nSlices < 1)
+            nSlices = 1;
+
+        MipLevel* pMipLevel = KTX2_CMips->GetMipLevel(pMipSet, nMipLevel, 0);
+        if (pMipLevel == NULL || pMipLevel->m_pbData == NULL)
+        {
+            if (KTX2_CMips)
+                KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_KTX2_ALLOCATEMIPSLEVELDATA, pszFilename);
+            return -1;
+        }
+
+        level.pData = pMipLevel->m_pbData;
+        level.nSize = pMipLevel->m_dwLinearSize;
+        if (nSlices > 1)
+        {
+            level.gathered.resize(level.nSize * nSlices);
+            for (int nSlice = 0; nSlice < nSlices; nSlice++)
+                memcpy(&level.gathered[nSlice * level.nSize], KTX2_CMips->GetMipLevel(pMipSet, nMipLevel, nSlice)->m_pbData, level.nSize);
+            level.pData = &level.gathered[0];
+            level.nSize = level.gathered.size();
+        }
+    }
+
+    if (dwScheme == KTX2_SUPERCOMPRESSION_ZSTD)
+    {
+        std::atomic<bool> bOK(true);
+        KTX2ForEachLevel(nLevels, [&](int nMipLevel)
+        {
+            CMP_TRACE_SCOPE("IO", "KTX2 Supercompress Level");
+            KTX2Level& level = levels[nMipLevel];
+            level.compressed.resize(ZSTD_compressBound(level.nSize));
+            size_t nResult = ZSTD_compress(&level.compressed[0], level.compressed.size(), level.pData, level.nSize, nZstdLevel);
+            if (ZSTD_isError(nResult))
+                bOK = false;
+            else
+                level.compressed.resize(nResult);
+        });
+
+        if (!bOK)
+        {
+            if (KTX2_CMips)
+                KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) zstd compression failed saving file = %s "), EL_Error, IDS_ERROR_KTX2_SUPERCOMPRESSION, pszFilename);
+            return -1;
+        }
+    }
+
+    // Layout: header, level index, DFD, key/value data, then the levels smallest first
+    std::vector<uint32_t> dfd;
+    KTX2BuildDFD(pInfo, nBlockWidth, nBlockHeight, dfd);
+
+    uint32_t dwKeyValueSize = (uint32_t)(sizeof(KTX2WriterKey) + sizeof(KTX2WriterValue));
+    uint32_t dwKVDSize      = (4 + dwKeyValueSize + 3) & ~3;
+
+    ktx2_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.identifier, KTX2FileIdentifier, sizeof(KTX2FileIdentifier));
+    header.vkFormat                 = vkFormat;
+    header.typeSize                 = pInfo->typeSize;
+    header.pixelWidth               = pMipSet->m_nWidth;
+    header.pixelHeight              = pMipSet->m_nHeight;
+    header.pixelDepth               = (pMipSet->m_TextureType == TT_VolumeTexture) ? pMipSet->m_nDepth : 0;
+    header.layerCount               = 0;
+    header.faceCount                = (pMipSet->m_TextureType == TT_CubeMap) ? 6 : 1;
+    header.levelCount               = nLevels;
+    header.supercompressionScheme   = dwScheme;
+    header.dfdByteOffset            = (uint32_t)(sizeof(header) + nLevels * sizeof(ktx2_level_index));
+    header.dfdByteLength            = (uint32_t)(dfd.size() * sizeof(uint32_t));
+    header.kvdByteOffset            = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength            = dwKVDSize;
+
+    // Uncompressed levels start on a texel block boundary, the block sizes used here are all powers of two
+    uint64_t nAlignment = (dwScheme == KTX2_SUPERCOMPRESSION_NONE) ? (pInfo->bytesPerBlock > 4 ? pInfo->bytesPerBlock : 4) : 1;
+    std::vector<ktx2_level_index> levelIndex(nLevels);
+    uint64_t nOffset = header.kvdByteOffset + header.kvdByteLength;
+    for (int nMipLevel = nLevels - 1; nMipLevel >= 0; nMipLevel--)
+    {
+        nOffset = (nOffset + nAlignment - 1) & ~(nAlignment - 1);
+        levelIndex[nMipLevel].byteOffset             = nOffset;
+        levelIndex[nMipLevel].byteLength             = (dwScheme == KTX2_SUPERCOMPRESSION_ZSTD) ? levels[nMipLevel].compressed.size() : levels[nMipLevel].nSize;
+        levelIndex[nMipLevel].uncompressedByteLength = levels[nMipLevel].nSize;
+        nOffset += levelIndex[nMipLevel].byteLength;
+    }
+
+    FILE* pFile = NULL;
+    pFile = fopen(pszFilename, "wb");
+    if (pFile == NULL)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_KTX2_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    static const uint8_t padding[16] = { 0 };
+    uint32_t dwKeyValueHeader = dwKeyValueSize;
+    bool bWritten = fwrite(&header, sizeof(header), 1, pFile) == 1 &&
+                    fwrite(&levelIndex[0], sizeof(ktx2_level_index), nLevels, pFile) == (size_t)nLevels &&
+                    fwrite(&dfd[0], sizeof(uint32_t), dfd.size(), pFile) == dfd.size() &&
+                    fwrite(&dwKeyValueHeader, sizeof(dwKeyValueHeader), 1, pFile) == 1 &&
+                    fwrite(KTX2WriterKey, sizeof(KTX2WriterKey), 1, pFile) == 1 &&
+                    fwrite(KTX2WriterValue, sizeof(KTX2WriterValue), 1, pFile) == 1 &&
+                    fwrite(padding, 1, dwKVDSize - 4 - dwKeyValueSize, pFile) == dwKVDSize - 4 - dwKeyValueSize;
+
+    nOffset = header.kvdByteOffset + header.kvdByteLength;
+    for (int nMipLevel = nLevels - 1; bWritten && nMipLevel >= 0; nMipLevel--)
+    {
+        size_t nPadding = (size_t)(levelIndex[nMipLevel].byteOffset - nOffset);
+        const uint8_t* pData = (dwScheme == KTX2_SUPERCOMPRESSION_ZSTD) ? &levels[nMipLevel].compressed[0] : levels[nMipLevel].pData;
+        size_t nSize = (size_t)levelIndex[nMipLevel].byteLength;
+
+        bWritten = fwrite(padding, 1, nPadding, pFile) == nPadding &&
+                   fwrite(pData, 1, nSize, pFile) == nSize;
+        nOffset = levelIndex[nMipLevel].byteOffset + nSize;
+    }
+
+    if (fclose(pFile) != 0 || !bWritten)
+    {
+        if (KTX2_CMips)
+            KTX2_CMips->PrintError(_T("Error(%d): KTX2 Plugin ID(%d) saving file = %s "), EL_Error, IDS_ERROR_KTX2_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
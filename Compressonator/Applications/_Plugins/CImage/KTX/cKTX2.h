@@ -0,0 +1,167 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _PLUGIN_IMAGE_KTX2_H
+#define _PLUGIN_IMAGE_KTX2_H
+
+#include "PluginInterface.h"
+#include "stdint.h"
+
+// {3F0B8C52-7D1E-4A65-9C2B-6E4D9A1F70C8}
+static const GUID g_GUID_KTX2 =
+{ 0x3f0b8c52, 0x7d1e, 0x4a65, { 0x9c, 0x2b, 0x6e, 0x4d, 0x9a, 0x1f, 0x70, 0xc8 } };
+
+#define TC_PLUGIN_KTX2_VERSION_MAJOR    1
+#define TC_PLUGIN_KTX2_VERSION_MINOR    0
+
+class Plugin_KTX2 : public PluginInterface_Image
+{
+    public:
+        Plugin_KTX2();
+        virtual ~Plugin_KTX2();
+
+        int TC_PluginSetSharedIO(void* Shared);
+        int TC_PluginGetVersion(TC_PluginVersion* pPluginVersion);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+
+};
+
+#define IDS_ERROR_KTX2_FILE_OPEN             1
+#define IDS_ERROR_KTX2_NOT_KTX2              2
+#define IDS_ERROR_KTX2_UNSUPPORTED_TYPE      3
+#define IDS_ERROR_KTX2_ALLOCATEMIPSET        4
+#define IDS_ERROR_KTX2_ALLOCATEMIPSLEVELDATA 5
+#define IDS_ERROR_KTX2_SUPERCOMPRESSION      6
+
+extern void *make_Plugin_KTX2();
+extern size_t KTX2_SupercompressedSize(const void* pData, size_t nSize, int nLevel);
+
+// ---------------- KTX2 File Definitions ------------------------
+
+/*
+https://github.khronos.org/KTX-Specification/
+
+Byte[12]    identifier
+UInt32      vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme
+UInt32      dfdByteOffset, dfdByteLength, kvdByteOffset, kvdByteLength
+UInt64      sgdByteOffset, sgdByteLength
+for each level in levelCount
+    UInt64  byteOffset, byteLength, uncompressedByteLength
+end
+UInt32      dfdTotalSize followed by the data format descriptor block
+for each keyValuePair
+    UInt32  keyAndValueByteLength
+    Byte    keyAndValue[keyAndValueByteLength]
+    Byte    valuePadding[align(4, keyAndValueByteLength) - keyAndValueByteLength]
+end
+for each level from levelCount - 1 down to 0
+    Byte    levelImages[byteLength]     layers, faces and z slices of the level, zstd compressed as one frame with scheme 2
+end
+
+Levels are stored smallest first so a loader can stream the coarse levels before the top one arrives.
+Without supercompression each level starts at a multiple of the texel block size, rounded up to 4 bytes.
+*/
+
+#define KTX2_SUPERCOMPRESSION_NONE      0
+#define KTX2_SUPERCOMPRESSION_ZSTD      2
+
+#define KTX2_DEFAULT_ZSTD_LEVEL         3
+
+#pragma pack(push, 1)
+struct ktx2_header
+{
+    uint8_t   identifier[12];
+    uint32_t  vkFormat;                 // VK_FORMAT_UNDEFINED only for formats described by the DFD alone
+    uint32_t  typeSize;                 // 1 for block compressed data, else the size of one component
+    uint32_t  pixelWidth;
+    uint32_t  pixelHeight;              // 0 for 1D textures
+    uint32_t  pixelDepth;               // 0 for 2D and cube textures
+    uint32_t  layerCount;               // 0 for textures that are not arrays
+    uint32_t  faceCount;                // 6 for cube maps, else 1
+    uint32_t  levelCount;               // 0 asks the loader to generate the mip chain
+    uint32_t  supercompressionScheme;
+    uint32_t  dfdByteOffset;
+    uint32_t  dfdByteLength;
+    uint32_t  kvdByteOffset;
+    uint32_t  kvdByteLength;
+    uint64_t  sgdByteOffset;
+    uint64_t  sgdByteLength;
+};
+
+struct ktx2_level_index
+{
+    uint64_t  byteOffset;
+    uint64_t  byteLength;               // Size in the file, after supercompression
+    uint64_t  uncompressedByteLength;
+};
+#pragma pack(pop)
+
+// VkFormat values of the formats the plugin reads and writes
+#define VK_FORMAT_R8G8B8A8_UNORM                  37
+#define VK_FORMAT_R16G16B16A16_SFLOAT             97
+#define VK_FORMAT_R32G32B32A32_SFLOAT             109
+#define VK_FORMAT_BC1_RGBA_UNORM_BLOCK            133
+#define VK_FORMAT_BC2_UNORM_BLOCK                 135
+#define VK_FORMAT_BC3_UNORM_BLOCK                 137
+#define VK_FORMAT_BC4_UNORM_BLOCK                 139
+#define VK_FORMAT_BC5_UNORM_BLOCK                 141
+#define VK_FORMAT_BC6H_UFLOAT_BLOCK               143
+#define VK_FORMAT_BC6H_SFLOAT_BLOCK               144
+#define VK_FORMAT_BC7_UNORM_BLOCK                 145
+#define VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK         147
+#define VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK       151
+#define VK_FORMAT_EAC_R11_UNORM_BLOCK             153
+#define VK_FORMAT_EAC_R11_SNORM_BLOCK             154
+#define VK_FORMAT_EAC_R11G11_UNORM_BLOCK          155
+#define VK_FORMAT_EAC_R11G11_SNORM_BLOCK          156
+#define VK_FORMAT_ASTC_4x4_UNORM_BLOCK            157     // Each larger ASTC block size follows as a UNORM, SRGB pair
+
+// Khronos Data Format descriptor values, from khr_df.h
+#define KHR_DF_VERSIONNUMBER_1_3        2
+#define KHR_DF_MODEL_RGBSDA             1
+#define KHR_DF_MODEL_BC1A               128
+#define KHR_DF_MODEL_BC2                129
+#define KHR_DF_MODEL_BC3                130
+#define KHR_DF_MODEL_BC4                131
+#define KHR_DF_MODEL_BC5                132
+#define KHR_DF_MODEL_BC6H               133
+#define KHR_DF_MODEL_BC7                134
+#define KHR_DF_MODEL_ETC1               160
+#define KHR_DF_MODEL_ETC2               161
+#define KHR_DF_MODEL_ASTC               162
+#define KHR_DF_PRIMARIES_BT709          1
+#define KHR_DF_TRANSFER_LINEAR          1
+#define KHR_DF_CHANNEL_RED              0
+#define KHR_DF_CHANNEL_GREEN            1
+#define KHR_DF_CHANNEL_BLUE             2
+#define KHR_DF_CHANNEL_COLOR            0       // Single color channel of BC1A, BC2, BC3, BC6H, BC7, ETC1 and ASTC
+#define KHR_DF_CHANNEL_BC1A_ALPHA       1
+#define KHR_DF_CHANNEL_ETC2_COLOR       2
+#define KHR_DF_CHANNEL_ALPHA            15
+#define KHR_DF_SAMPLE_SIGNED            0x40
+#define KHR_DF_SAMPLE_FLOAT             0x80
+
+#endif
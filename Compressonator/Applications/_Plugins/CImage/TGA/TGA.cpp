@@ -4,9 +4,11 @@
 #include "TC_PluginAPI.h"
 #include "TC_PluginInternal.h"
 #include "MIPS.h"
+#include "UtilFuncs.h"
 #include "TGA.h"
+#include "CMP_Trace.h"
 
-CMIPS *TGA_CMips;
+thread_local CMIPS *TGA_CMips;
 TGA_FileSaveParams g_FileSaveParams;
 
 #ifdef BUILD_AS_PLUGIN_DLL
@@ -73,6 +75,7 @@ int Plugin_TGA::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *
 
 int Plugin_TGA::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "TGA Load");
 
    // ATI code
    FILE* pFile = NULL;
@@ -129,6 +132,7 @@ int Plugin_TGA::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipS
 
 int Plugin_TGA::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
 {
+    CMP_TRACE_SCOPE("IO", "TGA Save");
     assert(pszFilename);
     assert(pMipSet);
 
@@ -206,14 +210,6 @@ TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
     pMipSet->m_format = CMP_FORMAT_ARGB_8888;
     pMipSet->m_nMipLevels = 1;
 
-    // Allocate a temporary buffer and read the bitmap data into it
-    DWORD dwSize = pMipSet->m_nWidth *  pMipSet->m_nHeight * sizeof(CMP_COLOR);
-    unsigned char* pTempData = static_cast<unsigned char*>(malloc(dwSize));
-    fread(pTempData, dwSize, 1, pFile);
-    fclose(pFile);
-
-    BYTE* pTempPtr = pTempData;
-
     int nStart, nEnd, nIncrement;
     // Bottom up ?
     if(Header.cFormatFlags & 0x20)
@@ -229,33 +225,17 @@ TC_PluginError LoadTGA_ARGB8888(FILE* pFile, MipSet* pMipSet, TGAHeader& Header)
         nIncrement = -1;
     }
 
-    char nBlue ;
-    char nGreen;
-    char nRed  ;
-    char nAlpha;
-
+    // Rows are read straight into the MIP level, then
+    // reordered in place: MIPSet is RGBA, TGA is saved as BGRA
+    DWORD dwRowSize = pMipSet->m_nWidth * sizeof(CMP_COLOR);
     for(int j = nStart; j != nEnd; j+= nIncrement)
     {
-        BYTE* pData = (BYTE*) (TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * pMipSet->m_nWidth * sizeof(CMP_COLOR)));
-        for(int i=0; i < pMipSet->m_nWidth; i++)
-        {
-            // Note MIPSet is  RGBA
-            // TGA is saved as BGRA
-            nBlue  = *pTempPtr++;
-            nGreen = *pTempPtr++;
-            nRed   = *pTempPtr++;
-            nAlpha = *pTempPtr++;
-
-            *pData++ = nRed;
-            *pData++ = nGreen;
-            *pData++ = nBlue;
-            *pData++ = nAlpha;
-
-
-        }
+        BYTE* pData = (BYTE*) (TGA_CMips->GetMipLevel(pMipSet, 0)->m_pbData + (j * dwRowSize));
+        if(fread(pData, dwRowSize, 1, pFile) != 1)
+            break;
+        SwapRedBlue8888(pData, pData, pMipSet->m_nWidth);
     }
-
-    free(pTempData);
+    fclose(pFile);
 
     return PE_OK;
 }
@@ -0,0 +1,329 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TC_PluginAPI.h"
+#include "TC_PluginInternal.h"
+#include "MIPS.h"
+#include "UtilFuncs.h"
+#include "WIC.h"
+#include "CMP_Trace.h"
+
+#include <wincodec.h>
+#include <wrl/client.h>
+
+#pragma comment(lib, "windowscodecs.lib")
+#pragma comment(lib, "ole32.lib")
+
+using Microsoft::WRL::ComPtr;
+
+thread_local CMIPS *WIC_CMips = NULL;
+
+#ifdef BUILD_AS_PLUGIN_DLL
+DECLARE_PLUGIN(Plugin_WIC)
+SET_PLUGIN_TYPE("IMAGE")
+SET_PLUGIN_NAME("WIC")
+#else
+void *make_Plugin_WIC() { return new Plugin_WIC; }
+#endif
+
+Plugin_WIC::Plugin_WIC()
+{
+    // Initialize COM (needed for WIC), a thread that already joined an apartment keeps it
+    HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    m_bCOMInitialized = SUCCEEDED(hr);
+}
+
+Plugin_WIC::~Plugin_WIC()
+{
+    if (m_bCOMInitialized)
+        CoUninitialize();
+}
+
+int Plugin_WIC::TC_PluginSetSharedIO(void* Shared)
+{
+    if (Shared)
+    {
+        WIC_CMips = static_cast<CMIPS *>(Shared);
+        return 0;
+    }
+    return 1;
+}
+
+int Plugin_WIC::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
+{
+    pPluginVersion->guid                    = g_GUID_WIC;
+    pPluginVersion->dwAPIVersionMajor       = TC_API_VERSION_MAJOR;
+    pPluginVersion->dwAPIVersionMinor       = TC_API_VERSION_MINOR;
+    pPluginVersion->dwPluginVersionMajor    = TC_PLUGIN_WIC_VERSION_MAJOR;
+    pPluginVersion->dwPluginVersionMinor    = TC_PLUGIN_WIC_VERSION_MINOR;
+    return 0;
+}
+
+int Plugin_WIC::TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    return -1;
+}
+
+int Plugin_WIC::TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture)
+{
+    return -1;
+}
+
+static bool CreateWICFactory(ComPtr<IWICImagingFactory>& pFactory)
+{
+    // The WIC2 factory that the Windows 8 SDK maps CLSID_WICImagingFactory to is missing on Windows 7
+#if defined(_WIN32_WINNT_WIN8) && (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    return SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory1, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(pFactory.GetAddressOf())));
+#else
+    return SUCCEEDED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(pFactory.GetAddressOf())));
+#endif
+}
+
+static void WICFileName(const TCHAR* pszFilename, wchar_t* szFile, size_t nSize)
+{
+    size_t convertedChars = 0;
+    mbstowcs_s(&convertedChars, szFile, nSize, pszFilename, _TRUNCATE);
+}
+
+// Container formats of the file extensions the plugin is registered for
+// Bits in the first channel of a WIC pixel format, 0 when WIC does not describe it. Padding
+// bits such as the X of 32bppBGR belong to no channel, so bits per pixel over channels is not used
+static UINT WICBitsPerChannel(IWICImagingFactory* pFactory, REFWICPixelFormatGUID format)
+{
+    ComPtr<IWICComponentInfo> pInfo;
+    ComPtr<IWICPixelFormatInfo> pFormatInfo;
+    BYTE mask[16];
+    UINT nMaskSize = 0;
+    if (FAILED(pFactory->CreateComponentInfo(format, pInfo.GetAddressOf())) ||
+        FAILED(pInfo.As(&pFormatInfo)) ||
+        FAILED(pFormatInfo->GetChannelMask(0, sizeof(mask), mask, &nMaskSize)) ||
+        (nMaskSize > sizeof(mask)))
+        return 0;
+
+    UINT nBits = 0;
+    for (UINT i = 0; i < nMaskSize; i++)
+        for (BYTE b = mask[i]; b; b &= b - 1)
+            nBits++;
+    return nBits;
+}
+
+static bool WICContainerFormat(const TCHAR* pszFilename, GUID& container)
+{
+    const char* pszExt = strrchr(pszFilename, '.');
+    if (pszExt == NULL)
+        return false;
+
+    if (_stricmp(pszExt, ".png") == 0)
+        container = GUID_ContainerFormatPng;
+    else if ((_stricmp(pszExt, ".jpg") == 0) || (_stricmp(pszExt, ".jpeg") == 0))
+        container = GUID_ContainerFormatJpeg;
+    else if (_stricmp(pszExt, ".bmp") == 0)
+        container = GUID_ContainerFormatBmp;
+    else if ((_stricmp(pszExt, ".tif") == 0) || (_stricmp(pszExt, ".tiff") == 0))
+        container = GUID_ContainerFormatTiff;
+    else
+        return false;
+    return true;
+}
+
+int Plugin_WIC::TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "WIC Load");
+
+    ComPtr<IWICImagingFactory> pFactory;
+    if (!CreateWICFactory(pFactory))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unable to create the imaging factory\n"), EL_Error, IDS_ERROR_WIC_FACTORY);
+        return -1;
+    }
+
+    wchar_t szFile[MAX_PATH];
+    WICFileName(pszFilename, szFile, MAX_PATH);
+
+    ComPtr<IWICBitmapDecoder> pDecoder;
+    ComPtr<IWICBitmapFrameDecode> pFrame;
+    if (FAILED(pFactory->CreateDecoderFromFilename(szFile, nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, pDecoder.GetAddressOf())) ||
+        FAILED(pDecoder->GetFrame(0, pFrame.GetAddressOf())))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) opening file = %s \n"), EL_Error, IDS_ERROR_WIC_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    UINT nWidth = 0;
+    UINT nHeight = 0;
+    WICPixelFormatGUID srcFormat;
+    if (FAILED(pFrame->GetSize(&nWidth, &nHeight)) || FAILED(pFrame->GetPixelFormat(&srcFormat)) || (nWidth == 0) || (nHeight == 0))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unsupported type Filename = %s \n"), EL_Error, IDS_ERROR_WIC_UNSUPPORTED_TYPE, pszFilename);
+        return -1;
+    }
+
+    // Everything is decoded to BGRA 8888, the layout most WIC decoders produce natively so the format
+    // converter is often skipped. 16 bit PNG and TIFF files are reduced to 8 bits as QImage did, the
+    // mip generation and swizzle of the command line only handle 8 bit and float data
+    WICPixelFormatGUID destFormat = GUID_WICPixelFormat32bppBGRA;
+    if (WIC_CMips && (WICBitsPerChannel(pFactory.Get(), srcFormat) > 8))
+        WIC_CMips->PrintError(_T("Warning(%d): WIC Plugin ID(%d) %s has more than 8 bits per channel, it is loaded as 8 bit RGBA\n"), EL_Warning, IDS_WARNING_WIC_REDUCED_TO_8BIT, pszFilename);
+
+    if (!WIC_CMips->AllocateMipSet(pMipSet, CF_8bit, TDT_ARGB, TT_2D, nWidth, nHeight, 1))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unable to allocate MipSet\n"), EL_Error, IDS_ERROR_WIC_ALLOCATEMIPSET);
+        return PE_Unknown;
+    }
+
+    MipLevel* pMipLevel = WIC_CMips->GetMipLevel(pMipSet, 0);
+    if (!WIC_CMips->AllocateMipLevelData(pMipLevel, nWidth, nHeight, CF_8bit, TDT_ARGB))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unable to allocate MIP level data\n"), EL_Error, IDS_ERROR_WIC_ALLOCATEMIPSET);
+        return PE_Unknown;
+    }
+
+    pMipSet->m_dwFourCC = 0;
+    pMipSet->m_dwFourCC2 = 0;
+    pMipSet->m_nMipLevels = 1;
+    pMipSet->m_format = CMP_FORMAT_ARGB_8888;
+
+    ComPtr<IWICBitmapSource> pSource = pFrame;
+    if (!IsEqualGUID(srcFormat, destFormat))
+    {
+        ComPtr<IWICFormatConverter> pConverter;
+        if (FAILED(pFactory->CreateFormatConverter(pConverter.GetAddressOf())) ||
+            FAILED(pConverter->Initialize(pFrame.Get(), destFormat, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)))
+        {
+            if (WIC_CMips)
+                WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unsupported type Filename = %s \n"), EL_Error, IDS_ERROR_WIC_UNSUPPORTED_TYPE, pszFilename);
+            return -1;
+        }
+        pSource = pConverter;
+    }
+
+    // Decode straight into the MIP level
+    UINT nPitch = nWidth * 4;
+    if (FAILED(pSource->CopyPixels(nullptr, nPitch, pMipLevel->m_dwLinearSize, pMipLevel->m_pbData)))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) decoding file = %s \n"), EL_Error, IDS_ERROR_WIC_DECODE, pszFilename);
+        return -1;
+    }
+
+    // The data is left as BGRA when the caller asked for swizzled data, as QImage2MIPS does
+    if (!pMipSet->m_swizzle)
+        SwapRedBlue8888(pMipLevel->m_pbData, pMipLevel->m_pbData, (size_t)nWidth * nHeight);
+    pMipSet->m_swizzle = false;
+
+    return 0;
+}
+
+int Plugin_WIC::TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet)
+{
+    CMP_TRACE_SCOPE("IO", "WIC Save");
+    assert(pszFilename);
+    assert(pMipSet);
+
+    // Only uncompressed 8 and 16 bit RGBA data, AMDSaveMIPSTextureImage falls back to Qt for the rest
+    GUID container;
+    if (!WICContainerFormat(pszFilename, container) ||
+        ((pMipSet->m_TextureDataType != TDT_ARGB) && (pMipSet->m_TextureDataType != TDT_XRGB)) ||
+        ((pMipSet->m_ChannelFormat != CF_8bit) && (pMipSet->m_ChannelFormat != CF_16bit)))
+        return -1;
+
+    MipLevel* pMipLevel = WIC_CMips->GetMipLevel(pMipSet, 0);
+    if (!pMipLevel || !pMipLevel->m_pbData)
+        return -1;
+
+    bool b16Bit = (pMipSet->m_ChannelFormat == CF_16bit);
+    WICPixelFormatGUID format = b16Bit ? GUID_WICPixelFormat64bppRGBA :
+                                (pMipSet->m_swizzle ? GUID_WICPixelFormat32bppBGRA : GUID_WICPixelFormat32bppRGBA);
+    UINT nWidth  = pMipLevel->m_nWidth;
+    UINT nHeight = pMipLevel->m_nHeight;
+    UINT nPitch  = nWidth * (b16Bit ? 8 : 4);
+    UINT nSize   = nPitch * nHeight;
+
+    ComPtr<IWICImagingFactory> pFactory;
+    if (!CreateWICFactory(pFactory))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) unable to create the imaging factory\n"), EL_Error, IDS_ERROR_WIC_FACTORY);
+        return -1;
+    }
+
+    wchar_t szFile[MAX_PATH];
+    WICFileName(pszFilename, szFile, MAX_PATH);
+
+    ComPtr<IWICStream> pStream;
+    ComPtr<IWICBitmapEncoder> pEncoder;
+    ComPtr<IWICBitmapFrameEncode> pFrame;
+    ComPtr<IPropertyBag2> pProperties;
+    if (FAILED(pFactory->CreateStream(pStream.GetAddressOf())) ||
+        FAILED(pStream->InitializeFromFilename(szFile, GENERIC_WRITE)))
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) saving file = %s \n"), EL_Error, IDS_ERROR_WIC_FILE_OPEN, pszFilename);
+        return -1;
+    }
+
+    WICPixelFormatGUID frameFormat = format;
+    bool bEncoded = SUCCEEDED(pFactory->CreateEncoder(container, nullptr, pEncoder.GetAddressOf())) &&
+                    SUCCEEDED(pEncoder->Initialize(pStream.Get(), WICBitmapEncoderNoCache)) &&
+                    SUCCEEDED(pEncoder->CreateNewFrame(pFrame.GetAddressOf(), pProperties.GetAddressOf())) &&
+                    SUCCEEDED(pFrame->Initialize(pProperties.Get())) &&
+                    SUCCEEDED(pFrame->SetSize(nWidth, nHeight)) &&
+                    SUCCEEDED(pFrame->SetPixelFormat(&frameFormat));
+
+    if (bEncoded)
+    {
+        if (IsEqualGUID(frameFormat, format))
+        {
+            bEncoded = SUCCEEDED(pFrame->WritePixels(nHeight, nPitch, nSize, pMipLevel->m_pbData));
+        }
+        else
+        {
+            // The encoder asked for another layout, JPEG has no alpha and BMP wants BGRA,
+            // so the level is wrapped in a bitmap and converted as it is written
+            ComPtr<IWICBitmap> pBitmap;
+            ComPtr<IWICFormatConverter> pConverter;
+            bEncoded = SUCCEEDED(pFactory->CreateBitmapFromMemory(nWidth, nHeight, format, nPitch, nSize, pMipLevel->m_pbData, pBitmap.GetAddressOf())) &&
+                       SUCCEEDED(pFactory->CreateFormatConverter(pConverter.GetAddressOf())) &&
+                       SUCCEEDED(pConverter->Initialize(pBitmap.Get(), frameFormat, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)) &&
+                       SUCCEEDED(pFrame->WriteSource(pConverter.Get(), nullptr));
+        }
+    }
+
+    bEncoded = bEncoded && SUCCEEDED(pFrame->Commit()) && SUCCEEDED(pEncoder->Commit());
+    if (!bEncoded)
+    {
+        if (WIC_CMips)
+            WIC_CMips->PrintError(_T("Error(%d): WIC Plugin ID(%d) encoding file = %s \n"), EL_Error, IDS_ERROR_WIC_ENCODE, pszFilename);
+        return -1;
+    }
+
+    return 0;
+}
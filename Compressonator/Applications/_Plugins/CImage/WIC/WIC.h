@@ -0,0 +1,73 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#ifndef _PLUGIN_IMAGE_WIC_H
+#define _PLUGIN_IMAGE_WIC_H
+
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN        // Exclude rarely-used stuff from Windows headers
+#include <assert.h>
+#include <tchar.h>
+
+#include "PluginInterface.h"
+
+// ---------------- WIC Plugin ------------------------
+// PNG, JPEG, BMP and TIFF files through the Windows Imaging Component codecs,
+// so the command line does not need Qt to read or write them
+
+// {6A1C4E93-2F7B-4D85-B0E6-93C58A2D17F4}
+static const GUID g_GUID_WIC =
+{ 0x6a1c4e93, 0x2f7b, 0x4d85, { 0xb0, 0xe6, 0x93, 0xc5, 0x8a, 0x2d, 0x17, 0xf4 } };
+
+#define TC_PLUGIN_WIC_VERSION_MAJOR    1
+#define TC_PLUGIN_WIC_VERSION_MINOR    0
+
+class Plugin_WIC : public PluginInterface_Image
+{
+    public:
+        Plugin_WIC();
+        virtual ~Plugin_WIC();
+
+        int TC_PluginSetSharedIO(void* Shared);
+        int TC_PluginGetVersion(TC_PluginVersion* pPluginVersion);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, MipSet* pMipSet);
+        int TC_PluginFileLoadTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+        int TC_PluginFileSaveTexture(const TCHAR* pszFilename, CMP_Texture *srcTexture);
+
+    private:
+        bool m_bCOMInitialized;
+};
+
+#define IDS_ERROR_WIC_FILE_OPEN             1
+#define IDS_ERROR_WIC_FACTORY               2
+#define IDS_ERROR_WIC_DECODE                3
+#define IDS_ERROR_WIC_UNSUPPORTED_TYPE      4
+#define IDS_ERROR_WIC_ALLOCATEMIPSET        5
+#define IDS_ERROR_WIC_ENCODE                6
+#define IDS_WARNING_WIC_REDUCED_TO_8BIT     7
+
+extern void *make_Plugin_WIC();
+
+#endif
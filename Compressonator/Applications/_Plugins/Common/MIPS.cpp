@@ -245,6 +245,65 @@ bool CMIPS::AllocateMipSet(MipSet* pMipSet, ChannelFormat channelFormat, Texture
     return true;
 }
 
+// Number of MipLevels in the table of a MipSet
+static int GetMipLevelCount(const MipSet* pMipSet)
+{
+    int nLevels = 0;
+    switch(pMipSet->m_TextureType)
+    {
+    case TT_2D:
+        nLevels = pMipSet->m_nMaxMipLevels;
+        break;
+    case TT_CubeMap:
+        nLevels = pMipSet->m_nMaxMipLevels * pMipSet->m_nDepth;
+        break;
+    case TT_VolumeTexture:        
+        for(int depth=pMipSet->m_nDepth, mipLevels=0;
+            mipLevels < pMipSet->m_nMaxMipLevels;
+            mipLevels++)
+        {
+            nLevels += depth;
+            if(depth > 1)
+            {
+                depth >>= 1;
+            }
+        }
+        break;
+    default:
+        ASSERT(0);
+    }
+    return nLevels;
+}
+
+// Carves the data of pMipLevel from its arena if its slot is large enough, otherwise mallocs it
+static BYTE* AllocateLevelData(MipLevel* pMipLevel)
+{
+    MipSetArena* pArena = pMipLevel->m_pArena;
+    if(pArena && pArena->m_pMipLevelTable)
+    {
+        for(size_t i = 0; i < pArena->m_offsets.size(); i++)
+        {
+            if(pArena->m_pMipLevelTable[i] == pMipLevel)
+            {
+                if(pMipLevel->m_dwLinearSize <= pArena->m_sizes[i])
+                    return pArena->m_pBase + pArena->m_offsets[i];
+                break;
+            }
+        }
+    }
+    return reinterpret_cast<BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+}
+
+static void FreeLevelData(MipLevel* pMipLevel)
+{
+    MipSetArena* pArena = pMipLevel->m_pArena;
+    bool bCarved = pArena && pArena->m_pBase &&
+                   pMipLevel->m_pbData >= pArena->m_pBase && pMipLevel->m_pbData < pArena->m_pBase + pArena->m_nCapacity;
+    if(!bCarved)
+        free(pMipLevel->m_pbData);
+    pMipLevel->m_pbData = NULL;
+}
+
 bool CMIPS::AllocateMipLevelData(MipLevel* pMipLevel, int nWidth, int nHeight, ChannelFormat channelFormat, TextureDataType textureDataType)
 {
     //TODO test
@@ -300,7 +359,7 @@ bool CMIPS::AllocateMipLevelData(MipLevel* pMipLevel, int nWidth, int nHeight, C
     pMipLevel->m_nWidth = nWidth;
     pMipLevel->m_nHeight = nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = AllocateLevelData(pMipLevel);
 
     return (pMipLevel->m_pbData != NULL);
 }
@@ -315,7 +374,7 @@ bool CMIPS::AllocateCompressedMipLevelData(MipLevel* pMipLevel, int nWidth, int
     pMipLevel->m_nWidth = nWidth;
     pMipLevel->m_nHeight = nHeight;
 
-    pMipLevel->m_pbData = reinterpret_cast<BYTE*>(malloc(pMipLevel->m_dwLinearSize));
+    pMipLevel->m_pbData = AllocateLevelData(pMipLevel);
 
     return (pMipLevel->m_pbData != NULL);
 }
@@ -330,36 +389,13 @@ void CMIPS::FreeMipSet(MipSet* pMipSet)
         if(pMipSet->m_pMipLevelTable)
         {
             //determine number of miplevels in the old mipleveltable
-            switch(pMipSet->m_TextureType)
-            {
-            case TT_2D:
-                nTotalOldMipLevels = pMipSet->m_nMaxMipLevels;
-                break;
-            case TT_CubeMap:
-                nTotalOldMipLevels = pMipSet->m_nMaxMipLevels * pMipSet->m_nDepth;
-                break;
-            case TT_VolumeTexture:        
-                for(int depth=pMipSet->m_nDepth, mipLevels=0;
-                    mipLevels < pMipSet->m_nMaxMipLevels;
-                    mipLevels++)
-                {
-                    nTotalOldMipLevels += depth;
-                    if(depth > 1)
-                    {
-                        depth >>= 1;
-                    }
-                }
-                break;
-            default:
-                ASSERT(0);
-            }
+            nTotalOldMipLevels = GetMipLevelCount(pMipSet);
             //free all miplevels and their data except the one use in gui view
             for(int i=0; i<nTotalOldMipLevels-2 ; i++)
             {
                 if (pMipSet->m_pMipLevelTable[i]->m_pbData)
                 {
-                    free(pMipSet->m_pMipLevelTable[i]->m_pbData);
-                    pMipSet->m_pMipLevelTable[i]->m_pbData = NULL;
+                    FreeLevelData(pMipSet->m_pMipLevelTable[i]);
                 }
 
                 if (pMipSet->m_pMipLevelTable[i])
@@ -377,6 +413,221 @@ void CMIPS::FreeMipSet(MipSet* pMipSet)
     }
 }
 
+//
+// Mip set arenas
+//
+
+MipSetArena::~MipSetArena()
+{
+    if(m_pBase)
+        VirtualFree(m_pBase, 0, MEM_RELEASE);
+}
+
+// Index of a MipLevel in the MipLevelTable, see GetMipLevel
+static int GetMipLevelIndex(const MipSet* pMipSet, int nMipLevel, int nFaceOrSlice)
+{
+    switch(pMipSet->m_TextureType)
+    {
+    case TT_CubeMap:
+        return nMipLevel * pMipSet->m_nDepth + nFaceOrSlice;
+    case TT_VolumeTexture:
+        {
+            int index = 0;
+            for(int depth = pMipSet->m_nDepth, mipLevel = 0; mipLevel < nMipLevel; mipLevel++)
+            {
+                index += depth;
+                depth = depth>1 ? depth>>1 : 1;
+            }
+            return index + nFaceOrSlice;
+        }
+    default:
+        return nMipLevel;
+    }
+}
+
+static int GetFacesOrSlices(const MipSet* pMipSet, int nMipLevel)
+{
+    switch(pMipSet->m_TextureType)
+    {
+    case TT_CubeMap:
+        return pMipSet->m_nDepth;
+    case TT_VolumeTexture:
+        {
+            int depth = pMipSet->m_nDepth >> nMipLevel;
+            return depth>1 ? depth : 1;
+        }
+    default:
+        return 1;
+    }
+}
+
+// Lays the MipLevels out in DDS file order, filling offsets and sizes in MipLevelTable order.
+// Each cube face runs its whole mip chain in turn, volume slices are grouped by mip level.
+static size_t LayoutMipSet(const MipSet* pMipSet, int nMipLevels, int nBlockWidth, int nBlockHeight, int nBlockBytes,
+                           std::vector<size_t>& offsets, std::vector<size_t>& sizes)
+{
+    offsets.assign(GetMipLevelCount(pMipSet), 0);
+    sizes.assign(offsets.size(), 0);
+
+    size_t levelSizes[32];
+    for(int nMipLevel = 0; nMipLevel < nMipLevels; nMipLevel++)
+    {
+        size_t nWidth  = pMipSet->m_nWidth  >> nMipLevel;
+        size_t nHeight = pMipSet->m_nHeight >> nMipLevel;
+        nWidth  = nWidth  ? nWidth  : 1;
+        nHeight = nHeight ? nHeight : 1;
+        levelSizes[nMipLevel] = ((nWidth + nBlockWidth - 1) / nBlockWidth) * ((nHeight + nBlockHeight - 1) / nBlockHeight) * nBlockBytes;
+    }
+
+    size_t nOffset = 0;
+    if(pMipSet->m_TextureType == TT_VolumeTexture)
+    {
+        for(int nMipLevel = 0; nMipLevel < nMipLevels; nMipLevel++)
+        {
+            for(int nSlice = 0; nSlice < GetFacesOrSlices(pMipSet, nMipLevel); nSlice++)
+            {
+                int index = GetMipLevelIndex(pMipSet, nMipLevel, nSlice);
+                offsets[index] = nOffset;
+                sizes[index]   = levelSizes[nMipLevel];
+                nOffset += levelSizes[nMipLevel];
+            }
+        }
+    }
+    else
+    {
+        for(int nFace = 0; nFace < GetFacesOrSlices(pMipSet, 0); nFace++)
+        {
+            for(int nMipLevel = 0; nMipLevel < nMipLevels; nMipLevel++)
+            {
+                int index = GetMipLevelIndex(pMipSet, nMipLevel, nFace);
+                offsets[index] = nOffset;
+                sizes[index]   = levelSizes[nMipLevel];
+                nOffset += levelSizes[nMipLevel];
+            }
+        }
+    }
+    return nOffset;
+}
+
+size_t CMIPS::GetMipSetArenaSize(const MipSet* pMipSet, int nMipLevels, int nBlockWidth, int nBlockHeight, int nBlockBytes)
+{
+    ASSERT(pMipSet);
+    if(!pMipSet || !pMipSet->m_pMipLevelTable || nMipLevels < 1 || nMipLevels > pMipSet->m_nMaxMipLevels || nMipLevels > 32)
+        return 0;
+    if(nBlockWidth < 1 || nBlockHeight < 1 || nBlockBytes < 1)
+        return 0;
+
+    std::vector<size_t> offsets, sizes;
+    return LayoutMipSet(pMipSet, nMipLevels, nBlockWidth, nBlockHeight, nBlockBytes, offsets, sizes);
+}
+
+bool CMIPS::AttachMipSetArena(MipSet* pMipSet, MipSetArena* pArena, int nMipLevels, int nBlockWidth, int nBlockHeight, int nBlockBytes, bool bLargePages)
+{
+    ASSERT(pMipSet && pArena);
+    if(!pMipSet || !pArena)
+        return false;
+
+    // An arena holds one MipSet at a time
+    if(pArena->m_pMipLevelTable)
+    {
+        ASSERT(!pArena->m_pMipLevelTable);
+        return false;
+    }
+
+    size_t nSize = GetMipSetArenaSize(pMipSet, nMipLevels, nBlockWidth, nBlockHeight, nBlockBytes);
+    if(nSize == 0)
+        return false;
+
+    // The block is kept between jobs and only grows
+    if(nSize > pArena->m_nCapacity)
+    {
+        FreeMipSetArena(pArena);
+
+        if(bLargePages)
+        {
+            // Large pages need the lock pages in memory privilege, without it VirtualAlloc fails and normal pages are used
+            SIZE_T nLargePage = GetLargePageMinimum();
+            if(nLargePage)
+            {
+                size_t nCapacity = ((nSize + nLargePage - 1) / nLargePage) * nLargePage;
+                pArena->m_pBase = reinterpret_cast<CMP_BYTE*>(VirtualAlloc(NULL, nCapacity, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+                if(pArena->m_pBase)
+                {
+                    pArena->m_nCapacity   = nCapacity;
+                    pArena->m_bLargePages = true;
+                }
+            }
+        }
+
+        if(!pArena->m_pBase)
+        {
+            pArena->m_pBase = reinterpret_cast<CMP_BYTE*>(VirtualAlloc(NULL, nSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+            if(!pArena->m_pBase)
+                return false;
+            pArena->m_nCapacity = nSize;
+        }
+    }
+
+    pArena->m_nSize          = LayoutMipSet(pMipSet, nMipLevels, nBlockWidth, nBlockHeight, nBlockBytes, pArena->m_offsets, pArena->m_sizes);
+    pArena->m_nMipLevels     = nMipLevels;
+    pArena->m_pMipLevelTable = pMipSet->m_pMipLevelTable;
+
+    for(size_t i = 0; i < pArena->m_offsets.size(); i++)
+        pMipSet->m_pMipLevelTable[i]->m_pArena = pArena;
+
+    return true;
+}
+
+bool CMIPS::GetMipSetArenaData(const MipSet* pMipSet, CMP_BYTE** ppData, size_t* pSize)
+{
+    MipLevel* pMipLevel = GetMipLevel(pMipSet, 0);
+    if(!pMipLevel || !pMipLevel->m_pArena)
+        return false;
+
+    MipSetArena* pArena = pMipLevel->m_pArena;
+    if(pArena->m_pMipLevelTable != pMipSet->m_pMipLevelTable || pArena->m_nMipLevels != pMipSet->m_nMipLevels)
+        return false;
+
+    // Every MipLevel has to fill its slot, one that did not fit was allocated on its own
+    for(size_t i = 0; i < pArena->m_offsets.size(); i++)
+    {
+        if(pArena->m_sizes[i] == 0)
+            continue;
+        pMipLevel = pMipSet->m_pMipLevelTable[i];
+        if(pMipLevel->m_pbData != pArena->m_pBase + pArena->m_offsets[i] || pMipLevel->m_dwLinearSize != pArena->m_sizes[i])
+            return false;
+    }
+
+    *ppData = pArena->m_pBase;
+    *pSize  = pArena->m_nSize;
+    return true;
+}
+
+void CMIPS::ResetMipSetArena(MipSetArena* pArena)
+{
+    // Call after FreeMipSet, the MipLevels of the attached MipSet must no longer be in use
+    ASSERT(pArena);
+    if(!pArena)
+        return;
+
+    pArena->m_nSize          = 0;
+    pArena->m_nMipLevels     = 0;
+    pArena->m_pMipLevelTable = NULL;
+    pArena->m_offsets.clear();
+    pArena->m_sizes.clear();
+}
+
+void CMIPS::FreeMipSetArena(MipSetArena* pArena)
+{
+    ResetMipSetArena(pArena);
+    if(pArena && pArena->m_pBase)
+    {
+        VirtualFree(pArena->m_pBase, 0, MEM_RELEASE);
+        pArena->m_pBase       = NULL;
+        pArena->m_nCapacity   = 0;
+        pArena->m_bLargePages = false;
+    }
+}
 
 void CMIPS::PrintError(const char* Format, ... )
 {
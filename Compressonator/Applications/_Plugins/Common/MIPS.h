@@ -27,9 +27,30 @@
 
 #include "stdlib.h"
 #include "TC_PluginAPI.h"
+#include <vector>
 
 #define MAX_MIPLEVEL_SUPPORTED 10
 
+//
+// One block that the MipLevel data of a MipSet is carved from instead of a malloc per MipLevel.
+// The block outlives the MipSet: after FreeMipSet, ResetMipSetArena detaches it and keeps the memory
+// so the next job reuses it without going back to the heap.
+//
+struct MipSetArena
+{
+    MipSetArena() : m_pBase(NULL), m_nCapacity(0), m_nSize(0), m_bLargePages(false), m_nMipLevels(0), m_pMipLevelTable(NULL) {}
+    ~MipSetArena();
+
+    CMP_BYTE*           m_pBase;            // Page aligned start of the block
+    size_t              m_nCapacity;        // Bytes reserved
+    size_t              m_nSize;            // Bytes used by the attached MipSet
+    bool                m_bLargePages;      // The block is backed by large pages
+    int                 m_nMipLevels;       // Mip levels laid out for the attached MipSet
+    MipLevelTable*      m_pMipLevelTable;   // Table of the attached MipSet, NULL when detached
+    std::vector<size_t> m_offsets;          // Offset and size of each MipLevel, in m_pMipLevelTable order
+    std::vector<size_t> m_sizes;
+};
+
 extern void(*PrintStatusLine)(char *);
 extern void PrintInfo(const char* Format, ...);
 class CMIPS
@@ -49,6 +70,15 @@ class CMIPS
 
     void FreeMipSet(MipSet* pMipSet);
 
+    // Arena mode, the MipLevel data is carved from one block in the order a DDS file stores it.
+    // Levels are sized as whole blocks of nBlockWidth x nBlockHeight pixels taking nBlockBytes each,
+    // uncompressed data is described as 1x1 blocks of the pixel size.
+    size_t GetMipSetArenaSize(const MipSet* pMipSet, int nMipLevels, int nBlockWidth, int nBlockHeight, int nBlockBytes);
+    bool AttachMipSetArena(MipSet* pMipSet, MipSetArena* pArena, int nMipLevels, int nBlockWidth, int nBlockHeight, int nBlockBytes, bool bLargePages);
+    bool GetMipSetArenaData(const MipSet* pMipSet, CMP_BYTE** ppData, size_t* pSize);
+    void ResetMipSetArena(MipSetArena* pArena);
+    void FreeMipSetArena(MipSetArena* pArena);
+
     void PrintError(const char* Format, ... );
 };
 
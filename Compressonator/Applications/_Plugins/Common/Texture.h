@@ -175,6 +175,8 @@ typedef enum
    MS_CF_All         = 0x3f, ///< All the cube-map faces.
 } MS_CubeFace;
 
+struct MipSetArena;  ///< \internal See MIPS.h
+
 /// A MipLevel is the fundamental unit for containing texture data. 
 /// \remarks
 /// One logical mip level can be composed of many MipLevels, see the documentation of MipSet for explanation.
@@ -195,6 +197,7 @@ typedef struct
       CMP_HALF*    m_phfData;        ///< A pointer to the texture data that this MipLevel contains.
       CMP_DWORD*   m_pdwData;        ///< A pointer to the texture data that this MipLevel contains.
    };
+   MipSetArena*  m_pArena;         ///< \internal The arena m_pbData is carved from, NULL if the data is allocated on its own.
 } MipLevel;
 
 typedef MipLevel* MipLevelTable; ///< A pointer to a set of MipLevels.
@@ -232,6 +235,8 @@ typedef struct
    int               m_nBlockHeight;      ///< Height in pixels of the Compression Block that is to be processed default for ASTC is 4
    int               m_nBlockDepth;       ///< Depth in pixels of the Compression Block that is to be processed default for ASTC is 1
    MipLevelTable*    m_pMipLevelTable;    ///< This is an implementation dependent way of storing the MipLevels that this mip-map set contains. Do not depend on it, use TC_AppGetMipLevel to access a mip-map set's MipLevels.
+   int               m_nSupercompressionLevel; ///< Zstandard level used by writers that supercompress their levels, such as KTX2. 0 stores the levels as they are.
+   const char*       m_pszEntryName;      ///< Entry of a container holding many textures, such as a CTB bundle, to load or save. NULL loads the first entry and saves under the file name.
 } MipSet;
 
 CMP_DWORD GetChannelSize(ChannelFormat channelFormat);       //< \internal
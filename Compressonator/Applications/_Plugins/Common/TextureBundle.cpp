@@ -0,0 +1,595 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TextureBundle.cpp : Reader and writer of CTB texture bundles, many MipSets in one file
+//
+
+#include "TextureBundle.h"
+#include "TC_PluginInternal.h"
+#include "CMP_Trace.h"
+
+#include <io.h>
+#include <string.h>
+#include <unordered_map>
+
+#define CTB_MAX_QUEUED      (256 * 1024 * 1024)     // Bytes AddEntry queues for the writer thread before it waits
+#define CTB_MAX_TOC_SIZE    0x40000000              // Larger tables of contents are taken as a damaged file
+
+static inline uint64_t CTB_Align(uint64_t nValue, uint64_t nAlignment)
+{
+    return (nValue + nAlignment - 1) & ~(nAlignment - 1);
+}
+
+static inline bool CTB_IsPowerOfTwo(uint64_t nValue)
+{
+    return nValue != 0 && (nValue & (nValue - 1)) == 0;
+}
+
+static bool CTB_Seek(FILE* pFile, uint64_t nOffset)
+{
+    return _fseeki64(pFile, (__int64) nOffset, SEEK_SET) == 0;
+}
+
+// Writes nSize zero bytes
+static bool CTB_WritePadding(FILE* pFile, uint64_t nSize)
+{
+    static const CMP_BYTE zeros[4096] = { 0 };
+    while(nSize > 0)
+    {
+        size_t nWrite = nSize < sizeof(zeros) ? (size_t) nSize : sizeof(zeros);
+        if(fwrite(zeros, 1, nWrite, pFile) != nWrite)
+            return false;
+        nSize -= nWrite;
+    }
+    return true;
+}
+
+uint64_t CTB_HashName(const char* pszName, size_t nLength)
+{
+    uint64_t nHash = 14695981039346656037ULL;
+    for(size_t i = 0; i < nLength; i++)
+    {
+        nHash ^= (uint8_t) pszName[i];
+        nHash *= 1099511628211ULL;
+    }
+    return nHash;
+}
+
+//=====================================================================
+// Reader
+//=====================================================================
+
+CTextureBundleReader::CTextureBundleReader() : m_pFile(NULL)
+{
+    memset(&m_Header, 0, sizeof(m_Header));
+}
+
+CTextureBundleReader::~CTextureBundleReader()
+{
+    Close();
+}
+
+void CTextureBundleReader::Close()
+{
+    if(m_pFile)
+    {
+        fclose(m_pFile);
+        m_pFile = NULL;
+    }
+    memset(&m_Header, 0, sizeof(m_Header));
+    m_Entries.clear();
+    m_Levels.clear();
+    m_HashTable.clear();
+    m_Names.clear();
+}
+
+bool CTextureBundleReader::Open(const char* pszFilename)
+{
+    CMP_TRACE_SCOPE_DETAIL("IO", "Bundle Open", pszFilename);
+    Close();
+
+    if(fopen_s(&m_pFile, pszFilename, "rb") != 0 || m_pFile == NULL)
+    {
+        m_pFile = NULL;
+        return false;
+    }
+
+    ctb_header& header = m_Header;
+    bool bOK = fread(&header, sizeof(header), 1, m_pFile) == 1 &&
+               header.identifier[0] == CTB_IDENTIFIER_0 && header.identifier[1] == CTB_IDENTIFIER_1 &&
+               header.version == CTB_VERSION && header.tocOffset != 0 && header.tocSize <= CTB_MAX_TOC_SIZE &&
+               CTB_IsPowerOfTwo(header.hashTableSize) && header.hashTableSize >= header.entryCount;
+
+    // The table of contents is the entries, levels, hash table and then the names
+    uint64_t nFixedSize = 0;
+    if(bOK)
+    {
+        nFixedSize = (uint64_t) header.entryCount * sizeof(ctb_entry) + (uint64_t) header.levelCount * sizeof(ctb_level) +
+                     (uint64_t) header.hashTableSize * sizeof(uint32_t);
+        bOK = nFixedSize <= header.tocSize && header.namesOffset == header.tocOffset + nFixedSize;
+    }
+
+    if(bOK)
+    {
+        m_Entries.resize(header.entryCount);
+        m_Levels.resize(header.levelCount);
+        m_HashTable.resize(header.hashTableSize);
+        m_Names.resize((size_t) (header.tocSize - nFixedSize));
+
+        bOK = CTB_Seek(m_pFile, header.tocOffset) &&
+              (m_Entries.empty()   || fread(&m_Entries[0],   sizeof(ctb_entry), m_Entries.size(),   m_pFile) == m_Entries.size()) &&
+              (m_Levels.empty()    || fread(&m_Levels[0],    sizeof(ctb_level), m_Levels.size(),    m_pFile) == m_Levels.size()) &&
+              (m_HashTable.empty() || fread(&m_HashTable[0], sizeof(uint32_t),  m_HashTable.size(), m_pFile) == m_HashTable.size()) &&
+              (m_Names.empty()     || fread(&m_Names[0],     1,                 m_Names.size(),     m_pFile) == m_Names.size());
+    }
+
+    for(size_t i = 0; bOK && i < m_Entries.size(); i++)
+    {
+        const ctb_entry& entry = m_Entries[i];
+        bOK = (uint64_t) entry.firstLevel + entry.levelCount <= m_Levels.size() &&
+              (uint64_t) entry.nameOffset + entry.nameLength <= m_Names.size();
+    }
+
+    if(!bOK)
+        Close();
+    return bOK;
+}
+
+int CTextureBundleReader::FindEntry(const char* pszName) const
+{
+    if(pszName == NULL || m_HashTable.empty())
+        return -1;
+
+    size_t nLength = strlen(pszName);
+    uint64_t nHash = CTB_HashName(pszName, nLength);
+    size_t nMask = m_HashTable.size() - 1;
+    size_t nSlot = (size_t) nHash & nMask;
+    for(size_t nProbe = 0; nProbe < m_HashTable.size(); nProbe++)
+    {
+        uint32_t nEntry = m_HashTable[nSlot];
+        if(nEntry == CTB_HASH_EMPTY)
+            break;
+        if(nEntry < m_Entries.size())
+        {
+            const ctb_entry& entry = m_Entries[nEntry];
+            if(entry.nameHash == nHash && entry.nameLength == nLength && memcmp(&m_Names[entry.nameOffset], pszName, nLength) == 0)
+                return (int) nEntry;
+        }
+        nSlot = (nSlot + 1) & nMask;
+    }
+    return -1;
+}
+
+std::string CTextureBundleReader::GetEntryName(int nEntry) const
+{
+    const ctb_entry* pEntry = GetEntry(nEntry);
+    if(pEntry == NULL || pEntry->nameLength == 0)
+        return std::string();
+    return std::string(&m_Names[pEntry->nameOffset], pEntry->nameLength);
+}
+
+const ctb_entry* CTextureBundleReader::GetEntry(int nEntry) const
+{
+    if(nEntry < 0 || nEntry >= (int) m_Entries.size())
+        return NULL;
+    return &m_Entries[nEntry];
+}
+
+const ctb_level* CTextureBundleReader::GetLevel(int nEntry, int nLevel) const
+{
+    const ctb_entry* pEntry = GetEntry(nEntry);
+    if(pEntry == NULL || nLevel < 0 || nLevel >= (int) pEntry->levelCount)
+        return NULL;
+    return &m_Levels[pEntry->firstLevel + nLevel];
+}
+
+bool CTextureBundleReader::LoadEntry(int nEntry, MipSet* pMipSet, CMIPS* pCMIPS)
+{
+    const ctb_entry* pEntry = GetEntry(nEntry);
+    if(m_pFile == NULL || pEntry == NULL || pMipSet == NULL || pCMIPS == NULL)
+        return false;
+
+    CMP_TRACE_SCOPE("IO", "Bundle Load Entry");
+
+    pMipSet->m_format           = (CMP_FORMAT) pEntry->format;
+    pMipSet->m_ChannelFormat    = (ChannelFormat) pEntry->channelFormat;
+    pMipSet->m_TextureDataType  = (TextureDataType) pEntry->textureDataType;
+    pMipSet->m_TextureType      = (TextureType) pEntry->textureType;
+    pMipSet->m_compressed       = (pMipSet->m_ChannelFormat == CF_Compressed);
+    pMipSet->m_nBlockWidth      = pEntry->blockWidth;
+    pMipSet->m_nBlockHeight     = pEntry->blockHeight;
+    pMipSet->m_nBlockDepth      = pEntry->blockDepth;
+
+    if(!pCMIPS->AllocateMipSet(pMipSet, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType, pMipSet->m_TextureType,
+                               pEntry->width, pEntry->height, pEntry->depth))
+        return false;
+
+    pMipSet->m_nMipLevels = (int) pEntry->mipLevels;
+    if(pMipSet->m_nMipLevels > pMipSet->m_nMaxMipLevels)
+        pMipSet->m_nMipLevels = pMipSet->m_nMaxMipLevels;
+
+    // The levels of an entry are contiguous, so this is one sequential read of the entry
+    for(uint32_t i = 0; i < pEntry->levelCount; i++)
+    {
+        const ctb_level& level = m_Levels[pEntry->firstLevel + i];
+        if((int) level.mipLevel >= pMipSet->m_nMipLevels)
+            continue;
+
+        MipLevel* pMipLevel = pCMIPS->GetMipLevel(pMipSet, level.mipLevel, level.faceOrSlice);
+        if(pMipLevel == NULL || level.dataSize > 0xFFFFFFFF)
+            return false;
+
+        bool bAllocated = pMipSet->m_compressed ? pCMIPS->AllocateCompressedMipLevelData(pMipLevel, level.width, level.height, (CMP_DWORD) level.dataSize)
+                                                : pCMIPS->AllocateMipLevelData(pMipLevel, level.width, level.height, pMipSet->m_ChannelFormat, pMipSet->m_TextureDataType);
+        if(!bAllocated || pMipLevel->m_dwLinearSize != level.dataSize)
+            return false;
+
+        if(!CTB_Seek(m_pFile, level.dataOffset) || fread(pMipLevel->m_pbData, 1, (size_t) level.dataSize, m_pFile) != level.dataSize)
+            return false;
+    }
+
+    return true;
+}
+
+//=====================================================================
+// Writer
+//=====================================================================
+
+CTextureBundleWriter::CTextureBundleWriter()
+    : m_pFile(NULL)
+    , m_dwAlignment(CTB_DEFAULT_ALIGNMENT)
+    , m_ullEnd(0)
+    , m_ullWritten(0)
+    , m_nQueuedBytes(0)
+    , m_bStop(false)
+    , m_bFailed(false)
+{
+}
+
+CTextureBundleWriter::~CTextureBundleWriter()
+{
+    Release();
+}
+
+void CTextureBundleWriter::Release()
+{
+    StopWriterThread();
+
+    if(m_pFile)
+    {
+        fclose(m_pFile);
+        m_pFile = NULL;
+    }
+
+    m_Entries.clear();
+    m_Levels.clear();
+    m_Names.clear();
+    m_jobs.clear();
+    m_nQueuedBytes  = 0;
+    m_bStop         = false;
+    m_bFailed       = false;
+}
+
+bool CTextureBundleWriter::Open(const char* pszFilename, CMP_DWORD dwAlignment)
+{
+    Release();
+
+    // New entries go after the table of contents of an existing bundle, which stays valid until Close
+    CTextureBundleReader reader;
+    bool bAppend = reader.Open(pszFilename);
+    if(bAppend)
+    {
+        m_Entries.swap(reader.m_Entries);
+        m_Levels.swap(reader.m_Levels);
+        m_Names.swap(reader.m_Names);
+        m_dwAlignment   = reader.m_Header.entryAlignment;
+        m_ullEnd        = reader.m_Header.tocOffset + reader.m_Header.tocSize;
+        reader.Close();
+    }
+    else
+    {
+        // Only a new bundle that was never closed is started again, any other file is left alone
+        FILE* pExisting = NULL;
+        if(fopen_s(&pExisting, pszFilename, "rb") == 0 && pExisting != NULL)
+        {
+            ctb_header existing;
+            bool bUnclosed = fread(&existing, sizeof(existing), 1, pExisting) == 1 &&
+                             existing.identifier[0] == CTB_IDENTIFIER_0 && existing.identifier[1] == CTB_IDENTIFIER_1 &&
+                             existing.tocOffset == 0;
+            fclose(pExisting);
+            if(!bUnclosed)
+                return false;
+        }
+
+        m_dwAlignment   = dwAlignment;
+        m_ullEnd        = sizeof(ctb_header);
+    }
+
+    if(!CTB_IsPowerOfTwo(m_dwAlignment))
+    {
+        Release();
+        return false;
+    }
+
+    if(fopen_s(&m_pFile, pszFilename, bAppend ? "r+b" : "wb") != 0 || m_pFile == NULL)
+    {
+        m_pFile = NULL;
+        Release();
+        return false;
+    }
+
+    // A new bundle is marked as not closed until Close writes the table of contents,
+    // the header of an existing one is only replaced by Close
+    if(!bAppend)
+    {
+        ctb_header header;
+        memset(&header, 0, sizeof(header));
+        header.identifier[0]    = CTB_IDENTIFIER_0;
+        header.identifier[1]    = CTB_IDENTIFIER_1;
+        header.version          = CTB_VERSION;
+        header.entryAlignment   = m_dwAlignment;
+        header.levelAlignment   = CTB_LEVEL_ALIGNMENT;
+        if(fwrite(&header, sizeof(header), 1, m_pFile) != 1)
+        {
+            Release();
+            return false;
+        }
+    }
+    if(!CTB_Seek(m_pFile, m_ullEnd))
+    {
+        Release();
+        return false;
+    }
+    m_ullWritten = m_ullEnd;
+
+    // Without the thread AddEntry writes each entry itself
+    try
+    {
+        m_thread = std::thread(&CTextureBundleWriter::WriterThread, this);
+    }
+    catch(...)
+    {
+    }
+
+    return true;
+}
+
+bool CTextureBundleWriter::AddEntry(const char* pszName, const MipSet* pMipSet, CMIPS* pCMIPS)
+{
+    if(m_pFile == NULL || pszName == NULL || pMipSet == NULL || pCMIPS == NULL || pMipSet->m_pMipLevelTable == NULL)
+        return false;
+
+    CMP_TRACE_SCOPE_DETAIL("IO", "Bundle Add Entry", pszName);
+
+    ctb_entry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.nameLength        = (uint32_t) strlen(pszName);
+    entry.nameHash          = CTB_HashName(pszName, entry.nameLength);
+    entry.nameOffset        = (uint32_t) m_Names.size();
+    entry.dataOffset        = CTB_Align(m_ullEnd, m_dwAlignment);
+    entry.firstLevel        = (uint32_t) m_Levels.size();
+    entry.format            = pMipSet->m_format;
+    entry.channelFormat     = pMipSet->m_ChannelFormat;
+    entry.textureDataType   = pMipSet->m_TextureDataType;
+    entry.textureType       = pMipSet->m_TextureType;
+    entry.width             = pMipSet->m_nWidth;
+    entry.height            = pMipSet->m_nHeight;
+    entry.depth             = pMipSet->m_nDepth > 0 ? pMipSet->m_nDepth : 1;
+    entry.mipLevels         = pMipSet->m_nMipLevels > 0 ? pMipSet->m_nMipLevels : 1;
+    entry.blockWidth        = (uint8_t) pMipSet->m_nBlockWidth;
+    entry.blockHeight       = (uint8_t) pMipSet->m_nBlockHeight;
+    entry.blockDepth        = (uint8_t) pMipSet->m_nBlockDepth;
+
+    // Gather the levels as they are laid out in the file
+    BundleJob job;
+    job.offset = entry.dataOffset;
+    std::vector<ctb_level> levels;
+    for(int nMipLevel = 0; nMipLevel < (int) entry.mipLevels; nMipLevel++)
+    {
+        int nSlices = MaxFacesOrSlices(pMipSet, nMipLevel);
+        if(nSlices < 1)
+            nSlices = 1;
+
+        for(int nSlice = 0; nSlice < nSlices; nSlice++)
+        {
+            MipLevel* pMipLevel = pCMIPS->GetMipLevel(pMipSet, nMipLevel, nSlice);
+            if(pMipLevel == NULL || pMipLevel->m_pbData == NULL)
+                return false;
+
+            size_t nOffset = (size_t) CTB_Align(job.data.size(), CTB_LEVEL_ALIGNMENT);
+            job.data.resize(nOffset);
+            job.data.insert(job.data.end(), pMipLevel->m_pbData, pMipLevel->m_pbData + pMipLevel->m_dwLinearSize);
+
+            ctb_level level;
+            level.dataOffset    = entry.dataOffset + nOffset;
+            level.dataSize      = pMipLevel->m_dwLinearSize;
+            level.width         = pMipLevel->m_nWidth;
+            level.height        = pMipLevel->m_nHeight;
+            level.mipLevel      = nMipLevel;
+            level.faceOrSlice   = nSlice;
+            levels.push_back(level);
+        }
+    }
+    entry.levelCount    = (uint32_t) levels.size();
+    entry.dataSize      = job.data.size();
+
+    // Hand the entry to the writer thread, waiting while too much is queued
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(m_thread.joinable() && !m_bFailed && !m_jobs.empty() && m_nQueuedBytes + job.data.size() > CTB_MAX_QUEUED)
+            m_written.wait(lock);
+        if(m_bFailed)
+            return false;
+
+        m_Entries.push_back(entry);
+        m_Levels.insert(m_Levels.end(), levels.begin(), levels.end());
+        m_Names.insert(m_Names.end(), pszName, pszName + entry.nameLength);
+        m_ullEnd = entry.dataOffset + entry.dataSize;
+
+        if(m_thread.joinable())
+        {
+            m_nQueuedBytes += job.data.size();
+            m_jobs.push_back(BundleJob());
+            m_jobs.back().offset = job.offset;
+            m_jobs.back().data.swap(job.data);
+            m_queued.notify_all();
+            return true;
+        }
+    }
+
+    if(!WriteJob(job))
+    {
+        m_bFailed = true;
+        return false;
+    }
+    return true;
+}
+
+bool CTextureBundleWriter::WriteJob(const BundleJob& job)
+{
+    CMP_TRACE_SCOPE("IO", "Bundle Writer");
+
+    // Jobs arrive in file order, only the alignment padding lies between them
+    bool bOK = CTB_WritePadding(m_pFile, job.offset - m_ullWritten) &&
+               (job.data.empty() || fwrite(&job.data[0], 1, job.data.size(), m_pFile) == job.data.size());
+    m_ullWritten = job.offset + job.data.size();
+    return bOK;
+}
+
+void CTextureBundleWriter::WriterThread()
+{
+    CMP_TRACE_THREAD_NAME("Bundle Writer");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for(;;)
+    {
+        while(m_jobs.empty() && !m_bStop)
+            m_queued.wait(lock);
+        if(m_jobs.empty())
+            break;
+
+        BundleJob job;
+        job.offset = m_jobs.front().offset;
+        job.data.swap(m_jobs.front().data);
+        m_jobs.pop_front();
+        lock.unlock();
+
+        bool bOK = !m_bFailed && WriteJob(job);
+
+        lock.lock();
+        if(!bOK)
+            m_bFailed = true;
+        m_nQueuedBytes -= job.data.size();
+        m_written.notify_all();
+    }
+}
+
+void CTextureBundleWriter::StopWriterThread()
+{
+    if(!m_thread.joinable())
+        return;
+
+    // Any entry still queued is written before the thread exits
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStop = true;
+    }
+    m_queued.notify_all();
+    m_thread.join();
+}
+
+bool CTextureBundleWriter::Close()
+{
+    if(m_pFile == NULL)
+        return false;
+
+    CMP_TRACE_SCOPE("IO", "Bundle Close");
+    StopWriterThread();
+    bool bOK = !m_bFailed;
+
+    // Table of contents, an entry added again under the same name replaces the older one
+    std::unordered_map<std::string, size_t> latest;
+    for(size_t i = 0; i < m_Entries.size(); i++)
+        latest[std::string(&m_Names[0] + m_Entries[i].nameOffset, m_Entries[i].nameLength)] = i;
+
+    std::vector<ctb_entry>  entries;
+    std::vector<ctb_level>  levels;
+    std::vector<char>       names;
+    for(size_t i = 0; i < m_Entries.size(); i++)
+    {
+        ctb_entry entry = m_Entries[i];
+        if(latest[std::string(&m_Names[0] + entry.nameOffset, entry.nameLength)] != i)
+            continue;
+
+        levels.insert(levels.end(), m_Levels.begin() + entry.firstLevel, m_Levels.begin() + entry.firstLevel + entry.levelCount);
+        names.insert(names.end(), m_Names.begin() + entry.nameOffset, m_Names.begin() + entry.nameOffset + entry.nameLength);
+        entry.firstLevel = (uint32_t) (levels.size() - entry.levelCount);
+        entry.nameOffset = (uint32_t) (names.size() - entry.nameLength);
+        entries.push_back(entry);
+    }
+
+    uint32_t nHashTableSize = 1;
+    while(nHashTableSize < 2 * entries.size())
+        nHashTableSize <<= 1;
+    std::vector<uint32_t> hashTable(nHashTableSize, CTB_HASH_EMPTY);
+    for(size_t i = 0; i < entries.size(); i++)
+    {
+        uint32_t nSlot = (uint32_t) entries[i].nameHash & (nHashTableSize - 1);
+        while(hashTable[nSlot] != CTB_HASH_EMPTY)
+            nSlot = (nSlot + 1) & (nHashTableSize - 1);
+        hashTable[nSlot] = (uint32_t) i;
+    }
+
+    ctb_header header;
+    memset(&header, 0, sizeof(header));
+    header.identifier[0]    = CTB_IDENTIFIER_0;
+    header.identifier[1]    = CTB_IDENTIFIER_1;
+    header.version          = CTB_VERSION;
+    header.entryCount       = (uint32_t) entries.size();
+    header.levelCount       = (uint32_t) levels.size();
+    header.hashTableSize    = nHashTableSize;
+    header.entryAlignment   = m_dwAlignment;
+    header.levelAlignment   = CTB_LEVEL_ALIGNMENT;
+    header.tocOffset        = CTB_Align(m_ullWritten, 8);
+    header.namesOffset      = header.tocOffset + entries.size() * sizeof(ctb_entry) + levels.size() * sizeof(ctb_level) + hashTable.size() * sizeof(uint32_t);
+    header.tocSize          = header.namesOffset + names.size() - header.tocOffset;
+
+    bOK = bOK && CTB_WritePadding(m_pFile, header.tocOffset - m_ullWritten) &&
+          (entries.empty() || fwrite(&entries[0],   sizeof(ctb_entry), entries.size(),   m_pFile) == entries.size()) &&
+          (levels.empty()  || fwrite(&levels[0],    sizeof(ctb_level), levels.size(),    m_pFile) == levels.size()) &&
+          fwrite(&hashTable[0], sizeof(uint32_t), hashTable.size(), m_pFile) == hashTable.size() &&
+          (names.empty()   || fwrite(&names[0],     1,                 names.size(),     m_pFile) == names.size());
+
+    // Data an interrupted append left past the new end is cut off. The table is on disk
+    // before the header points at it, so a crash in between keeps the previous table
+    bOK = bOK && fflush(m_pFile) == 0 && _chsize_s(_fileno(m_pFile), (__int64) (header.tocOffset + header.tocSize)) == 0 &&
+          _commit(_fileno(m_pFile)) == 0;
+
+    bOK = bOK && CTB_Seek(m_pFile, 0) && fwrite(&header, sizeof(header), 1, m_pFile) == 1;
+
+    if(fclose(m_pFile) != 0)
+        bOK = false;
+    m_pFile = NULL;
+
+    Release();
+    return bOK;
+}
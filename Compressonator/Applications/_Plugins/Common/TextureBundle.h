@@ -0,0 +1,213 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TextureBundle.h : Reader and writer of CTB texture bundles, many MipSets in one file
+//
+
+#ifndef _TEXTUREBUNDLE_H_
+#define _TEXTUREBUNDLE_H_
+
+#include "MIPS.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+// ---------------- CTB File Definitions ------------------------
+
+/*
+ctb_header                              at offset 0
+for each entry
+    Byte    padding                     up to the entry alignment
+    for each level, then each face or slice of the level
+        Byte    padding                 up to CTB_LEVEL_ALIGNMENT from the start of the entry
+        Byte    data[size]              as the MipLevel holds it, rows and block rows tightly packed
+    end
+end
+Table of contents                       at tocOffset, 8 byte aligned
+    ctb_entry   entries[entryCount]
+    ctb_level   levels[levelCount]
+    UInt32      hashTable[hashTableSize]    entry index or CTB_HASH_EMPTY, linear probing from nameHash & (hashTableSize - 1)
+    Byte        names[]                     entry names, not terminated
+
+Entry data is never moved once written. Entries are appended after the table of contents and a new
+table is written after them, so a bundle can grow one texture at a time. The header is written last,
+until then it and the old table still describe the file, and the old table stays in it unused.
+An entry added with the name of an older one replaces it in the table, the older data stays in the
+file unused. A tocOffset of 0 marks a new bundle that was not closed.
+*/
+
+#define CTB_IDENTIFIER_0            0x31425443      // "CTB1"
+#define CTB_IDENTIFIER_1            0x0A1A0A0D      // "\r\n\x1A\n", catches text mode transfers
+#define CTB_VERSION                 1
+#define CTB_DEFAULT_ALIGNMENT       4096            // Entry alignment, a page so entries can be mapped in place
+#define CTB_LEVEL_ALIGNMENT         512             // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, where a level may be placed in an upload buffer.
+                                                    // Rows are not padded to the 256 byte D3D12_TEXTURE_DATA_PITCH_ALIGNMENT,
+                                                    // a level with another row pitch is copied to the upload buffer row by row
+#define CTB_HASH_EMPTY              0xFFFFFFFF
+
+#pragma pack(push, 1)
+struct ctb_header
+{
+    uint32_t  identifier[2];
+    uint32_t  version;
+    uint32_t  entryCount;
+    uint32_t  levelCount;
+    uint32_t  hashTableSize;            // Power of two, at least twice the entry count
+    uint32_t  entryAlignment;
+    uint32_t  levelAlignment;
+    uint64_t  tocOffset;
+    uint64_t  tocSize;
+    uint64_t  namesOffset;              // Names blob, inside the table of contents
+    uint64_t  reserved;
+};
+
+struct ctb_entry
+{
+    uint64_t  nameHash;                 // CTB_HashName of the name
+    uint32_t  nameOffset;               // In the names blob
+    uint32_t  nameLength;
+    uint64_t  dataOffset;               // From the start of the file, a multiple of entryAlignment
+    uint64_t  dataSize;
+    uint32_t  firstLevel;               // Index of the entry's first ctb_level
+    uint32_t  levelCount;               // MIP levels times faces or slices
+    uint32_t  format;                   // CMP_FORMAT
+    uint32_t  channelFormat;            // ChannelFormat
+    uint32_t  textureDataType;          // TextureDataType
+    uint32_t  textureType;              // TextureType
+    uint32_t  width;
+    uint32_t  height;
+    uint32_t  depth;                    // 6 for cube maps, slices of volume textures, else 1
+    uint32_t  mipLevels;
+    uint8_t   blockWidth;               // Compression block size, used by ASTC
+    uint8_t   blockHeight;
+    uint8_t   blockDepth;
+    uint8_t   reserved[5];
+};
+
+struct ctb_level
+{
+    uint64_t  dataOffset;               // From the start of the file
+    uint64_t  dataSize;
+    uint32_t  width;
+    uint32_t  height;
+    uint32_t  mipLevel;
+    uint32_t  faceOrSlice;
+};
+#pragma pack(pop)
+
+// 64 bit FNV-1a of the name, names are case sensitive
+uint64_t CTB_HashName(const char* pszName, size_t nLength);
+
+//
+// Reads the table of contents of a bundle, then single entries on request
+//
+class CTextureBundleReader
+{
+public:
+    CTextureBundleReader();
+    ~CTextureBundleReader();
+
+    // Reads the header and table of contents only
+    bool Open(const char* pszFilename);
+    void Close();
+
+    int GetEntryCount() const { return (int) m_Entries.size(); }
+
+    // Entry index of a name, -1 if the bundle has none
+    int FindEntry(const char* pszName) const;
+
+    std::string GetEntryName(int nEntry) const;
+
+    // File layout of an entry and its levels, for callers that map the file instead of loading entries
+    const ctb_entry* GetEntry(int nEntry) const;
+    const ctb_level* GetLevel(int nEntry, int nLevel) const;
+
+    // Allocates pMipSet and reads the entry's levels into it, nothing else is read from the file
+    bool LoadEntry(int nEntry, MipSet* pMipSet, CMIPS* pCMIPS);
+
+private:
+    friend class CTextureBundleWriter;
+
+    FILE*                   m_pFile;
+    ctb_header              m_Header;
+    std::vector<ctb_entry>  m_Entries;
+    std::vector<ctb_level>  m_Levels;
+    std::vector<uint32_t>   m_HashTable;
+    std::vector<char>       m_Names;
+};
+
+//
+// Appends MipSets to a new or existing bundle. AddEntry copies the levels and returns, a background
+// thread writes them while the caller goes on with the next texture. Close writes the table of contents.
+//
+class CTextureBundleWriter
+{
+public:
+    CTextureBundleWriter();
+    ~CTextureBundleWriter();
+
+    // Keeps the entries and alignment of a bundle that exists, else dwAlignment must be a power of two.
+    // Fails on an existing file that is not a bundle rather than overwriting it
+    bool Open(const char* pszFilename, CMP_DWORD dwAlignment = CTB_DEFAULT_ALIGNMENT);
+
+    bool AddEntry(const char* pszName, const MipSet* pMipSet, CMIPS* pCMIPS);
+
+    // Fails if a write to disk failed
+    bool Close();
+
+private:
+    struct BundleJob
+    {
+        uint64_t                offset;
+        std::vector<CMP_BYTE>   data;
+    };
+
+    void WriterThread();
+    void StopWriterThread();
+    bool WriteJob(const BundleJob& job);
+    void Release();
+
+    FILE*                       m_pFile;
+    CMP_DWORD                   m_dwAlignment;
+    uint64_t                    m_ullEnd;           // End of the entry data, queued data included
+    uint64_t                    m_ullWritten;       // End of the data on disk
+    std::vector<ctb_entry>      m_Entries;
+    std::vector<ctb_level>      m_Levels;
+    std::vector<char>           m_Names;
+
+    std::thread                 m_thread;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_queued;
+    std::condition_variable     m_written;
+    std::deque<BundleJob>       m_jobs;
+    size_t                      m_nQueuedBytes;
+    bool                        m_bStop;
+    std::atomic<bool>           m_bFailed;          // Read by the writer thread outside m_mutex
+};
+
+#endif
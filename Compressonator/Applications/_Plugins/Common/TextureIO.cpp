@@ -31,7 +31,9 @@
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp> 
 #include "TextureIO.h"
+#include "CMP_Trace.h"
 #include <iostream>
+#include <mutex>
 
 
 
@@ -180,10 +182,20 @@ bool IsDestinationUnCompressed(const char *fname)
         isuncompressed = false;
     }
     else
+    if (file_extension.compare(".ktx2") == 0)
+    {
+        isuncompressed = false;
+    }
+    else
     if(file_extension.compare(".raw") == 0)
     {
         isuncompressed = false;
     }
+    else
+    if (file_extension.compare(".ctb") == 0)
+    {
+        isuncompressed = false;
+    }
     return isuncompressed;
 }
 
@@ -659,8 +671,36 @@ QImage *MIPS2QImage(CMIPS *m_CMips, MipSet *mipset, int level)
 
 
 
+#ifdef USE_QT_IMAGELOAD
+static std::once_flag g_QtImageLoadOnce;
+
+void InitQtImageLoad()
+{
+    std::call_once(g_QtImageLoadOnce, []()
+    {
+        if (QCoreApplication::instance() == NULL)
+        {
+            // Never deleted, Qt objects may be used until the process exits
+            static int   argc     = 1;
+            static char  szName[] = "CompressonatorCLI";
+            static char* argv[]   = { szName, NULL };
+            new QCoreApplication(argc, argv);
+
+            QString dirPath = QCoreApplication::applicationDirPath();
+            QCoreApplication::addLibraryPath(dirPath + "./plugins/imageformats");
+        }
+    });
+}
+#endif
+
 int AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *MipSetIn, bool use_OCV)
+{
+    return AMDLoadMIPSTextureImage(SourceFile, MipSetIn, use_OCV, g_CMIPS);
+}
+
+int AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *MipSetIn, bool use_OCV, CMIPS *pCMIPS)
 { 
+    CMP_TRACE_SCOPE_DETAIL("IO", "Load", SourceFile);
     string file_extension  = boost::filesystem::extension(SourceFile);
     boost::algorithm::to_upper(file_extension); 
     boost::erase_all(file_extension,".");
@@ -677,7 +717,7 @@ int AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *MipSetIn, bool use_O
     // do the load
     if (plugin_Image)
     {
-        plugin_Image->TC_PluginSetSharedIO(&g_CMIPS);
+        plugin_Image->TC_PluginSetSharedIO(pCMIPS);
 
         if (plugin_Image->TC_PluginFileLoadTexture(SourceFile, MipSetIn) != 0)
         {
@@ -697,11 +737,12 @@ int AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *MipSetIn, bool use_O
         // Try Qt based
         int result = -1;
         QImage *qimage;
+        InitQtImageLoad();
         qimage = new QImage(SourceFile);
 
         if (qimage)
         {
-            result = QImage2MIPS(qimage, g_CMIPS, MipSetIn);
+            result = QImage2MIPS(qimage, pCMIPS, MipSetIn);
             delete qimage;
             qimage = NULL;
         }
@@ -718,6 +759,7 @@ int AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *MipSetIn, bool use_O
 
 int AMDSaveMIPSTextureImage(const char * DestFile, MipSet *MipSetIn, bool use_OCV)
 {
+    CMP_TRACE_SCOPE_DETAIL("IO", "Save", DestFile);
     bool filesaved = false;
     CMIPS m_CMIPS;
     string file_extension  = boost::filesystem::extension(DestFile);
@@ -752,6 +794,11 @@ int AMDSaveMIPSTextureImage(const char * DestFile, MipSet *MipSetIn, bool use_OC
             case CMP_FORMAT_BC6H_SF:
             case CMP_FORMAT_ETC_RGB:
             case CMP_FORMAT_ETC2_RGB:
+            case CMP_FORMAT_ETC2_RGBA:
+            case CMP_FORMAT_EAC_R11:
+            case CMP_FORMAT_EAC_R11_SIGNED:
+            case CMP_FORMAT_EAC_RG11:
+            case CMP_FORMAT_EAC_RG11_SIGNED:
                 MipSetIn->m_swizzle = true;
                 break;
             }
@@ -773,6 +820,7 @@ int AMDSaveMIPSTextureImage(const char * DestFile, MipSet *MipSetIn, bool use_OC
     if (!filesaved)
     {
         // Try Qt based filesave!
+        InitQtImageLoad();
         QImage *qimage = MIPS2QImage(&m_CMIPS, MipSetIn, 0);
 
         if (qimage)
@@ -86,10 +86,17 @@ bool            IsDestinationUnCompressed(const char *fname);
 CMP_FORMAT      FormatByFileExtension(const char *fname, MipSet *pMipSet);
 
 int             AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *CMips, bool use_OCV);
+int             AMDLoadMIPSTextureImage(const char *SourceFile, MipSet *CMips, bool use_OCV, CMIPS *pCMIPS);    // For loads off the main thread
 int             AMDSaveMIPSTextureImage(const char *DestFile, MipSet *CMips, bool use_OCV);
 
 QRgb            floatToQrgba(float r, float g, float b, float a);
 
+#ifdef USE_QT_IMAGELOAD
+// Call before the first QImage use. Creates a QCoreApplication when the application has none, the
+// command line tool delay loads Qt and only maps it when an image falls back to Qt or is analysed
+void            InitQtImageLoad();
+#endif
+
 bool            CompressedFormat(CMP_FORMAT format);
 bool            FloatFormat(CMP_FORMAT format);
 
@@ -0,0 +1,315 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TexturePrefetch.cpp : Loads the next source images on I/O threads while the current one is processed
+//
+
+#include "TexturePrefetch.h"
+#include "TextureIO.h"
+#include "CMP_Trace.h"
+
+#include "windows.h"
+#include <string.h>
+#include <chrono>
+
+#define PREFETCH_CACHE_READ     (1024 * 1024)   // Bytes per read when filling the system cache
+
+// Reads a file once with a sequential scan hint, so the system cache holds it when its load starts.
+// Stops early when bStop is set
+static void ReadIntoSystemCache(const std::string& file, std::atomic<bool>& bStop)
+{
+    CMP_TRACE_SCOPE_DETAIL("IO", "Prefetch Cache", file.c_str());
+
+    HANDLE hFile = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    std::vector<char> buffer(PREFETCH_CACHE_READ);
+    DWORD dwRead = 0;
+    while(!bStop && ReadFile(hFile, buffer.data(), PREFETCH_CACHE_READ, &dwRead, NULL) && dwRead > 0)
+        ;
+
+    CloseHandle(hFile);
+}
+
+CTexturePrefetcher::CTexturePrefetcher(const std::vector<std::string>& SourceFiles, int nDepth, unsigned long long ullMemoryBudget)
+    : m_bStop(false)
+    , m_nDepth(nDepth > 0 ? nDepth : 1)
+    , m_ullMemoryBudget(ullMemoryBudget)
+    , m_nNext(0)
+    , m_nNextCached(0)
+    , m_nHeld(0)
+    , m_nAcquired(SourceFiles.size())
+    , m_ullHeldSize(0)
+    , m_nLoadCount(0)
+    , m_fLoadTime(0)
+    , m_fStallTime(0)
+{
+    m_Entries.resize(SourceFiles.size());
+    for(size_t i = 0; i < SourceFiles.size(); i++)
+    {
+        m_Entries[i].m_File     = SourceFiles[i];
+        m_Entries[i].m_State    = PS_Queued;
+        m_Entries[i].m_ullSize  = 0;
+        memset(&m_Entries[i].m_MipSet, 0, sizeof(MipSet));
+    }
+
+    // One thread per image held ahead, Acquire loads the images itself if none could be started
+    size_t nThreads = m_nDepth < m_Entries.size() ? m_nDepth : m_Entries.size();
+    for(size_t i = 0; i < nThreads; i++)
+    {
+        try
+        {
+            m_Threads.push_back(std::thread(&CTexturePrefetcher::LoadThread, this));
+        }
+        catch(...)
+        {
+            break;
+        }
+    }
+}
+
+CTexturePrefetcher::~CTexturePrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStop = true;
+    }
+    m_Space.notify_all();
+
+    for(size_t i = 0; i < m_Threads.size(); i++)
+        m_Threads[i].join();
+
+    for(size_t i = 0; i < m_Entries.size(); i++)
+        FreeEntry(m_Entries[i]);
+}
+
+// Held images that are ahead of the consumer, the one it is processing does not take a place.
+// Called with m_Mutex held
+size_t CTexturePrefetcher::HeldAhead()
+{
+    size_t nHeld = m_nHeld;
+    if(m_nAcquired < m_Entries.size())
+    {
+        PrefetchState state = m_Entries[m_nAcquired].m_State;
+        if(state == PS_Loading || state == PS_Loaded || state == PS_Failed)
+            nHeld--;
+    }
+    return nHeld;
+}
+
+void CTexturePrefetcher::LoadThread()
+{
+    CMP_TRACE_THREAD_NAME("Prefetch Loader");
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for(;;)
+    {
+        // Skip images the consumer released before they were loaded
+        while(m_nNext < m_Entries.size() && m_Entries[m_nNext].m_State != PS_Queued)
+            m_nNext++;
+
+        // Wait for room ahead of the consumer, an image can always load when nothing is held ahead
+        while(!m_bStop && m_nNext < m_Entries.size() && HeldAhead() > 0 &&
+              (HeldAhead() >= m_nDepth || m_ullHeldSize >= m_ullMemoryBudget))
+        {
+            // Meanwhile have the file system read the next image
+            if(m_nNextCached <= m_nNext)
+            {
+                m_nNextCached = m_nNext + 1;
+                std::string file = m_Entries[m_nNext].m_File;
+                lock.unlock();
+                ReadIntoSystemCache(file, m_bStop);
+                lock.lock();
+                continue;
+            }
+            m_Space.wait(lock);
+        }
+
+        if(m_bStop || m_nNext >= m_Entries.size())
+            break;
+        if(m_Entries[m_nNext].m_State != PS_Queued)
+            continue;
+
+        PrefetchEntry& entry = m_Entries[m_nNext++];
+        entry.m_State = PS_Loading;
+        m_nHeld++;
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool bLoaded = AMDLoadMIPSTextureImage(entry.m_File.c_str(), &entry.m_MipSet, false, &m_CMIPS) == 0;
+        if(bLoaded && entry.m_MipSet.m_ChannelFormat == CF_Compressed)
+            entry.m_MipSet.m_compressed = true;
+        unsigned long long ullSize = bLoaded ? MipSetSize(&entry.m_MipSet) : 0;
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        entry.m_ullSize = ullSize;
+        m_ullHeldSize  += ullSize;
+        m_fLoadTime    += duration.count();
+        m_nLoadCount++;
+
+        if(entry.m_State == PS_Released)
+        {
+            // The consumer moved past the image while it loaded
+            FreeEntry(entry);
+            m_nHeld--;
+            m_ullHeldSize -= ullSize;
+        }
+        else
+            entry.m_State = bLoaded ? PS_Loaded : PS_Failed;
+
+        m_Loaded.notify_all();
+        m_Space.notify_all();
+    }
+}
+
+MipSet* CTexturePrefetcher::Acquire(size_t nIndex)
+{
+    if(nIndex >= m_Entries.size())
+        return NULL;
+
+    for(size_t i = 0; i < nIndex; i++)
+        Release(i);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    PrefetchEntry& entry = m_Entries[nIndex];
+
+    // The image stops counting as ahead of the consumer, which makes room for the next one
+    m_nAcquired = nIndex;
+    m_Space.notify_all();
+
+    if(entry.m_State == PS_Queued || entry.m_State == PS_Loading)
+    {
+        CMP_TRACE_SCOPE_DETAIL("IO", "Prefetch Stall", entry.m_File.c_str());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if(m_Threads.empty())
+        {
+            // No I/O threads could be started, load in place
+            entry.m_State = PS_Loading;
+            m_nNext = nIndex + 1;
+            m_nHeld++;
+            lock.unlock();
+            bool bLoaded = AMDLoadMIPSTextureImage(entry.m_File.c_str(), &entry.m_MipSet, false, &m_CMIPS) == 0;
+            if(bLoaded && entry.m_MipSet.m_ChannelFormat == CF_Compressed)
+                entry.m_MipSet.m_compressed = true;
+            lock.lock();
+            entry.m_ullSize = bLoaded ? MipSetSize(&entry.m_MipSet) : 0;
+            m_ullHeldSize  += entry.m_ullSize;
+            m_nLoadCount++;
+            entry.m_State = bLoaded ? PS_Loaded : PS_Failed;
+        }
+        else
+        {
+            while(entry.m_State == PS_Queued || entry.m_State == PS_Loading)
+                m_Loaded.wait(lock);
+        }
+
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        m_fStallTime += duration.count();
+    }
+
+    return entry.m_State == PS_Loaded ? &entry.m_MipSet : NULL;
+}
+
+void CTexturePrefetcher::Release(size_t nIndex)
+{
+    if(nIndex >= m_Entries.size())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        PrefetchEntry& entry = m_Entries[nIndex];
+        switch(entry.m_State)
+        {
+        case PS_Queued:
+            // Never loaded, the I/O threads skip it
+            entry.m_State = PS_Released;
+            if(m_nNext <= nIndex)
+                m_nNext = nIndex + 1;
+            return;
+        case PS_Loading:
+            // Freed by the I/O thread once the load is done
+            entry.m_State = PS_Released;
+            return;
+        case PS_Loaded:
+        case PS_Failed:
+            FreeEntry(entry);
+            entry.m_State = PS_Released;
+            m_ullHeldSize -= entry.m_ullSize;
+            m_nHeld--;
+            break;
+        default:
+            return;
+        }
+    }
+    m_Space.notify_all();
+}
+
+size_t CTexturePrefetcher::GetLoadCount()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_nLoadCount;
+}
+
+double CTexturePrefetcher::GetLoadTime()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_fLoadTime;
+}
+
+double CTexturePrefetcher::GetStallTime()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_fStallTime;
+}
+
+void CTexturePrefetcher::FreeEntry(PrefetchEntry& entry)
+{
+    if(entry.m_MipSet.m_pMipLevelTable)
+    {
+        m_CMIPS.FreeMipSet(&entry.m_MipSet);
+        entry.m_MipSet.m_pMipLevelTable = NULL;
+    }
+}
+
+unsigned long long CTexturePrefetcher::MipSetSize(MipSet* pMipSet)
+{
+    unsigned long long ullSize = 0;
+    for(int nLevel = 0; nLevel < pMipSet->m_nMipLevels; nLevel++)
+    {
+        int nFaces = pMipSet->m_nDepth;
+        if(pMipSet->m_TextureType == TT_VolumeTexture)
+            nFaces >>= nLevel;
+        if(nFaces < 1)
+            nFaces = 1;
+
+        for(int nFace = 0; nFace < nFaces; nFace++)
+        {
+            MipLevel* pMipLevel = m_CMIPS.GetMipLevel(pMipSet, nLevel, nFace);
+            if(pMipLevel)
+                ullSize += pMipLevel->m_dwLinearSize;
+        }
+    }
+    return ullSize;
+}
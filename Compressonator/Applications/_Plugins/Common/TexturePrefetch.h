@@ -0,0 +1,100 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TexturePrefetch.h : Loads the next source images on I/O threads while the current one is processed
+//
+
+#ifndef _TEXTUREPREFETCH_H_
+#define _TEXTUREPREFETCH_H_
+
+#include "MIPS.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#define PREFETCH_DEFAULT_DEPTH          2       // Images loaded ahead of the one being processed
+#define PREFETCH_DEFAULT_BUDGET_MB      512     // Memory the loaded images may hold before loading stops
+
+//
+// Loads a list of source images in order with AMDLoadMIPSTextureImage, up to nDepth images
+// ahead of the consumer, not counting the image it last acquired. A load only starts while the
+// loaded images, that one included, hold less than the memory budget, the file after it is read
+// into the system cache in the meantime.
+// Images are loaded as the GUI image loader does: RGBA, m_swizzle not set.
+//
+class CTexturePrefetcher
+{
+public:
+    CTexturePrefetcher(const std::vector<std::string>& SourceFiles, int nDepth, unsigned long long ullMemoryBudget);
+    ~CTexturePrefetcher();
+
+    // Waits for image nIndex, NULL if it failed to load. The MipSet stays owned by the
+    // prefetcher until Release, images before nIndex are released by the call
+    MipSet* Acquire(size_t nIndex);
+
+    // Frees image nIndex so the I/O threads can load further ahead
+    void Release(size_t nIndex);
+
+    size_t GetLoadCount();
+    double GetLoadTime();       // Seconds the I/O threads spent loading images
+    double GetStallTime();      // Seconds Acquire waited on images that were not loaded yet
+
+private:
+    enum PrefetchState { PS_Queued, PS_Loading, PS_Loaded, PS_Failed, PS_Released };
+
+    struct PrefetchEntry
+    {
+        std::string         m_File;
+        MipSet              m_MipSet;
+        PrefetchState       m_State;
+        unsigned long long  m_ullSize;
+    };
+
+    void LoadThread();
+    size_t HeldAhead();
+    void FreeEntry(PrefetchEntry& entry);
+    unsigned long long MipSetSize(MipSet* pMipSet);
+
+    std::vector<PrefetchEntry>  m_Entries;
+    std::vector<std::thread>    m_Threads;
+    std::mutex                  m_Mutex;
+    std::condition_variable     m_Loaded;
+    std::condition_variable     m_Space;
+    std::atomic<bool>           m_bStop;
+    CMIPS                       m_CMIPS;        // g_CMIPS is freed and reallocated by every ProcessCMDLine
+
+    size_t                      m_nDepth;
+    unsigned long long          m_ullMemoryBudget;
+    size_t                      m_nNext;        // Next image to load
+    size_t                      m_nNextCached;  // Next image to read into the system cache
+    size_t                      m_nHeld;        // Images loading or loaded and not released
+    size_t                      m_nAcquired;    // Image last acquired, m_Entries.size() before the first Acquire
+    unsigned long long          m_ullHeldSize;
+    size_t                      m_nLoadCount;
+    double                      m_fLoadTime;
+    double                      m_fStallTime;
+};
+
+#endif
@@ -0,0 +1,762 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TextureStream.cpp : Row sources and block row writers for streamed compression
+//
+
+#include "TextureStream.h"
+#include "TextureIO.h"
+#include "CMP_Trace.h"
+#include "cExr.h"
+
+#include "windows.h"
+#include <string.h>
+#include <vector>
+
+#define STREAM_DDS_MAGIC        0x20534444  // "DDS "
+#define STREAM_KTX_ENDIANNESS   0x04030201
+#define STREAM_WRITE_CHUNK      (4 * 1024 * 1024)   // Bytes per staging chunk and per fwrite
+
+// DDS header flags, from ddraw.h
+#define STREAM_DDSD_CAPS        0x00000001
+#define STREAM_DDSD_HEIGHT      0x00000002
+#define STREAM_DDSD_WIDTH       0x00000004
+#define STREAM_DDSD_PIXELFORMAT 0x00001000
+#define STREAM_DDSD_MIPMAPCOUNT 0x00020000
+#define STREAM_DDSD_LINEARSIZE  0x00080000
+#define STREAM_DDPF_ALPHAPIXELS 0x00000001
+#define STREAM_DDPF_FOURCC      0x00000004
+#define STREAM_DDPF_RGB         0x00000040
+#define STREAM_DDSCAPS_COMPLEX  0x00000008
+#define STREAM_DDSCAPS_TEXTURE  0x00001000
+#define STREAM_DDSCAPS_MIPMAP   0x00400000
+#define STREAM_DDSCAPS2_CUBEMAP 0x00000200
+#define STREAM_DDSCAPS2_VOLUME  0x00200000
+
+// Word offsets in the 124 byte DDS header
+enum
+{
+    DDSH_SIZE = 0, DDSH_FLAGS, DDSH_HEIGHT, DDSH_WIDTH, DDSH_PITCH, DDSH_DEPTH, DDSH_MIPMAPCOUNT,
+    DDSH_PF_SIZE = 18, DDSH_PF_FLAGS, DDSH_PF_FOURCC, DDSH_PF_BITCOUNT, DDSH_PF_RMASK, DDSH_PF_GMASK, DDSH_PF_BMASK, DDSH_PF_AMASK,
+    DDSH_CAPS, DDSH_CAPS2, DDSH_CAPS3, DDSH_CAPS4, DDSH_RESERVED2,
+    DDSH_WORDS
+};
+
+typedef struct
+{
+    CMP_DWORD   dxgiFormat;
+    CMP_DWORD   resourceDimension;
+    CMP_DWORD   miscFlag;
+    CMP_DWORD   arraySize;
+    CMP_DWORD   reserved;
+} StreamDDS10Header;
+
+#pragma pack(push, 1)
+typedef struct
+{
+    CMP_BYTE        cIDFieldLength;
+    CMP_BYTE        cColorMapType;
+    CMP_BYTE        cImageType;
+    unsigned short  nColorMapFirst;
+    unsigned short  nColorMapLength;
+    CMP_BYTE        cColorMapEntrySize;
+    unsigned short  nXOrigin;
+    unsigned short  nYOrigin;
+    unsigned short  nWidth;
+    unsigned short  nHeight;
+    CMP_BYTE        cColorDepth;
+    CMP_BYTE        cFormatFlags;
+} StreamTGAHeader;
+#pragma pack(pop)
+
+static bool SeekFile(FILE* pFile, unsigned long long nOffset)
+{
+    return _fseeki64(pFile, (__int64) nOffset, SEEK_SET) == 0;
+}
+
+//
+// Uncompressed 8 bit RGBA, 16 and 32 bit float RGBA files, read row by row at a known offset
+//
+class CRawStreamSource : public CStreamSource
+{
+public:
+    CRawStreamSource(FILE* pFile, unsigned long long nDataOffset, CMP_DWORD dwFileBytesPerPixel, bool bBottomUp, bool bBGR, bool bOpaque)
+        : m_pFile(pFile), m_nDataOffset(nDataOffset), m_dwFileBytesPerPixel(dwFileBytesPerPixel),
+          m_bBottomUp(bBottomUp), m_bBGR(bBGR), m_bOpaque(bOpaque) {}
+
+    ~CRawStreamSource()
+    {
+        fclose(m_pFile);
+    }
+
+    bool ReadRows(CMP_DWORD dwFirstRow, CMP_DWORD dwNumRows, CMP_BYTE* pData, CMP_DWORD dwPitch)
+    {
+        CMP_TRACE_SCOPE("IO", "Stream Source Read");
+
+        if(dwFirstRow + dwNumRows > m_dwHeight)
+            return false;
+
+        // A bottom up band is still one contiguous run of the file, only the row order flips
+        unsigned long long nFileRowBytes = (unsigned long long) m_dwWidth * m_dwFileBytesPerPixel;
+        CMP_DWORD dwFileFirstRow = m_bBottomUp ? m_dwHeight - dwFirstRow - dwNumRows : dwFirstRow;
+        if(!SeekFile(m_pFile, m_nDataOffset + dwFileFirstRow * nFileRowBytes))
+            return false;
+
+        m_row.resize((size_t) nFileRowBytes);
+        for(CMP_DWORD i = 0; i < dwNumRows; i++)
+        {
+            if(fread(&m_row[0], 1, m_row.size(), m_pFile) != m_row.size())
+                return false;
+
+            CMP_DWORD dwRow = m_bBottomUp ? dwNumRows - 1 - i : i;
+            ConvertRow(&m_row[0], pData + (size_t) dwRow * dwPitch);
+        }
+        return true;
+    }
+
+private:
+    void ConvertRow(const CMP_BYTE* pSrc, CMP_BYTE* pDest)
+    {
+        // Float rows are stored as they are
+        if(m_format != CMP_FORMAT_ARGB_8888)
+        {
+            memcpy(pDest, pSrc, m_row.size());
+            return;
+        }
+
+        bool bSwap = (m_bBGR != m_swizzle);
+        for(CMP_DWORD x = 0; x < m_dwWidth; x++, pSrc += m_dwFileBytesPerPixel, pDest += 4)
+        {
+            pDest[0] = bSwap ? pSrc[2] : pSrc[0];
+            pDest[1] = pSrc[1];
+            pDest[2] = bSwap ? pSrc[0] : pSrc[2];
+            pDest[3] = (m_bOpaque || m_dwFileBytesPerPixel < 4) ? 0xff : pSrc[3];
+        }
+    }
+
+    FILE*                   m_pFile;
+    unsigned long long      m_nDataOffset;
+    CMP_DWORD               m_dwFileBytesPerPixel;
+    bool                    m_bBottomUp;
+    bool                    m_bBGR;             // File stores blue first
+    bool                    m_bOpaque;          // File has no alpha channel
+    std::vector<CMP_BYTE>   m_row;
+};
+
+static CStreamSource* OpenTGA(FILE* pFile)
+{
+    StreamTGAHeader header;
+    if(fread(&header, sizeof(header), 1, pFile) != 1)
+        return NULL;
+
+    // Raw true colour only, RLE and colour mapped files have to be decoded in full
+    if(header.cColorMapType != 0 || header.cImageType != 2 || (header.cColorDepth != 24 && header.cColorDepth != 32))
+        return NULL;
+
+    CRawStreamSource* pSource = new CRawStreamSource(pFile, sizeof(header) + header.cIDFieldLength, header.cColorDepth / 8,
+                                                     (header.cFormatFlags & 0x20) == 0, true, false);
+    pSource->m_dwWidth  = header.nWidth;
+    pSource->m_dwHeight = header.nHeight;
+    pSource->m_format   = CMP_FORMAT_ARGB_8888;
+    return pSource;
+}
+
+static CStreamSource* OpenDDS(FILE* pFile)
+{
+    CMP_DWORD dwMagic;
+    CMP_DWORD header[DDSH_WORDS];
+    if(fread(&dwMagic, sizeof(dwMagic), 1, pFile) != 1 || dwMagic != STREAM_DDS_MAGIC)
+        return NULL;
+    if(fread(header, sizeof(header), 1, pFile) != 1 || header[DDSH_SIZE] != sizeof(header))
+        return NULL;
+
+    // Only the top level of a plain 2D texture is read
+    if(header[DDSH_CAPS2] & (STREAM_DDSCAPS2_CUBEMAP | STREAM_DDSCAPS2_VOLUME))
+        return NULL;
+
+    unsigned long long nDataOffset = sizeof(dwMagic) + sizeof(header);
+    CMP_FORMAT format   = CMP_FORMAT_Unknown;
+    CMP_DWORD  dwBytes  = 0;
+    bool       bBGR     = false;
+    bool       bOpaque  = false;
+
+    CMP_DWORD dwFourCC = (header[DDSH_PF_FLAGS] & STREAM_DDPF_FOURCC) ? header[DDSH_PF_FOURCC] : 0;
+    if(dwFourCC == FOURCC_DX10)
+    {
+        StreamDDS10Header header10;
+        if(fread(&header10, sizeof(header10), 1, pFile) != 1 || header10.arraySize > 1)
+            return NULL;
+        nDataOffset += sizeof(header10);
+
+        switch(header10.dxgiFormat)
+        {
+            case 2:  format = CMP_FORMAT_ARGB_32F;  dwBytes = 16;                break;   // R32G32B32A32_FLOAT
+            case 10: format = CMP_FORMAT_ARGB_16F;  dwBytes = 8;                 break;   // R16G16B16A16_FLOAT
+            case 28:
+            case 29: format = CMP_FORMAT_ARGB_8888; dwBytes = 4;                 break;   // R8G8B8A8_UNORM(_SRGB)
+            case 87:
+            case 91: format = CMP_FORMAT_ARGB_8888; dwBytes = 4; bBGR = true;    break;   // B8G8R8A8_UNORM(_SRGB)
+            default: return NULL;
+        }
+    }
+    else if(dwFourCC == 113)    // D3DFMT_A16B16G16R16F
+    {
+        format  = CMP_FORMAT_ARGB_16F;
+        dwBytes = 8;
+    }
+    else if(dwFourCC == 116)    // D3DFMT_A32B32G32R32F
+    {
+        format  = CMP_FORMAT_ARGB_32F;
+        dwBytes = 16;
+    }
+    else if(dwFourCC == 0 && (header[DDSH_PF_FLAGS] & STREAM_DDPF_RGB) && header[DDSH_PF_BITCOUNT] == 32)
+    {
+        if(header[DDSH_PF_RMASK] == 0x00ff0000 && header[DDSH_PF_BMASK] == 0x000000ff)
+            bBGR = true;
+        else if(header[DDSH_PF_RMASK] != 0x000000ff || header[DDSH_PF_BMASK] != 0x00ff0000)
+            return NULL;
+
+        format  = CMP_FORMAT_ARGB_8888;
+        dwBytes = 4;
+        bOpaque = !(header[DDSH_PF_FLAGS] & STREAM_DDPF_ALPHAPIXELS);
+    }
+    else
+        return NULL;
+
+    CRawStreamSource* pSource = new CRawStreamSource(pFile, nDataOffset, dwBytes, false, bBGR, bOpaque);
+    pSource->m_dwWidth  = header[DDSH_WIDTH];
+    pSource->m_dwHeight = header[DDSH_HEIGHT];
+    pSource->m_format   = format;
+    return pSource;
+}
+
+//
+// OpenEXR files, each band is decoded on the OpenEXR thread pool straight into the caller's half float rows
+//
+class CExrStreamSource : public CStreamSource
+{
+public:
+    CExrStreamSource(const char* pszFilename) : m_file(pszFilename, ExrThreadCount())
+    {
+        Box2i dataWindow = m_file.dataWindow();
+        m_nMinX     = dataWindow.min.x;
+        m_nMinY     = dataWindow.min.y;
+        m_dwWidth   = dataWindow.max.x - dataWindow.min.x + 1;
+        m_dwHeight  = dataWindow.max.y - dataWindow.min.y + 1;
+        m_format    = CMP_FORMAT_ARGB_16F;
+    }
+
+    bool ReadRows(CMP_DWORD dwFirstRow, CMP_DWORD dwNumRows, CMP_BYTE* pData, CMP_DWORD dwPitch)
+    {
+        CMP_TRACE_SCOPE("IO", "Stream Source Read");
+
+        if(dwFirstRow + dwNumRows > m_dwHeight || dwPitch % sizeof(Rgba) != 0)
+            return false;
+
+        // Rgba has the same layout as CMP_FORMAT_ARGB_16F, the frame buffer base is the
+        // address data window pixel (0, 0) would have if the band were part of a whole image
+        size_t nPitch = dwPitch / sizeof(Rgba);
+        int    nFirstY = m_nMinY + (int)dwFirstRow;
+        Rgba*  pBase = (Rgba*)pData - m_nMinX - (ptrdiff_t)nFirstY * (ptrdiff_t)nPitch;
+
+        try
+        {
+            m_file.setFrameBuffer(pBase, 1, nPitch);
+            m_file.readPixels(nFirstY, nFirstY + (int)dwNumRows - 1);
+        }
+        catch(const std::exception&)
+        {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    RgbaInputFile   m_file;
+    int             m_nMinX;
+    int             m_nMinY;
+};
+
+static CStreamSource* OpenEXR(const char* pszFilename)
+{
+    try
+    {
+        return new CExrStreamSource(pszFilename);
+    }
+    catch(const std::exception&)
+    {
+        return NULL;
+    }
+}
+
+CStreamSource* OpenStreamSource(const char* pszFilename)
+{
+    CStreamSource* pSource = NULL;
+    if(IsFileExt(pszFilename, ".exr"))
+    {
+        pSource = OpenEXR(pszFilename);
+        if(!pSource)
+            return NULL;
+    }
+    else
+    {
+        FILE* pFile = NULL;
+        if(fopen_s(&pFile, pszFilename, "rb") != 0 || pFile == NULL)
+            return NULL;
+
+        if(IsFileExt(pszFilename, ".tga"))
+            pSource = OpenTGA(pFile);
+        else if(IsFileExt(pszFilename, ".dds"))
+            pSource = OpenDDS(pFile);
+
+        if(!pSource)
+        {
+            fclose(pFile);
+            return NULL;
+        }
+    }
+
+    if(pSource->m_dwWidth == 0 || pSource->m_dwHeight == 0)
+    {
+        delete pSource;
+        return NULL;
+    }
+    return pSource;
+}
+
+// OpenGL internal formats of the compressed formats the KTX plugin writes
+static CMP_DWORD GetKTXInternalFormat(CMP_FORMAT format, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight)
+{
+    static const struct { CMP_BYTE w, h; } astcBlocks[] =
+    {
+        { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+        { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+    };
+
+    switch(format)
+    {
+        case CMP_FORMAT_BC1:
+        case CMP_FORMAT_DXT1:                   return 0x83F1;  // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+        case CMP_FORMAT_BC2:
+        case CMP_FORMAT_DXT3:                   return 0x83F2;  // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+        case CMP_FORMAT_BC3:
+        case CMP_FORMAT_DXT5:                   return 0x83F3;  // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+        case CMP_FORMAT_BC4:                    return 0x8DBB;  // GL_COMPRESSED_RED_RGTC1
+        case CMP_FORMAT_BC5:                    return 0x8DBD;  // GL_COMPRESSED_RG_RGTC2
+        case CMP_FORMAT_BC6H:                   return 0x8E8F;  // GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
+        case CMP_FORMAT_BC6H_SF:                return 0x8E8E;  // GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT
+        case CMP_FORMAT_BC7:                    return 0x8E8C;  // GL_COMPRESSED_RGBA_BPTC_UNORM
+        case CMP_FORMAT_ATC_RGB:                return 0x8C92;  // ATC_RGB_AMD
+        case CMP_FORMAT_ATC_RGBA_Explicit:      return 0x8C93;  // ATC_RGBA_EXPLICIT_ALPHA_AMD
+        case CMP_FORMAT_ATC_RGBA_Interpolated:  return 0x87EE;  // ATC_RGBA_INTERPOLATED_ALPHA_AMD
+        case CMP_FORMAT_ETC_RGB:                return 0x8D64;  // ETC1_RGB8_OES
+        case CMP_FORMAT_ETC2_RGB:               return 0x9274;  // GL_COMPRESSED_RGB8_ETC2
+        case CMP_FORMAT_ETC2_RGBA:              return 0x9278;  // GL_COMPRESSED_RGBA8_ETC2_EAC
+        case CMP_FORMAT_EAC_R11:                return 0x9270;  // GL_COMPRESSED_R11_EAC
+        case CMP_FORMAT_EAC_R11_SIGNED:         return 0x9271;  // GL_COMPRESSED_SIGNED_R11_EAC
+        case CMP_FORMAT_EAC_RG11:               return 0x9272;  // GL_COMPRESSED_RG11_EAC
+        case CMP_FORMAT_EAC_RG11_SIGNED:        return 0x9273;  // GL_COMPRESSED_SIGNED_RG11_EAC
+        case CMP_FORMAT_ASTC:
+            for(int i = 0; i < (int)(sizeof(astcBlocks) / sizeof(astcBlocks[0])); i++)
+            {
+                if(astcBlocks[i].w == nBlockWidth && astcBlocks[i].h == nBlockHeight)
+                    return 0x93B0 + i;                          // GL_COMPRESSED_RGBA_ASTC_WxH_KHR
+            }
+            return 0x93B0;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// DXGI formats of the compressed formats the DDS plugin writes with a DX10 header
+static CMP_DWORD GetDDSDXGIFormat(CMP_FORMAT format)
+{
+    switch(format)
+    {
+        case CMP_FORMAT_BC6H:       return 95;      // DXGI_FORMAT_BC6H_UF16
+        case CMP_FORMAT_BC6H_SF:    return 96;      // DXGI_FORMAT_BC6H_SF16
+        case CMP_FORMAT_BC7:        return 98;      // DXGI_FORMAT_BC7_UNORM
+        default:                    break;
+    }
+    return 0;
+}
+
+CStreamWriter::CStreamWriter() : m_pFile(NULL), m_bKTX(false), m_nLevel(0), m_nWritten(0), m_nChunk(0), m_nChunkUsed(0),
+                                 m_nPendingChunk(0), m_nPending(0), m_bStop(false), m_bError(false)
+{
+    m_pChunks[0] = NULL;
+    m_pChunks[1] = NULL;
+}
+
+CStreamWriter::~CStreamWriter()
+{
+    // Still open, the caller gave up part way through the levels
+    bool bAbandoned = (m_pFile != NULL);
+    Release();
+    if(bAbandoned)
+        remove(m_strFilename.c_str());
+}
+
+void CStreamWriter::Release()
+{
+    StopWriterThread();
+
+    if(m_pFile)
+    {
+        fclose(m_pFile);
+        m_pFile = NULL;
+    }
+
+    for(int i = 0; i < 2; i++)
+    {
+        if(m_pChunks[i])
+            VirtualFree(m_pChunks[i], 0, MEM_RELEASE);
+        m_pChunks[i] = NULL;
+    }
+}
+
+bool CStreamWriter::Open(const char* pszFilename, CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, int nMipLevels)
+{
+    Release();
+
+    m_bKTX = IsFileExt(pszFilename, ".ktx");
+    if((!m_bKTX && !IsFileExt(pszFilename, ".dds")) || nMipLevels < 1)
+        return false;
+
+    // Size of one block, levels are sized in 64 bits as they can pass 4GB
+    CMP_Texture block;
+    memset(&block, 0, sizeof(block));
+    block.dwSize        = sizeof(block);
+    block.format        = format;
+    block.nBlockWidth   = (format == CMP_FORMAT_ASTC && nBlockWidth)  ? nBlockWidth  : 4;
+    block.nBlockHeight  = (format == CMP_FORMAT_ASTC && nBlockHeight) ? nBlockHeight : 4;
+    block.nBlockDepth   = 1;
+    block.dwWidth       = block.nBlockWidth;
+    block.dwHeight      = block.nBlockHeight;
+    CMP_DWORD dwBlockBytes = CMP_CalculateBufferSize(&block);
+    if(dwBlockBytes == 0)
+        return false;
+
+    m_levelSizes.clear();
+    for(int nMipLevel = 0; nMipLevel < nMipLevels; nMipLevel++)
+    {
+        CMP_DWORD dwLevelWidth  = (dwWidth  >> nMipLevel) ? (dwWidth  >> nMipLevel) : 1;
+        CMP_DWORD dwLevelHeight = (dwHeight >> nMipLevel) ? (dwHeight >> nMipLevel) : 1;
+        unsigned long long nBlocksX = (dwLevelWidth  + block.nBlockWidth  - 1) / block.nBlockWidth;
+        unsigned long long nBlocksY = (dwLevelHeight + block.nBlockHeight - 1) / block.nBlockHeight;
+        m_levelSizes.push_back(nBlocksX * nBlocksY * dwBlockBytes);
+    }
+
+    m_nLevel        = 0;
+    m_nWritten      = 0;
+    m_nChunk        = 0;
+    m_nChunkUsed    = 0;
+    m_nPending      = 0;
+    m_bStop         = false;
+    m_bError        = false;
+
+    for(int i = 0; i < 2; i++)
+    {
+        m_pChunks[i] = reinterpret_cast<CMP_BYTE*>(VirtualAlloc(NULL, STREAM_WRITE_CHUNK, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+        if(m_pChunks[i] == NULL)
+        {
+            Release();
+            return false;
+        }
+    }
+
+    if(fopen_s(&m_pFile, pszFilename, "wb") != 0 || m_pFile == NULL)
+    {
+        m_pFile = NULL;
+        Release();
+        return false;
+    }
+    m_strFilename = pszFilename;
+
+    // Chunks are already as large as the writes stdio would gather
+    setvbuf(m_pFile, NULL, _IONBF, 0);
+
+    // Without the thread Flush writes each chunk itself
+    try
+    {
+        m_thread = std::thread(&CStreamWriter::WriterThread, this);
+    }
+    catch(...)
+    {
+    }
+
+    if(m_bKTX ? WriteKTXHeader(format, dwWidth, dwHeight, block.nBlockWidth, block.nBlockHeight) : WriteDDSHeader(format, dwWidth, dwHeight))
+        return true;
+
+    Release();
+    remove(pszFilename);
+    return false;
+}
+
+unsigned long long CStreamWriter::GetLevelSize(int nMipLevel) const
+{
+    if(nMipLevel < 0 || nMipLevel >= (int) m_levelSizes.size())
+        return 0;
+    return m_levelSizes[nMipLevel];
+}
+
+bool CStreamWriter::WriteDDSHeader(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight)
+{
+    // Same headers as SaveDDS_FourCC and SaveDDS_DX10 in the DDS plugin
+    MipSet mipset;
+    memset(&mipset, 0, sizeof(mipset));
+    Format2FourCC(format, &mipset);
+
+    CMP_DWORD header[DDSH_WORDS];
+    memset(header, 0, sizeof(header));
+    header[DDSH_SIZE]           = sizeof(header);
+    header[DDSH_HEIGHT]         = dwHeight;
+    header[DDSH_WIDTH]          = dwWidth;
+    header[DDSH_MIPMAPCOUNT]    = (CMP_DWORD) m_levelSizes.size();
+    header[DDSH_PF_SIZE]        = 32;
+    header[DDSH_PF_FLAGS]       = STREAM_DDPF_FOURCC;
+    header[DDSH_PF_FOURCC]      = mipset.m_dwFourCC;
+
+    StreamDDS10Header header10;
+    memset(&header10, 0, sizeof(header10));
+    if(mipset.m_dwFourCC == FOURCC_DX10)
+    {
+        header10.dxgiFormat         = GetDDSDXGIFormat(format);
+        header10.resourceDimension  = 3;    // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+        header10.arraySize          = 1;
+        if(header10.dxgiFormat == 0)
+            return false;
+
+        header[DDSH_FLAGS]  = STREAM_DDSD_WIDTH | STREAM_DDSD_HEIGHT;
+        header[DDSH_PITCH]  = dwWidth * 4;
+        header[DDSH_CAPS]   = STREAM_DDSCAPS_TEXTURE;
+        if(m_levelSizes.size() > 1)
+        {
+            header[DDSH_FLAGS] |= STREAM_DDSD_MIPMAPCOUNT;
+            header[DDSH_CAPS]  |= STREAM_DDSCAPS_MIPMAP;
+        }
+    }
+    else
+    {
+        header[DDSH_FLAGS]          = STREAM_DDSD_CAPS | STREAM_DDSD_WIDTH | STREAM_DDSD_HEIGHT | STREAM_DDSD_PIXELFORMAT | STREAM_DDSD_MIPMAPCOUNT | STREAM_DDSD_LINEARSIZE;
+        header[DDSH_PITCH]          = m_levelSizes[0] > 0xffffffff ? 0 : (CMP_DWORD) m_levelSizes[0];
+        header[DDSH_PF_FLAGS]      |= STREAM_DDPF_ALPHAPIXELS;
+        header[DDSH_PF_BITCOUNT]    = mipset.m_dwFourCC2;
+        header[DDSH_CAPS]           = STREAM_DDSCAPS_TEXTURE | STREAM_DDSCAPS_COMPLEX | STREAM_DDSCAPS_MIPMAP;
+    }
+
+    CMP_DWORD dwMagic = STREAM_DDS_MAGIC;
+    if(!Append(&dwMagic, sizeof(dwMagic)) || !Append(header, sizeof(header)))
+        return false;
+    if(mipset.m_dwFourCC == FOURCC_DX10 && !Append(&header10, sizeof(header10)))
+        return false;
+    return true;
+}
+
+bool CStreamWriter::WriteKTXHeader(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight)
+{
+    static const CMP_BYTE identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    CMP_DWORD dwInternalFormat = GetKTXInternalFormat(format, nBlockWidth, nBlockHeight);
+    if(dwInternalFormat == 0)
+        return false;
+
+    // KTX 1 stores the level sizes in 32 bits
+    for(size_t i = 0; i < m_levelSizes.size(); i++)
+    {
+        if(m_levelSizes[i] > 0xffffffff)
+            return false;
+    }
+
+    CMP_DWORD header[13] =
+    {
+        STREAM_KTX_ENDIANNESS,
+        0,                      // glType
+        1,                      // glTypeSize
+        0,                      // glFormat
+        dwInternalFormat,
+        0x1908,                 // glBaseInternalFormat GL_RGBA
+        dwWidth,
+        dwHeight,
+        0,                      // pixelDepth
+        0,                      // numberOfArrayElements
+        1,                      // numberOfFaces
+        (CMP_DWORD) m_levelSizes.size(),
+        0,                      // bytesOfKeyValueData
+    };
+
+    // Each imageSize is written by Write as its level starts
+    return Append(identifier, sizeof(identifier)) && Append(header, sizeof(header));
+}
+
+bool CStreamWriter::Write(const CMP_BYTE* pData, CMP_DWORD dwSize)
+{
+    CMP_TRACE_SCOPE("IO", "Stream Writer Write");
+
+    if(!m_pFile)
+        return false;
+
+    while(dwSize > 0)
+    {
+        if(m_nLevel >= (int) m_levelSizes.size())
+            return false;
+
+        if(m_nWritten == 0 && m_bKTX)
+        {
+            CMP_DWORD dwImageSize = (CMP_DWORD) m_levelSizes[m_nLevel];
+            if(!Append(&dwImageSize, sizeof(dwImageSize)))
+                return false;
+        }
+
+        unsigned long long nLeft = m_levelSizes[m_nLevel] - m_nWritten;
+        CMP_DWORD dwPart = (dwSize < nLeft) ? dwSize : (CMP_DWORD) nLeft;
+        if(!Append(pData, dwPart))
+            return false;
+
+        pData       += dwPart;
+        dwSize      -= dwPart;
+        m_nWritten  += dwPart;
+
+        // Block sizes are a multiple of 4 so KTX needs no mip padding
+        if(m_nWritten == m_levelSizes[m_nLevel])
+        {
+            m_nLevel++;
+            m_nWritten = 0;
+        }
+    }
+
+    return true;
+}
+
+bool CStreamWriter::Append(const void* pData, size_t nSize)
+{
+    const CMP_BYTE* pSrc = reinterpret_cast<const CMP_BYTE*>(pData);
+    while(nSize > 0)
+    {
+        size_t nPart = STREAM_WRITE_CHUNK - m_nChunkUsed;
+        if(nPart > nSize)
+            nPart = nSize;
+
+        memcpy(m_pChunks[m_nChunk] + m_nChunkUsed, pSrc, nPart);
+        m_nChunkUsed    += nPart;
+        pSrc            += nPart;
+        nSize           -= nPart;
+
+        if(m_nChunkUsed == STREAM_WRITE_CHUNK && !Flush())
+            return false;
+    }
+    return true;
+}
+
+bool CStreamWriter::Flush()
+{
+    if(m_nChunkUsed == 0)
+        return true;
+
+    if(!m_thread.joinable())
+    {
+        bool bOK = fwrite(m_pChunks[m_nChunk], 1, m_nChunkUsed, m_pFile) == m_nChunkUsed;
+        m_nChunkUsed = 0;
+        return bOK;
+    }
+
+    {
+        // The chunk handed over last time must reach the disk before another is queued
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(m_nPending != 0)
+            m_cv.wait(lock);
+        if(m_bError)
+            return false;
+
+        m_nPendingChunk = m_nChunk;
+        m_nPending      = m_nChunkUsed;
+    }
+    m_cv.notify_all();
+
+    m_nChunk     ^= 1;
+    m_nChunkUsed  = 0;
+    return true;
+}
+
+void CStreamWriter::WriterThread()
+{
+    CMP_TRACE_THREAD_NAME("Stream Writer");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for(;;)
+    {
+        while(m_nPending == 0 && !m_bStop)
+            m_cv.wait(lock);
+        if(m_nPending == 0)
+            break;
+
+        const CMP_BYTE* pData = m_pChunks[m_nPendingChunk];
+        size_t nSize = m_nPending;
+        lock.unlock();
+
+        bool bOK;
+        {
+            CMP_TRACE_SCOPE("IO", "Stream Writer Flush");
+            bOK = fwrite(pData, 1, nSize, m_pFile) == nSize;
+        }
+
+        lock.lock();
+        if(!bOK)
+            m_bError = true;
+        m_nPending = 0;
+        m_cv.notify_all();
+    }
+}
+
+void CStreamWriter::StopWriterThread()
+{
+    if(!m_thread.joinable())
+        return;
+
+    // Any chunk still pending is written before the thread exits
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_bStop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+bool CStreamWriter::Close()
+{
+    if(!m_pFile)
+        return false;
+
+    bool bOK = Flush();
+    StopWriterThread();
+
+    bOK = bOK && !m_bError && (m_nLevel == (int) m_levelSizes.size());
+    if(fclose(m_pFile) != 0)
+        bOK = false;
+    m_pFile = NULL;
+
+    Release();
+    if(!bOK)
+        remove(m_strFilename.c_str());
+    return bOK;
+}
@@ -0,0 +1,111 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//=====================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// TextureStream.h : Row sources and block row writers for streamed compression
+//
+
+#ifndef _TEXTURESTREAM_H_
+#define _TEXTURESTREAM_H_
+
+#include "Compressonator.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//
+// An image file read a band of rows at a time, rows are returned top down
+//
+class CStreamSource
+{
+public:
+    CStreamSource() : m_dwWidth(0), m_dwHeight(0), m_format(CMP_FORMAT_Unknown), m_swizzle(false) {}
+    virtual ~CStreamSource() {}
+
+    // Reads dwNumRows rows in m_format starting at dwFirstRow
+    virtual bool ReadRows(CMP_DWORD dwFirstRow, CMP_DWORD dwNumRows, CMP_BYTE* pData, CMP_DWORD dwPitch) = 0;
+
+    CMP_DWORD   m_dwWidth;
+    CMP_DWORD   m_dwHeight;
+    CMP_FORMAT  m_format;
+    bool        m_swizzle;      // 8 bit sources only: return BGRA rather than RGBA, as SwizzleMipMap does
+};
+
+// Opens uncompressed TGA and DDS files and OpenEXR files, returns NULL for files that can not be streamed
+CStreamSource* OpenStreamSource(const char* pszFilename);
+
+//
+// Writes the header of a DDS or KTX file and then the compressed levels in file order, top level first.
+// Data is staged in page aligned chunks that a background thread writes while the caller encodes
+// the next band or level, so each fwrite is a whole chunk at a chunk aligned file offset.
+// A file that is not closed successfully is deleted, so an error part way never leaves a truncated file.
+//
+class CStreamWriter
+{
+public:
+    CStreamWriter();
+    ~CStreamWriter();
+
+    // The file type is taken from the extension, level m is max(1, dwWidth >> m) by max(1, dwHeight >> m)
+    bool Open(const char* pszFilename, CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, int nMipLevels = 1);
+
+    // Appends whole levels or block row bands of them, the next level starts once the current one is full
+    bool Write(const CMP_BYTE* pData, CMP_DWORD dwSize);
+
+    // Fails and deletes the file if fewer bytes were written than the levels hold or a write to disk failed
+    bool Close();
+
+    // Compressed size of a level, 0 if it is not in the file
+    unsigned long long GetLevelSize(int nMipLevel) const;
+
+private:
+    bool WriteDDSHeader(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight);
+    bool WriteKTXHeader(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight);
+    bool Append(const void* pData, size_t nSize);
+    bool Flush();
+    void WriterThread();
+    void StopWriterThread();
+    void Release();
+
+    FILE*                           m_pFile;
+    std::string                     m_strFilename;
+    bool                            m_bKTX;
+    std::vector<unsigned long long> m_levelSizes;
+    int                             m_nLevel;           // Level being written
+    unsigned long long              m_nWritten;         // Bytes of m_nLevel written so far
+
+    CMP_BYTE*                       m_pChunks[2];       // Staging chunks, one filled while the other is on its way to disk
+    int                             m_nChunk;           // Chunk being filled
+    size_t                          m_nChunkUsed;
+
+    std::thread                     m_thread;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_cv;
+    int                             m_nPendingChunk;
+    size_t                          m_nPending;         // Bytes handed to the writer thread, 0 when it is idle
+    bool                            m_bStop;
+    bool                            m_bError;
+};
+
+#endif
@@ -34,6 +34,7 @@
 #include <tchar.h>
 
 #include "UtilFuncs.h"
+#include <emmintrin.h>
 
 void SwizzleBytes(void* src, unsigned long numBytes)
 {
@@ -53,6 +54,32 @@ void SwizzleBytes(void* src, unsigned long numBytes)
 		pSrc[i] = tmp[i];
 }
 
+void SwapRedBlue8888(unsigned char* pDest, const unsigned char* pSrc, size_t nPixels)
+{
+	ASSERT(pDest && pSrc);
+
+	// Green and alpha stay put, red and blue swap 16 bit halves of the masked pixel
+	const __m128i ga = _mm_set1_epi32((int)0xFF00FF00);
+	size_t i = 0;
+	for(; i + 4 <= nPixels; i += 4)
+	{
+		__m128i v  = _mm_loadu_si128((const __m128i*)(pSrc + i * 4));
+		__m128i rb = _mm_andnot_si128(ga, v);
+		rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+		_mm_storeu_si128((__m128i*)(pDest + i * 4), _mm_or_si128(_mm_and_si128(v, ga), rb));
+	}
+
+	for(; i < nPixels; i++)
+	{
+		unsigned char c0 = pSrc[i * 4 + 0];
+		unsigned char c2 = pSrc[i * 4 + 2];
+		pDest[i * 4 + 0] = c2;
+		pDest[i * 4 + 1] = pSrc[i * 4 + 1];
+		pDest[i * 4 + 2] = c0;
+		pDest[i * 4 + 3] = pSrc[i * 4 + 3];
+	}
+}
+
 typedef struct 
 {
 	TCHAR* pszName;
@@ -29,6 +29,10 @@
 #include "Windows.h"
 
 void SwizzleBytes(void* src, unsigned long numBytes);
+
+// Swaps the red and blue bytes of 32 bit pixels, BGRA <-> RGBA, four pixels at a time with SSE2.
+// pDest may be pSrc to convert in place
+void SwapRedBlue8888(unsigned char* pDest, const unsigned char* pSrc, size_t nPixels);
 HWND FindTopLevelWindow(TCHAR* pszName);
 
 #endif // !defined(_AMD_TEX_UTILSFUNCS_H_INCLUDED_)
@@ -23,6 +23,8 @@
 
 #include "stdafx.h"
 #include "cExr.h"
+#include <ImfThreading.h>
+#include <thread>
 
 float half_conv_float(unsigned short in) 
 {
@@ -53,6 +55,20 @@ float half_conv_float(unsigned short in)
     return u.f;
 }
 
+int ExrThreadCount()
+{
+    // Function statics are initialized once even when several loads start together
+    static const int nThreads = []()
+    {
+        int n = (int)std::thread::hardware_concurrency();
+        if (n < 1)
+            n = 1;
+        setGlobalThreadCount(n);
+        return n;
+    }();
+    return nThreads;
+}
+
 void Exr::fileinfo(const string inf, int &width, int &height)
 {
     RgbaInputFile file (inf.c_str());
@@ -64,7 +80,7 @@ void Exr::fileinfo(const string inf, int &width, int &height)
 
 void Exr::readRgba(const string inf, Array2D<Rgba> &pix, int &w, int &h)
 {
-    RgbaInputFile file (inf.c_str());
+    RgbaInputFile file (inf.c_str(), ExrThreadCount());
     Box2i dw = file.dataWindow();
     w  = dw.max.x - dw.min.x + 1;
     h = dw.max.y - dw.min.y + 1;
@@ -58,4 +58,8 @@ extern void Rgba2Texture(Array2D<Rgba> &pixels, CMP_HALF *data, int w, int h);
 extern void Texture2Rgba(CMP_HALF* data, Array2D<Rgba> &pixels, int w, int h, CMP_FORMAT isDeCompressed);
 extern float half_conv_float(unsigned short in);
 
+// Sizes the OpenEXR global thread pool to the CPU count on first use and returns the thread count
+// to pass to the file constructors, so line buffers and tiles are decoded in parallel
+extern int ExrThreadCount();
+
 #endif
\ No newline at end of file
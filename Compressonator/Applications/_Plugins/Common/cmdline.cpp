@@ -31,11 +31,17 @@
 #include "PluginInterface.h"
 #include "TC_PluginInternal.h"
 #include "Version.h"
+#include "CMP_Trace.h"
+#include "TextureStream.h"
+#include "TextureBundle.h"
+#include "TexturePrefetch.h"
 
 #include <ImfStandardAttributes.h>
 #include <ImathBox.h>
 #include <ImfArray.h>
 #include <imfrgba.h>
+#include <algorithm>
+#include <map>
 
 // #define SHOW_PROCESS_MEMORY
 // #define USE_COMPUTE
@@ -71,7 +77,9 @@ void PrintUsage()
 {
     AboutCompressonator();
     
-    printf("Usage: CompressonatorCLI.exe [options] SourceFile DestFile\n\n");
+    printf("Usage: CompressonatorCLI.exe [options] SourceFile DestFile\n");
+    printf("       CompressonatorCLI.exe [options] SourceFolder DestFile.ctb\n");
+    printf("       compresses every image in the folder into one texture bundle\n\n");
     printf("MipMap options:\n\n");
     printf("-nomipmap                 Turns off Mipmap generation\n");
     printf("-mipsize    <size>        The size in pixels used to determine\n");
@@ -98,11 +106,17 @@ void PrintUsage()
     printf("-UseGPUDecompress    By default decompression is done using CPU\n");
     printf("                     when set OpenGL will be used by default, this can be \n");
     printf("                     changed to DirectX or Vulkan using DecodeWith setting\n");
-    printf("-DecodeWith          Sets OpenGL, DirectX or Vulkan for GPU decompress\n");
+    printf("-DecodeWith          Sets OpenGL, DirectX, Vulkan or CPU for GPU decompress\n");
     printf("                     Default is OpenGL, UseGPUDecompress is implied when\n");
-    printf("                     this option is set\n");
+    printf("                     this option is set. CPU decodes on all cores and is\n");
+    printf("                     used automatically when the GPU decoder cannot be loaded\n");
+    printf("-DecodeBenchmark <n> Decode the first mip level n times with OpenGL, DirectX,\n");
+    printf("                     Vulkan and CPU and print the throughput of each\n");
     printf("-doswizzle           Swizzle the source images Red and Blue channels\n");
     printf("\n");
+    printf("PNG, JPEG, BMP and TIFF sources are read as 8 bit RGBA, files with 16 bit\n");
+    printf("channels are reduced to 8 bits. Use EXR sources for more precision\n");
+    printf("\n");
     printf("The following is a list of channel formats\n");
     printf("ARGB_16        ARGB format with 16-bit fixed channels\n");
     printf("ARGB_16F       ARGB format with 16-bit floating-point channels\n");
@@ -168,6 +182,19 @@ void PrintUsage()
     printf("               green channel. Eight bits per pixel\n");
     printf("ETC_RGB        Ericsson Texture Compression - Compressed RGB format.\n");
     printf("ETC2_RGB       Ericsson Texture Compression - Compressed RGB format.\n");
+    printf("ETC2_RGBA      Ericsson Texture Compression - Compressed RGB format\n");
+    printf("               with EAC compressed alpha. Eight bits per pixel\n");
+    printf("EAC_R11        EAC compressed single channel 11 bit format.\n");
+    printf("               Four bits per pixel\n");
+    printf("EAC_R11_SIGNED EAC compressed single channel signed 11 bit format.\n");
+    printf("               Four bits per pixel\n");
+    printf("EAC_RG11       EAC compressed two channel 11 bit format.\n");
+    printf("               Eight bits per pixel\n");
+    printf("EAC_RG11_SIGNED\n");
+    printf("               EAC compressed two channel signed 11 bit format.\n");
+    printf("               Eight bits per pixel\n");
+    printf("               ETC2_RGBA and the EAC formats are saved as .ktx or .ktx2,\n");
+    printf("               DDS files have no format code for them\n");
     printf("\n");
     printf("<codec options>: Reference  documentation for range of values\n\n");
     printf("-UseChannelWeighting <value> Use channel weightings\n");
@@ -183,6 +210,9 @@ void PrintUsage()
     printf("                             value can be a bit per pixel rate from 0.0 to 9.9\n");
     printf("                             or can be a combination of x and y axes with paired\n");
     printf("                             values of 4,5,6,8,10 or 12 from 4x4 to 12x12\n");
+    printf("-Speed <value>               ASTC only - named encoder preset, overrides Quality\n");
+    printf("                             value is one of fastest, fast, medium or thorough\n");
+    printf("                             presets bound the partition and block mode search\n");
     printf("-DXT1UseAlpha <value>        Encode single-bit alpha data.\n");
     printf("                             Only valid when compressing to DXT1 & BC1\n");
     printf("-OutputExposure <value>      BC6 only: Sets the resulting exposure of compressed Images\n");
@@ -196,7 +226,9 @@ void PrintUsage()
     printf("                             use a sign bit\n");
     printf("-NumThreads <value>          Number of threads to initialize for BC6H or BC7\n");
     printf("                             encoding (Max up to 128). Default set to 8\n");
-    printf("-Quality <value>             Sets quality of encoding for BC7\n");
+    printf("-Quality <value>             Sets quality of encoding for BC6H and BC7\n");
+    printf("                             for BC6H this sets how many shape partitions\n");
+    printf("                             are searched, 1.0 searches all of them\n");
     printf("-Performance <value>         Sets performance of encoding for BC7\n");
     printf("-ColourRestrict <value>      This setting is a quality tuning setting for BC7\n");
     printf("                             which may be necessary for convenience in some\n");
@@ -211,16 +243,46 @@ void PrintUsage()
     printf("\n\n");
     printf("-diff_image <image1> <image2> Generate difference between 2 images with same size \n");
     printf("                              A .bmp file will be generated. Please use compressonator GUI to increase the contrast to view the diff pixels.\n");
+    printf("-stream                      Compress a band of rows at a time without loading the whole\n");
+    printf("                             image, for uncompressed TGA or DDS and EXR sources and DDS\n");
+    printf("                             or KTX destinations. Only the top MIP level is written\n");
+    printf("-stream_rows <value>         Source rows per band with -stream (default about 64MB)\n");
+    printf("-zstd <value>                Zstandard supercompression level 1 to 22 for KTX2\n");
+    printf("                             destinations, 0 stores the MIP levels uncompressed (default 3)\n");
+    printf("-rdo <lambda>                BC1, BC3 and BC7: trade up to lambda squared error per\n");
+    printf("                             saved bit for blocks that zstd or LZ4 pack smaller, 0 to 10\n");
+    printf("                             is typical. Prints the PSNR and zstd size of the result\n");
+    printf("-rdo_window <blocks>         Preceding blocks -rdo may copy from, 1 to 1024 (default 16)\n");
+    printf("-entry <name>                Entry of a .ctb bundle source to load, or name to save\n");
+    printf("                             under in a .ctb destination (default: source file name)\n");
+    printf("-bundle_align <bytes>        Entry alignment of a new .ctb bundle, a power of two\n");
+    printf("                             (default 4096)\n");
+    printf("-prefetch <images>           Images loaded ahead of the one being compressed when the\n");
+    printf("                             source is a folder, 1 to 64 (default %d)\n", PREFETCH_DEFAULT_DEPTH);
+    printf("-prefetch_mb <MB>            Memory the images loaded ahead may hold before loading\n");
+    printf("                             waits (default %d)\n", PREFETCH_DEFAULT_BUDGET_MB);
+    printf("-arena                       Hold all compressed MIP levels in one block laid out as a\n");
+    printf("                             DDS file stores them, and reuse it for the next image\n");
+    printf("-update <file>               Previous compressed output of this image, only blocks that\n");
+    printf("                             changed are re-encoded and copied into the old data\n");
+    printf("-update_src <image>          Source image the -update file was made from, blocks are\n");
+    printf("                             compared with it at every mip level\n");
+    printf("-dirty <x,y,w,h>             Region of the source that changed, can be repeated\n");
+    printf("                             Without -update_src or -dirty every block is re-encoded\n");
     printf("\n\n");
     printf("Output options:\n\n");
     printf("-silent                      Disable print messages\n");
     printf("-performance                 Shows various performance stats\n");
     printf("-noprogress                  Disables showing of compression progress messages\n");
+    printf("-trace <file>                Records load, mip, compress, decompress, analysis and save\n");
+    printf("                             scopes on every thread to a Chrome trace-event JSON file\n");
+    printf("                             (chrome://tracing) and prints a summary per scope\n");
     printf("\n\n");
     printf("Example compression:\n\n");
     printf("CompressonatorCLI.exe -fd ASTC image.bmp result.astc \n");
     printf("CompressonatorCLI.exe -fd ASTC -BlockRate 0.8 image.bmp result.astc\n");
     printf("CompressonatorCLI.exe -fd ASTC -BlockRate 12x12 image.bmp result.astc\n");
+    printf("CompressonatorCLI.exe -fd ASTC -BlockRate 6x6 -Speed fast image.bmp result.astc\n");
     printf("CompressonatorCLI.exe -fd BC7  image.bmp result.dds \n");
     printf("CompressonatorCLI.exe -fd BC7  -NumTheads 16 image.bmp result.dds\n");
     printf("CompressonatorCLI.exe -fd BC6H image.exr result.dds\n\n");
@@ -278,6 +340,8 @@ CMP_GPUDecode DecodeWith(const  char *strParameter)
         return GPUDecode_OPENGL;
     else if (strcmp(strParameter, "Vulkan") == 0)
         return GPUDecode_VULKAN;
+    else if (strcmp(strParameter, "CPU") == 0)
+        return GPUDecode_CPU;
     else
         return GPUDecode_INVALID;
 }
@@ -321,6 +385,18 @@ bool ProcessSingleFlags(const  char *strCommand)
         isset = true;
     }
     else
+    if ((strcmp(strCommand,"-stream") == 0))
+    {
+        g_CmdPrams.use_Stream = true;
+        isset = true;
+    }
+    else
+    if ((strcmp(strCommand,"-arena") == 0))
+    {
+        g_CmdPrams.use_Arena = true;
+        isset = true;
+    }
+    else
     if ((strcmp(strCommand,"-noprogress") == 0))
     {
         g_CmdPrams.noprogressinfo = true;
@@ -411,6 +487,22 @@ bool ProcessCMDLineOptions(const  char *strCommand, const char *strParameter)
             g_CmdPrams.CompressOptions.fquality = value;
 
         }
+        else
+        if (strcmp(strCommand, "-Speed") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No Speed preset specified";
+            }
+            if      (_stricmp(strParameter, "fastest")  == 0) g_CmdPrams.CompressOptions.nASTCSpeed = CMP_ASTC_Speed_Fastest;
+            else if (_stricmp(strParameter, "fast")     == 0) g_CmdPrams.CompressOptions.nASTCSpeed = CMP_ASTC_Speed_Fast;
+            else if (_stricmp(strParameter, "medium")   == 0) g_CmdPrams.CompressOptions.nASTCSpeed = CMP_ASTC_Speed_Medium;
+            else if (_stricmp(strParameter, "thorough") == 0) g_CmdPrams.CompressOptions.nASTCSpeed = CMP_ASTC_Speed_Thorough;
+            else
+            {
+                throw "Speed preset should be one of fastest, fast, medium or thorough";
+            }
+        }
 #ifdef ENABLE_MAKE_COMPATIBLE_API  
         else
         if (strcmp(strCommand, "-InExposure") == 0)
@@ -585,11 +677,167 @@ bool ProcessCMDLineOptions(const  char *strCommand, const char *strParameter)
             g_CmdPrams.CompressOptions.nAlphaThreshold = 128;  //default to 128
         }
         else
+        if (strcmp(strCommand, "-DecodeBenchmark") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No DecodeBenchmark iteration count specified";
+            }
+            int value = std::stoi(strParameter);
+            if (value < 1)
+            {
+                throw "DecodeBenchmark iteration count should be 1 or more";
+            }
+            g_CmdPrams.DecodeBenchmark = value;
+        }
+        else
+        if (strcmp(strCommand, "-trace") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No trace file specified";
+            }
+            g_CmdPrams.TraceFile = strParameter;
+        }
+        else
+        if (strcmp(strCommand, "-stream_rows") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No band height specified";
+            }
+            g_CmdPrams.StreamBandRows = atoi(strParameter);
+            if (g_CmdPrams.StreamBandRows < 1)
+            {
+                throw "Band height must be at least 1";
+            }
+        }
+        else
+        if (strcmp(strCommand, "-zstd") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No zstd level specified";
+            }
+            g_CmdPrams.ZstdLevel = atoi(strParameter);
+            if ((g_CmdPrams.ZstdLevel < 0) || (g_CmdPrams.ZstdLevel > 22))
+            {
+                throw "zstd level must be 0 to 22";
+            }
+        }
+        else
+        if (strcmp(strCommand, "-rdo") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No RDO lambda specified";
+            }
+            float value = std::stof(strParameter);
+            if (value < 0)
+            {
+                throw "RDO lambda must be 0 or above";
+            }
+            g_CmdPrams.CompressOptions.fRDOLambda = value;
+            g_CmdPrams.ReportRDO = true;
+        }
+        else
+        if (strcmp(strCommand, "-rdo_window") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No RDO window specified";
+            }
+            int value = atoi(strParameter);
+            if ((value < 1) || (value > 1024))
+            {
+                throw "RDO window must be 1 to 1024 blocks";
+            }
+            g_CmdPrams.CompressOptions.dwRDOWindow = value;
+        }
+        else
+        if (strcmp(strCommand, "-entry") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No bundle entry name specified";
+            }
+            g_CmdPrams.BundleEntry = strParameter;
+        }
+        else
+        if (strcmp(strCommand, "-bundle_align") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No bundle alignment specified";
+            }
+            g_CmdPrams.BundleAlignment = atoi(strParameter);
+            if ((g_CmdPrams.BundleAlignment < 1) || (g_CmdPrams.BundleAlignment & (g_CmdPrams.BundleAlignment - 1)))
+            {
+                throw "Bundle alignment must be a power of two";
+            }
+        }
+        else
+        if (strcmp(strCommand, "-prefetch") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No prefetch depth specified";
+            }
+            int value = atoi(strParameter);
+            if ((value < 1) || (value > 64))
+            {
+                throw "Prefetch depth must be 1 to 64 images";
+            }
+            g_CmdPrams.PrefetchDepth = value;
+        }
+        else
+        if (strcmp(strCommand, "-prefetch_mb") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No prefetch memory budget specified";
+            }
+            int value = atoi(strParameter);
+            if (value < 1)
+            {
+                throw "Prefetch memory budget must be at least 1 MB";
+            }
+            g_CmdPrams.PrefetchBudgetMB = value;
+        }
+        else
+        if (strcmp(strCommand, "-update") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No previous compressed file specified";
+            }
+            g_CmdPrams.UpdateCmpFile = strParameter;
+        }
+        else
+        if (strcmp(strCommand, "-update_src") == 0)
+        {
+            if (strlen(strParameter) == 0)
+            {
+                throw "No previous source image specified";
+            }
+            g_CmdPrams.UpdateSourceFile = strParameter;
+        }
+        else
+        if (strcmp(strCommand, "-dirty") == 0)
+        {
+            CMP_Rect rect;
+            if (sscanf(strParameter, "%lu,%lu,%lu,%lu", &rect.x, &rect.y, &rect.dwWidth, &rect.dwHeight) != 4)
+            {
+                throw "Dirty region must be given as x,y,w,h";
+            }
+            g_CmdPrams.DirtyRects.push_back(rect);
+        }
+        else
         if (strcmp(strCommand, "-DecodeWith") == 0)
         {
             if (strlen(strParameter) == 0)
             {
-                throw "No API specified (set either OpenGL or DirectX (Default is OpenGL).";
+                throw "No API specified (set either OpenGL, DirectX, Vulkan or CPU (Default is OpenGL).";
             }
 
             g_CmdPrams.CompressOptions.nGPUDecode= DecodeWith((char *)strParameter);
@@ -889,6 +1137,10 @@ extern CMIPS*           g_CMIPS;                            // Global MIPS funct
 MipSet            g_MipSetIn;
 MipSet            g_MipSetCmp;
 MipSet            g_MipSetOut;
+MipSet            g_MipSetPrevIn;                   // Source the -update file was made from
+MipSet            g_MipSetPrevCmp;                  // Previous compressed output loaded with -update
+MipSetArena       g_MipSetCmpArena;                 // Block g_MipSetCmp levels are carved from with -arena, kept between jobs
+CTextureBundleWriter* g_pBundleWriter = NULL;       // Bundle every image of a folder is added to, NULL outside a bundle batch
 int               g_MipLevel = 1;
 float             g_fProgress = -1;
 
@@ -940,6 +1192,21 @@ bool _cdecl TC_PluginCodecSupportsFormat(const MipSet* pMipSet)
             pMipSet->m_ChannelFormat == CF_Float32);
 }
 
+void FreeUpdateMipSets()
+{
+    if (g_MipSetPrevIn.m_pMipLevelTable)
+    {
+        g_CMIPS->FreeMipSet(&g_MipSetPrevIn);
+        g_MipSetPrevIn.m_pMipLevelTable = NULL;
+    }
+
+    if (g_MipSetPrevCmp.m_pMipLevelTable)
+    {
+        g_CMIPS->FreeMipSet(&g_MipSetPrevCmp);
+        g_MipSetPrevCmp.m_pMipLevelTable = NULL;
+    }
+}
+
 void cleanup(bool Delete_gMipSetIn,bool SwizzleMipSetIn)
 {
     SetDllDirectory(NULL);
@@ -964,6 +1231,7 @@ void cleanup(bool Delete_gMipSetIn,bool SwizzleMipSetIn)
     {
         g_CMIPS->FreeMipSet(&g_MipSetCmp);
         g_MipSetCmp.m_pMipLevelTable = NULL;
+        g_CMIPS->ResetMipSetArena(&g_MipSetCmpArena);
     }
 
     if (g_MipSetOut.m_pMipLevelTable)
@@ -972,6 +1240,8 @@ void cleanup(bool Delete_gMipSetIn,bool SwizzleMipSetIn)
         g_MipSetOut.m_pMipLevelTable = NULL;
     }
 
+    FreeUpdateMipSets();
+
     if (g_CMIPS)
     {
         free(g_CMIPS);
@@ -1027,6 +1297,37 @@ void SwizzleMipMap(MipSet *pMipSet)
 
 }
 
+// Decode one texture with each decode backend and print the throughput of each,
+// backends that are not available on this machine are reported and skipped
+void BenchmarkDecode(const CMP_Texture *srcTexture, CMP_Texture *destTexture, int nIterations)
+{
+    struct
+    {
+        CMP_GPUDecode   type;
+        const char      *name;
+    } backends[] = {
+        { GPUDecode_OPENGL,  "OpenGL"  },
+        { GPUDecode_DIRECTX, "DirectX" },
+        { GPUDecode_VULKAN,  "Vulkan"  },
+        { GPUDecode_CPU,     "CPU"     },
+    };
+
+    PrintInfo("\nDecode benchmark %d x %d, %d iterations\n", srcTexture->dwWidth, srcTexture->dwHeight, nIterations);
+
+    for (int i = 0; i < sizeof(backends) / sizeof(backends[0]); i++)
+    {
+        CMP_DecodeBenchmark result;
+        if (CMP_BenchmarkDecompressTexture(srcTexture, destTexture, backends[i].type, nIterations, &result) != CMP_OK)
+            PrintInfo("%-8s failed\n", backends[i].name);
+        else if (result.DecodeType != backends[i].type)
+            PrintInfo("%-8s not available\n", backends[i].name);
+        else
+            PrintInfo("%-8s %10.2f MPixels/sec %10.3f ms per decode\n", backends[i].name, result.fMPixelsPerSec, result.fTotalTime * 1000.0 / nIterations);
+    }
+
+    CMP_ShutdownDecompessLibrary();
+}
+
 // Determine if RGB channel to BGA can be done or skipped
 // for special cases of compressed formats.
 
@@ -1079,6 +1380,9 @@ bool GenerateAnalysis(std::string SourceFile, std::string DestFile)
     Plugin_Analysis = reinterpret_cast<PluginInterface_Analysis *>(g_pluginManager.GetPlugin("IMAGE", "ANALYSIS"));
     if (Plugin_Analysis)
     {
+#ifdef USE_QT_IMAGELOAD
+        InitQtImageLoad();
+#endif
         if (g_CmdPrams.diffImage) {
             g_CmdPrams.DiffFile = DestFile;
             int lastindex = g_CmdPrams.DiffFile.find_last_of(".");
@@ -1383,8 +1687,470 @@ MipSet* DecompressMIPSet(MipSet *MipSetIn, CMP_GPUDecode decodeWith, Config *con
 }
 
 
+//
+// Records a trace for the duration of ProcessCMDLine when -trace is set,
+// the trace is written and summarised on every return path
+//
+class CTraceSession
+{
+public:
+    // A bundle batch runs ProcessCMDLine for each image inside its own session, one trace covers the batch
+    CTraceSession() : m_bActive(!g_CmdPrams.TraceFile.empty() && !s_bOpen)
+    {
+        if (!m_bActive) return;
+        s_bOpen = true;
+        CMP_TraceReset();
+        CMP_TraceEnable(true);
+        CMP_TraceSetThreadName("Main");
+        CMP_TraceMemory();
+    }
+
+    ~CTraceSession()
+    {
+        if (!m_bActive) return;
+        s_bOpen = false;
+        CMP_TraceMemory();
+        CMP_TraceEnable(false);
+        if (CMP_TraceWriteJSON(g_CmdPrams.TraceFile.c_str()) != CMP_OK)
+            PrintInfo("Error: unable to write trace file %s\n", g_CmdPrams.TraceFile.c_str());
+        else
+        if (!g_CmdPrams.silent)
+        {
+            CMP_TracePrintSummary();
+            PrintInfo("Trace written to %s\n", g_CmdPrams.TraceFile.c_str());
+        }
+    }
+
+private:
+    bool        m_bActive;
+    static bool s_bOpen;
+};
+
+bool CTraceSession::s_bOpen = false;
+
+//
+// Loads the -update and -update_src files, on any mismatch with the new source the
+// update sets are freed and the whole image is compressed as usual
+//
+bool LoadUpdateMipSets(CMP_FORMAT destFormat)
+{
+    memset(&g_MipSetPrevCmp, 0, sizeof(MipSet));
+    memset(&g_MipSetPrevIn, 0, sizeof(MipSet));
+
+    if (AMDLoadMIPSTextureImage(g_CmdPrams.UpdateCmpFile.c_str(), &g_MipSetPrevCmp, false) != 0)
+    {
+        PrintInfo("Warning: unable to load %s, compressing the whole image\n", g_CmdPrams.UpdateCmpFile.c_str());
+        FreeUpdateMipSets();
+        return false;
+    }
+
+    if ((g_MipSetPrevCmp.m_format != destFormat) ||
+        (g_MipSetPrevCmp.m_nWidth != g_MipSetIn.m_nWidth) || (g_MipSetPrevCmp.m_nHeight != g_MipSetIn.m_nHeight))
+    {
+        PrintInfo("Warning: %s does not match the destination format or image size, compressing the whole image\n", g_CmdPrams.UpdateCmpFile.c_str());
+        FreeUpdateMipSets();
+        return false;
+    }
+
+    if (g_CmdPrams.UpdateSourceFile.length() == 0)
+        return true;
+
+    // Loaded the same way as the new source so the pixels compare like for like
+    g_MipSetPrevIn.m_nBlockWidth  = g_MipSetIn.m_nBlockWidth;
+    g_MipSetPrevIn.m_nBlockHeight = g_MipSetIn.m_nBlockHeight;
+    g_MipSetPrevIn.m_nBlockDepth  = g_MipSetIn.m_nBlockDepth;
+    g_MipSetPrevIn.m_Flags        = g_MipSetIn.m_Flags;
+    g_MipSetPrevIn.m_swizzle      = g_MipSetIn.m_swizzle;
+
+    if (AMDLoadMIPSTextureImage(g_CmdPrams.UpdateSourceFile.c_str(), &g_MipSetPrevIn, g_CmdPrams.use_OCV) != 0)
+    {
+        PrintInfo("Warning: unable to load %s, compressing the whole image\n", g_CmdPrams.UpdateSourceFile.c_str());
+        FreeUpdateMipSets();
+        return false;
+    }
+
+    if ((g_MipSetPrevIn.m_format != g_MipSetIn.m_format) ||
+        (g_MipSetPrevIn.m_nWidth != g_MipSetIn.m_nWidth) || (g_MipSetPrevIn.m_nHeight != g_MipSetIn.m_nHeight))
+    {
+        PrintInfo("Warning: %s does not match the source format or image size, compressing the whole image\n", g_CmdPrams.UpdateSourceFile.c_str());
+        FreeUpdateMipSets();
+        return false;
+    }
+
+    if (g_MipSetPrevIn.m_swizzle)
+        SwizzleMipMap(&g_MipSetPrevIn);
+
+    return true;
+}
+
+//
+// Scales the -dirty regions down to a mip level, a one pixel margin is kept below
+// the top level as the mip filter reads neighbouring pixels
+//
+void GetMipDirtyRects(int nMipLevel, const MipLevel* pMipLevel, std::vector<CMP_Rect>& rects)
+{
+    rects.clear();
+    for (size_t i = 0; i < g_CmdPrams.DirtyRects.size(); i++)
+    {
+        const CMP_Rect& src = g_CmdPrams.DirtyRects[i];
+        CMP_DWORD x0 = src.x >> nMipLevel;
+        CMP_DWORD y0 = src.y >> nMipLevel;
+        CMP_DWORD x1 = (src.x + src.dwWidth  + (1 << nMipLevel) - 1) >> nMipLevel;
+        CMP_DWORD y1 = (src.y + src.dwHeight + (1 << nMipLevel) - 1) >> nMipLevel;
+
+        if (nMipLevel > 0)
+        {
+            if (x0 > 0) x0--;
+            if (y0 > 0) y0--;
+            x1++;
+            y1++;
+        }
+
+        if (x1 > (CMP_DWORD)pMipLevel->m_nWidth)  x1 = pMipLevel->m_nWidth;
+        if (y1 > (CMP_DWORD)pMipLevel->m_nHeight) y1 = pMipLevel->m_nHeight;
+        if (x0 >= x1 || y0 >= y1)
+            continue;
+
+        CMP_Rect rect;
+        rect.x        = x0;
+        rect.y        = y0;
+        rect.dwWidth  = x1 - x0;
+        rect.dwHeight = y1 - y0;
+        rects.push_back(rect);
+    }
+}
+
+//
+// -rdo report: the PSNR of the compressed levels against their sources, and the size of
+// all the levels packed together by zstd, as a game package would store them
+//
+typedef struct
+{
+    double                  fSquaredError;
+    unsigned long long      ullSamples;
+    std::vector<CMP_BYTE>   compressedData;
+} RDOReport;
+
+// KTX2 plugin, the zstd build the tool links is only used through it
+extern size_t KTX2_SupercompressedSize(const void* pData, size_t nSize, int nLevel);
+
+static void AddRDOReportLevel(RDOReport& report, const CMP_Texture& srcTexture, CMP_Texture& destTexture)
+{
+    report.compressedData.insert(report.compressedData.end(), destTexture.pData, destTexture.pData + destTexture.dwDataSize);
+
+    // The source has been prepared for the codec, decoding to its format gives the same channel order
+    if ((srcTexture.format != CMP_FORMAT_ARGB_8888) && (srcTexture.format != CMP_FORMAT_RGBA_8888) && (srcTexture.format != CMP_FORMAT_BGRA_8888))
+        return;
+
+    CMP_Texture decodedTexture = srcTexture;
+    decodedTexture.dwPitch    = srcTexture.dwWidth * 4;
+    decodedTexture.dwDataSize = CMP_CalculateBufferSize(&decodedTexture);
+    std::vector<CMP_BYTE> decodedData(decodedTexture.dwDataSize);
+    decodedTexture.pData = &decodedData[0];
+
+    CMP_CompressOptions options = g_CmdPrams.CompressOptions;
+    options.fRDOLambda = 0;
+    if (CMP_ConvertTexture(&destTexture, &decodedTexture, &options, NULL, NULL, NULL) != CMP_OK)
+        return;
+
+    // Alpha is left out, it is byte 3 in all three formats
+    CMP_DWORD dwSrcPitch = srcTexture.dwPitch ? srcTexture.dwPitch : srcTexture.dwWidth * 4;
+    for (CMP_DWORD y = 0; y < srcTexture.dwHeight; y++)
+    {
+        const CMP_BYTE* pSrc     = srcTexture.pData + y * dwSrcPitch;
+        const CMP_BYTE* pDecoded = decodedTexture.pData + y * decodedTexture.dwPitch;
+        for (CMP_DWORD x = 0; x < srcTexture.dwWidth * 4; x += 4)
+        {
+            for (int ch = 0; ch < 3; ch++)
+            {
+                double d = (double)pSrc[x + ch] - (double)pDecoded[x + ch];
+                report.fSquaredError += d * d;
+            }
+        }
+    }
+    report.ullSamples += (unsigned long long)srcTexture.dwWidth * srcTexture.dwHeight * 3;
+}
+
+static void PrintRDOReport(const RDOReport& report)
+{
+    if (report.ullSamples > 0)
+    {
+        if (report.fSquaredError > 0)
+            PrintInfo("RDO: RGB PSNR %.2f dB\n", 10.0 * log10(255.0 * 255.0 * report.ullSamples / report.fSquaredError));
+        else
+            PrintInfo("RDO: RGB PSNR infinite, no error\n");
+    }
+
+    if (report.compressedData.empty())
+        return;
+
+    int nLevel = g_CmdPrams.ZstdLevel > 0 ? g_CmdPrams.ZstdLevel : 3;
+    size_t nPacked = KTX2_SupercompressedSize(&report.compressedData[0], report.compressedData.size(), nLevel);
+    if (nPacked == 0)
+    {
+        PrintInfo("RDO: zstd compression failed\n");
+        return;
+    }
+
+    PrintInfo("RDO: %llu bytes compressed, %llu bytes after zstd level %d (%.1f%%)\n",
+              (unsigned long long)report.compressedData.size(), (unsigned long long)nPacked, nLevel,
+              100.0 * nPacked / report.compressedData.size());
+}
+
+typedef struct
+{
+    CStreamSource*  pSource;
+    CStreamWriter*  pWriter;
+} StreamIO;
+
+static CMP_ERROR CMP_API StreamReadRows(CMP_DWORD dwFirstRow, CMP_DWORD dwNumRows, CMP_BYTE* pData, CMP_DWORD dwPitch, void* pUser)
+{
+    StreamIO* pIO = (StreamIO*)pUser;
+    return pIO->pSource->ReadRows(dwFirstRow, dwNumRows, pData, dwPitch) ? CMP_OK : CMP_ERR_INVALID_SOURCE_TEXTURE;
+}
+
+static CMP_ERROR CMP_API StreamWriteBlockRows(CMP_DWORD /*dwFirstBlockRow*/, CMP_DWORD /*dwNumBlockRows*/, const CMP_BYTE* pData, CMP_DWORD dwDataSize, void* pUser)
+{
+    StreamIO* pIO = (StreamIO*)pUser;
+    return pIO->pWriter->Write(pData, dwDataSize) ? CMP_OK : CMP_ERR_GENERIC;
+}
+
+//
+// -stream: the source is read a band at a time and each compressed band goes straight
+// to the destination file, so memory use depends on the band height and not the image size
+//
+int ProcessStreamedCMDLine(CMP_Feedback_Proc pFeedbackProc)
+{
+    CMP_TRACE_SCOPE("App", "Streamed Compression");
+
+    CMP_FORMAT destFormat = g_CmdPrams.DestFormat;
+    if (!CompressedFormat(destFormat) || g_CmdPrams.CompressOptions.bUseGPUCompress)
+    {
+        PrintInfo("Error: -stream needs a compressed destination format and CPU compression\n");
+        return -1;
+    }
+
+    CStreamSource* pSource = OpenStreamSource(g_CmdPrams.SourceFile.c_str());
+    if (!pSource)
+    {
+        PrintInfo("Error: %s can not be streamed, use an uncompressed TGA or DDS file or an EXR file\n", g_CmdPrams.SourceFile.c_str());
+        return -1;
+    }
+
+    // Same channel order as the SwizzleMipMap path
+#ifdef USE_SWIZZLE
+    pSource->m_swizzle = KeepSwizzle(destFormat);
+#endif
+    if (g_CmdPrams.noswizzle)
+        pSource->m_swizzle = false;
+    if (g_CmdPrams.doswizzle)
+        pSource->m_swizzle = true;
+
+#ifndef ENABLE_MAKE_COMPATIBLE_API
+    if (FloatFormat(pSource->m_format) != FloatFormat(destFormat))
+    {
+        delete pSource;
+        PrintInfo("Error: Processing floating point format <-> non-floating point format is not supported\n");
+        return -1;
+    }
+#endif
+
+    CStreamWriter writer;
+    if (!writer.Open(g_CmdPrams.DestFile.c_str(), destFormat, pSource->m_dwWidth, pSource->m_dwHeight, (CMP_BYTE)g_CmdPrams.BlockWidth, (CMP_BYTE)g_CmdPrams.BlockHeight))
+    {
+        delete pSource;
+        PrintInfo("Error: unable to write %s, -stream writes %s to DDS or KTX files only\n", g_CmdPrams.DestFile.c_str(), GetFormatDesc(destFormat));
+        return -1;
+    }
+
+    StreamIO io;
+    io.pSource = pSource;
+    io.pWriter = &writer;
+
+    CMP_TextureStream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.dwSize       = sizeof(stream);
+    stream.dwWidth      = pSource->m_dwWidth;
+    stream.dwHeight     = pSource->m_dwHeight;
+    stream.sourceFormat = pSource->m_format;
+    stream.destFormat   = destFormat;
+    stream.nBlockWidth  = (CMP_BYTE)g_CmdPrams.BlockWidth;
+    stream.nBlockHeight = (CMP_BYTE)g_CmdPrams.BlockHeight;
+    stream.dwBandHeight = g_CmdPrams.StreamBandRows;
+    stream.pReadProc    = StreamReadRows;
+    stream.pWriteProc   = StreamWriteBlockRows;
+    stream.pUser        = &io;
+
+    PrintInfo("Streaming source width = %d px  height = %d px\n", stream.dwWidth, stream.dwHeight);
+
+    LARGE_INTEGER frequency, startTime, endTime;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&startTime);
+
+    g_MipLevel  = 1;
+    g_fProgress = -1;
+    CMP_ERROR result = CMP_ConvertTextureStream(&stream, &g_CmdPrams.CompressOptions, pFeedbackProc, NULL, NULL);
+
+    QueryPerformanceCounter(&endTime);
+    delete pSource;
+
+    if (!writer.Close() || (result != CMP_OK))
+    {
+        remove(g_CmdPrams.DestFile.c_str());
+        PrintInfo("Error in streamed compression of destination texture\n");
+        return -1;
+    }
+
+    g_CmdPrams.conversion_fDuration = ((double)(endTime.QuadPart - startTime.QuadPart)) / ((double)frequency.QuadPart);
+    if ((!g_CmdPrams.silent) && (g_CmdPrams.showperformance))
+        PrintInfo("\rStreamed to %s in %.3f seconds\n", GetFormatDesc(destFormat), g_CmdPrams.conversion_fDuration);
+
+    if (!g_CmdPrams.silent)
+    {
+#ifdef USE_WITH_COMMANDLINE_TOOL
+        PrintInfo("\rDone                                                  \n");
+#else
+        PrintInfo("Done\n");
+#endif
+    }
+
+    return 0;
+}
+
+// Saves a destination MipSet under the -entry name or the source file name when the destination is
+// a bundle. In a bundle batch it goes to the open bundle writer instead of opening the file again
+static int SaveDestination(MipSet* pMipSet)
+{
+    pMipSet->m_nSupercompressionLevel = g_CmdPrams.ZstdLevel;
+
+    std::string Entry = g_CmdPrams.BundleEntry.empty() ? boost::filesystem::path(g_CmdPrams.SourceFile).stem().string() : g_CmdPrams.BundleEntry;
+    if (g_pBundleWriter)
+        return g_pBundleWriter->AddEntry(Entry.c_str(), pMipSet, g_CMIPS) ? 0 : -1;
+
+    pMipSet->m_pszEntryName = Entry.c_str();
+    int result = AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), pMipSet, g_CmdPrams.use_OCV_out);
+    pMipSet->m_pszEntryName = NULL;
+    return result;
+}
+
+static bool IsBundleBatch()
+{
+    return boost::filesystem::is_directory(g_CmdPrams.SourceFile) &&
+           (_stricmp(boost::filesystem::extension(g_CmdPrams.DestFile).c_str(), ".ctb") == 0);
+}
+
+//
+// A folder source and a .ctb destination: every image in the folder is compressed into the bundle,
+// each entry named after its file without the extension, two files that give the same name stop the
+// run before anything is written. The prefetcher loads the next images while one is compressed and
+// the bundle writer thread writes the finished ones, so loads, compression and writes overlap.
+//
+int ProcessBundleCMDLine(CMP_Feedback_Proc pFeedbackProc)
+{
+    CMP_TRACE_SCOPE("App", "ProcessBundleCMDLine");
+
+    if (g_CmdPrams.doDecompress)
+    {
+        PrintInfo("Error: -decomp can not be used when compressing a folder into a bundle\n");
+        return -1;
+    }
+
+    std::vector<std::string> SourceFiles;
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator it(g_CmdPrams.SourceFile, ec), end; !ec && (it != end); it.increment(ec))
+    {
+        if (boost::filesystem::is_regular_file(it->status()) && (_stricmp(it->path().extension().string().c_str(), ".ctb") != 0))
+            SourceFiles.push_back(it->path().string());
+    }
+    std::sort(SourceFiles.begin(), SourceFiles.end());
+
+    if (SourceFiles.empty())
+    {
+        PrintInfo("Error: %s has no images to bundle\n", g_CmdPrams.SourceFile.c_str());
+        return -1;
+    }
+
+    // Entries are named by the file name without its extension, a.png and a.tga would replace each other
+    std::vector<std::string>           EntryNames;
+    std::map<std::string, std::string> EntryFiles;
+    bool                               bDuplicates = false;
+    for (size_t i = 0; i < SourceFiles.size(); i++)
+    {
+        EntryNames.push_back(boost::filesystem::path(SourceFiles[i]).stem().string());
+        std::map<std::string, std::string>::iterator it = EntryFiles.find(EntryNames[i]);
+        if (it != EntryFiles.end())
+        {
+            PrintInfo("Error: %s and %s would both be added as entry %s\n", it->second.c_str(), SourceFiles[i].c_str(), EntryNames[i].c_str());
+            bDuplicates = true;
+        }
+        else
+            EntryFiles[EntryNames[i]] = SourceFiles[i];
+    }
+    if (bDuplicates)
+        return -1;
+
+    CTextureBundleWriter writer;
+    if (!writer.Open(g_CmdPrams.DestFile.c_str(), (g_CmdPrams.BundleAlignment > 0) ? g_CmdPrams.BundleAlignment : CTB_DEFAULT_ALIGNMENT))
+    {
+        PrintInfo("Error: unable to open bundle %s\n", g_CmdPrams.DestFile.c_str());
+        return -1;
+    }
+
+    std::string SourceFolder = g_CmdPrams.SourceFile;
+    std::string BundleEntry  = g_CmdPrams.BundleEntry;
+    int         nAdded       = 0;
+    g_pBundleWriter = &writer;
+    {
+        int nPrefetchDepth    = (g_CmdPrams.PrefetchDepth > 0) ? g_CmdPrams.PrefetchDepth : PREFETCH_DEFAULT_DEPTH;
+        int nPrefetchBudgetMB = (g_CmdPrams.PrefetchBudgetMB > 0) ? g_CmdPrams.PrefetchBudgetMB : PREFETCH_DEFAULT_BUDGET_MB;
+        CTexturePrefetcher prefetcher(SourceFiles, nPrefetchDepth, (unsigned long long)nPrefetchBudgetMB * 1024 * 1024);
+
+        for (size_t i = 0; i < SourceFiles.size(); i++)
+        {
+            g_CmdPrams.SourceFile  = SourceFiles[i];
+            g_CmdPrams.BundleEntry = EntryNames[i];
+
+            MipSet* pMipSet = prefetcher.Acquire(i);
+            if (pMipSet == NULL)
+            {
+                PrintInfo("Warning: skipping %s, unable to load the image\n", SourceFiles[i].c_str());
+                continue;
+            }
+
+            if (!g_CmdPrams.silent)
+                PrintInfo("%s\n", SourceFiles[i].c_str());
+
+            // The prefetched image is passed as a user MipSet, it is restored and not freed afterwards
+            if (ProcessCMDLine(pFeedbackProc, pMipSet) == 0)
+                nAdded++;
+            prefetcher.Release(i);
+        }
+
+        if ((!g_CmdPrams.silent) && (g_CmdPrams.showperformance))
+            PrintInfo("Loaded %d images in %.3f seconds on I/O threads, compression waited %.3f seconds for them\n",
+                      (int)prefetcher.GetLoadCount(), prefetcher.GetLoadTime(), prefetcher.GetStallTime());
+    }
+    g_pBundleWriter        = NULL;
+    g_CmdPrams.SourceFile  = SourceFolder;
+    g_CmdPrams.BundleEntry = BundleEntry;
+
+    if (!writer.Close())
+    {
+        PrintInfo("Error: writing bundle %s\n", g_CmdPrams.DestFile.c_str());
+        return -1;
+    }
+
+    if (!g_CmdPrams.silent)
+        PrintInfo("%d of %d images added to %s\n", nAdded, (int)SourceFiles.size(), g_CmdPrams.DestFile.c_str());
+
+    return (nAdded == (int)SourceFiles.size()) ? 0 : -1;
+}
+
 int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
 {
+    CTraceSession   traceSession;
+    CMP_TRACE_SCOPE("App", "ProcessCMDLine");
+
     LARGE_INTEGER   frequency,
                     conversion_loopStartTime    = {0},
                     conversion_loopEndTime      = {0},
@@ -1394,6 +2160,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                     decompress_loopEndTime      = {0};
     int             compress_nIterations        =0,
                     decompress_nIterations      =0;
+    double          decompress_nPixels          =0;     // texels decoded, used for the decode throughput
 
     // These flags indicate if the source and destination files are compressed
     bool            SourceFormatIsCompressed        = false;
@@ -1442,6 +2209,12 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
             return 0;
         }
 
+        //================================================
+        // A folder of images into one texture bundle
+        //================================================
+        if (!p_userMipSetIn && IsBundleBatch())
+            return ProcessBundleCMDLine(pFeedbackProc);
+
         QueryPerformanceFrequency(&frequency);
 
         // ==========================
@@ -1449,6 +2222,16 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
         // ==========================
         g_CMIPS = (CMIPS*) new(MyCMIPS);
 
+        //================================================
+        // Streamed compression, the source is never held
+        //================================================
+        if (g_CmdPrams.use_Stream && !p_userMipSetIn)
+        {
+            int result = ProcessStreamedCMDLine(pFeedbackProc);
+            cleanup(false, false);
+            return result;
+        }
+
         // ---------
         // Input
         // ---------
@@ -1522,12 +2305,17 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
             // Set user specification for Block sizes
             //----------------------------------------
 
+            // Entry to load when the source is a bundle
+            if (!g_CmdPrams.BundleEntry.empty())
+                g_MipSetIn.m_pszEntryName = g_CmdPrams.BundleEntry.c_str();
+
             if (AMDLoadMIPSTextureImage(g_CmdPrams.SourceFile.c_str(), &g_MipSetIn, g_CmdPrams.use_OCV) != 0)
             {
                 cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
                 PrintInfo("Error: loading image, data type not supported.\n");
                 return -1;
             }
+            CMP_TRACE_MEMORY();
         }
 
         if (g_CmdPrams.showperformance)
@@ -1594,6 +2382,18 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                 SwizzleMipMap(&g_MipSetIn);
         }
 
+        //=====================================================
+        // Load the previous output for an incremental update
+        // ===================================================
+        bool UpdateDestination = false;
+        if (!p_userMipSetIn && (g_CmdPrams.UpdateCmpFile.length() > 0))
+        {
+            if (SourceFormatIsCompressed || !DestinationFormatIsCompressed || g_CmdPrams.CompressOptions.bUseGPUCompress)
+                PrintInfo("Warning: -update needs an uncompressed source, a compressed destination and CPU compression\n");
+            else
+                UpdateDestination = LoadUpdateMipSets(destFormat);
+        }
+
         //======================================================
         // Determine if MIP mapping is required
         // if so generate the MIP levels for the source file
@@ -1614,7 +2414,10 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                     nMinSize = CalcMinMipSize(g_MipSetIn.m_nHeight, g_MipSetIn.m_nWidth, g_CmdPrams.MipsLevel);
 
                 plugin_Filter->TC_GenerateMIPLevels(&g_MipSetIn, nMinSize);
+                if (g_MipSetPrevIn.m_pMipLevelTable && (g_MipSetPrevIn.m_nMipLevels == 1))
+                    plugin_Filter->TC_GenerateMIPLevels(&g_MipSetPrevIn, nMinSize);
                 delete plugin_Filter;
+                CMP_TRACE_MEMORY();
             }
             else
             {
@@ -1624,10 +2427,22 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
             }
         }
 
+        if (UpdateDestination)
+        {
+            if ((g_MipSetPrevCmp.m_nMipLevels != g_MipSetIn.m_nMipLevels) ||
+                (g_MipSetPrevIn.m_pMipLevelTable && (g_MipSetPrevIn.m_nMipLevels != g_MipSetIn.m_nMipLevels)))
+            {
+                PrintInfo("Warning: -update files do not have %d MIP levels, compressing the whole image\n", g_MipSetIn.m_nMipLevels);
+                FreeUpdateMipSets();
+                UpdateDestination = false;
+            }
+        }
+
         // --------------------------------
         // Setup Compressed Mip Set
         // --------------------------------
         CMP_FORMAT   cmpformat = CMP_FORMAT_Unknown;
+        bool         DestinationWritten = false;    // Levels went straight to the destination file as they were compressed
         memset(&g_MipSetCmp, 0, sizeof(MipSet));
         g_MipSetCmp.m_Flags = MS_FLAG_Default;
 
@@ -1666,15 +2481,73 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                g_MipSetCmp.m_format     = destFormat;
                Format2FourCC(destFormat,&g_MipSetCmp);
 
+               if (g_CmdPrams.use_Arena)
+               {
+                   // One block sized for the whole chain, laid out as a DDS file stores it so the DDS writers save it in one write
+                   CMP_Texture blockTexture;
+                   memset(&blockTexture, 0, sizeof(blockTexture));
+                   blockTexture.dwSize       = sizeof(blockTexture);
+                   blockTexture.nBlockWidth  = (CMP_BYTE)g_CmdPrams.BlockWidth;
+                   blockTexture.nBlockHeight = (CMP_BYTE)g_CmdPrams.BlockHeight;
+                   blockTexture.dwWidth      = (destFormat == CMP_FORMAT_ASTC) ? g_CmdPrams.BlockWidth  : 4;
+                   blockTexture.dwHeight     = (destFormat == CMP_FORMAT_ASTC) ? g_CmdPrams.BlockHeight : 4;
+                   blockTexture.format       = destFormat;
+
+                   if (!g_CMIPS->AttachMipSetArena(&g_MipSetCmp, &g_MipSetCmpArena, g_MipSetIn.m_nMipLevels,
+                                                   blockTexture.dwWidth, blockTexture.dwHeight, CMP_CalculateBufferSize(&blockTexture), true))
+                       PrintInfo("Warning: unable to reserve the -arena block, MIP levels are allocated separately\n");
+               }
+
                CMP_Texture srcTexture;
                srcTexture.dwSize = sizeof(srcTexture);
                int DestMipLevel = g_MipSetIn.m_nMipLevels;
 
+               // When nothing reads g_MipSetCmp after saving, each level is written to the DDS or KTX file
+               // as soon as it is compressed, overlapping disk I/O with the next level and keeping only
+               // one level resident. Formats the writer can not describe still go through the plugins.
+               // Returning on an error leaves directWriter open, its destructor then deletes the partial file.
+               CStreamWriter           directWriter;
+               std::vector<CMP_BYTE>   directLevelData;
+               if (!g_CmdPrams.use_Arena && !g_CmdPrams.doDecompress && !g_CmdPrams.use_OCV_out && !UpdateDestination &&
+                   (g_MipSetIn.m_TextureType == TT_2D) && !IsDestinationUnCompressed(g_CmdPrams.DestFile.c_str()) &&
+                   directWriter.Open(g_CmdPrams.DestFile.c_str(), destFormat, g_MipSetIn.m_nWidth, g_MipSetIn.m_nHeight,
+                                     (CMP_BYTE)g_CmdPrams.BlockWidth, (CMP_BYTE)g_CmdPrams.BlockHeight, DestMipLevel))
+               {
+                   DestinationWritten = true;
+
+                   // The writer halves each level, chains sized any other way are saved by the plugin
+                   for (int nMipLevel = 0; DestinationWritten && (nMipLevel < DestMipLevel); nMipLevel++)
+                   {
+                       MipLevel* pInMipLevel = g_CMIPS->GetMipLevel(&g_MipSetIn, nMipLevel, 0);
+                       CMP_Texture levelTexture;
+                       memset(&levelTexture, 0, sizeof(levelTexture));
+                       levelTexture.dwSize       = sizeof(levelTexture);
+                       levelTexture.dwWidth      = pInMipLevel->m_nWidth;
+                       levelTexture.dwHeight     = pInMipLevel->m_nHeight;
+                       levelTexture.nBlockWidth  = (CMP_BYTE)g_CmdPrams.BlockWidth;
+                       levelTexture.nBlockHeight = (CMP_BYTE)g_CmdPrams.BlockHeight;
+                       levelTexture.format       = destFormat;
+                       DestinationWritten = (CMP_CalculateBufferSize(&levelTexture) == directWriter.GetLevelSize(nMipLevel));
+                   }
+
+                   // Closing short of the levels deletes the file again
+                   if (!DestinationWritten)
+                       directWriter.Close();
+               }
+
                if (g_CmdPrams.showperformance)
                    QueryPerformanceCounter(&compress_loopStartTime);
 
+               CMP_DWORD dwBlocksUpdated = 0;
+               CMP_DWORD dwBlocksTotal   = 0;
+               RDOReport rdoReport;
+               rdoReport.fSquaredError = 0;
+               rdoReport.ullSamples    = 0;
+               std::vector<CMP_Rect> mipDirtyRects;
+
                for(int nMipLevel=0; nMipLevel<DestMipLevel; nMipLevel++)
                {        
+                    CMP_TRACE_SCOPE("App", "Compress Mip Level");
                     g_MipLevel = nMipLevel+1;
 
                     for (int nFaceOrSlice = 0; nFaceOrSlice < MaxFacesOrSlices(&g_MipSetIn, nMipLevel); nFaceOrSlice++)
@@ -1719,16 +2592,26 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                                 destTexture.dwDataSize,
                                 srcTexture.dwDataSize / (float)destTexture.dwDataSize);
 
-                        MipLevel* pOutMipLevel = g_CMIPS->GetMipLevel(&g_MipSetCmp, nMipLevel, nFaceOrSlice);
-                        if (!g_CMIPS->AllocateCompressedMipLevelData(pOutMipLevel, destTexture.dwWidth, destTexture.dwHeight, destTexture.dwDataSize))
+                        if (DestinationWritten)
                         {
-                            PrintInfo("Memory Error(1): allocating MIPSet compression level data buffer\n");
-                            cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
-
-                            return -1;
+                            // One buffer sized by the top level is reused down the chain
+                            if (directLevelData.size() < destTexture.dwDataSize)
+                                directLevelData.resize(destTexture.dwDataSize);
+                            destTexture.pData = &directLevelData[0];
                         }
+                        else
+                        {
+                            MipLevel* pOutMipLevel = g_CMIPS->GetMipLevel(&g_MipSetCmp, nMipLevel, nFaceOrSlice);
+                            if (!g_CMIPS->AllocateCompressedMipLevelData(pOutMipLevel, destTexture.dwWidth, destTexture.dwHeight, destTexture.dwDataSize))
+                            {
+                                PrintInfo("Memory Error(1): allocating MIPSet compression level data buffer\n");
+                                cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+
+                                return -1;
+                            }
 
-                        destTexture.pData = pOutMipLevel->m_pbData;
+                            destTexture.pData = pOutMipLevel->m_pbData;
+                        }
                         g_fProgress = -1;
 
                         //========================
@@ -1815,6 +2698,52 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                         }
                         else
 #endif
+                        if (UpdateDestination)
+                        {
+                            MipLevel* pPrevCmpMipLevel = g_CMIPS->GetMipLevel(&g_MipSetPrevCmp, nMipLevel, nFaceOrSlice);
+                            if (!pPrevCmpMipLevel || !pPrevCmpMipLevel->m_pbData || ((CMP_DWORD)pPrevCmpMipLevel->m_dwLinearSize != destTexture.dwDataSize))
+                            {
+                                PrintInfo("Error: MIP level %d of %s does not match the destination\n", nMipLevel, g_CmdPrams.UpdateCmpFile.c_str());
+                                cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                                return -1;
+                            }
+
+                            CMP_Texture prevDestTexture = destTexture;
+                            prevDestTexture.pData = pPrevCmpMipLevel->m_pbData;
+
+                            CMP_Texture  prevSrcTexture;
+                            CMP_Texture* pPrevSrcTexture = NULL;
+                            if (g_MipSetPrevIn.m_pMipLevelTable)
+                            {
+                                MipLevel* pPrevInMipLevel = g_CMIPS->GetMipLevel(&g_MipSetPrevIn, nMipLevel, nFaceOrSlice);
+                                prevSrcTexture = srcTexture;
+                                prevSrcTexture.pData = pPrevInMipLevel->m_pbData;
+                                pPrevSrcTexture = &prevSrcTexture;
+                            }
+
+                            GetMipDirtyRects(nMipLevel, pInMipLevel, mipDirtyRects);
+
+                            CMP_DWORD dwBlocksEncoded = 0;
+                            if (!pPrevSrcTexture && (g_CmdPrams.DirtyRects.size() > 0) && (mipDirtyRects.size() == 0))
+                            {
+                                // Nothing changed at this level
+                                memcpy(destTexture.pData, prevDestTexture.pData, destTexture.dwDataSize);
+                            }
+                            else
+                            if (CMP_UpdateTexture(&srcTexture, pPrevSrcTexture, mipDirtyRects.size() > 0 ? &mipDirtyRects[0] : NULL, (CMP_DWORD)mipDirtyRects.size(),
+                                                  &prevDestTexture, &destTexture, &g_CmdPrams.CompressOptions, pFeedbackProc, NULL, NULL, &dwBlocksEncoded) != CMP_OK)
+                            {
+                                PrintInfo("Error in updating destination texture\n");
+                                cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                                return -1;
+                            }
+
+                            int nBlockWidth  = (destTexture.nBlockWidth  > 0) && (destFormat == CMP_FORMAT_ASTC) ? destTexture.nBlockWidth  : 4;
+                            int nBlockHeight = (destTexture.nBlockHeight > 0) && (destFormat == CMP_FORMAT_ASTC) ? destTexture.nBlockHeight : 4;
+                            dwBlocksUpdated += dwBlocksEncoded;
+                            dwBlocksTotal   += ((destTexture.dwWidth + nBlockWidth - 1) / nBlockWidth) * ((destTexture.dwHeight + nBlockHeight - 1) / nBlockHeight);
+                        }
+                        else
                         {
 
                             if (CMP_ConvertTexture(&srcTexture, &destTexture, &g_CmdPrams.CompressOptions, pFeedbackProc, NULL, NULL) != CMP_OK)
@@ -1825,6 +2754,16 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                             }
                         }
 
+                        if (g_CmdPrams.ReportRDO)
+                            AddRDOReportLevel(rdoReport, srcTexture, destTexture);
+
+                        if (DestinationWritten && !directWriter.Write(destTexture.pData, destTexture.dwDataSize))
+                        {
+                            PrintInfo("Error: writing %s\n", g_CmdPrams.DestFile.c_str());
+                            cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                            return -1;
+                        }
+
                         if (g_CmdPrams.showperformance)
                                     compress_nIterations++;
 
@@ -1832,9 +2771,26 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                     g_MipSetCmp.m_nMipLevels++;
                 }
 
+                if (DestinationWritten && !directWriter.Close())
+                {
+                    PrintInfo("Error: writing %s\n", g_CmdPrams.DestFile.c_str());
+                    cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
+                    return -1;
+                }
+
                 if (g_CmdPrams.showperformance)
                     QueryPerformanceCounter(&compress_loopEndTime);
 
+                if (UpdateDestination)
+                {
+                    PrintInfo("Updated %lu of %lu blocks\n", dwBlocksUpdated, dwBlocksTotal);
+                    FreeUpdateMipSets();
+                }
+
+                if (g_CmdPrams.ReportRDO)
+                    PrintRDOReport(rdoReport);
+                CMP_TRACE_MEMORY();
+
                 srcFormat    = destFormat;
 
                 // for printing info about what compression was used
@@ -1852,6 +2808,8 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
         if ((!SourceFormatIsCompressed) && (DestinationFormatIsCompressed)
             &&
             !IsDestinationUnCompressed((const char *)g_CmdPrams.DestFile.c_str())
+            &&
+            !DestinationWritten
             )
         {
             //-------------------------------------------------------------
@@ -1861,7 +2819,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
             g_MipSetCmp.m_nBlockHeight = g_CmdPrams.BlockHeight;
             g_MipSetCmp.m_nBlockDepth  = g_CmdPrams.BlockDepth;
 
-            if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), &g_MipSetCmp, g_CmdPrams.use_OCV_out) != 0)
+            if (SaveDestination(&g_MipSetCmp) != 0)
             {
                 PrintInfo("Error: saving image or format is unsupported\n");
                 cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
@@ -2013,6 +2971,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
 
                     for(int nMipLevel=0; nMipLevel<p_MipSetIn->m_nMipLevels; nMipLevel++)
                     {
+                        CMP_TRACE_SCOPE("App", "Decompress Mip Level");
                         MipLevel* pInMipLevel = g_CMIPS->GetMipLevel(p_MipSetIn, nMipLevel, nFaceOrSlice);
                         if(!pInMipLevel)
                         {
@@ -2076,9 +3035,12 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
 
                         g_fProgress = -1;
 
+                        if ((g_CmdPrams.DecodeBenchmark > 0) && (nMipLevel == 0) && (nFaceOrSlice == 0))
+                            BenchmarkDecode(&srcTexture, &destTexture, g_CmdPrams.DecodeBenchmark);
+
                         if (use_GPUDecode)
                         {
-                            if (srcTexture.format == CMP_FORMAT_ASTC)
+                            if ((srcTexture.format == CMP_FORMAT_ASTC) && (DecodeWith != GPUDecode_CPU))
                             {
                                 PrintInfo("Decompress Error: ASTC decompressed with GPU is not supported yet. Please view ASTC compressed images using CPU.\n");
                                 cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
@@ -2104,7 +3066,10 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                         }
 
                         if (g_CmdPrams.showperformance)
+                        {
                                         decompress_nIterations++;
+                                        decompress_nPixels += (double)nMipWidth * nMipHeight;
+                        }
 
                         pMipData += srcTexture.dwDataSize;
                         nMipWidth = (nMipWidth>1) ? (nMipWidth>>1) : 1;
@@ -2114,6 +3079,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
 
                 if (g_CmdPrams.showperformance)
                     QueryPerformanceCounter(&decompress_loopEndTime);
+                CMP_TRACE_MEMORY();
 
                 g_MipSetOut.m_nMipLevels = p_MipSetIn->m_nMipLevels;
 
@@ -2148,7 +3114,7 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                 p_MipSetOut->m_nBlockHeight = g_CmdPrams.BlockHeight;
                 p_MipSetOut->m_nBlockDepth  = g_CmdPrams.BlockDepth;
 
-                if (AMDSaveMIPSTextureImage(g_CmdPrams.DestFile.c_str(), p_MipSetOut, g_CmdPrams.use_OCV_out) != 0)
+                if (SaveDestination(p_MipSetOut) != 0)
                 {
                     PrintInfo(" Error: saving image or destination format is unsupported by Qt\n");
                     cleanup(Delete_gMipSetIn, SwizzledMipSetIn);
@@ -2190,6 +3156,11 @@ int ProcessCMDLine(CMP_Feedback_Proc pFeedbackProc, MipSet *p_userMipSetIn)
                  decompress_nIterations, 
                  decompress_fDuration);
 
+       if (decompress_nIterations && (decompress_fDuration > 0))
+       PrintInfo("Decode throughput for %s: %.2f MPixels/sec\n",
+                 GetFormatDesc(srcFormat),
+                 (decompress_nPixels / 1000000.0) / decompress_fDuration);
+
        PrintInfo("Total time taken (includes file I/O): %.3f seconds\n", g_CmdPrams.conversion_fDuration);
     }
 
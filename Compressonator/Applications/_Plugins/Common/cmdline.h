@@ -26,6 +26,7 @@
 
 #include <windows.h>
 #include <string>
+#include <vector>
 #include <tchar.h>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
@@ -54,6 +55,13 @@ public:
         SourceFile              = "";
         DestFile                = "";
         DecompressFile          = "";
+        UpdateSourceFile        = "";
+        UpdateCmpFile           = "";
+        BundleEntry             = "";
+        BundleAlignment         = 0;
+        PrefetchDepth           = 0;
+        PrefetchBudgetMB        = 0;
+        DirtyRects.clear();
         use_WIC                 = false;
         use_OCV                 = false;
         use_WIC_out             = false;
@@ -73,6 +81,12 @@ public:
         BlockHeight             = 4;
         BlockDepth              = 1;
         conversion_fDuration    = 0;
+        DecodeBenchmark         = 0;
+        use_Stream              = false;
+        StreamBandRows          = 0;
+        use_Arena               = false;
+        ZstdLevel               = 3;
+        ReportRDO               = false;
         memset(&CompressOptions, 0, sizeof(CompressOptions));
         CompressOptions.dwSize              = sizeof(CompressOptions);
         CompressOptions.nCompressionSpeed   = (CMP_Speed)CMP_Speed_Normal;
@@ -94,6 +108,14 @@ public:
     std::string                 DestFile;               //
     std::string                 DiffFile;                // Diff image file name
     std::string                 DecompressFile;         //
+    std::string                 TraceFile;              // Chrome trace-event JSON written after processing, tracing is off when empty
+    std::string                 UpdateSourceFile;       // Source image the previous compressed output was made from, used to find changed blocks
+    std::string                 UpdateCmpFile;          // Previous compressed output, only changed blocks are re-encoded when set
+    std::vector<CMP_Rect>       DirtyRects;             // Changed regions of the source image, used with UpdateCmpFile
+    std::string                 BundleEntry;            // Entry of a .ctb source to load, or to save under in a .ctb destination, the source file name when empty
+    int                         BundleAlignment;        // Entry alignment in bytes of a new .ctb destination, 0 for the default page alignment
+    int                         PrefetchDepth;          // Images loaded ahead when bundling a folder, 0 for PREFETCH_DEFAULT_DEPTH
+    int                         PrefetchBudgetMB;       // Memory in MB the prefetched images may hold when bundling a folder, 0 for PREFETCH_DEFAULT_BUDGET_MB
     CMP_FORMAT               SourceFormat;           //
     CMP_FORMAT               DestFormat;             //
     CMP_CompressOptions      CompressOptions;        //
@@ -109,6 +131,12 @@ public:
     bool                        analysis;               // run analysis
     bool                        diffImage;              // generate diff image
     bool                        showperformance;        //
+    int                         DecodeBenchmark;        // Number of timed decodes per backend when comparing GPU and CPU decode, 0 is off
+    bool                        use_Stream;             // Compress band by band without loading the whole source
+    int                         StreamBandRows;         // Source rows per band with use_Stream, 0 for the library default
+    bool                        use_Arena;              // Carve the compressed MIP levels from one block that is reused between jobs
+    int                         ZstdLevel;              // Zstandard supercompression level of KTX2 destinations, 0 stores the levels uncompressed
+    bool                        ReportRDO;              // Print the PSNR and zstd size of the compressed levels, set by -rdo
     bool                        noprogressinfo;         //
     bool                        use_noMipMaps;          //  use of image loads based on Open CV Components in place of raw image plugins for write to file
     bool                        use_WIC;                //  use of image loads based on Windows Imagaing Components in place of raw image plugins for read from file
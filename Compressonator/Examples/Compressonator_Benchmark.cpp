@@ -0,0 +1,742 @@
+//=====================================================================
+// Copyright 2016 (c), Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// Compressonator_Benchmark.cpp : Measures encode and decode throughput of every codec
+// on synthetic textures generated in memory and writes the results as JSON.
+//
+// Usage: CMPBenchmark [options]
+//   -size <n>            Width and height of the generated textures (default 256)
+//   -runs <n>            Timed encodes and decodes per configuration (default 5)
+//   -quality <q,q,..>    Quality levels (default 0.05,0.5,1.0)
+//   -threads <t,t,..>    Thread counts, 0 is all cores (default 1,0)
+//   -format <f,f,..>     Only run these formats, names as in -list
+//   -corpus <c,c,..>     Only run these corpora, names as in -list
+//   -out <file>          Write JSON to file instead of stdout
+//   -tag <text>          Free text stored in the JSON, e.g. a commit id
+//   -list                Print the formats and corpora and exit
+//
+// The corpora are generated from a fixed seed so results are comparable between runs,
+// commits and machines.
+//
+
+#define NOMINMAX                    // Use std::min and std::max
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "Compressonator.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <intrin.h>
+#pragma comment(lib,"psapi.lib")
+#else
+#include <sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef _DEBUG
+
+#ifdef  BUILD_MTd_DLL
+#pragma comment(lib,"Compressonator_MTd_DLL.lib")
+#endif
+
+#ifdef  BUILD_MDd_DLL
+#pragma comment(lib,"Compressonator_MDd_DLL.lib")
+#endif
+
+#ifdef  BUILD_MTd
+#pragma comment(lib,"Compressonator_MTd.lib")
+#endif
+
+#ifdef  BUILD_MDd
+#pragma comment(lib,"Compressonator_MDd.lib")
+#endif
+
+#else  // Building Release
+
+#ifdef  BUILD_MT_DLL
+#pragma comment(lib,"Compressonator_MT_DLL.lib")
+#endif
+
+#ifdef  BUILD_MD_DLL
+#pragma comment(lib,"Compressonator_MD_DLL.lib")
+#endif
+
+#ifdef  BUILD_MT
+#pragma comment(lib,"Compressonator_MT.lib")
+#endif
+
+#ifdef  BUILD_MD
+#pragma comment(lib,"Compressonator_MD.lib")
+#endif
+
+#endif
+
+// Byte offsets of the channels in CMP_FORMAT_ARGB_8888 memory, as read by the codec buffers
+#define BYTE_B  0
+#define BYTE_G  1
+#define BYTE_R  2
+#define BYTE_A  3
+
+// Channels a format stores, used to restrict PSNR to meaningful data
+#define CH_R    0x1
+#define CH_G    0x2
+#define CH_B    0x4
+#define CH_A    0x8
+#define CH_RGB  (CH_R | CH_G | CH_B)
+#define CH_RGBA (CH_RGB | CH_A)
+
+typedef struct
+{
+    CMP_FORMAT  format;
+    const char  *name;
+    int         channels;       // CH_ mask of the stored channels
+    bool        hdr;            // Encodes float sources
+    bool        usesSpeed;      // nCompressionSpeed changes the encoder
+} BenchFormat;
+
+static const BenchFormat g_Formats[] =
+{
+    { CMP_FORMAT_BC1,                   "BC1",                  CH_RGB,  false, true  },
+    { CMP_FORMAT_BC2,                   "BC2",                  CH_RGBA, false, true  },
+    { CMP_FORMAT_BC3,                   "BC3",                  CH_RGBA, false, true  },
+    { CMP_FORMAT_BC4,                   "BC4",                  CH_R,    false, true  },
+    { CMP_FORMAT_BC5,                   "BC5",                  CH_R | CH_G, false, true },
+    { CMP_FORMAT_BC6H,                  "BC6H",                 CH_RGB,  true,  false },
+    { CMP_FORMAT_BC6H_SF,               "BC6H_SF",              CH_RGB,  true,  false },
+    { CMP_FORMAT_BC7,                   "BC7",                  CH_RGBA, false, false },
+    { CMP_FORMAT_ATI1N,                 "ATI1N",                CH_R,    false, true  },
+    { CMP_FORMAT_ATI2N,                 "ATI2N",                CH_R | CH_G, false, true },
+    { CMP_FORMAT_DXT5_xGBR,             "DXT5_xGBR",            CH_RGB,  false, true  },
+    { CMP_FORMAT_DXT5_RxBG,             "DXT5_RxBG",            CH_RGB,  false, true  },
+    { CMP_FORMAT_DXT5_RBxG,             "DXT5_RBxG",            CH_RGB,  false, true  },
+    { CMP_FORMAT_DXT5_xRBG,             "DXT5_xRBG",            CH_RGB,  false, true  },
+    { CMP_FORMAT_DXT5_RGxB,             "DXT5_RGxB",            CH_RGB,  false, true  },
+    { CMP_FORMAT_DXT5_xGxR,             "DXT5_xGxR",            CH_R | CH_G, false, true },
+    { CMP_FORMAT_ATC_RGB,               "ATC_RGB",              CH_RGB,  false, true  },
+    { CMP_FORMAT_ATC_RGBA_Explicit,     "ATC_RGBA_Explicit",    CH_RGBA, false, true  },
+    { CMP_FORMAT_ATC_RGBA_Interpolated, "ATC_RGBA_Interpolated",CH_RGBA, false, true  },
+    { CMP_FORMAT_ETC_RGB,               "ETC_RGB",              CH_RGB,  false, false },
+    { CMP_FORMAT_ETC2_RGB,              "ETC2_RGB",             CH_RGB,  false, false },
+    { CMP_FORMAT_ETC2_RGBA,             "ETC2_RGBA",            CH_RGBA, false, false },
+    { CMP_FORMAT_EAC_R11,               "EAC_R11",              CH_R,    false, false },
+    { CMP_FORMAT_EAC_R11_SIGNED,        "EAC_R11_SIGNED",       CH_R,    false, false },
+    { CMP_FORMAT_EAC_RG11,              "EAC_RG11",             CH_R | CH_G, false, false },
+    { CMP_FORMAT_EAC_RG11_SIGNED,       "EAC_RG11_SIGNED",      CH_R | CH_G, false, false },
+    { CMP_FORMAT_ASTC,                  "ASTC",                 CH_RGBA, false, false },
+};
+
+static const struct
+{
+    CMP_Speed   speed;
+    const char  *name;
+} g_Speeds[] =
+{
+    { CMP_Speed_Normal,     "Normal"    },
+    { CMP_Speed_Fast,       "Fast"      },
+    { CMP_Speed_SuperFast,  "SuperFast" },
+};
+
+// ASTC takes its own presets instead of nCompressionSpeed, only "Quality" depends on fquality
+static const struct
+{
+    CMP_ASTC_Speed  speed;
+    const char      *name;
+} g_ASTCSpeeds[] =
+{
+    { CMP_ASTC_Speed_Quality,   "Quality"   },
+    { CMP_ASTC_Speed_Fastest,   "Fastest"   },
+    { CMP_ASTC_Speed_Fast,      "Fast"      },
+    { CMP_ASTC_Speed_Medium,    "Medium"    },
+    { CMP_ASTC_Speed_Thorough,  "Thorough"  },
+};
+
+static int SpeedCount(const BenchFormat &fmt)
+{
+    if (fmt.format == CMP_FORMAT_ASTC)
+        return (int)(sizeof(g_ASTCSpeeds) / sizeof(g_ASTCSpeeds[0]));
+    return fmt.usesSpeed ? (int)(sizeof(g_Speeds) / sizeof(g_Speeds[0])) : 1;
+}
+
+static const char *SpeedName(const BenchFormat &fmt, int speedIndex)
+{
+    return (fmt.format == CMP_FORMAT_ASTC) ? g_ASTCSpeeds[speedIndex].name : g_Speeds[speedIndex].name;
+}
+
+//=====================================================================
+// Synthetic corpora
+//=====================================================================
+
+typedef struct
+{
+    std::string             name;
+    bool                    hdr;
+    std::vector<CMP_BYTE>   data;       // ARGB_8888 or ARGB_32F pixels
+} Corpus;
+
+// Small LCG so the corpora are identical on every platform and compiler
+static CMP_DWORD g_Seed;
+static CMP_DWORD NextRandom()
+{
+    g_Seed = g_Seed * 1664525u + 1013904223u;
+    return g_Seed >> 8;
+}
+
+static CMP_BYTE ClampByte(float v)
+{
+    return (CMP_BYTE)(v < 0.0f ? 0 : (v > 255.0f ? 255 : (int)(v + 0.5f)));
+}
+
+static void SetPixel(CMP_BYTE *pData, int size, int x, int y, CMP_BYTE r, CMP_BYTE g, CMP_BYTE b, CMP_BYTE a)
+{
+    CMP_BYTE *p = pData + (y * size + x) * 4;
+    p[BYTE_R] = r;
+    p[BYTE_G] = g;
+    p[BYTE_B] = b;
+    p[BYTE_A] = a;
+}
+
+static void MakeGradient(CMP_BYTE *pData, int size)
+{
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+        {
+            float u = (float)x / size;
+            float v = (float)y / size;
+            SetPixel(pData, size, x, y, ClampByte(255.0f * u), ClampByte(255.0f * v), ClampByte(255.0f * (1.0f - 0.5f * (u + v))), 255);
+        }
+}
+
+static void MakeNoise(CMP_BYTE *pData, int size)
+{
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+        {
+            // The high bits of an LCG are the most random ones
+            CMP_BYTE r = (CMP_BYTE)(NextRandom() >> 16);
+            CMP_BYTE g = (CMP_BYTE)(NextRandom() >> 16);
+            CMP_BYTE b = (CMP_BYTE)(NextRandom() >> 16);
+            CMP_BYTE a = (CMP_BYTE)(NextRandom() >> 16);
+            SetPixel(pData, size, x, y, r, g, b, a);
+        }
+}
+
+static void MakeNormalMap(CMP_BYTE *pData, int size)
+{
+    // Height field of overlapping bumps plus fine noise, normals from central differences
+    std::vector<float> height(size * size);
+    const int nBumps = 24;
+    float bx[nBumps], by[nBumps], br[nBumps];
+    for (int i = 0; i < nBumps; i++)
+    {
+        bx[i] = (float)(NextRandom() % size);
+        by[i] = (float)(NextRandom() % size);
+        br[i] = 4.0f + (float)(NextRandom() % (size / 6 + 1));
+    }
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+        {
+            float h = 0.05f * (float)(NextRandom() >> 16) / 255.0f;
+            for (int i = 0; i < nBumps; i++)
+            {
+                float dx = (x - bx[i]) / br[i];
+                float dy = (y - by[i]) / br[i];
+                h += expf(-(dx * dx + dy * dy));
+            }
+            height[y * size + x] = h;
+        }
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+        {
+            float hl = height[y * size + (x > 0 ? x - 1 : x)];
+            float hr = height[y * size + (x < size - 1 ? x + 1 : x)];
+            float hu = height[(y > 0 ? y - 1 : y) * size + x];
+            float hd = height[(y < size - 1 ? y + 1 : y) * size + x];
+            float nx = (hl - hr) * 4.0f;
+            float ny = (hu - hd) * 4.0f;
+            float len = sqrtf(nx * nx + ny * ny + 1.0f);
+            SetPixel(pData, size, x, y,
+                     ClampByte(127.5f * (nx / len + 1.0f)),
+                     ClampByte(127.5f * (ny / len + 1.0f)),
+                     ClampByte(127.5f * (1.0f / len + 1.0f)), 255);
+        }
+}
+
+static void MakeUI(CMP_BYTE *pData, int size)
+{
+    // Flat panels with hard edges and thin text like strokes
+    static const CMP_BYTE palette[6][3] = { { 32, 32, 36 }, { 240, 240, 240 }, { 0, 120, 215 }, { 232, 17, 35 }, { 16, 124, 16 }, { 128, 128, 128 } };
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+            SetPixel(pData, size, x, y, palette[0][0], palette[0][1], palette[0][2], 255);
+
+    for (int i = 0; i < 40; i++)
+    {
+        int x0 = NextRandom() % size, y0 = NextRandom() % size;
+        int w  = 8 + NextRandom() % (size / 3 + 1), h = 6 + NextRandom() % (size / 5 + 1);
+        const CMP_BYTE *c = palette[1 + NextRandom() % 5];
+        for (int y = y0; y < std::min(size, y0 + h); y++)
+            for (int x = x0; x < std::min(size, x0 + w); x++)
+                SetPixel(pData, size, x, y, c[0], c[1], c[2], 255);
+
+        // A line of "glyphs" inside the panel
+        int gy = y0 + 2;
+        for (int gx = x0 + 2; (gx + 3 < std::min(size, x0 + w)) && (gy + 5 < size); gx += 5)
+        {
+            CMP_DWORD glyph = NextRandom();
+            for (int k = 0; k < 15; k++)
+                if (glyph & (1 << k))
+                    SetPixel(pData, size, gx + k % 3, gy + k / 3, palette[0][0], palette[0][1], palette[0][2], 255);
+        }
+    }
+}
+
+static void MakeAlphaMask(CMP_BYTE *pData, int size)
+{
+    // Soft edged and hard edged shapes in alpha over a colour gradient
+    MakeGradient(pData, size);
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+            pData[(y * size + x) * 4 + BYTE_A] = 0;
+
+    for (int i = 0; i < 12; i++)
+    {
+        float cx = (float)(NextRandom() % size), cy = (float)(NextRandom() % size);
+        float r  = 4.0f + (float)(NextRandom() % (size / 5 + 1));
+        bool  hard = (i & 1) != 0;
+        for (int y = 0; y < size; y++)
+            for (int x = 0; x < size; x++)
+            {
+                float d = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy));
+                float a = hard ? (d < r ? 255.0f : 0.0f) : 255.0f * std::max(0.0f, std::min(1.0f, (r - d) / 4.0f + 0.5f));
+                CMP_BYTE *p = pData + (y * size + x) * 4 + BYTE_A;
+                *p = std::max(*p, ClampByte(a));
+            }
+    }
+}
+
+static void MakeHDRRamp(float *pData, int size)
+{
+    // Exponential luminance ramp from 1/64 to 64 with slowly varying hue
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+        {
+            float lum = powf(2.0f, -6.0f + 12.0f * x / size);
+            float hue = 6.2831853f * y / size;
+            float *p  = pData + (y * size + x) * 4;
+            p[0] = lum * (0.6f + 0.4f * cosf(hue));
+            p[1] = lum * (0.6f + 0.4f * cosf(hue - 2.0943951f));
+            p[2] = lum * (0.6f + 0.4f * cosf(hue + 2.0943951f));
+            p[3] = 1.0f;
+        }
+}
+
+static std::vector<Corpus> MakeCorpora(int size)
+{
+    static const char *names[] = { "gradient", "noise", "normal_map", "ui", "alpha_mask", "hdr_ramp" };
+    std::vector<Corpus> corpora;
+
+    g_Seed = 0x43504D42;    // "CMPB"
+    for (int i = 0; i < 6; i++)
+    {
+        Corpus corpus;
+        corpus.name = names[i];
+        corpus.hdr  = (i == 5);
+        corpus.data.resize((size_t)size * size * 4 * (corpus.hdr ? sizeof(float) : 1));
+        switch (i)
+        {
+        case 0: MakeGradient(&corpus.data[0], size);    break;
+        case 1: MakeNoise(&corpus.data[0], size);       break;
+        case 2: MakeNormalMap(&corpus.data[0], size);   break;
+        case 3: MakeUI(&corpus.data[0], size);          break;
+        case 4: MakeAlphaMask(&corpus.data[0], size);   break;
+        case 5: MakeHDRRamp((float *)&corpus.data[0], size); break;
+        }
+        corpora.push_back(corpus);
+    }
+    return corpora;
+}
+
+//=====================================================================
+// Measurements
+//=====================================================================
+
+typedef struct
+{
+    double  min, p50, p90, p99, max;
+} Latency;
+
+// Nearest rank percentiles of the per texture times in milliseconds
+static Latency GetLatency(std::vector<double> times)
+{
+    Latency l;
+    std::sort(times.begin(), times.end());
+    size_t n = times.size();
+    l.min = times[0];
+    l.max = times[n - 1];
+    l.p50 = times[(size_t)ceil(0.50 * n) - 1];
+    l.p90 = times[(size_t)ceil(0.90 * n) - 1];
+    l.p99 = times[(size_t)ceil(0.99 * n) - 1];
+    return l;
+}
+
+static double PSNR8(const CMP_BYTE *pSrc, const CMP_BYTE *pDec, size_t nPixels, int channels)
+{
+    static const int offsets[4] = { BYTE_R, BYTE_G, BYTE_B, BYTE_A };
+    double sum = 0;
+    int    n   = 0;
+    for (int c = 0; c < 4; c++)
+    {
+        if (!(channels & (1 << c))) continue;
+        for (size_t i = 0; i < nPixels; i++)
+        {
+            double d = (double)pSrc[i * 4 + offsets[c]] - (double)pDec[i * 4 + offsets[c]];
+            sum += d * d;
+        }
+        n++;
+    }
+    double mse = sum / ((double)nPixels * n);
+    return mse > 0 ? 10.0 * log10(255.0 * 255.0 / mse) : 999.0;
+}
+
+static double PSNRFloat(const float *pSrc, const float *pDec, size_t nPixels)
+{
+    double sum  = 0;
+    double peak = 0;
+    for (size_t i = 0; i < nPixels * 4; i++)
+    {
+        if ((i & 3) == 3) continue;
+        double d = (double)pSrc[i] - (double)pDec[i];
+        sum += d * d;
+        peak = std::max(peak, fabs((double)pSrc[i]));
+    }
+    double mse = sum / ((double)nPixels * 3);
+    return mse > 0 ? 10.0 * log10(peak * peak / mse) : 999.0;
+}
+
+static size_t GetPeakRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        return (size_t)usage.ru_maxrss * 1024;
+    return 0;
+#endif
+}
+
+static std::string GetCPUName()
+{
+    char brand[49] = { 0 };
+#if defined(_WIN32)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if ((unsigned)regs[0] >= 0x80000004)
+        for (int i = 0; i < 3; i++)
+            __cpuid((int *)(brand + 16 * i), 0x80000002 + i);
+#elif defined(__x86_64__) || defined(__i386__)
+    unsigned int regs[4];
+    if (__get_cpuid(0x80000000, &regs[0], &regs[1], &regs[2], &regs[3]) && regs[0] >= 0x80000004)
+        for (int i = 0; i < 3; i++)
+            __get_cpuid(0x80000002 + i, (unsigned int *)(brand + 16 * i), (unsigned int *)(brand + 16 * i + 4),
+                        (unsigned int *)(brand + 16 * i + 8), (unsigned int *)(brand + 16 * i + 12));
+#endif
+    std::string name(brand);
+    name.erase(0, name.find_first_not_of(' '));
+    return name.empty() ? "unknown" : name;
+}
+
+// Escapes the few characters that can appear in tags and CPU names
+static std::string JSONString(const std::string &s)
+{
+    std::string out = "\"";
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if ((s[i] == '"') || (s[i] == '\\')) out += '\\';
+        if ((unsigned char)s[i] >= 0x20) out += s[i];
+    }
+    return out + "\"";
+}
+
+//=====================================================================
+// Benchmark
+//=====================================================================
+
+typedef struct
+{
+    int                     size;
+    int                     runs;
+    std::vector<double>     qualities;
+    std::vector<int>        threads;
+    std::vector<std::string> formats;
+    std::vector<std::string> corpora;
+    std::string             outFile;
+    std::string             tag;
+} BenchConfig;
+
+static bool Selected(const std::vector<std::string> &filter, const char *name)
+{
+    return filter.empty() || (std::find(filter.begin(), filter.end(), std::string(name)) != filter.end());
+}
+
+// Runs one configuration: runs timed encodes then runs timed decodes of the last encode.
+// Returns false if the library rejected the configuration.
+static bool RunConfig(FILE *pOut, bool &first, const BenchConfig &config, const Corpus &corpus, const BenchFormat &fmt,
+                      double quality, int speedIndex, int threads)
+{
+    const int    size    = config.size;
+    const size_t nPixels = (size_t)size * size;
+    const double nBlocks = (double)((size + 3) / 4) * ((size + 3) / 4);
+    const int    nCores  = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    CMP_Texture srcTexture;
+    memset(&srcTexture, 0, sizeof(srcTexture));
+    srcTexture.dwSize       = sizeof(srcTexture);
+    srcTexture.dwWidth      = size;
+    srcTexture.dwHeight     = size;
+    srcTexture.dwPitch      = 0;
+    srcTexture.format       = corpus.hdr ? CMP_FORMAT_ARGB_32F : CMP_FORMAT_ARGB_8888;
+    srcTexture.nBlockWidth  = 4;
+    srcTexture.nBlockHeight = 4;
+    srcTexture.nBlockDepth  = 1;
+    srcTexture.dwDataSize   = CMP_CalculateBufferSize(&srcTexture);
+    srcTexture.pData        = (CMP_BYTE *)&corpus.data[0];
+
+    CMP_Texture cmpTexture  = srcTexture;
+    cmpTexture.format       = fmt.format;
+    cmpTexture.dwDataSize   = CMP_CalculateBufferSize(&cmpTexture);
+    std::vector<CMP_BYTE> cmpData(cmpTexture.dwDataSize);
+    cmpTexture.pData        = &cmpData[0];
+
+    CMP_Texture decTexture  = srcTexture;
+    std::vector<CMP_BYTE> decData(decTexture.dwDataSize);
+    decTexture.pData        = &decData[0];
+
+    CMP_CompressOptions options;
+    memset(&options, 0, sizeof(options));
+    options.dwSize                  = sizeof(options);
+    options.fquality                = quality;
+    if (fmt.format == CMP_FORMAT_ASTC)
+        options.nASTCSpeed          = g_ASTCSpeeds[speedIndex].speed;
+    else
+        options.nCompressionSpeed   = g_Speeds[speedIndex].speed;
+    options.dwnumThreads            = (threads == 0) ? nCores : threads;
+    options.bDisableMultiThreading  = (threads == 1);
+    options.dwmodeMask              = 0xCF;
+
+    std::vector<double> encodeTimes, decodeTimes;
+    for (int run = 0; run < config.runs; run++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (CMP_ConvertTexture(&srcTexture, &cmpTexture, &options, NULL, NULL, NULL) != CMP_OK)
+            return false;
+        encodeTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    for (int run = 0; run < config.runs; run++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (CMP_ConvertTexture(&cmpTexture, &decTexture, &options, NULL, NULL, NULL) != CMP_OK)
+            return false;
+        decodeTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    double psnr = corpus.hdr ? PSNRFloat((const float *)srcTexture.pData, (const float *)decTexture.pData, nPixels)
+                             : PSNR8(srcTexture.pData, decTexture.pData, nPixels, fmt.channels);
+
+    fprintf(pOut, "%s\n    {\n", first ? "" : ",");
+    first = false;
+    fprintf(pOut, "      \"corpus\": %s,\n", JSONString(corpus.name).c_str());
+    fprintf(pOut, "      \"format\": %s,\n", JSONString(fmt.name).c_str());
+    fprintf(pOut, "      \"quality\": %.3f,\n", quality);
+    fprintf(pOut, "      \"speed\": %s,\n", JSONString(SpeedName(fmt, speedIndex)).c_str());
+    fprintf(pOut, "      \"threads\": %d,\n", (threads == 0) ? nCores : threads);
+    fprintf(pOut, "      \"bits_per_pixel\": %.3f,\n", 8.0 * cmpTexture.dwDataSize / nPixels);
+    fprintf(pOut, "      \"psnr\": %.3f,\n", psnr);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Latency l = GetLatency(pass == 0 ? encodeTimes : decodeTimes);
+        fprintf(pOut, "      \"%s\": { \"blocks_per_sec\": %.1f, \"mpixels_per_sec\": %.3f, "
+                      "\"latency_ms\": { \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f } }%s\n",
+                pass == 0 ? "encode" : "decode",
+                nBlocks * 1000.0 / l.p50, (double)nPixels / (l.p50 * 1000.0),
+                l.min, l.p50, l.p90, l.p99, l.max, pass == 0 ? "," : "");
+    }
+    fprintf(pOut, "    }");
+    fflush(pOut);
+    return true;
+}
+
+static std::vector<std::string> SplitList(const char *list)
+{
+    std::vector<std::string> items;
+    std::string s(list);
+    size_t start = 0;
+    while (start <= s.size())
+    {
+        size_t end = s.find(',', start);
+        if (end == std::string::npos) end = s.size();
+        if (end > start) items.push_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    return items;
+}
+
+static void PrintList()
+{
+    printf("Formats:\n");
+    for (size_t i = 0; i < sizeof(g_Formats) / sizeof(g_Formats[0]); i++)
+        printf("  %s\n", g_Formats[i].name);
+    printf("Corpora:\n  gradient\n  noise\n  normal_map\n  ui\n  alpha_mask\n  hdr_ramp (BC6H only)\n");
+}
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config;
+    config.size      = 256;
+    config.runs      = 5;
+    config.qualities = { 0.05, 0.5, 1.0 };
+    config.threads   = { 1, 0 };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg   = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "-list") == 0)
+        {
+            PrintList();
+            return 0;
+        }
+        if (!value)
+        {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return 1;
+        }
+        i++;
+
+        if (strcmp(arg, "-size") == 0)
+            config.size = std::max(4, atoi(value));
+        else if (strcmp(arg, "-runs") == 0)
+            config.runs = std::max(1, atoi(value));
+        else if (strcmp(arg, "-quality") == 0)
+        {
+            config.qualities.clear();
+            std::vector<std::string> items = SplitList(value);
+            for (size_t q = 0; q < items.size(); q++)
+                config.qualities.push_back(atof(items[q].c_str()));
+        }
+        else if (strcmp(arg, "-threads") == 0)
+        {
+            config.threads.clear();
+            std::vector<std::string> items = SplitList(value);
+            for (size_t t = 0; t < items.size(); t++)
+                config.threads.push_back(std::max(0, atoi(items[t].c_str())));
+        }
+        else if (strcmp(arg, "-format") == 0)
+            config.formats = SplitList(value);
+        else if (strcmp(arg, "-corpus") == 0)
+            config.corpora = SplitList(value);
+        else if (strcmp(arg, "-out") == 0)
+            config.outFile = value;
+        else if (strcmp(arg, "-tag") == 0)
+            config.tag = value;
+        else
+        {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return 1;
+        }
+    }
+
+    FILE *pOut = stdout;
+    if (!config.outFile.empty())
+    {
+        pOut = fopen(config.outFile.c_str(), "w");
+        if (!pOut)
+        {
+            fprintf(stderr, "Unable to open %s\n", config.outFile.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<Corpus> corpora = MakeCorpora(config.size);
+
+    fprintf(pOut, "{\n");
+    fprintf(pOut, "  \"benchmark\": \"CMPBenchmark\",\n");
+    fprintf(pOut, "  \"version\": 2,\n");
+    fprintf(pOut, "  \"tag\": %s,\n", JSONString(config.tag).c_str());
+    fprintf(pOut, "  \"cpu\": %s,\n", JSONString(GetCPUName()).c_str());
+    fprintf(pOut, "  \"cpu_threads\": %u,\n", std::max(1u, std::thread::hardware_concurrency()));
+    fprintf(pOut, "  \"size\": %d,\n", config.size);
+    fprintf(pOut, "  \"runs\": %d,\n", config.runs);
+    fprintf(pOut, "  \"results\": [");
+
+    bool first = true;
+    for (size_t c = 0; c < corpora.size(); c++)
+    {
+        if (!Selected(config.corpora, corpora[c].name.c_str())) continue;
+
+        for (size_t f = 0; f < sizeof(g_Formats) / sizeof(g_Formats[0]); f++)
+        {
+            const BenchFormat &fmt = g_Formats[f];
+            if ((fmt.hdr != corpora[c].hdr) || !Selected(config.formats, fmt.name)) continue;
+
+            int nSpeeds = SpeedCount(fmt);
+            for (size_t q = 0; q < config.qualities.size(); q++)
+                for (int s = 0; s < nSpeeds; s++)
+                {
+                    // The ASTC presets other than Quality ignore fquality, they run at the first quality only
+                    if ((fmt.format == CMP_FORMAT_ASTC) && (s > 0) && (q > 0)) continue;
+
+                    for (size_t t = 0; t < config.threads.size(); t++)
+                    {
+                        fprintf(stderr, "%-10s %-22s quality %.2f %-9s threads %d\n", corpora[c].name.c_str(), fmt.name,
+                                config.qualities[q], SpeedName(fmt, s), config.threads[t]);
+                        if (!RunConfig(pOut, first, config, corpora[c], fmt, config.qualities[q], s, config.threads[t]))
+                            fprintf(stderr, "  %s failed\n", fmt.name);
+                    }
+                }
+        }
+    }
+
+    fprintf(pOut, "\n  ],\n");
+    fprintf(pOut, "  \"peak_rss_bytes\": %llu\n", (unsigned long long)GetPeakRSS());
+    fprintf(pOut, "}\n");
+
+    if (pOut != stdout)
+        fclose(pOut);
+
+    return 0;
+}
@@ -23,9 +23,11 @@
 //
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <tchar.h>
 #include <assert.h>
 #include <string>
+#include <vector>
 #include <math.h>
 #include <float.h>
 
@@ -39,6 +41,12 @@
 
 #include "Compressonator_Test_Helpers.h"
 
+// The DXTC row decoders are internal to the library, only the static library builds can call them
+#if defined(BUILD_MT) || defined(BUILD_MD) || defined(BUILD_MTd) || defined(BUILD_MDd)
+#define TEST_DXTC_DECODE_PATHS
+#include "Codec/DXTC/Codec_DXTC_Decode.h"
+#endif
+
 // There are two examples of how to compress a source image 
 // 1st is using high level SDK API's optimized with MultiThreading
 // 2nd is an example of low level API that give access to compression blocks (4x4) for BC6H and BC7
@@ -104,11 +112,660 @@ bool CompressionCallback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2)
     return g_bAbortCompression;
 }
 
+//---------------------------------------------------------------------------
+// Self tests, run with Compressonator_Test -selftest
+//---------------------------------------------------------------------------
+
+static float HalfBitsToFloat(unsigned short h)
+{
+    int   exponent = (h >> 10) & 0x1F;
+    int   mantissa = h & 0x3FF;
+    float value;
+
+    if (exponent == 0)
+        value = ldexpf((float)mantissa, -24);
+    else if (exponent == 31)
+        value = mantissa ? NAN : INFINITY;
+    else
+        value = ldexpf((float)(mantissa | 0x400), exponent - 25);
+
+    return (h & 0x8000) ? -value : value;
+}
+
+// Encodes BC6H_SF blocks holding negative values from 2^-10 to 2^10 and checks they decode with the right sign and size
+static bool TestBC6HSignedRoundTrip()
+{
+    // The library may already be initialized, that is not an error here
+    CMP_InitializeBCLibrary();
+
+    CMP_BC6H_BLOCK_PARAMETERS settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.dwMask    = 0xFFFF;
+    settings.fExposure = 0.95;
+    settings.bIsSigned = true;
+    settings.fQuality  = 1.0;
+
+    BC6HBlockEncoder *encoder = NULL;
+    if (CMP_CreateBC6HEncoder(settings, &encoder) != BC_ERROR_NONE)
+    {
+        printf(_T("BC6H signed round trip: could not create the encoder\n"));
+        return false;
+    }
+
+    bool bPassed = true;
+    for (int nBlock = 0; nBlock <= 20 && bPassed; nBlock++)
+    {
+        float fScale = ldexpf(1.0f, nBlock - 10);
+
+        // A gradient per channel, blue mixes signs across the block
+        CMP_FLOAT in[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT];
+        for (int i = 0; i < BC_BLOCK_PIXELS; i++)
+        {
+            in[i][BC_COMP_RED]   = -fScale * (1.0f + i / 16.0f);
+            in[i][BC_COMP_GREEN] = -fScale * (2.0f - i / 16.0f);
+            in[i][BC_COMP_BLUE]  = (i & 1) ? -fScale : fScale * 0.5f;
+            in[i][BC_COMP_ALPHA] = 0.0f;
+        }
+
+        BYTE     block[16];
+        CMP_HALF out[BC_BLOCK_PIXELS * BC_COMPONENT_COUNT];
+        if (CMP_EncodeBC6HBlock(encoder, in, block) != BC_ERROR_NONE ||
+            CMP_DecodeBC6HBlocks(block, 1, out, TRUE) != BC_ERROR_NONE)
+        {
+            printf(_T("BC6H signed round trip: block %d failed to encode or decode\n"), nBlock);
+            bPassed = false;
+            break;
+        }
+
+        for (int i = 0; i < BC_BLOCK_PIXELS && bPassed; i++)
+        {
+            for (int c = BC_COMP_RED; c <= BC_COMP_BLUE; c++)
+            {
+                float fExpected = in[i][c];
+                float fDecoded  = HalfBitsToFloat((unsigned short)out[i * BC_COMPONENT_COUNT + c]);
+
+                // The encoder fits these gradients coarsely, so only the sign and the magnitude to within 2x are checked
+                if ((fDecoded < 0.0f) != (fExpected < 0.0f) || fabs(fDecoded) > 2.0f * fabs(fExpected) || fabs(fDecoded) < 0.5f * fabs(fExpected))
+                {
+                    printf(_T("BC6H signed round trip: block %d pixel %d channel %d expected %g decoded %g\n"), nBlock, i, c, fExpected, fDecoded);
+                    bPassed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    CMP_DestroyBC6HEncoder(encoder);
+    return bPassed;
+}
+
+// Checks CMP_CalculateBufferSize64 against sizes near and past the size_t limit, and that CMP_CalculateBufferSize gives 0 above 4GB
+static bool TestBufferSize64()
+{
+    struct SizeCase
+    {
+        CMP_FORMAT          format;
+        CMP_DWORD           dwWidth;
+        CMP_DWORD           dwHeight;
+        size_t              nPitch;
+        bool                bFits64;        // The size fits a 64 bit size_t
+        unsigned long long  ullSize;        // The expected size when it fits
+    };
+
+    const SizeCase cases[] =
+    {
+        { CMP_FORMAT_BC1,       5,          5,          0,                          true,  32ULL },
+        { CMP_FORMAT_ARGB_8888, 65536,      65537,      0,                          true,  17180131328ULL },
+        { CMP_FORMAT_BC1,       0xFFFFFFFF, 0xFFFFFFFF, 0,                          true,  9223372036854775808ULL },    // Rounding up to whole blocks must not wrap
+        { CMP_FORMAT_BC7,       0xFFFFFFFF, 0xFFFFFFFF, 0,                          false, 0ULL },
+        { CMP_FORMAT_ARGB_32F,  0xFFFFFFFF, 0xFFFFFFFF, 0,                          false, 0ULL },
+        { CMP_FORMAT_ARGB_8888, 16,         2,          ((size_t) -1) / 2 + 1,      false, 0ULL },
+    };
+
+    const int nCases = sizeof(cases) / sizeof(cases[0]);
+
+    bool bPassed = true;
+    for (int i = 0; i < nCases; i++)
+    {
+        const SizeCase& sizeCase = cases[i];
+        bool bFits = sizeCase.bFits64 && (sizeCase.ullSize == (size_t) sizeCase.ullSize);
+
+        CMP_Texture64 texture64;
+        memset(&texture64, 0, sizeof(texture64));
+        texture64.dwSize    = sizeof(texture64);
+        texture64.dwWidth   = sizeCase.dwWidth;
+        texture64.dwHeight  = sizeCase.dwHeight;
+        texture64.nPitch    = sizeCase.nPitch;
+        texture64.format    = sizeCase.format;
+
+        size_t nSize = 0;
+        CMP_ERROR cmp_status = CMP_CalculateBufferSize64(&texture64, &nSize);
+        if (bFits ? (cmp_status != CMP_OK || nSize != sizeCase.ullSize) : (cmp_status == CMP_OK))
+        {
+            printf(_T("BufferSize64: case %d returned %d size %llu\n"), i, cmp_status, (unsigned long long) nSize);
+            bPassed = false;
+        }
+
+        // The 32 bit call has to give 0 rather than a wrapped size
+        if (sizeCase.nPitch == 0)
+        {
+            CMP_Texture texture;
+            memset(&texture, 0, sizeof(texture));
+            texture.dwSize      = sizeof(texture);
+            texture.dwWidth     = sizeCase.dwWidth;
+            texture.dwHeight    = sizeCase.dwHeight;
+            texture.format      = sizeCase.format;
+
+            CMP_DWORD dwExpected = (bFits && sizeCase.ullSize <= 0xFFFFFFFF) ? (CMP_DWORD) sizeCase.ullSize : 0;
+            CMP_DWORD dwSize     = CMP_CalculateBufferSize(&texture);
+            if (dwSize != dwExpected)
+            {
+                printf(_T("BufferSize64: case %d CMP_CalculateBufferSize returned %u\n"), i, dwSize);
+                bPassed = false;
+            }
+        }
+    }
+
+    return bPassed;
+}
+
+// A colour per 4x4 block, with 5 or 6 significant bits per channel so solid BC1 blocks keep it
+static void TestBlockColour(CMP_DWORD dwBlockX, CMP_DWORD dwBlockY, CMP_BYTE colour[4])
+{
+    unsigned int h = (dwBlockX * 0x9E3779B1u) ^ (dwBlockY * 0x85EBCA77u);
+    h ^= h >> 15;
+
+    unsigned int r = h & 31;
+    unsigned int g = (h >> 5) & 63;
+    unsigned int b = (h >> 11) & 31;
+    colour[0] = (CMP_BYTE) ((r << 3) | (r >> 2));
+    colour[1] = (CMP_BYTE) ((g << 2) | (g >> 4));
+    colour[2] = (CMP_BYTE) ((b << 3) | (b >> 2));
+    colour[3] = 255;
+}
+
+// Compresses an ARGB_8888 texture just over 4GB to BC1 with CMP_ConvertTexture64, decompresses it again and checks
+// every pixel, so a band converted at the wrong offset shows up as the colour of another block
+static bool TestConvertTexture64()
+{
+    if (sizeof(size_t) <= 4)
+    {
+        printf(_T("ConvertTexture64: skipped, needs a 64 bit build\n"));
+        return true;
+    }
+
+    CMP_Texture64 srcTexture;
+    memset(&srcTexture, 0, sizeof(srcTexture));
+    srcTexture.dwSize   = sizeof(srcTexture);
+    srcTexture.dwWidth  = 16384;
+    srcTexture.dwHeight = 65540;
+    srcTexture.format   = CMP_FORMAT_ARGB_8888;
+
+    CMP_Texture64 destTexture = srcTexture;
+    destTexture.format = CMP_FORMAT_BC1;
+
+    if (CMP_CalculateBufferSize64(&srcTexture, &srcTexture.nDataSize) != CMP_OK ||
+        CMP_CalculateBufferSize64(&destTexture, &destTexture.nDataSize) != CMP_OK)
+    {
+        printf(_T("ConvertTexture64: could not size the textures\n"));
+        return false;
+    }
+
+    srcTexture.pData  = (CMP_BYTE*) malloc(srcTexture.nDataSize);
+    destTexture.pData = (CMP_BYTE*) malloc(destTexture.nDataSize);
+    if (!srcTexture.pData || !destTexture.pData)
+    {
+        if (srcTexture.pData)  free(srcTexture.pData);
+        if (destTexture.pData) free(destTexture.pData);
+        printf(_T("ConvertTexture64: skipped, %llu bytes could not be allocated\n"), (unsigned long long) (srcTexture.nDataSize + destTexture.nDataSize));
+        return true;
+    }
+
+    for (CMP_DWORD y = 0; y < srcTexture.dwHeight; y++)
+    {
+        CMP_BYTE* pRow = srcTexture.pData + (size_t) y * srcTexture.dwWidth * 4;
+        for (CMP_DWORD x = 0; x < srcTexture.dwWidth; x++)
+            TestBlockColour(x / 4, y / 4, pRow + (size_t) x * 4);
+    }
+
+    CMP_CompressOptions options;
+    memset(&options, 0, sizeof(options));
+    options.dwSize = sizeof(options);
+
+    bool bPassed = true;
+    CMP_ERROR cmp_status = CMP_ConvertTexture64(&srcTexture, &destTexture, &options, NULL, NULL, NULL);
+    if (cmp_status != CMP_OK)
+    {
+        printf(_T("ConvertTexture64: compression returned %d\n"), cmp_status);
+        bPassed = false;
+    }
+
+    // Decompress over the source so only one large buffer is needed
+    if (bPassed)
+    {
+        memset(srcTexture.pData, 0, srcTexture.nDataSize);
+        cmp_status = CMP_ConvertTexture64(&destTexture, &srcTexture, &options, NULL, NULL, NULL);
+        if (cmp_status != CMP_OK)
+        {
+            printf(_T("ConvertTexture64: decompression returned %d\n"), cmp_status);
+            bPassed = false;
+        }
+    }
+
+    for (CMP_DWORD y = 0; y < srcTexture.dwHeight && bPassed; y++)
+    {
+        const CMP_BYTE* pRow = srcTexture.pData + (size_t) y * srcTexture.dwWidth * 4;
+        for (CMP_DWORD x = 0; x < srcTexture.dwWidth; x++)
+        {
+            CMP_BYTE expected[4];
+            TestBlockColour(x / 4, y / 4, expected);
+
+            // Allow for endpoint rounding in the encoder, a misplaced band gives an unrelated colour
+            const CMP_BYTE* pPixel = pRow + (size_t) x * 4;
+            if (abs(pPixel[0] - expected[0]) > 8 || abs(pPixel[1] - expected[1]) > 8 || abs(pPixel[2] - expected[2]) > 8)
+            {
+                printf(_T("ConvertTexture64: pixel %u,%u is %d,%d,%d expected %d,%d,%d\n"), x, y,
+                       pPixel[0], pPixel[1], pPixel[2], expected[0], expected[1], expected[2]);
+                bPassed = false;
+                break;
+            }
+        }
+    }
+
+    free(srcTexture.pData);
+    free(destTexture.pData);
+    return bPassed;
+}
+
+// Compresses red and green gradients to each EAC format, decompresses them again and checks every pixel.
+// ARGB_8888 is stored as B, G, R, A bytes. R11 decodes to grey and RG11 to a zero blue channel.
+static bool TestEACRoundTrip()
+{
+    struct EACCase
+    {
+        CMP_FORMAT   format;
+        const TCHAR* pszName;
+        bool         bTwoChannel;
+    };
+
+    const EACCase cases[] =
+    {
+        { CMP_FORMAT_EAC_R11,          _T("EAC_R11"),          false },
+        { CMP_FORMAT_EAC_R11_SIGNED,   _T("EAC_R11_SIGNED"),   false },
+        { CMP_FORMAT_EAC_RG11,         _T("EAC_RG11"),         true  },
+        { CMP_FORMAT_EAC_RG11_SIGNED,  _T("EAC_RG11_SIGNED"),  true  },
+    };
+
+    const CMP_DWORD dwSize = 64;
+
+    CMP_Texture srcTexture;
+    memset(&srcTexture, 0, sizeof(srcTexture));
+    srcTexture.dwSize     = sizeof(srcTexture);
+    srcTexture.dwWidth    = dwSize;
+    srcTexture.dwHeight   = dwSize;
+    srcTexture.dwPitch    = dwSize * 4;
+    srcTexture.format     = CMP_FORMAT_ARGB_8888;
+    srcTexture.dwDataSize = CMP_CalculateBufferSize(&srcTexture);
+
+    CMP_Texture roundTexture = srcTexture;
+
+    srcTexture.pData   = (CMP_BYTE*) malloc(srcTexture.dwDataSize);
+    roundTexture.pData = (CMP_BYTE*) malloc(roundTexture.dwDataSize);
+    if (!srcTexture.pData || !roundTexture.pData)
+    {
+        if (srcTexture.pData)   free(srcTexture.pData);
+        if (roundTexture.pData) free(roundTexture.pData);
+        printf(_T("EAC round trip: could not allocate the textures\n"));
+        return false;
+    }
+
+    // Red runs across and green runs down, including both ends of the range
+    for (CMP_DWORD y = 0; y < dwSize; y++)
+    {
+        for (CMP_DWORD x = 0; x < dwSize; x++)
+        {
+            CMP_BYTE* pPixel = srcTexture.pData + y * srcTexture.dwPitch + x * 4;
+            pPixel[0] = 0;
+            pPixel[1] = (CMP_BYTE) (255 - y * 255 / (dwSize - 1));
+            pPixel[2] = (CMP_BYTE) (x * 255 / (dwSize - 1));
+            pPixel[3] = 255;
+        }
+    }
+
+    CMP_CompressOptions options;
+    memset(&options, 0, sizeof(options));
+    options.dwSize   = sizeof(options);
+    options.fquality = 1.0f;
+
+    bool bPassed = true;
+    for (size_t nCase = 0; nCase < sizeof(cases) / sizeof(cases[0]) && bPassed; nCase++)
+    {
+        CMP_Texture destTexture;
+        memset(&destTexture, 0, sizeof(destTexture));
+        destTexture.dwSize     = sizeof(destTexture);
+        destTexture.dwWidth    = dwSize;
+        destTexture.dwHeight   = dwSize;
+        destTexture.format     = cases[nCase].format;
+        destTexture.dwDataSize = CMP_CalculateBufferSize(&destTexture);
+        destTexture.pData      = (CMP_BYTE*) malloc(destTexture.dwDataSize);
+        if (!destTexture.pData)
+        {
+            printf(_T("EAC round trip: could not allocate the %s texture\n"), cases[nCase].pszName);
+            bPassed = false;
+            break;
+        }
+
+        memset(roundTexture.pData, 0xCD, roundTexture.dwDataSize);
+
+        CMP_ERROR cmp_status = CMP_ConvertTexture(&srcTexture, &destTexture, &options, NULL, NULL, NULL);
+        if (cmp_status == CMP_OK)
+            cmp_status = CMP_ConvertTexture(&destTexture, &roundTexture, &options, NULL, NULL, NULL);
+        if (cmp_status != CMP_OK)
+        {
+            printf(_T("EAC round trip: %s returned %d\n"), cases[nCase].pszName, cmp_status);
+            bPassed = false;
+        }
+
+        for (CMP_DWORD y = 0; y < dwSize && bPassed; y++)
+        {
+            for (CMP_DWORD x = 0; x < dwSize; x++)
+            {
+                const CMP_BYTE* pIn  = srcTexture.pData + y * srcTexture.dwPitch + x * 4;
+                const CMP_BYTE* pOut = roundTexture.pData + y * roundTexture.dwPitch + x * 4;
+
+                int nExpectedG = cases[nCase].bTwoChannel ? pIn[1] : pIn[2];
+                int nExpectedB = cases[nCase].bTwoChannel ? 0      : pIn[2];
+
+                // 11 bit endpoints in 8 bit gradients, a wrong channel or sign mapping is off by far more
+                if (abs(pOut[2] - pIn[2]) > 4 || abs(pOut[1] - nExpectedG) > 4 || abs(pOut[0] - nExpectedB) > 4 || pOut[3] != 255)
+                {
+                    printf(_T("EAC round trip: %s pixel %u,%u is %d,%d,%d,%d expected %d,%d,%d,255\n"), cases[nCase].pszName, x, y,
+                           pOut[2], pOut[1], pOut[0], pOut[3], pIn[2], nExpectedG, nExpectedB);
+                    bPassed = false;
+                    break;
+                }
+            }
+        }
+
+        free(destTexture.pData);
+    }
+
+    free(srcTexture.pData);
+    free(roundTexture.pData);
+    return bPassed;
+}
+
+// Compresses srcTexture to format, then decompresses it again into roundTexture when that is given
+static bool TestRDOConvert(const CMP_Texture& srcTexture, CMP_FORMAT format, const CMP_CompressOptions& options, std::vector<CMP_BYTE>& blocks,
+                           CMP_Texture* pRoundTexture)
+{
+    CMP_Texture destTexture;
+    memset(&destTexture, 0, sizeof(destTexture));
+    destTexture.dwSize     = sizeof(destTexture);
+    destTexture.dwWidth    = srcTexture.dwWidth;
+    destTexture.dwHeight   = srcTexture.dwHeight;
+    destTexture.format     = format;
+    destTexture.dwDataSize = CMP_CalculateBufferSize(&destTexture);
+
+    blocks.assign(destTexture.dwDataSize, 0);
+    destTexture.pData = &blocks[0];
+
+    CMP_ERROR cmp_status = CMP_ConvertTexture((CMP_Texture*) &srcTexture, &destTexture, (CMP_CompressOptions*) &options, NULL, NULL, NULL);
+    if (cmp_status == CMP_OK && pRoundTexture)
+        cmp_status = CMP_ConvertTexture(&destTexture, pRoundTexture, (CMP_CompressOptions*) &options, NULL, NULL, NULL);
+    return cmp_status == CMP_OK;
+}
+
+// Squared error of the 4x4 block at bx,by, alpha is left out for BC1 as the RDO pass does without bDXT1UseAlpha
+static double TestRDOBlockError(const CMP_Texture& srcTexture, const CMP_Texture& roundTexture, CMP_DWORD bx, CMP_DWORD by, int nChannels)
+{
+    double fError = 0;
+    for (CMP_DWORD y = by * 4; y < by * 4 + 4; y++)
+    {
+        for (CMP_DWORD x = bx * 4; x < bx * 4 + 4; x++)
+        {
+            const CMP_BYTE* pIn  = srcTexture.pData + y * srcTexture.dwPitch + x * 4;
+            const CMP_BYTE* pOut = roundTexture.pData + y * roundTexture.dwPitch + x * 4;
+            for (int ch = 0; ch < nChannels; ch++)
+                fError += (double) (pOut[ch] - pIn[ch]) * (pOut[ch] - pIn[ch]);
+        }
+    }
+    return fError;
+}
+
+// fRDOLambda 0 has to leave the blocks exactly as the codec writes them, and with a lambda no block may gain more
+// squared error than lambda times its size in bits, the bound documented for CMP_CompressOptions::fRDOLambda
+static bool TestRDOErrorBound()
+{
+    struct RDOCase
+    {
+        CMP_FORMAT   format;
+        const TCHAR* pszName;
+        CMP_DWORD    dwBlockBytes;
+        int          nChannels;
+    };
+
+    const RDOCase cases[] =
+    {
+        { CMP_FORMAT_BC1,  _T("BC1"),  8,  3 },
+        { CMP_FORMAT_BC3,  _T("BC3"),  16, 4 },
+        { CMP_FORMAT_BC7,  _T("BC7"),  16, 4 },
+    };
+
+    const CMP_DWORD dwSize   = 128;     // Enough block rows for the pass to split the texture between threads
+    const double    fLambda  = 4.0;
+
+    CMP_Texture srcTexture;
+    memset(&srcTexture, 0, sizeof(srcTexture));
+    srcTexture.dwSize     = sizeof(srcTexture);
+    srcTexture.dwWidth    = dwSize;
+    srcTexture.dwHeight   = dwSize;
+    srcTexture.dwPitch    = dwSize * 4;
+    srcTexture.format     = CMP_FORMAT_ARGB_8888;
+    srcTexture.dwDataSize = CMP_CalculateBufferSize(&srcTexture);
+
+    CMP_Texture baseTexture = srcTexture;
+    CMP_Texture rdoTexture  = srcTexture;
+
+    std::vector<CMP_BYTE> source(srcTexture.dwDataSize);
+    std::vector<CMP_BYTE> baseRound(srcTexture.dwDataSize);
+    std::vector<CMP_BYTE> rdoRound(srcTexture.dwDataSize);
+    srcTexture.pData  = &source[0];
+    baseTexture.pData = &baseRound[0];
+    rdoTexture.pData  = &rdoRound[0];
+
+    // Gradients with a little noise, so neighbouring blocks are alike without being equal
+    for (CMP_DWORD y = 0; y < dwSize; y++)
+    {
+        for (CMP_DWORD x = 0; x < dwSize; x++)
+        {
+            unsigned int h = (x * 0x9E3779B1u) ^ (y * 0x85EBCA77u);
+            h ^= h >> 15;
+
+            CMP_BYTE* pPixel = srcTexture.pData + y * srcTexture.dwPitch + x * 4;
+            pPixel[0] = (CMP_BYTE) ((x + y) / 2 + (h & 7));
+            pPixel[1] = (CMP_BYTE) (y * 2 + ((h >> 3) & 7));
+            pPixel[2] = (CMP_BYTE) (x * 2 + ((h >> 6) & 7));
+            pPixel[3] = 255;
+        }
+    }
+
+    CMP_CompressOptions options;
+    memset(&options, 0, sizeof(options));
+    options.dwSize   = sizeof(options);
+    options.fquality = 0.05f;
+
+    bool bPassed = true;
+    for (size_t nCase = 0; nCase < sizeof(cases) / sizeof(cases[0]) && bPassed; nCase++)
+    {
+        const RDOCase& rdoCase = cases[nCase];
+
+        std::vector<CMP_BYTE> baseBlocks;
+        std::vector<CMP_BYTE> blocks;
+
+        CMP_CompressOptions rdoOptions = options;
+        rdoOptions.fRDOLambda  = 0;
+        rdoOptions.dwRDOWindow = 64;
+
+        if (!TestRDOConvert(srcTexture, rdoCase.format, options, baseBlocks, &baseTexture) ||
+            !TestRDOConvert(srcTexture, rdoCase.format, rdoOptions, blocks, NULL))
+        {
+            printf(_T("RDO: %s conversion failed\n"), rdoCase.pszName);
+            bPassed = false;
+            break;
+        }
+
+        if (blocks != baseBlocks)
+        {
+            printf(_T("RDO: %s with lambda 0 differs from the codec's blocks\n"), rdoCase.pszName);
+            bPassed = false;
+        }
+
+        rdoOptions.fRDOLambda = fLambda;
+        if (!TestRDOConvert(srcTexture, rdoCase.format, rdoOptions, blocks, &rdoTexture))
+        {
+            printf(_T("RDO: %s conversion with lambda %.1f failed\n"), rdoCase.pszName, fLambda);
+            bPassed = false;
+            break;
+        }
+
+        double fBound = fLambda * rdoCase.dwBlockBytes * 8;
+        for (CMP_DWORD by = 0; by < dwSize / 4 && bPassed; by++)
+        {
+            for (CMP_DWORD bx = 0; bx < dwSize / 4; bx++)
+            {
+                double fBaseError = TestRDOBlockError(srcTexture, baseTexture, bx, by, rdoCase.nChannels);
+                double fRDOError  = TestRDOBlockError(srcTexture, rdoTexture, bx, by, rdoCase.nChannels);
+                if (fRDOError > fBaseError + fBound)
+                {
+                    printf(_T("RDO: %s block %u,%u error went from %.0f to %.0f, more than %.0f\n"), rdoCase.pszName, bx, by,
+                           fBaseError, fRDOError, fBound);
+                    bPassed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    return bPassed;
+}
+
+// Decodes rows of random BC1 - BC5 blocks on every decode path the CPU supports and checks the SSE2 and AVX2
+// kernels write exactly the bytes of the scalar reference, full rows as well as rows clipped at the edges
+static bool TestDXTCDecodePaths()
+{
+#ifdef TEST_DXTC_DECODE_PATHS
+    const CMP_DWORD dwBlocks = 16;
+    const CMP_DWORD dwPitch  = dwBlocks * 4 * 4;
+    const int       nRows    = 500;
+
+    DXTCSetDecodePath(DXTC_DECODE_AVX2);
+    DXTCDecodePath best = DXTCGetDecodePath();
+    if (best == DXTC_DECODE_SCALAR)
+    {
+        printf(_T("DXTC decode paths: skipped, no SIMD path on this CPU\n"));
+        return true;
+    }
+
+    static const TCHAR* pszCases[] =
+    {
+        _T("BC1"), _T("BC1 swizzled"), _T("BC2"), _T("BC3 swizzled"), _T("BC4 R8"), _T("BC4 RGBA8888"),
+        _T("BC5 RG8"), _T("BC5 RGBA8888"), _T("BC5 RG8 swapped"),
+    };
+    const int nCases = sizeof(pszCases) / sizeof(pszCases[0]);
+
+    std::vector<CMP_BYTE> blocks(dwBlocks * 16);
+    std::vector<CMP_BYTE> reference(dwPitch * 4);
+    std::vector<CMP_BYTE> decoded(dwPitch * 4);
+
+    unsigned int nSeed = 0x44585443;
+    bool bPassed = true;
+    for (int nRow = 0; nRow < nRows && bPassed; nRow++)
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            nSeed = nSeed * 1664525u + 1013904223u;
+            blocks[i] = (CMP_BYTE) (nSeed >> 24);
+        }
+
+        // Every other row is clipped to a partial last block and 3 scanlines
+        CMP_DWORD dwWidth  = (nRow & 1) ? dwBlocks * 4 - 3 : dwBlocks * 4;
+        CMP_DWORD dwHeight = (nRow & 1) ? 3 : 4;
+
+        for (int nCase = 0; nCase < nCases && bPassed; nCase++)
+        {
+            for (int nPath = DXTC_DECODE_SCALAR; nPath <= best && bPassed; nPath++)
+            {
+                DXTCSetDecodePath((DXTCDecodePath) nPath);
+
+                std::vector<CMP_BYTE>& dest = (nPath == DXTC_DECODE_SCALAR) ? reference : decoded;
+                memset(&dest[0], 0xCD, dest.size());
+
+                const CMP_BYTE* pSrc  = &blocks[0];
+                CMP_BYTE*       pDest = &dest[0];
+                switch (nCase)
+                {
+                case 0: DXTCDecodeRowBC1(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, false);                      break;
+                case 1: DXTCDecodeRowBC1(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, true);                       break;
+                case 2: DXTCDecodeRowBC2(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, false);                      break;
+                case 3: DXTCDecodeRowBC3(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, true);                       break;
+                case 4: DXTCDecodeRowBC4(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, DXTC_DECODE_R8);             break;
+                case 5: DXTCDecodeRowBC4(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, DXTC_DECODE_RGBA8888);       break;
+                case 6: DXTCDecodeRowBC5(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, 0, DXTC_DECODE_RG8);         break;
+                case 7: DXTCDecodeRowBC5(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, 0, DXTC_DECODE_RGBA8888);    break;
+                case 8: DXTCDecodeRowBC5(pSrc, dwBlocks, pDest, dwPitch, dwWidth, dwHeight, 2, DXTC_DECODE_RG8);         break;
+                }
+
+                if (nPath != DXTC_DECODE_SCALAR && decoded != reference)
+                {
+                    printf(_T("DXTC decode paths: %s row %d differs between path %d and the scalar path\n"), pszCases[nCase], nRow, nPath);
+                    bPassed = false;
+                }
+            }
+        }
+    }
+
+    DXTCSetDecodePath(best);
+    return bPassed;
+#else
+    printf(_T("DXTC decode paths: skipped, needs a static library build\n"));
+    return true;
+#endif
+}
+
+typedef bool (*SelfTestProc)();
+
+static bool RunSelfTest(const TCHAR* pszName, SelfTestProc pTest)
+{
+    bool bPassed = pTest();
+    printf(_T("%-40s %s\n"), pszName, bPassed ? _T("passed") : _T("FAILED"));
+    return bPassed;
+}
+
+// Returns the number of failed tests
+static int RunSelfTests()
+{
+    int nFailed = 0;
+
+    if (!RunSelfTest(_T("BC6H signed round trip"), TestBC6HSignedRoundTrip)) nFailed++;
+    if (!RunSelfTest(_T("Buffer sizes above 4GB"), TestBufferSize64)) nFailed++;
+    if (!RunSelfTest(_T("ConvertTexture64 round trip above 4GB"), TestConvertTexture64)) nFailed++;
+    if (!RunSelfTest(_T("EAC R11 and RG11 round trip"), TestEACRoundTrip)) nFailed++;
+    if (!RunSelfTest(_T("RDO lambda 0 and error bound"), TestRDOErrorBound)) nFailed++;
+    if (!RunSelfTest(_T("DXTC SIMD decode matches scalar"), TestDXTCDecodePaths)) nFailed++;
+
+    return nFailed;
+}
+
 int _tmain(int argc, _TCHAR* argv[])
 {
+    if (argc == 2 && _tcscmp(argv[1], _T("-selftest")) == 0)
+        return RunSelfTests();
+
     if (argc < 5)
     {
         _tprintf(_T("Compressonator_Test SourceFile DestFile Format Quality\n"));
+        _tprintf(_T("Compressonator_Test -selftest\n"));
         return 0;
     }
 
@@ -0,0 +1,88 @@
+//=====================================================================
+// Copyright (c) 2016    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+/// \file CMP_Trace.h
+//
+//=====================================================================
+
+#ifndef H_CMP_TRACE
+#define H_CMP_TRACE
+
+#include "Compressonator.h"
+
+//
+// Scoped trace events, see the CMP_Trace functions in Compressonator.h
+//
+//     CMP_TRACE_SCOPE("IO", "DDS Load");
+//     CMP_TRACE_SCOPE_DETAIL("IO", "Load", pszFilename);
+//
+// Categories used by the library and plugins:
+//     App        - application stages
+//     IO         - image plugin load and save
+//     Mip        - mip map generation
+//     Convert    - CMP_ConvertTexture and format conversion
+//     Compress   - codec encode, the name is the codec
+//     Decompress - codec decode, the name is the codec
+//     GPUDecode  - GPU and CPU decode plugins
+//     Analysis   - image diff, PSNR and SSIM
+//
+// Define CMP_DISABLE_TRACE to compile all scopes out.
+//
+
+class CMP_TraceScope
+{
+public:
+    CMP_TraceScope(const char* pCategory, const char* pName, const char* pDetail) :
+        m_pCategory(pCategory), m_pName(pName), m_pDetail(pDetail), m_nStart(CMP_TraceBegin())
+    {
+    }
+
+    ~CMP_TraceScope()
+    {
+        if (m_nStart)
+            CMP_TraceEnd(m_pCategory, m_pName, m_pDetail, m_nStart);
+    }
+
+private:
+    CMP_TraceScope(const CMP_TraceScope&);
+    CMP_TraceScope& operator=(const CMP_TraceScope&);
+
+    const char*         m_pCategory;
+    const char*         m_pName;
+    const char*         m_pDetail;
+    unsigned long long  m_nStart;
+};
+
+#ifndef CMP_DISABLE_TRACE
+#define CMP_TRACE_CONCAT2(a, b)                         a##b
+#define CMP_TRACE_CONCAT(a, b)                          CMP_TRACE_CONCAT2(a, b)
+#define CMP_TRACE_SCOPE(category, name)                 CMP_TraceScope CMP_TRACE_CONCAT(cmp_trace_scope_, __LINE__)(category, name, NULL)
+#define CMP_TRACE_SCOPE_DETAIL(category, name, detail)  CMP_TraceScope CMP_TRACE_CONCAT(cmp_trace_scope_, __LINE__)(category, name, detail)
+#define CMP_TRACE_THREAD_NAME(name)                     CMP_TraceSetThreadName(name)
+#define CMP_TRACE_MEMORY()                              CMP_TraceMemory()
+#else
+#define CMP_TRACE_SCOPE(category, name)
+#define CMP_TRACE_SCOPE_DETAIL(category, name, detail)
+#define CMP_TRACE_THREAD_NAME(name)
+#define CMP_TRACE_MEMORY()
+#endif
+
+#endif // !H_CMP_TRACE
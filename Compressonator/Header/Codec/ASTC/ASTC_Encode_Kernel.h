@@ -2530,6 +2530,13 @@ __constant int hcounter_incr3[3] = { 0, 0, 1 };
 #define MAX(x,y) ((x)>(y)?(x):(y))
 #endif
 
+// Named encoder presets, values match CMP_ASTC_Speed
+#define ASTC_SPEED_QUALITY      0       // search limits derived from m_Quality
+#define ASTC_SPEED_FASTEST      1
+#define ASTC_SPEED_FAST         2
+#define ASTC_SPEED_MEDIUM       3
+#define ASTC_SPEED_THOROUGH     4
+
 typedef struct 
 {
     unsigned int m_src_width;                   // Original source width
@@ -2572,6 +2579,7 @@ typedef struct
     int                             m_compress_to_mono;
     block_size_descriptor           bsd;
     float                           m_Quality;
+    int                             m_Speed;    // ASTC_SPEED_xxx preset, overrides m_Quality search limits when set
     partition_info                  partition_tables[5][PARTITION_COUNT];
 } 
 ASTC_Encode 
@@ -4803,6 +4803,18 @@ namespace ASTC_Encoder
         int padding;
     };
     
+    // Read only view of the caller's source image. Blocks are fetched from it in place
+    // so the encoder does not need its own copy of the image.
+    struct astc_source_image_cpu
+    {
+        const uint8_t *data;
+        int pitch;                  // bytes per row
+        int xsize;
+        int ysize;
+        int zsize;
+        int is_half;                // 1 for RGBA16F texels, 0 for RGBA8888 texels
+    };
+
     typedef uint16_t sf16;
     
     // on conversions to/from uint8_t (this also allows us to handle hdr textures easily)
@@ -4911,6 +4923,8 @@ namespace ASTC_Encoder
         uint64_t coverage_bitmaps[4];    // used for the purposes of k-means partition search.
     };
 
+    block_size_descriptor_cpu *get_block_size_descriptor_cpu(int xdim, int ydim, int zdim);
+
     astc_codec_image_cpu *allocate_image_cpu(int bitness, int xsize, int ysize, int zsize, int padding);
 
     void initialize_image_cpu(astc_codec_image_cpu * img);
@@ -4935,7 +4949,7 @@ namespace ASTC_Encoder
     void imageblock_initialize_orig_from_work_cpu(imageblock_cpu * pb, int pixelcount);
     
     void fetch_imageblock_cpu(
-        const astc_codec_image_cpu * img,
+        const astc_source_image_cpu * img,
         imageblock_cpu * pb,	// picture-block to imitialize with image data
                                 // block dimensions
         int xdim, int ydim, int zdim,
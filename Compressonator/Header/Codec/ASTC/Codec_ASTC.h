@@ -56,6 +56,8 @@ private:
     WORD     m_NumEncodingThreads;
     bool     m_AbortRequested;
 
+    bool     m_HDRSource;               // source buffer is RGBA16F, set before the library is initialized
+
     int m_xdim, m_ydim, m_zdim;        // Is now implamented and set by user ( defined in g_ASTCEncode )
     float m_target_bitrate;            // defined in g_ASTCEncode 
 
@@ -77,6 +79,7 @@ private:
         int z);
 
     CodecError      FinishASTCEncoding();
+    void            InitializeASTCSettings();
     CodecError      InitializeASTCLibrary();
 
     // Encoder interfaces
@@ -91,6 +94,7 @@ private:
 
     // Speed and Quality
     double  m_Quality;
+    int     m_Speed;        // ASTC_SPEED_xxx preset, ASTC_SPEED_QUALITY uses m_Quality
 
 };
 
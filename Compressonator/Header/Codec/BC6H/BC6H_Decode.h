@@ -36,6 +36,9 @@ public:
     ~BC6HBlockDecoder(){};
     void DecompressBlock(float out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],BYTE in[COMPRESSED_BLOCK_SIZE]);
 
+    // Integer decode straight to IEEE half bits, alpha is set to 1.0
+    void DecompressBlock(unsigned short out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],BYTE in[COMPRESSED_BLOCK_SIZE]);
+
     bool bc6signed = false; // this is suppiled by user for compression for SIGNED_F16 or UNSIGNED_F16 or obtained during decompression
 
 };
@@ -47,6 +47,14 @@
 #define DELTA_DOWN       2
 #define DELTA_LEFT       3
 
+// Two region shape search pruning
+// Shapes are ranked by the summed luminance variance of their two regions and only
+// the best ranked are passed on to the full quantization, the count kept scales with quality
+#define BC6H_MIN_SHAPES_KEPT    4       // Shapes kept at quality 0.0, all BC6H_MAX_PARTITIONS are kept at quality 1.0
+#define BC6H_LUMA_RED           0.2126f
+#define BC6H_LUMA_GREEN         0.7152f
+#define BC6H_LUMA_BLUE          0.0722f
+
 
 class BC6HBlockEncoder
 {
@@ -61,6 +69,10 @@ public:
         m_Exposure                = user_options.fExposure;
         m_bAverageEndPoint        = true;
         m_DiffLevel               = 0.01f;
+
+        m_ShapesKept              = BC6H_MIN_SHAPES_KEPT + (int)(m_quality * (BC6H_MAX_PARTITIONS - BC6H_MIN_SHAPES_KEPT) + 0.5f);
+        if (m_ShapesKept > BC6H_MAX_PARTITIONS) m_ShapesKept = BC6H_MAX_PARTITIONS;
+        if (m_ShapesKept < BC6H_MIN_SHAPES_KEPT) m_ShapesKept = BC6H_MIN_SHAPES_KEPT;
     };
      
     ~BC6HBlockEncoder(){};
@@ -91,6 +103,9 @@ private:
     float    EncodePattern(AMD_BC6H_Format &BC6H_data,
         float  error);
 
+    int      RankShapes(AMD_BC6H_Format &BC6H_data,
+                        int    shapeOrder[BC6H_MAX_PARTITIONS]);
+
     void    SaveCompressedBlockData(AMD_BC6H_Format &BC6H_data, 
                                     int oEndPoints[MAX_SUBSETS][MAX_END_POINTS][MAX_DIMENSION_BIG],
                                     int iIndices[3][MAX_SUBSET_SIZE], 
@@ -121,6 +136,7 @@ private:
     float  m_Exposure;
     bool    m_bAverageEndPoint;         // Enables Averaging Endpoints for low bits modes
     float   m_DiffLevel;                // Threashhold for Channel diferance to set Averages value of channels on Endpoints
+    int     m_ShapesKept;               // Number of two region shapes given a full encode, set from quality
 };
 
 #endif
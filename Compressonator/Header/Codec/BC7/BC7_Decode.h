@@ -35,6 +35,11 @@ public:
     void DecompressBlock(double  out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],
                          BYTE   in[COMPRESSED_BLOCK_SIZE]);
 
+    // Integer decoder writing RGBA8 directly, it keeps no state in the decoder
+    // so it can be called for several blocks at once from different threads
+    void DecompressBlock(BYTE    out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],
+                         BYTE   in[COMPRESSED_BLOCK_SIZE]);
+
 private:
 
     void DecompressDualIndexBlock(double  out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],
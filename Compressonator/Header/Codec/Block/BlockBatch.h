@@ -0,0 +1,71 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File : BlockBatch.h
+//
+// Threaded batch encoding of 4x4 blocks for the BC7 and BC6H block APIs
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _BLOCKBATCH_H_
+#define _BLOCKBATCH_H_
+
+#include "Compressonator.h"
+
+// Maximum number of workers used for one batch
+#define MAX_BLOCKBATCH_THREADS  128
+
+//
+// A block encoder that can be copied for each worker
+//
+class CBlockBatchEncoder
+{
+public:
+    virtual ~CBlockBatchEncoder() {};
+
+    // Returns a new encoder with the same settings, allocated with new
+    virtual CBlockBatchEncoder* Clone() const = 0;
+
+    // Encodes one block, pixels are read with BlockBatch_ReadBlock()
+    virtual void EncodeBlock(const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD dwRowStride, BYTE* pOut) = 0;
+};
+
+//
+// Reads the 16 pixels of a block to float RGBA
+// 8 bit values are returned unscaled in the range 0->255, half and float values are returned as is
+//
+void BlockBatch_ReadBlock(const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD dwRowStride, CMP_FLOAT block[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT]);
+
+//
+// Encodes numBlocks blocks on up to numThreads workers (0 = one per processor) and returns when all are written
+//
+BC_ERROR BlockBatch_Encode(const CBlockBatchEncoder& encoder, const char* pszName, const void* in, CMP_BLOCK_LAYOUT layout,
+                           CMP_DWORD blockStride, CMP_DWORD rowStride, CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads);
+
+//
+// Starts BlockBatch_Encode() on its own thread, takes ownership of pEncoder
+//
+BC_ERROR BlockBatch_EncodeAsync(CBlockBatchEncoder* pEncoder, const char* pszName, const void* in, CMP_BLOCK_LAYOUT layout,
+                                CMP_DWORD blockStride, CMP_DWORD rowStride, CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job);
+
+#endif
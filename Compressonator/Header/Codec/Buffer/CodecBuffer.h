@@ -115,6 +115,15 @@ typedef enum _CodecBufferType
 #define RGBA32F_OFFSET_G 1
 #define RGBA32F_OFFSET_B 2
 
+// Overflow checked size arithmetic, returns false if the product does not fit a size_t
+inline bool CMP_MulSize(size_t a, size_t b, size_t* pResult)
+{
+    if(a != 0 && b > ((size_t) -1) / a)
+        return false;
+    *pResult = a * b;
+    return true;
+}
+
 #define TWO_BIT_MASK    0x0003
 #define BYTE_MASK        0x00ff
 #define TEN_BIT_MASK    0x03ff
@@ -322,6 +331,9 @@ public:
 
 protected:
 
+    // Allocates dwRows rows of dwPitch bytes, returns NULL if the size does not fit a CMP_DWORD
+    CMP_BYTE* AllocData(CMP_DWORD dwPitch, CMP_DWORD dwRows);
+
     void ConvertBlock(double dBlock[], float fBlock[], CMP_DWORD dwBlockSize);
     void ConvertBlock(double dBlock[], half hBlock[], CMP_DWORD dwBlockSize);
     void ConvertBlock(double dBlock[], CMP_DWORD dwBlock[], CMP_DWORD dwBlockSize);
@@ -60,6 +60,11 @@ typedef enum _CodecType
     CT_ETC_RGBA_Interpolated,
 #endif // SUPPORT_ETC_ALPHA
     CT_ETC2_RGB,
+    CT_ETC2_RGBA,
+    CT_EAC_R11,
+    CT_EAC_R11_SIGNED,
+    CT_EAC_RG11,
+    CT_EAC_RG11_SIGNED,
     CT_BC6H,
     CT_BC6H_SF,
     CT_BC7,
@@ -117,9 +122,14 @@ bool SupportsSSE();
 bool SupportsSSE2();
 
 CCodec* CreateCodec(CodecType nCodecType);
+const char* GetCodecName(CodecType nCodecType);
 CMP_DWORD CalcBufferSize(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight);
 CMP_DWORD CalcBufferSize(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwPitch, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight);
 
+// size_t versions of CalcBufferSize, return false if the size overflows. The CMP_DWORD versions return 0 in that case.
+bool CalcBufferSize64(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, size_t* pSize);
+bool CalcBufferSize64(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, size_t nPitch, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, size_t* pSize);
+
 CMP_BYTE DeriveB(CMP_BYTE R, CMP_BYTE G);
 CODECFLOAT DeriveB(CODECFLOAT R, CODECFLOAT G);
 
@@ -0,0 +1,79 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+//  File Name:   Codec_DXTC_Decode.h
+//  Description: row batch decoders for the BC1 - BC5 block formats
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _CODEC_DXTC_DECODE_H_INCLUDED_
+#define _CODEC_DXTC_DECODE_H_INCLUDED_
+
+#include "Compressonator.h"
+
+// Each row decoder expands dwBlocks consecutive 4x4 blocks (one block row of a
+// CCodecBuffer_Block) into a linear 8 bit destination.
+//
+//   pSrc      first compressed block of the row
+//   pDest     first pixel of the top scanline covered by the block row
+//   dwPitch   destination scanline pitch in bytes
+//   dwWidth   destination width in pixels, the last block is clipped to it
+//   dwHeight  scanlines left in the destination, at most 4 are written
+//
+// The RGBA8888 layout matches CCodecBuffer_RGBA8888 (one DWORD per pixel with
+// A in the top byte), R8 matches CCodecBuffer_R8 and RG8 matches CCodecBuffer_RG8.
+
+typedef enum _DXTCDecodePath
+{
+    DXTC_DECODE_SCALAR = 0,     // Reference path, bit exact with CCodec_DXTC::Decompress*Block
+    DXTC_DECODE_SSE2,
+    DXTC_DECODE_AVX2,
+} DXTCDecodePath;
+
+typedef enum _DXTCDecodeFormat
+{
+    DXTC_DECODE_RGBA8888 = 0,
+    DXTC_DECODE_R8,
+    DXTC_DECODE_RG8,
+} DXTCDecodeFormat;
+
+// Returns the path used by the row decoders, the best one this CPU supports unless overridden
+DXTCDecodePath DXTCGetDecodePath();
+
+// Overrides the decode path, requests above what the CPU supports are clamped.
+// DXTC_DECODE_SCALAR forces the reference path for exact match comparisons.
+void DXTCSetDecodePath(DXTCDecodePath path);
+
+void DXTCDecodeRowBC1(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle);
+void DXTCDecodeRowBC2(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle);
+void DXTCDecodeRowBC3(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle);
+
+// BC4 writes R8, or RGBA8888 with the value replicated to all four channels
+void DXTCDecodeRowBC4(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, DXTCDecodeFormat format);
+
+// BC5 writes RG8, or RGBA8888 with B = 0 and A = 255.
+// dwROffset is the DWORD offset (0 or 2) of the channel block decoded into R, the other goes to G.
+void DXTCDecodeRowBC5(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwROffset, DXTCDecodeFormat format);
+
+#endif // !defined(_CODEC_DXTC_DECODE_H_INCLUDED_)
@@ -34,16 +34,34 @@
 #define ATC_OFFSET_ALPHA 0
 #define ATC_OFFSET_RGB 2
 
+#define ETC_QUALITY_EXHAUSTIVE   0.6
+#define ETC_QUALITY_EAC_THOROUGH 0.3
+#define MAX_ETC_THREADS          128
+
 class CCodec_ETC2 : public CCodec_Block_4x4
 {
 public:
     CCodec_ETC2(CodecType codecType);
     virtual ~CCodec_ETC2();
 
+    virtual bool SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue);
+    virtual bool SetParameter(const CMP_CHAR* pszParamName, CMP_DWORD dwValue);
+    virtual bool SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue);
+
 protected:
     CodecError CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2]);
 
     void DecompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DWORD compressedBlock[2]);
 
+    // Encodes the block at block column i and block row j, called from the encode threads
+    virtual void CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j) = 0;
+    CodecError CompressBlockRows(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, bool bThreadSafeRead, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2);
+
+    struct EncodeThreadParam;
+    void CompressRows(EncodeThreadParam *tp);
+    static unsigned int _stdcall ThreadProcEncode(void* param);
+
+    CODECFLOAT  m_fQuality;         // ETC_QUALITY_EXHAUSTIVE and up select the exhaustive etcpack search, ETC_QUALITY_EAC_THOROUGH and up the thorough EAC search
+    CMP_DWORD   m_NumThreads;       // Number of threads used to encode block rows
 };
 #endif // !defined(_Codec_ETC2_H_INCLUDED_)
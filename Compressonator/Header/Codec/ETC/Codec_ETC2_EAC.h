@@ -0,0 +1,55 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   Codec_ETC2_EAC.h
+//  Description: interface for the CCodec_ETC2_EAC class
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Codec_ETC2_EAC_H_INCLUDED_
+#define _Codec_ETC2_EAC_H_INCLUDED_
+
+#include "Codec_ETC2.h"
+
+// EAC R11 and RG11, signed or unsigned as given by the codec type
+class CCodec_ETC2_EAC : public CCodec_ETC2
+{
+public:
+    CCodec_ETC2_EAC(CodecType codecType);
+    virtual ~CCodec_ETC2_EAC();
+
+    virtual CCodecBuffer* CreateBuffer(
+        CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, CMP_BYTE nBlockDepth,
+        CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwPitch = 0, CMP_BYTE* pData = 0) const;
+
+    virtual CodecError Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc = NULL, DWORD_PTR pUser1 = NULL, DWORD_PTR pUser2 = NULL);
+    virtual CodecError Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc = NULL, DWORD_PTR pUser1 = NULL, DWORD_PTR pUser2 = NULL);
+
+protected:
+    virtual void CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j);
+
+    bool    m_bSigned;          // SIGNED_R11 and SIGNED_RG11
+    int     m_nChannels;        // 1 for R11, 2 for RG11
+    bool    m_bByteSource;      // Source is RGBA8888, read its channels directly, set by Compress
+};
+#endif // !defined(_Codec_ETC2_EAC_H_INCLUDED_)
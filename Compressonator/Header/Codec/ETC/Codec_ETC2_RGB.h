@@ -43,5 +43,8 @@ public:
 
     virtual CodecError Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc = NULL, DWORD_PTR pUser1 = NULL, DWORD_PTR pUser2 = NULL);
     virtual CodecError Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc = NULL, DWORD_PTR pUser1 = NULL, DWORD_PTR pUser2 = NULL);
+
+protected:
+    virtual void CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j);
 };
 #endif // !defined(_Codec_ETC2_RGB_H_INCLUDED_)
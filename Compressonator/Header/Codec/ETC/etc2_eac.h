@@ -0,0 +1,48 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   etc2_eac.h
+//  Description: EAC block encoder and decoder used by the ETC2 RGBA8, R11 and RG11 codecs
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ETC2_EAC_H_INCLUDED_
+#define _ETC2_EAC_H_INCLUDED_
+
+#include "Compressonator.h"
+
+// An EAC block holds a base value, a multiplier, one of 16 modifier tables and a 3 bit
+// index per pixel in 64 bits. The ETC2 RGBA8 alpha channel uses it with 8 bit values,
+// R11 and RG11 use it with 11 bit values. Pixels are passed in row order, [y*4+x].
+// These functions keep no state and can be called from several threads at once.
+
+// 8 bit alpha of an ETC2 RGBA8 block
+void atiEncodeEACAlphaBlock(const CMP_BYTE alpha[16], CMP_BYTE compressed[8], bool fast);
+void atiDecodeEACAlphaBlock(CMP_BYTE alpha[16], const CMP_BYTE compressed[8]);
+
+// One channel of an R11 or RG11 block, as 16 bit values. For the signed formats
+// 1 stands for -1.0, 32768 for 0.0 and 65535 for 1.0, as in etcpack.
+void atiEncodeEAC11Block(const CMP_WORD values[16], bool isSigned, CMP_BYTE compressed[8], bool fast);
+void atiDecodeEAC11Block(CMP_WORD values[16], bool isSigned, const CMP_BYTE compressed[8]);
+
+#endif // !defined(_ETC2_EAC_H_INCLUDED_)
@@ -153,8 +153,13 @@ typedef enum
    CMP_FORMAT_ETC_RGB,                    ///< ETC  (Ericsson Texture Compression) 
    CMP_FORMAT_ETC2_RGB,                   ///< ETC2 (Ericsson Texture Compression) 
    CMP_FORMAT_GT,                         ///< GT   (Reserved for a future implementation)
+   CMP_FORMAT_ETC2_RGBA,                  ///< ETC2 RGB with an EAC compressed alpha channel. Eight bits per pixel.
+   CMP_FORMAT_EAC_R11,                    ///< Single component EAC compressed format with 11-bit precision. Four bits per pixel.
+   CMP_FORMAT_EAC_R11_SIGNED,             ///< Signed single component EAC compressed format with 11-bit precision. Four bits per pixel.
+   CMP_FORMAT_EAC_RG11,                   ///< Two component EAC compressed format with 11-bit precision. Eight bits per pixel.
+   CMP_FORMAT_EAC_RG11_SIGNED,            ///< Signed two component EAC compressed format with 11-bit precision. Eight bits per pixel.
                                           //--------------------------------------------------------------------------------------------------------
-   CMP_FORMAT_MAX = CMP_FORMAT_GT
+   CMP_FORMAT_MAX = CMP_FORMAT_EAC_RG11_SIGNED
 } CMP_FORMAT;
 
 /// An enum selecting the speed vs. quality trade-off.
@@ -165,12 +170,24 @@ typedef enum
    CMP_Speed_SuperFast,                   ///< Slightly lower quality but much, much faster compression mode - DXTn & ATInN only
 } CMP_Speed;
 
+/// An enum selecting a named ASTC encoder preset. Presets bound the partition search,
+/// block mode cutoff, refinement iterations and the early exit error limit.
+typedef enum
+{
+   CMP_ASTC_Speed_Quality,                ///< No preset, the encoder search is derived from fquality
+   CMP_ASTC_Speed_Fastest,                ///< Minimal partition and block mode search, loose early exit
+   CMP_ASTC_Speed_Fast,                   ///< Small partition and block mode search
+   CMP_ASTC_Speed_Medium,                 ///< Balanced search with two refinement iterations
+   CMP_ASTC_Speed_Thorough,               ///< Wide search with four refinement iterations, tight early exit
+} CMP_ASTC_Speed;
+
 /// An enum selecting the different GPU driver types.
 typedef enum
 {
     GPUDecode_OPENGL = 0,                  ///< Use OpenGL   to decode Textures
     GPUDecode_DIRECTX,                     ///< Use DirectX  to decode Textures
     GPUDecode_VULKAN,                      ///< Use Vulkan  to decode Textures
+    GPUDecode_CPU,                         ///< Use the multithreaded CPU decoders, also used when no GPU plugin can be loaded
     GPUDecode_INVALID
 } CMP_GPUDecode;
 
@@ -283,6 +300,11 @@ typedef struct
    double           fInputKneeLow;              ///< ToneMap properties for float type image send into non float compress algorithm.
    double           fInputKneeHigh;             ///< ToneMap properties for float type image send into non float compress algorithm.
    double           fInputGamma;                ///< ToneMap properties for float type image send into non float compress algorithm.
+   CMP_ASTC_Speed   nASTCSpeed;                 ///< ASTC only: named encoder preset. When set to CMP_ASTC_Speed_Quality (default) the search is derived from fquality
+   double           fRDOLambda;                 ///< BC1, BC3 & BC7 only: rate-distortion weight, 0 (default) disables the pass. After encoding, blocks take endpoints, selectors or byte runs
+                                                ///< of the blocks before them when that saves more LZ bits than it adds squared error divided by fRDOLambda, so the texture packs smaller with zstd or LZ4.
+                                                ///< The error is summed over the texels and channels of a block, a block never gains more than fRDOLambda times its size in bits. Typical values are 0.5 to 10
+   CMP_DWORD        dwRDOWindow;                ///< The number of preceding blocks the rate-distortion pass may copy from, 0 uses the default of 16
 
 } CMP_CompressOptions;
 
@@ -301,6 +323,31 @@ typedef struct
     CMP_BYTE*    pData;                      ///< Pointer to the texture data
 } CMP_Texture;
 
+/// The structure describing a texture whose data can be larger than a CMP_DWORD can count.
+/// Texture arrays and volume slices with block aligned heights can be described as one tall texture.
+typedef struct
+{
+    CMP_DWORD    dwSize;                     ///< Size of this structure.
+    CMP_DWORD    dwWidth;                    ///< Width of the texture.
+    CMP_DWORD    dwHeight;                   ///< Height of the texture.
+    size_t       nPitch;                     ///< Distance to start of next line - necessary only for uncompressed textures.
+    CMP_FORMAT   format;                     ///< Format of the texture.
+    CMP_BYTE     nBlockHeight;               ///< Size Block to use (Default is 4x4x1).
+    CMP_BYTE     nBlockWidth;                ///<
+    CMP_BYTE     nBlockDepth;                ///<
+    size_t       nDataSize;                  ///< Size of the allocated texture data.
+    CMP_BYTE*    pData;                      ///< Pointer to the texture data
+} CMP_Texture64;
+
+/// A rectangle of pixels in a texture.
+typedef struct
+{
+    CMP_DWORD    x;                          ///< Left edge.
+    CMP_DWORD    y;                          ///< Top edge.
+    CMP_DWORD    dwWidth;                    ///< Width of the rectangle.
+    CMP_DWORD    dwHeight;                   ///< Height of the rectangle.
+} CMP_Rect;
+
 #define MINIMUM_WEIGHT_VALUE 0.01f
 
 //=================================================================================
@@ -332,6 +379,17 @@ typedef enum _BC_ERROR
     BC_ERROR_OUT_OF_MEMORY,
 } BC_ERROR;
 
+// Pixel layouts accepted by the batch block encoders
+typedef enum _CMP_BLOCK_LAYOUT
+{
+    CMP_BLOCK_LAYOUT_RGBA8,       // 4 CMP_BYTE  per pixel, 0..255
+    CMP_BLOCK_LAYOUT_RGBA16F,     // 4 CMP_HALF  per pixel
+    CMP_BLOCK_LAYOUT_RGBA32F,     // 4 CMP_FLOAT per pixel
+} CMP_BLOCK_LAYOUT;
+
+// Handle to an asynchronous batch encode started by CMP_EncodeBC7BlocksAsync() or CMP_EncodeBC6HBlocksAsync()
+typedef struct _CMP_BLOCK_JOB CMP_BLOCK_JOB;
+
 
 class BC7BlockEncoder;
 class BC6HBlockEncoder;
@@ -360,7 +418,7 @@ extern "C" {
         CMP_WORD        dwMask;                // User can enable or disable specific modes default is 0xFFFF
         double          fExposure;             // Sets the image lighter (using larger values) or darker (using lower values) default is 0.95
         bool            bIsSigned;             // Specify if half floats are signed or unsigned BC6H_UF16 or BC6H_SF16
-        double          fQuality;              // Reserved: not used in BC6H at this time
+        double          fQuality;              // Sets how many two region shapes are fully encoded, 0.0 gives the fastest (4 shapes) and 1.0 searches all 32
         bool            bUsePatternRec;        // Reserved: for new algorithm to use mono pattern shape matching based on two pixel planes
     } CMP_BC6H_BLOCK_PARAMETERS;
 
@@ -452,6 +510,80 @@ extern "C" {
     BC_ERROR CMP_API CMP_DecodeBC6HBlock(BYTE* in, CMP_FLOAT  out[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT]);
     BC_ERROR CMP_API CMP_DecodeBC7Block(BYTE* in, double out[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT]);
 
+    //
+    // CMP_DecodeBC7Blocks() - Decode numBlocks contiguous BC7 blocks to 8 bit RGBA
+    //
+    // in must hold numBlocks * 16 bytes. out receives numBlocks * 64 bytes, one block after another,
+    // each block is 16 pixels in row-major order with the components in BC_COMPONENT order.
+    // This uses an integer decoder and does not require CMP_InitializeBCLibrary()
+    //
+    BC_ERROR CMP_API CMP_DecodeBC7Blocks(BYTE* in, CMP_DWORD numBlocks, BYTE* out);
+
+    //
+    // CMP_DecodeBC6HBlocks() - Decode numBlocks contiguous BC6H blocks to 16 bit float RGBA
+    //
+    // in must hold numBlocks * 16 bytes. out receives numBlocks * 64 half values, one block after another,
+    // each block is 16 pixels in row-major order with the components in BC_COMPONENT order and alpha set to 1.0.
+    // Set isSigned for BC6H_SF data. This uses an integer decoder and does not require CMP_InitializeBCLibrary()
+    //
+    BC_ERROR CMP_API CMP_DecodeBC6HBlocks(BYTE* in, CMP_DWORD numBlocks, CMP_HALF* out, BOOL isSigned);
+
+    //
+    // CMP_EncodeBC7Blocks()  - Encode numBlocks BC7  blocks using a pool of worker threads
+    // CMP_EncodeBC6HBlocks() - Encode numBlocks BC6H blocks using a pool of worker threads
+    //
+    // Arguments:
+    //
+    //      encoder       - Encoder created by CMP_CreateBC7Encoder() or CMP_CreateBC6HEncoder(). Each worker
+    //                      encodes with its own copy so the settings apply to every block
+    //
+    //      in            - First pixel of the first block, in the given layout with components in BC_COMPONENT order
+    //                      For BC7 floating point input is clamped to 0.0->1.0, for BC6H 8 bit input is scaled to 0.0->1.0
+    //
+    //      blockStride   - Bytes from the first pixel of one block to the first pixel of the next
+    //                      0 means the blocks are packed one after another (16 pixels per block)
+    //
+    //      rowStride     - Bytes from one row of 4 pixels in a block to the next
+    //                      0 means each block is 16 packed pixels in row-major order
+    //                      To encode a row of blocks straight from an image set rowStride to the image pitch
+    //                      and blockStride to 4 pixels
+    //
+    //      out           - Receives numBlocks * 16 bytes of compressed blocks in order
+    //
+    //      numThreads    - Number of worker threads, 0 uses one per processor
+    //
+    BC_ERROR CMP_API CMP_EncodeBC7Blocks(BC7BlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                         CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads);
+    BC_ERROR CMP_API CMP_EncodeBC6HBlocks(BC6HBlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                          CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads);
+
+    //
+    // CMP_EncodeBC7BlocksAsync()  - Start CMP_EncodeBC7Blocks()  and return without waiting for it to finish
+    // CMP_EncodeBC6HBlocksAsync() - Start CMP_EncodeBC6HBlocks() and return without waiting for it to finish
+    //
+    // The encoder settings are copied before returning, so the encoder may be destroyed straight away.
+    // in and out must stay valid until the job has completed.
+    //
+    // When all blocks are written pCallback (if not NULL) is called on a worker thread with the result and pUser.
+    // If job is not NULL it receives a handle that must be passed to CMP_WaitBlockJob(), otherwise the job
+    // cleans up after itself once the callback has returned.
+    //
+    typedef void (CMP_API * CMP_BlockJob_Proc)(BC_ERROR result, void* pUser);
+
+    BC_ERROR CMP_API CMP_EncodeBC7BlocksAsync(BC7BlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                              CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                              CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job);
+    BC_ERROR CMP_API CMP_EncodeBC6HBlocksAsync(BC6HBlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                               CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                               CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job);
+
+    //
+    // CMP_IsBlockJobDone() - Returns true once an asynchronous batch encode has written all of its blocks
+    // CMP_WaitBlockJob()   - Waits for an asynchronous batch encode, releases the handle and returns the encode result
+    //
+    bool     CMP_API CMP_IsBlockJobDone(CMP_BLOCK_JOB* job);
+    BC_ERROR CMP_API CMP_WaitBlockJob(CMP_BLOCK_JOB* job);
+
     //
     // CMP_DestroyBC6HEncoder() - Deletes a previously allocated encoder object
     // CMP_DestroyBC7Encoder()  - Deletes a previously allocated encoder object
@@ -489,6 +621,212 @@ extern "C" {
                                         const CMP_CompressOptions* pOptions,
                                         CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2);
 
+   /// Calculates the required buffer size for the specified texture without overflowing.
+   /// CMP_CalculateBufferSize returns 0 for textures whose size does not fit a CMP_DWORD.
+   /// \param[in] pTexture A pointer to the texture.
+   /// \param[out] pSize Receives the size of the buffer required to hold the texture data.
+   /// \return    CMP_OK if successful, CMP_ERR_INVALID_SOURCE_TEXTURE if the texture is invalid or its size overflows a size_t.
+   CMP_ERROR CMP_API CMP_CalculateBufferSize64(const CMP_Texture64* pTexture, size_t* pSize);
+
+   /// Converts the source texture to the destination texture like CMP_ConvertTexture, for textures larger than 4GB.
+   /// The texture is converted in bands of whole block rows with CMP_ConvertTexture, each band small enough
+   /// for the 32 bit codec buffers. The threaded encoders (ASTC, BC6H and BC7) are not guaranteed to give the same blocks as a single call.
+   /// \param[in] pSourceTexture A pointer to the source texture.
+   /// \param[in] pDestTexture A pointer to the destination texture.
+   /// \param[in] pOptions A pointer to the compression options - can be NULL.
+   /// \param[in] pFeedbackProc A pointer to the feedback function - can be NULL.
+   /// \param[in] pUser1 User data to pass to the feedback function.
+   /// \param[in] pUser2 User data to pass to the feedback function.
+   /// \return    CMP_OK if successful, otherwise the error code.
+   CMP_ERROR CMP_API CMP_ConvertTexture64(CMP_Texture64* pSourceTexture,
+                                          CMP_Texture64* pDestTexture,
+                                          const CMP_CompressOptions* pOptions,
+                                          CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2);
+
+   /// Re-encodes only the blocks of a texture that changed since it was last compressed.
+   /// The previous compressed data is copied to the destination and the dirty blocks are compressed
+   /// with CMP_ConvertTexture and written over it. Blocks are dirty if their pixels differ from
+   /// pPrevSourceTexture or if they overlap one of the dirty rectangles; if neither is given every block is
+   /// re-encoded. Works for every compressed destination format, the source must be uncompressed.
+   /// \param[in] pSourceTexture A pointer to the new source texture.
+   /// \param[in] pPrevSourceTexture A pointer to the source the previous data was compressed from - can be NULL.
+   /// \param[in] pDirtyRects Rectangles of the source that changed - can be NULL.
+   /// \param[in] dwNumRects The number of dirty rectangles.
+   /// \param[in] pPrevDestTexture A pointer to the previous compressed texture, it can share pData with pDestTexture.
+   /// \param[in] pDestTexture A pointer to the destination texture, same format and size as pPrevDestTexture.
+   /// \param[in] pOptions A pointer to the compression options - can be NULL.
+   /// \param[in] pFeedbackProc A pointer to the feedback function - can be NULL.
+   /// \param[in] pUser1 User data to pass to the feedback function.
+   /// \param[in] pUser2 User data to pass to the feedback function.
+   /// \param[out] pdwBlocksEncoded Receives the number of blocks that were re-encoded - can be NULL.
+   /// \return    CMP_OK if successful, otherwise the error code.
+   CMP_ERROR CMP_API CMP_UpdateTexture(CMP_Texture* pSourceTexture,
+                                       const CMP_Texture* pPrevSourceTexture,
+                                       const CMP_Rect* pDirtyRects, CMP_DWORD dwNumRects,
+                                       const CMP_Texture* pPrevDestTexture,
+                                       CMP_Texture* pDestTexture,
+                                       const CMP_CompressOptions* pOptions,
+                                       CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2,
+                                       CMP_DWORD* pdwBlocksEncoded);
+
+   //=================================================================================
+   // Streaming conversion
+   //
+   // CMP_ConvertTextureStream compresses a texture a band of block rows at a time, so neither
+   // the whole source nor the whole compressed result has to be in memory. The source rows are
+   // pulled through a read callback and each compressed band is passed to a write callback in
+   // order from the top. At most two source bands and one compressed band are held: the next band
+   // is read on a second thread while the current one is compressed, so the read callback must not
+   // rely on being called from the caller's thread. Each band is a separate CMP_ConvertTexture call, the
+   // threaded encoders (ASTC, BC6H and BC7) are not guaranteed to give the same blocks as a single call.
+   //=================================================================================
+
+   /// Supplies source rows for CMP_ConvertTextureStream.
+   /// \param[in] dwFirstRow The first row to read, counted from the top.
+   /// \param[in] dwNumRows The number of rows to read.
+   /// \param[out] pData Where to write the rows, in the stream's source format.
+   /// \param[in] dwPitch Distance in bytes between the rows in pData.
+   /// \param[in] pUser User data from CMP_TextureStream.
+   /// \return    CMP_OK to continue, any other value stops the conversion and is returned by it.
+   typedef CMP_ERROR (CMP_API * CMP_StreamRead_Proc)(CMP_DWORD dwFirstRow, CMP_DWORD dwNumRows, CMP_BYTE* pData, CMP_DWORD dwPitch, void* pUser);
+
+   /// Receives compressed block rows from CMP_ConvertTextureStream.
+   /// \param[in] dwFirstBlockRow The first block row in pData, counted from the top.
+   /// \param[in] dwNumBlockRows The number of block rows in pData.
+   /// \param[in] pData The compressed blocks, only valid during the call.
+   /// \param[in] dwDataSize The size of pData in bytes.
+   /// \param[in] pUser User data from CMP_TextureStream.
+   /// \return    CMP_OK to continue, any other value stops the conversion and is returned by it.
+   typedef CMP_ERROR (CMP_API * CMP_StreamWrite_Proc)(CMP_DWORD dwFirstBlockRow, CMP_DWORD dwNumBlockRows, const CMP_BYTE* pData, CMP_DWORD dwDataSize, void* pUser);
+
+   /// The structure describing a streamed texture conversion.
+   typedef struct
+   {
+      CMP_DWORD            dwSize;              ///< Size of this structure.
+      CMP_DWORD            dwWidth;             ///< Width of the texture.
+      CMP_DWORD            dwHeight;            ///< Height of the texture.
+      CMP_FORMAT           sourceFormat;        ///< Format of the source rows, must be uncompressed.
+      CMP_FORMAT           destFormat;          ///< Compressed format to convert to.
+      CMP_BYTE             nBlockWidth;         ///< Block size for ASTC (Default is 4x4).
+      CMP_BYTE             nBlockHeight;        ///<
+      CMP_DWORD            dwBandHeight;        ///< Source rows per band, at most the texture height, rounded up to whole block rows. 0 picks bands of about 64MB.
+      CMP_StreamRead_Proc  pReadProc;           ///< Supplies the source rows.
+      CMP_StreamWrite_Proc pWriteProc;          ///< Receives the compressed block rows.
+      void*                pUser;               ///< User data passed to both callbacks.
+   } CMP_TextureStream;
+
+   /// Compresses a texture band by band through the stream callbacks.
+   /// \param[in] pStream A pointer to the stream description.
+   /// \param[in] pOptions A pointer to the compression options - can be NULL.
+   /// \param[in] pFeedbackProc A pointer to the feedback function - can be NULL. The progress covers the whole texture.
+   /// \param[in] pUser1 User data to pass to the feedback function.
+   /// \param[in] pUser2 User data to pass to the feedback function.
+   /// \return    CMP_OK if successful, otherwise the error code.
+   CMP_ERROR CMP_API CMP_ConvertTextureStream(const CMP_TextureStream* pStream,
+                                              const CMP_CompressOptions* pOptions,
+                                              CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2);
+
+   //=================================================================================
+   // Asynchronous conversion
+   //
+   // CMP_ConvertTextureAsync queues a CMP_ConvertTexture call and returns a job handle straight
+   // away. Conversions are already threaded internally, so the scheduler runs one job at a time:
+   // the highest priority first, in submission order within a priority. A running job that is
+   // outranked by a waiting job is paused at its next feedback point and resumes once no higher
+   // priority job is left. Cancellation takes effect at the same points, which the codecs reach
+   // after every block row of each worker.
+   //=================================================================================
+
+   /// Handle to a queued or running conversion.
+   typedef struct _CMP_CONVERT_JOB CMP_CONVERT_JOB;
+
+   /// Suggested job priorities, any int can be used and higher values run first.
+   typedef enum _CMP_JOB_PRIORITY
+   {
+      CMP_PRIORITY_BACKGROUND  = 0,             ///< Bakes and batch work.
+      CMP_PRIORITY_NORMAL      = 100,           ///< Default.
+      CMP_PRIORITY_INTERACTIVE = 200,           ///< Previews the user is waiting for.
+   } CMP_JOB_PRIORITY;
+
+   /// Queues a conversion, see CMP_ConvertTexture for the texture and feedback arguments.
+   /// The source texture structure and the options are copied. The destination texture structure,
+   /// both data buffers and any option strings must stay valid until the job is done.
+   /// The feedback function is called from worker threads.
+   /// \param[in] nPriority The job priority, see CMP_JOB_PRIORITY.
+   /// \param[out] ppJob Receives the job handle, release it with CMP_DestroyConvertJob.
+   /// \return    CMP_OK if the job was queued, CMP_ERR_GENERIC otherwise. The conversion result is returned by CMP_WaitConvertJob.
+   CMP_ERROR CMP_API CMP_ConvertTextureAsync(CMP_Texture* pSourceTexture,
+                                             CMP_Texture* pDestTexture,
+                                             const CMP_CompressOptions* pOptions,
+                                             int nPriority,
+                                             CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2,
+                                             CMP_CONVERT_JOB** ppJob);
+
+   /// Returns true once the job is done and, if pResult is not NULL, sets it to the conversion result.
+   bool CMP_API CMP_PollConvertJob(CMP_CONVERT_JOB* pJob, CMP_ERROR* pResult);
+
+   /// Waits for the job to finish.
+   /// \return    The conversion result, CMP_ABORTED if the job was cancelled.
+   CMP_ERROR CMP_API CMP_WaitConvertJob(CMP_CONVERT_JOB* pJob);
+
+   /// Asks the job to stop. A queued job is dropped, a running or paused job stops at its next feedback point.
+   void CMP_API CMP_CancelConvertJob(CMP_CONVERT_JOB* pJob);
+
+   /// Returns the last progress reported by the job's codec, 0 to 100.
+   float CMP_API CMP_GetConvertJobProgress(CMP_CONVERT_JOB* pJob);
+
+   /// Changes the priority of a queued, running or paused job.
+   void CMP_API CMP_SetConvertJobPriority(CMP_CONVERT_JOB* pJob, int nPriority);
+
+   /// Cancels the job if it has not finished, waits for it and releases the handle.
+   void CMP_API CMP_DestroyConvertJob(CMP_CONVERT_JOB* pJob);
+
+   //=================================================================================
+   // Trace instrumentation
+   //
+   // The library, the image plugins and the applications record named scopes per thread
+   // while tracing is enabled. The recorded trace can be saved as Chrome trace-event JSON
+   // (chrome://tracing or ui.perfetto.dev) and summarised per scope. While tracing is
+   // disabled a scope costs a call to CMP_TraceBegin, which only loads the enabled flag, and
+   // recording an event takes a lock that only its own thread uses outside of collecting.
+   // Use the CMP_TRACE_SCOPE macros in CMP_Trace.h rather than calling CMP_TraceBegin and
+   // CMP_TraceEnd directly.
+   //
+   // Category and name strings must stay valid until the trace is written (string literals),
+   // detail strings are copied.
+   //=================================================================================
+
+   /// Starts or stops recording. Events recorded so far are kept.
+   void CMP_API CMP_TraceEnable(bool bEnable);
+
+   /// Returns true while events are being recorded.
+   bool CMP_API CMP_TraceIsEnabled();
+
+   /// Discards all recorded events. Events of scopes still running are recorded once they end.
+   void CMP_API CMP_TraceReset();
+
+   /// Returns the start time of a scope, or 0 when tracing is disabled.
+   unsigned long long CMP_API CMP_TraceBegin();
+
+   /// Records a scope started with CMP_TraceBegin. Ignored when nStart is 0.
+   void CMP_API CMP_TraceEnd(const char* pCategory, const char* pName, const char* pDetail, unsigned long long nStart);
+
+   /// Records a value on a counter track.
+   void CMP_API CMP_TraceCounter(const char* pName, double fValue);
+
+   /// Records the process working set and its peak (in MB) on the "Memory" counter track.
+   void CMP_API CMP_TraceMemory();
+
+   /// Names the calling thread in the trace.
+   void CMP_API CMP_TraceSetThreadName(const char* pName);
+
+   /// Writes all recorded events as Chrome trace-event JSON. Scopes still running are left out.
+   /// \return    CMP_OK if successful, CMP_ERR_GENERIC if the file could not be written.
+   CMP_ERROR CMP_API CMP_TraceWriteJSON(const char* pFileName);
+
+   /// Prints a table of call count, total, self and maximum time per scope to stdout. Scopes still running are left out.
+   void CMP_API CMP_TracePrintSummary();
+
 #ifdef __cplusplus
 };
 #endif
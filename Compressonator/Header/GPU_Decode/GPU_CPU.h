@@ -0,0 +1,65 @@
+//=====================================================================
+// Copyright (c) 2016    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+/// \file GPU_CPU.h
+//
+//=====================================================================
+
+#ifndef H_GPU_CPU
+#define H_GPU_CPU
+
+#include "GPU_DecodeBase.h"
+#include "PluginInterface.h"
+
+namespace GPU_Decode
+{
+    // Software backend for the GPU decode interface. Textures are decoded with the
+    // multithreaded CPU codecs and returned in the same channel order as the GPU plugins,
+    // so it can stand in for them on machines without a usable GPU driver.
+    class GPU_CPU : public TextureControl
+    {
+    public:
+        GPU_CPU(CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback);
+        ~GPU_CPU();
+
+        virtual CMP_ERROR WINAPI Decompress(
+            const CMP_Texture* pSourceTexture,
+            CMP_Texture* pDestTexture
+            ) const;
+    };
+}
+
+// Built in GPUDECODE plugin wrapping GPU_CPU, used for GPUDecode_CPU and
+// whenever the requested GPU plugin cannot be loaded or initialized
+class Plugin_CCPU : public PluginInterface_GPUDecode
+{
+public:
+        Plugin_CCPU();
+        virtual ~Plugin_CCPU();
+        int TC_PluginGetVersion(TC_PluginVersion* pPluginVersion);
+        int TC_Init(CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback);
+        CMP_ERROR TC_Decompress(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture);
+        int TC_Close();
+private:
+        GPU_Decode::TextureControl  *m_pGPUDecode;
+};
+
+#endif // !H_GPU_CPU
@@ -28,6 +28,15 @@
 
 #include "Compressonator.h"
 
+/// Throughput measured by CMP_BenchmarkDecompressTexture
+typedef struct
+{
+    CMP_GPUDecode   DecodeType;         ///< Backend that ran the decodes, GPUDecode_CPU if the requested GPU plugin was not available
+    CMP_DWORD       nIterations;        ///< Number of timed decodes
+    double          fTotalTime;         ///< Total time of the timed decodes in seconds
+    double          fMPixelsPerSec;     ///< Decoded mega pixels per second
+} CMP_DecodeBenchmark;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,6 +65,24 @@ extern "C" {
 //
     CMP_ERROR CMP_API CMP_ShutdownDecompessLibrary();
 
+//
+/// CMP_BenchmarkDecompressTexture - Decode the source texture nIterations times with the given backend
+/// and report the throughput, so GPU and CPU decode can be compared on the same machine
+/// \param[in] pSourceTexture A pointer to the source texture.
+/// \param[in] pDestTexture A pointer to the destination texture.
+/// \param[in] Type of GPU drivers to use for decode, GPUDecode_CPU for the software decoder
+/// \param[in] nIterations Number of timed decodes
+/// \param[out] pBenchmark The measured throughput
+/// \return    CMP_OK if successful, otherwise the error code.
+//
+    CMP_ERROR CMP_API CMP_BenchmarkDecompressTexture(
+        const CMP_Texture* pSourceTexture,
+              CMP_Texture* pDestTexture,
+              CMP_GPUDecode GPUDecodeType,
+              CMP_DWORD nIterations,
+              CMP_DecodeBenchmark* pBenchmark
+        );
+
 #ifdef __cplusplus
 };
 #endif
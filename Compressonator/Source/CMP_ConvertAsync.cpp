@@ -0,0 +1,334 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   CMP_ConvertAsync.cpp
+//  Description: Prioritised job scheduler for CMP_ConvertTextureAsync
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Compressonator.h"
+#include "CMP_Trace.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef enum _ConvertJobState
+{
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_PAUSED,
+    JOB_DONE,
+} ConvertJobState;
+
+struct _CMP_CONVERT_JOB
+{
+    CMP_Texture             source;
+    CMP_Texture*            pDest;
+    CMP_CompressOptions     options;
+    bool                    bOptions;
+    CMP_Feedback_Proc       pFeedbackProc;
+    DWORD_PTR               pUser1;
+    DWORD_PTR               pUser2;
+
+    // Guarded by the scheduler mutex
+    int                     nPriority;
+    unsigned long long      nSequence;
+    ConvertJobState         state;
+    CMP_ERROR               result;
+
+    volatile bool           bCancel;
+    volatile float          fProgress;
+    std::thread             thread;
+};
+
+//
+// Runs one job at a time, the highest priority first and FIFO within a priority.
+// Jobs give up the slot in Yield, called from the codec feedback points.
+//
+class CConvertScheduler
+{
+public:
+    CConvertScheduler() : m_nSequence(0), m_pRunning(NULL) {}
+
+    static CConvertScheduler& Instance()
+    {
+        static CConvertScheduler scheduler;
+        return scheduler;
+    }
+
+    void Submit(CMP_CONVERT_JOB* pJob)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pJob->state     = JOB_QUEUED;
+        pJob->nSequence = m_nSequence++;
+        m_jobs.push_back(pJob);
+        Dispatch();
+    }
+
+    // Pauses the calling job while a higher priority job is waiting
+    void Yield(CMP_CONVERT_JOB* pJob)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(pJob->state == JOB_RUNNING && m_pRunning == pJob && !pJob->bCancel && IsOutranked(pJob))
+        {
+            pJob->state = JOB_PAUSED;
+            m_pRunning  = NULL;
+            Dispatch();
+        }
+
+        // Every worker of a paused job waits here
+        while(pJob->state == JOB_PAUSED && !pJob->bCancel)
+            m_cv.wait(lock);
+    }
+
+    void Finish(CMP_CONVERT_JOB* pJob, CMP_ERROR result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pJob->result = result;
+        Remove(pJob);
+        Dispatch();
+        m_cv.notify_all();
+    }
+
+    void Cancel(CMP_CONVERT_JOB* pJob)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pJob->bCancel = true;
+
+        // A job that never started is dropped here, it has no thread to unwind
+        if(pJob->state == JOB_QUEUED)
+        {
+            pJob->result = CMP_ABORTED;
+            Remove(pJob);
+        }
+        m_cv.notify_all();
+    }
+
+    void SetPriority(CMP_CONVERT_JOB* pJob, int nPriority)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pJob->nPriority = nPriority;
+    }
+
+    bool IsDone(CMP_CONVERT_JOB* pJob, CMP_ERROR* pResult)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if(pJob->state != JOB_DONE)
+            return false;
+        if(pResult)
+            *pResult = pJob->result;
+        return true;
+    }
+
+    CMP_ERROR Wait(CMP_CONVERT_JOB* pJob)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(pJob->state != JOB_DONE)
+            m_cv.wait(lock);
+        return pJob->result;
+    }
+
+private:
+    bool Outranks(const CMP_CONVERT_JOB* pA, const CMP_CONVERT_JOB* pB) const
+    {
+        if(pA->nPriority != pB->nPriority)
+            return pA->nPriority > pB->nPriority;
+        return pA->nSequence < pB->nSequence;
+    }
+
+    bool IsOutranked(const CMP_CONVERT_JOB* pJob) const
+    {
+        for(size_t i = 0; i < m_jobs.size(); i++)
+        {
+            if(m_jobs[i] != pJob && !m_jobs[i]->bCancel && m_jobs[i]->nPriority > pJob->nPriority)
+                return true;
+        }
+        return false;
+    }
+
+    void Remove(CMP_CONVERT_JOB* pJob)
+    {
+        for(size_t i = 0; i < m_jobs.size(); i++)
+        {
+            if(m_jobs[i] == pJob)
+            {
+                m_jobs.erase(m_jobs.begin() + i);
+                break;
+            }
+        }
+        if(m_pRunning == pJob)
+            m_pRunning = NULL;
+        pJob->state = JOB_DONE;
+    }
+
+    // Called with the mutex held, starts or resumes the best waiting job if the slot is free
+    void Dispatch()
+    {
+        if(m_pRunning)
+            return;
+
+        CMP_CONVERT_JOB* pBest = NULL;
+        for(size_t i = 0; i < m_jobs.size(); i++)
+        {
+            CMP_CONVERT_JOB* pJob = m_jobs[i];
+            if((pJob->state == JOB_QUEUED || pJob->state == JOB_PAUSED) && (!pBest || Outranks(pJob, pBest)))
+                pBest = pJob;
+        }
+        if(!pBest)
+            return;
+
+        m_pRunning = pBest;
+        if(pBest->state == JOB_PAUSED)
+        {
+            pBest->state = JOB_RUNNING;
+            m_cv.notify_all();
+            return;
+        }
+
+        pBest->state = JOB_RUNNING;
+        try
+        {
+            pBest->thread = std::thread(JobProc, pBest);
+        }
+        catch(...)
+        {
+            pBest->result = CMP_ERR_GENERIC;
+            Remove(pBest);
+            m_cv.notify_all();
+            Dispatch();
+        }
+    }
+
+    static void JobProc(CMP_CONVERT_JOB* pJob);
+
+    std::mutex                      m_mutex;
+    std::condition_variable         m_cv;
+    std::vector<CMP_CONVERT_JOB*>   m_jobs;         // Queued, running and paused jobs
+    unsigned long long              m_nSequence;
+    CMP_CONVERT_JOB*                m_pRunning;     // Job holding the slot, NULL if free
+};
+
+// Wraps the caller's feedback proc, it is called by the codecs after every block row
+static bool CMP_API ConvertJobFeedback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    CMP_CONVERT_JOB* pJob = (CMP_CONVERT_JOB*) pUser1;
+    pJob->fProgress = fProgress;
+
+    if(!pJob->bCancel && pJob->pFeedbackProc && pJob->pFeedbackProc(fProgress, pJob->pUser1, pJob->pUser2))
+        pJob->bCancel = true;
+
+    if(!pJob->bCancel)
+        CConvertScheduler::Instance().Yield(pJob);
+
+    return pJob->bCancel;
+}
+
+void CConvertScheduler::JobProc(CMP_CONVERT_JOB* pJob)
+{
+    CMP_TRACE_THREAD_NAME("Convert Job");
+
+    CMP_ERROR result = CMP_ABORTED;
+    if(!pJob->bCancel)
+        result = CMP_ConvertTexture(&pJob->source, pJob->pDest, pJob->bOptions ? &pJob->options : NULL, ConvertJobFeedback, (DWORD_PTR) pJob, NULL);
+
+    if(pJob->bCancel)
+        result = CMP_ABORTED;
+    else if(result == CMP_OK)
+        pJob->fProgress = 100.0f;
+
+    Instance().Finish(pJob, result);
+}
+
+CMP_ERROR CMP_API CMP_ConvertTextureAsync(CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions, int nPriority,
+                                          CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CMP_CONVERT_JOB** ppJob)
+{
+    if(!ppJob || !pSourceTexture || !pDestTexture)
+        return CMP_ERR_GENERIC;
+
+    CMP_CONVERT_JOB* pJob = new CMP_CONVERT_JOB;
+    pJob->source        = *pSourceTexture;
+    pJob->pDest         = pDestTexture;
+    pJob->bOptions      = (pOptions != NULL);
+    if(pOptions)
+        pJob->options   = *pOptions;
+    pJob->pFeedbackProc = pFeedbackProc;
+    pJob->pUser1        = pUser1;
+    pJob->pUser2        = pUser2;
+    pJob->nPriority     = nPriority;
+    pJob->nSequence     = 0;
+    pJob->state         = JOB_QUEUED;
+    pJob->result        = CMP_OK;
+    pJob->bCancel       = false;
+    pJob->fProgress     = 0.0f;
+
+    *ppJob = pJob;
+    CConvertScheduler::Instance().Submit(pJob);
+    return CMP_OK;
+}
+
+bool CMP_API CMP_PollConvertJob(CMP_CONVERT_JOB* pJob, CMP_ERROR* pResult)
+{
+    if(!pJob)
+        return true;
+    return CConvertScheduler::Instance().IsDone(pJob, pResult);
+}
+
+CMP_ERROR CMP_API CMP_WaitConvertJob(CMP_CONVERT_JOB* pJob)
+{
+    if(!pJob)
+        return CMP_ERR_GENERIC;
+    return CConvertScheduler::Instance().Wait(pJob);
+}
+
+void CMP_API CMP_CancelConvertJob(CMP_CONVERT_JOB* pJob)
+{
+    if(pJob)
+        CConvertScheduler::Instance().Cancel(pJob);
+}
+
+float CMP_API CMP_GetConvertJobProgress(CMP_CONVERT_JOB* pJob)
+{
+    if(!pJob)
+        return 0.0f;
+    return pJob->fProgress;
+}
+
+void CMP_API CMP_SetConvertJobPriority(CMP_CONVERT_JOB* pJob, int nPriority)
+{
+    if(pJob)
+        CConvertScheduler::Instance().SetPriority(pJob, nPriority);
+}
+
+void CMP_API CMP_DestroyConvertJob(CMP_CONVERT_JOB* pJob)
+{
+    if(!pJob)
+        return;
+
+    CConvertScheduler& scheduler = CConvertScheduler::Instance();
+    if(!scheduler.IsDone(pJob, NULL))
+        scheduler.Cancel(pJob);
+    scheduler.Wait(pJob);
+
+    if(pJob->thread.joinable())
+        pJob->thread.join();
+    delete pJob;
+}
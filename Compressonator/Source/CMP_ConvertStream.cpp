@@ -0,0 +1,236 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   CMP_ConvertStream.cpp
+//  Description: Band by band compression of textures too large to hold in memory
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Compressonator.h"
+#include "Compress.h"
+#include "CMP_Trace.h"
+#include <thread>
+#include <vector>
+
+extern CodecType GetCodecType(CMP_FORMAT format);
+
+// Source bytes per band when the caller leaves dwBandHeight at 0
+#define STREAM_DEFAULT_BAND_BYTES   (64 * 1024 * 1024)
+
+typedef struct
+{
+    CMP_Feedback_Proc   pFeedbackProc;
+    DWORD_PTR           pUser1;
+    DWORD_PTR           pUser2;
+    float               fBase;              // Progress at the start of the current band
+    float               fScale;             // Share of the whole texture taken by the current band
+} StreamFeedback;
+
+// Maps the progress of one band onto the whole texture
+static bool CMP_API StreamFeedbackProc(float fProgress, DWORD_PTR pUser1, DWORD_PTR /*pUser2*/)
+{
+    StreamFeedback* pFeedback = (StreamFeedback*) pUser1;
+    return pFeedback->pFeedbackProc(pFeedback->fBase + fProgress * pFeedback->fScale, pFeedback->pUser1, pFeedback->pUser2);
+}
+
+typedef struct
+{
+    const CMP_TextureStream* pStream;
+    CMP_DWORD                dwFirstRow;
+    CMP_DWORD                dwNumRows;
+    CMP_BYTE*                pData;
+    CMP_DWORD                dwPitch;
+    CMP_ERROR                result;
+} StreamBand;
+
+static void ReadBand(StreamBand* pBand)
+{
+    CMP_TRACE_SCOPE("IO", "Stream Read Band");
+    pBand->result = pBand->pStream->pReadProc(pBand->dwFirstRow, pBand->dwNumRows, pBand->pData, pBand->dwPitch, pBand->pStream->pUser);
+}
+
+CMP_ERROR CMP_API CMP_ConvertTextureStream(const CMP_TextureStream* pStream, const CMP_CompressOptions* pOptions,
+                                           CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    if(!pStream || pStream->dwSize != sizeof(CMP_TextureStream) || !pStream->pReadProc || !pStream->pWriteProc)
+        return CMP_ERR_GENERIC;
+
+    if(pStream->dwWidth == 0 || pStream->dwHeight == 0)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    if(GetCodecType(pStream->sourceFormat) != CT_None)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    CodecType destType = GetCodecType(pStream->destFormat);
+    if(destType == CT_None || destType == CT_Unknown)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    // Only ASTC has a variable block size
+    CMP_DWORD dwBlockHeight = 4;
+    if(destType == CT_ASTC && pStream->nBlockHeight)
+        dwBlockHeight = pStream->nBlockHeight;
+
+    CMP_DWORD dwPitch = CalcBufferSize(pStream->sourceFormat, pStream->dwWidth, 1, 0, 0, 0);
+    if(dwPitch == 0)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    // Clamped to the image before rounding up to whole block rows, so a large request can't overflow
+    CMP_DWORD dwBandHeight = pStream->dwBandHeight;
+    if(dwBandHeight == 0)
+        dwBandHeight = STREAM_DEFAULT_BAND_BYTES / dwPitch;
+    if(dwBandHeight > pStream->dwHeight)
+        dwBandHeight = pStream->dwHeight;
+    dwBandHeight = ((dwBandHeight + dwBlockHeight - 1) / dwBlockHeight) * dwBlockHeight;
+    if(dwBandHeight == 0)
+        dwBandHeight = dwBlockHeight;
+
+    // A band has to fit the CMP_DWORD data size of the codec buffers
+    const CMP_DWORD dwMaxBandBytes = (CMP_DWORD) ~0;
+    if((size_t) dwPitch * dwBandHeight > dwMaxBandBytes)
+        dwBandHeight = ((dwMaxBandBytes / dwPitch) / dwBlockHeight) * dwBlockHeight;
+    if(dwBandHeight == 0)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    CMP_Texture srcBand;
+    srcBand.dwSize          = sizeof(srcBand);
+    srcBand.dwWidth         = pStream->dwWidth;
+    srcBand.dwHeight        = dwBandHeight;
+    srcBand.dwPitch         = dwPitch;
+    srcBand.format          = pStream->sourceFormat;
+    srcBand.nBlockWidth     = pStream->nBlockWidth;
+    srcBand.nBlockHeight    = pStream->nBlockHeight;
+    srcBand.nBlockDepth     = 1;
+    srcBand.dwDataSize      = dwPitch * dwBandHeight;
+    srcBand.pData           = NULL;
+
+    CMP_Texture destBand;
+    destBand.dwSize         = sizeof(destBand);
+    destBand.dwWidth        = pStream->dwWidth;
+    destBand.dwHeight       = dwBandHeight;
+    destBand.dwPitch        = 0;
+    destBand.format         = pStream->destFormat;
+    destBand.nBlockWidth    = pStream->nBlockWidth;
+    destBand.nBlockHeight   = pStream->nBlockHeight;
+    destBand.nBlockDepth    = 1;
+    destBand.dwDataSize     = CMP_CalculateBufferSize(&destBand);
+    destBand.pData          = NULL;
+
+    if(destBand.dwDataSize == 0)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    // One band is compressed while the next is read into the other buffer
+    std::vector<CMP_BYTE> srcData[2];
+    std::vector<CMP_BYTE> destData;
+    try
+    {
+        srcData[0].resize(srcBand.dwDataSize);
+        srcData[1].resize(srcBand.dwDataSize);
+        destData.resize(destBand.dwDataSize);
+    }
+    catch(...)
+    {
+        return CMP_ERR_GENERIC;
+    }
+
+    CMP_TRACE_SCOPE("Convert", "CMP_ConvertTextureStream");
+
+    CMP_DWORD dwNumBands = (pStream->dwHeight + dwBandHeight - 1) / dwBandHeight;
+
+    StreamFeedback feedback;
+    feedback.pFeedbackProc  = pFeedbackProc;
+    feedback.pUser1         = pUser1;
+    feedback.pUser2         = pUser2;
+    feedback.fBase          = 0.0f;
+    feedback.fScale         = 1.0f / dwNumBands;
+
+    StreamBand bands[2];
+    for(int i = 0; i < 2; i++)
+    {
+        bands[i].pStream    = pStream;
+        bands[i].dwFirstRow = 0;
+        bands[i].dwNumRows  = 0;
+        bands[i].pData      = &srcData[i][0];
+        bands[i].dwPitch    = dwPitch;
+        bands[i].result     = CMP_OK;
+    }
+
+    bands[0].dwNumRows = dwBandHeight < pStream->dwHeight ? dwBandHeight : pStream->dwHeight;
+    ReadBand(&bands[0]);
+
+    CMP_ERROR result = CMP_OK;
+    for(CMP_DWORD nBand = 0; nBand < dwNumBands; nBand++)
+    {
+        StreamBand& band = bands[nBand & 1];
+        if(band.result != CMP_OK)
+        {
+            result = band.result;
+            break;
+        }
+
+        // Start reading the next band
+        std::thread reader;
+        StreamBand* pNext = NULL;
+        if(nBand + 1 < dwNumBands)
+        {
+            pNext = &bands[(nBand + 1) & 1];
+            pNext->dwFirstRow = band.dwFirstRow + dwBandHeight;
+            pNext->dwNumRows  = pStream->dwHeight - pNext->dwFirstRow;
+            if(pNext->dwNumRows > dwBandHeight)
+                pNext->dwNumRows = dwBandHeight;
+
+            try
+            {
+                reader = std::thread(ReadBand, pNext);
+            }
+            catch(...)
+            {
+                ReadBand(pNext);
+            }
+        }
+
+        // The last band can end part way through a block row, the codecs pad it as usual
+        srcBand.dwHeight    = band.dwNumRows;
+        srcBand.dwDataSize  = dwPitch * band.dwNumRows;
+        srcBand.pData       = band.pData;
+        destBand.dwHeight   = band.dwNumRows;
+        destBand.dwDataSize = CMP_CalculateBufferSize(&destBand);
+        destBand.pData      = &destData[0];
+
+        feedback.fBase = 100.0f * nBand / dwNumBands;
+        result = CMP_ConvertTexture(&srcBand, &destBand, pOptions, pFeedbackProc ? StreamFeedbackProc : NULL, (DWORD_PTR) &feedback, NULL);
+
+        if(result == CMP_OK)
+        {
+            CMP_TRACE_SCOPE("IO", "Stream Write Band");
+            CMP_DWORD dwFirstBlockRow = band.dwFirstRow / dwBlockHeight;
+            CMP_DWORD dwNumBlockRows  = (band.dwNumRows + dwBlockHeight - 1) / dwBlockHeight;
+            result = pStream->pWriteProc(dwFirstBlockRow, dwNumBlockRows, destBand.pData, destBand.dwDataSize, pStream->pUser);
+        }
+
+        if(reader.joinable())
+            reader.join();
+
+        if(result != CMP_OK)
+            break;
+    }
+
+    return result;
+}
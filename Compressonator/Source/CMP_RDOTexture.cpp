@@ -0,0 +1,723 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   CMP_RDOTexture.cpp
+//  Description: Rate-distortion pass over BC1, BC3 and BC7 blocks, makes the
+//               compressed data cheaper for an LZ coder such as zstd to pack
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Compressonator.h"
+#include "Compress.h"
+#include "CMP_Trace.h"
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <vector>
+#include <thread>
+
+extern CodecType GetCodecType(CMP_FORMAT format);
+
+// The blocks are revisited in the order they are stored. Each block is replaced by the candidate
+// with the lowest cost J = D + lambda * R, where D is the squared error of the decoded texels and
+// R the bits an LZ coder is estimated to spend on the block after the blocks before it. Candidates
+// copy endpoints, selectors or whole byte runs from the blocks in the window behind the current one,
+// so matches get longer and more frequent. The original block is always a candidate and R is never
+// below zero, so no block gains more than lambda times its size in bits of squared error.
+
+#define RDO_DEFAULT_WINDOW      16          // Blocks looked back when CMP_CompressOptions::dwRDOWindow is 0
+#define RDO_MAX_WINDOW          1024
+#define RDO_MIN_MATCH           4           // Shortest match the LZ model takes, LZ4 and the fast zstd levels use 4 or more
+#define RDO_LITERAL_BITS        8.0         // Compressed blocks are close to random, literals barely compress
+#define RDO_MATCH_BITS          20.0        // Offset and length of a short match
+#define RDO_HASH_BITS           14
+#define RDO_MAX_CHAIN           32          // Positions the match finder tries per hash
+#define RDO_MIN_STRIP_ROWS      16          // Block rows per thread, the match window does not cross strips
+
+enum RDOBlockFormat
+{
+    RDO_BC1,
+    RDO_BC3,
+    RDO_BC7,
+};
+
+struct RDOContext
+{
+    RDOBlockFormat  format;
+    CMP_DWORD       dwBlockBytes;
+    CMP_DWORD       dwWindow;
+    double          fLambda;
+    bool            bDXT1UseAlpha;
+    CMP_BYTE        nAlphaThreshold;
+    int             nRed;           // Source byte of the channel the 565 endpoints keep in their top bits
+    int             nBlue;          // Source byte of the channel in their low bits
+};
+
+//
+// BC1 & BC3 decoding, the same arithmetic as CCodec_DXTC so the error matches the codec's own decode
+//
+
+static void ColourPalette(const RDOContext& ctx, const CMP_BYTE* pColour, bool bDXT1, CMP_BYTE palette[4][4])
+{
+    CMP_DWORD n0 = pColour[0] | (pColour[1] << 8);
+    CMP_DWORD n1 = pColour[2] | (pColour[3] << 8);
+
+    CMP_DWORD c[2][3];
+    c[0][0] = (n0 & 0xf800) >> 8;   c[0][1] = (n0 & 0x07e0) >> 3;   c[0][2] = (n0 & 0x001f) << 3;
+    c[1][0] = (n1 & 0xf800) >> 8;   c[1][1] = (n1 & 0x07e0) >> 3;   c[1][2] = (n1 & 0x001f) << 3;
+    for(int e = 0; e < 2; e++)
+    {
+        c[e][0] += c[e][0] >> 5;
+        c[e][1] += c[e][1] >> 6;
+        c[e][2] += c[e][2] >> 5;
+    }
+
+    const int nChannel[3] = { ctx.nRed, 1, ctx.nBlue };
+    for(int ch = 0; ch < 3; ch++)
+    {
+        CMP_DWORD a = c[0][ch];
+        CMP_DWORD b = c[1][ch];
+        palette[0][nChannel[ch]] = (CMP_BYTE) a;
+        palette[1][nChannel[ch]] = (CMP_BYTE) b;
+        if(!bDXT1 || n0 > n1)
+        {
+            palette[2][nChannel[ch]] = (CMP_BYTE) ((2*a + b + 1) / 3);
+            palette[3][nChannel[ch]] = (CMP_BYTE) ((2*b + a + 1) / 3);
+        }
+        else
+        {
+            palette[2][nChannel[ch]] = (CMP_BYTE) ((a + b) / 2);
+            palette[3][nChannel[ch]] = 0;
+        }
+    }
+
+    palette[0][3] = palette[1][3] = palette[2][3] = 0xff;
+    palette[3][3] = (!bDXT1 || n0 > n1) ? 0xff : 0;
+}
+
+static bool ThreeColourMode(const CMP_BYTE* pColour)
+{
+    return (pColour[0] | (pColour[1] << 8)) <= (pColour[2] | (pColour[3] << 8));
+}
+
+static void DecodeColour(const RDOContext& ctx, const CMP_BYTE* pColour, bool bDXT1, CMP_BYTE texels[BLOCK_SIZE_4X4X4])
+{
+    CMP_BYTE palette[4][4];
+    ColourPalette(ctx, pColour, bDXT1, palette);
+
+    CMP_DWORD dwIndices = pColour[4] | (pColour[5] << 8) | (pColour[6] << 16) | ((CMP_DWORD) pColour[7] << 24);
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        memcpy(&texels[i * 4], palette[(dwIndices >> (2 * i)) & 3], 4);
+}
+
+static void AlphaPalette(const CMP_BYTE* pAlpha, CMP_BYTE alpha[8])
+{
+    alpha[0] = pAlpha[0];
+    alpha[1] = pAlpha[1];
+    if(alpha[0] > alpha[1])
+    {
+        for(int i = 1; i < 7; i++)
+            alpha[i + 1] = (CMP_BYTE) (((7 - i) * alpha[0] + i * alpha[1] + 3) / 7);
+    }
+    else
+    {
+        for(int i = 1; i < 5; i++)
+            alpha[i + 1] = (CMP_BYTE) (((5 - i) * alpha[0] + i * alpha[1] + 2) / 5);
+        alpha[6] = 0;
+        alpha[7] = 255;
+    }
+}
+
+// The 48 index bits follow the two endpoints, 3 bits per texel
+static CMP_DWORD AlphaIndex(const CMP_BYTE* pAlpha, int i)
+{
+    int nBit = 16 + i * 3;
+    CMP_DWORD dwBits = pAlpha[nBit >> 3] | (((nBit >> 3) < 7 ? pAlpha[(nBit >> 3) + 1] : 0) << 8);
+    return (dwBits >> (nBit & 7)) & 7;
+}
+
+static void DecodeAlpha(const CMP_BYTE* pAlpha, CMP_BYTE texels[BLOCK_SIZE_4X4X4])
+{
+    CMP_BYTE alpha[8];
+    AlphaPalette(pAlpha, alpha);
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        texels[i * 4 + 3] = alpha[AlphaIndex(pAlpha, i)];
+}
+
+// Squared error of a candidate over the texels inside the texture
+static CMP_DWORD BlockError(const RDOContext& ctx, const CMP_BYTE* pBlock, const CMP_BYTE source[BLOCK_SIZE_4X4X4], CMP_DWORD dwTexelMask)
+{
+    CMP_BYTE texels[BLOCK_SIZE_4X4X4];
+    int nChannels = 4;
+    switch(ctx.format)
+    {
+    case RDO_BC1:
+        DecodeColour(ctx, pBlock, true, texels);
+        if(!ctx.bDXT1UseAlpha)
+            nChannels = 3;
+        break;
+    case RDO_BC3:
+        DecodeColour(ctx, pBlock + 8, false, texels);
+        DecodeAlpha(pBlock, texels);
+        break;
+    default:
+        CMP_DecodeBC7Blocks((BYTE*) pBlock, 1, texels);
+        break;
+    }
+
+    CMP_DWORD dwError = 0;
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+    {
+        if(!(dwTexelMask & (1 << i)))
+            continue;
+
+        for(int ch = 0; ch < 3; ch++)
+        {
+            int d = (int) texels[i * 4 + ch] - (int) source[i * 4 + ch];
+            dwError += d * d;
+        }
+
+        if(nChannels == 4)
+        {
+            // BC1 alpha is a single bit, the source is compared as the codec thresholds it
+            int nSource = source[i * 4 + 3];
+            if(ctx.format == RDO_BC1)
+                nSource = nSource < ctx.nAlphaThreshold ? 0 : 0xff;
+            int d = (int) texels[i * 4 + 3] - nSource;
+            dwError += d * d;
+        }
+    }
+    return dwError;
+}
+
+// Picks the closest colour of the endpoints in pColour for every texel
+static void RefitColourIndices(const RDOContext& ctx, CMP_BYTE* pColour, bool bDXT1, const CMP_BYTE source[BLOCK_SIZE_4X4X4])
+{
+    CMP_BYTE palette[4][4];
+    ColourPalette(ctx, pColour, bDXT1, palette);
+
+    bool bThreeColour = bDXT1 && ThreeColourMode(pColour);
+    int nColours = bThreeColour ? 3 : 4;
+
+    CMP_DWORD dwIndices = 0;
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+    {
+        const CMP_BYTE* pTexel = &source[i * 4];
+        CMP_DWORD dwBest = 0;
+        if(bThreeColour && ctx.bDXT1UseAlpha && pTexel[3] < ctx.nAlphaThreshold)
+            dwBest = 3;
+        else
+        {
+            int nBestError = INT_MAX;
+            for(int c = 0; c < nColours; c++)
+            {
+                int nError = 0;
+                for(int ch = 0; ch < 3; ch++)
+                {
+                    int d = (int) palette[c][ch] - (int) pTexel[ch];
+                    nError += d * d;
+                }
+                if(nError < nBestError)
+                {
+                    nBestError = nError;
+                    dwBest     = c;
+                }
+            }
+        }
+        dwIndices |= dwBest << (2 * i);
+    }
+
+    pColour[4] = (CMP_BYTE) dwIndices;
+    pColour[5] = (CMP_BYTE) (dwIndices >> 8);
+    pColour[6] = (CMP_BYTE) (dwIndices >> 16);
+    pColour[7] = (CMP_BYTE) (dwIndices >> 24);
+}
+
+static void RefitAlphaIndices(CMP_BYTE* pAlpha, const CMP_BYTE source[BLOCK_SIZE_4X4X4])
+{
+    CMP_BYTE alpha[8];
+    AlphaPalette(pAlpha, alpha);
+
+    unsigned long long ullIndices = 0;
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+    {
+        int nBest      = 0;
+        int nBestError = INT_MAX;
+        for(int a = 0; a < 8; a++)
+        {
+            int nError = abs((int) alpha[a] - (int) source[i * 4 + 3]);
+            if(nError < nBestError)
+            {
+                nBestError = nError;
+                nBest      = a;
+            }
+        }
+        ullIndices |= (unsigned long long) nBest << (3 * i);
+    }
+
+    for(int i = 0; i < 6; i++)
+        pAlpha[2 + i] = (CMP_BYTE) (ullIndices >> (8 * i));
+}
+
+//
+// LZ match model over one strip of blocks, a hash chain of the finished bytes in the window
+//
+
+class RDOMatchModel
+{
+public:
+    RDOMatchModel(const CMP_BYTE* pData, CMP_DWORD dwWindowBytes)
+        : m_pData(pData)
+        , m_dwInserted(0)
+    {
+        CMP_DWORD dwRing = 1;
+        while(dwRing < dwWindowBytes + RDO_MIN_MATCH)
+            dwRing <<= 1;
+        m_Head.assign(1 << RDO_HASH_BITS, -1);
+        m_Prev.assign(dwRing, -1);
+        m_dwRingMask = dwRing - 1;
+    }
+
+    // Makes the bytes before dwEnd searchable, they must not change afterwards
+    void Insert(CMP_DWORD dwEnd)
+    {
+        for(; m_dwInserted + RDO_MIN_MATCH <= dwEnd; m_dwInserted++)
+        {
+            CMP_DWORD h = Hash(m_pData + m_dwInserted);
+            m_Prev[m_dwInserted & m_dwRingMask] = m_Head[h];
+            m_Head[h] = (int) m_dwInserted;
+        }
+    }
+
+    // Estimated bits for a block placed at dwBase, matches may start from dwWindowStart on
+    double Bits(const CMP_BYTE* pBlock, CMP_DWORD dwBlockBytes, CMP_DWORD dwBase, CMP_DWORD dwWindowStart) const
+    {
+        double fBits = 0;
+        CMP_DWORD i = 0;
+        while(i < dwBlockBytes)
+        {
+            CMP_DWORD dwBest = 0;
+
+            // Matches starting in the hashed bytes
+            if(i + RDO_MIN_MATCH <= dwBlockBytes)
+            {
+                int nPos = m_Head[Hash(pBlock + i)];
+                for(int nChain = 0; nPos >= (int) dwWindowStart && nChain < RDO_MAX_CHAIN; nChain++)
+                {
+                    CMP_DWORD dwLength = MatchLength(pBlock, dwBlockBytes, dwBase, nPos, i);
+                    if(dwLength > dwBest)
+                        dwBest = dwLength;
+
+                    int nNext = m_Prev[nPos & m_dwRingMask];
+                    if(nNext >= nPos)
+                        break;
+                    nPos = nNext;
+                }
+            }
+
+            // Matches starting in the bytes not hashed yet, the end of the window and the block itself
+            CMP_DWORD dwStart = dwBase >= RDO_MIN_MATCH - 1 ? dwBase - (RDO_MIN_MATCH - 1) : 0;
+            if(dwStart < dwWindowStart)
+                dwStart = dwWindowStart;
+            for(CMP_DWORD dwPos = dwStart; dwPos < dwBase + i; dwPos++)
+            {
+                CMP_DWORD dwLength = MatchLength(pBlock, dwBlockBytes, dwBase, dwPos, i);
+                if(dwLength > dwBest)
+                    dwBest = dwLength;
+            }
+
+            if(dwBest >= RDO_MIN_MATCH)
+            {
+                fBits += RDO_MATCH_BITS;
+                i     += dwBest;
+            }
+            else
+            {
+                fBits += RDO_LITERAL_BITS;
+                i++;
+            }
+        }
+        return fBits;
+    }
+
+private:
+    static CMP_DWORD Hash(const CMP_BYTE* p)
+    {
+        CMP_DWORD dwValue = p[0] | (p[1] << 8) | (p[2] << 16) | ((CMP_DWORD) p[3] << 24);
+        return ((dwValue * 2654435761u) >> (32 - RDO_HASH_BITS)) & ((1 << RDO_HASH_BITS) - 1);
+    }
+
+    // Bytes before dwBase come from the strip, the rest from the candidate block
+    CMP_DWORD MatchLength(const CMP_BYTE* pBlock, CMP_DWORD dwBlockBytes, CMP_DWORD dwBase, CMP_DWORD dwPos, CMP_DWORD i) const
+    {
+        CMP_DWORD dwLength = 0;
+        while(i + dwLength < dwBlockBytes)
+        {
+            CMP_DWORD dwFrom = dwPos + dwLength;
+            CMP_BYTE  nByte  = dwFrom < dwBase ? m_pData[dwFrom] : pBlock[dwFrom - dwBase];
+            if(nByte != pBlock[i + dwLength])
+                break;
+            dwLength++;
+        }
+        return dwLength;
+    }
+
+    const CMP_BYTE*     m_pData;
+    CMP_DWORD           m_dwInserted;
+    CMP_DWORD           m_dwRingMask;
+    std::vector<int>    m_Head;
+    std::vector<int>    m_Prev;
+};
+
+//
+// Block search
+//
+
+class RDOBlockSearch
+{
+public:
+    RDOBlockSearch(const RDOContext& ctx, const RDOMatchModel& model, const CMP_BYTE* pStrip, CMP_DWORD dwBase, CMP_DWORD dwWindowStart,
+                   const CMP_BYTE* pSource, CMP_DWORD dwTexelMask)
+        : m_ctx(ctx)
+        , m_model(model)
+        , m_pStrip(pStrip)
+        , m_dwBase(dwBase)
+        , m_dwWindowStart(dwWindowStart)
+        , m_pSource(pSource)
+        , m_dwTexelMask(dwTexelMask)
+    {
+        memcpy(m_Best, pStrip + dwBase, ctx.dwBlockBytes);
+        m_fBestCost = Cost(m_Best, DBL_MAX);
+    }
+
+    void Try(const CMP_BYTE* pCandidate)
+    {
+        if(memcmp(pCandidate, m_Best, m_ctx.dwBlockBytes) == 0)
+            return;
+
+        double fCost = Cost(pCandidate, m_fBestCost);
+        if(fCost < m_fBestCost)
+        {
+            m_fBestCost = fCost;
+            memcpy(m_Best, pCandidate, m_ctx.dwBlockBytes);
+        }
+    }
+
+    const CMP_BYTE* GetBest() const { return m_Best; }
+
+private:
+    double Cost(const CMP_BYTE* pCandidate, double fLimit) const
+    {
+        double fCost = BlockError(m_ctx, pCandidate, m_pSource, m_dwTexelMask);
+        if(fCost >= fLimit)
+            return fCost;
+        return fCost + m_ctx.fLambda * m_model.Bits(pCandidate, m_ctx.dwBlockBytes, m_dwBase, m_dwWindowStart);
+    }
+
+    const RDOContext&       m_ctx;
+    const RDOMatchModel&    m_model;
+    const CMP_BYTE*         m_pStrip;
+    CMP_DWORD               m_dwBase;
+    CMP_DWORD               m_dwWindowStart;
+    const CMP_BYTE*         m_pSource;
+    CMP_DWORD               m_dwTexelMask;
+    CMP_BYTE                m_Best[16];
+    double                  m_fBestCost;
+};
+
+static void TryBC1(const RDOContext& ctx, RDOBlockSearch& search, const CMP_BYTE* pBlock, const CMP_BYTE* pPrev, const CMP_BYTE* pSource)
+{
+    CMP_BYTE candidate[8];
+
+    // The other block's endpoints with indices for our texels
+    memcpy(candidate, pPrev, 4);
+    RefitColourIndices(ctx, candidate, true, pSource);
+    search.Try(candidate);
+
+    // Our endpoints with the other block's indices
+    memcpy(candidate, pBlock, 4);
+    memcpy(candidate + 4, pPrev + 4, 4);
+    search.Try(candidate);
+}
+
+static void TryBC3(const RDOContext& ctx, RDOBlockSearch& search, const CMP_BYTE* pBlock, const CMP_BYTE* pPrev, const CMP_BYTE* pSource)
+{
+    // Alpha and colour are decoded separately, every choice for one half is paired with every choice for the other
+    CMP_BYTE alpha[4][8];
+    memcpy(alpha[0], pBlock, 8);
+    memcpy(alpha[1], pPrev, 8);
+    memcpy(alpha[2], pPrev, 2);
+    RefitAlphaIndices(alpha[2], pSource);
+    memcpy(alpha[3], pBlock, 2);
+    memcpy(alpha[3] + 2, pPrev + 2, 6);
+
+    CMP_BYTE colour[4][8];
+    memcpy(colour[0], pBlock + 8, 8);
+    memcpy(colour[1], pPrev + 8, 8);
+    memcpy(colour[2], pPrev + 8, 4);
+    RefitColourIndices(ctx, colour[2], false, pSource);
+    memcpy(colour[3], pBlock + 8, 4);
+    memcpy(colour[3] + 4, pPrev + 12, 4);
+
+    CMP_BYTE candidate[16];
+    for(int a = 0; a < 4; a++)
+    {
+        for(int c = 0; c < 4; c++)
+        {
+            memcpy(candidate, alpha[a], 8);
+            memcpy(candidate + 8, colour[c], 8);
+            search.Try(candidate);
+        }
+    }
+}
+
+//
+// BC7 fields, the mode is the lowest set bit and every other field lies at a fixed bit position for the mode
+//
+
+struct RDOBC7Mode
+{
+    int nSubsets;
+    int nPartitionBits;
+    int nRotationBits;
+    int nIndexSelectionBits;
+    int nColourBits;        // Per channel and endpoint
+    int nAlphaBits;
+    int nEndpointPBits;     // One per endpoint
+    int nSharedPBits;       // One per subset
+    int nIndexBits;
+    int nIndex2Bits;        // Second index set of modes 4 and 5
+};
+
+static const RDOBC7Mode g_RDOBC7Modes[8] =
+{
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+// -1 for the reserved encoding without a mode bit
+static int BC7Mode(const CMP_BYTE* pBlock)
+{
+    for(int nMode = 0; nMode < 8; nMode++)
+        if(pBlock[0] & (1 << nMode))
+            return nMode;
+    return -1;
+}
+
+// The partition follows the mode bits, it is at most 6 bits so it never spans more than two bytes
+static int BC7Partition(const CMP_BYTE* pBlock, int nMode)
+{
+    int nBit   = nMode + 1;
+    int nBits  = g_RDOBC7Modes[nMode].nPartitionBits;
+    int nValue = pBlock[nBit >> 3] | (pBlock[(nBit >> 3) + 1] << 8);
+    return (nValue >> (nBit & 7)) & ((1 << nBits) - 1);
+}
+
+// First bit of the indices, they end the block in every mode. The anchor texel of each subset drops its top index bit
+static int BC7IndexStart(int nMode)
+{
+    const RDOBC7Mode& mode = g_RDOBC7Modes[nMode];
+    int nIndexBits = 16 * mode.nIndexBits - mode.nSubsets;
+    if(mode.nIndex2Bits)
+        nIndexBits += 16 * mode.nIndex2Bits - 1;
+    return 128 - nIndexBits;
+}
+
+// Bits from nStart to the end of the block are taken from pFrom
+static void BC7SpliceIndices(CMP_BYTE* pBlock, const CMP_BYTE* pFrom, int nStart)
+{
+    int      nByte = nStart >> 3;
+    CMP_BYTE nMask = (CMP_BYTE) (0xff << (nStart & 7));
+    pBlock[nByte] = (CMP_BYTE) ((pBlock[nByte] & ~nMask) | (pFrom[nByte] & nMask));
+    memcpy(pBlock + nByte + 1, pFrom + nByte + 1, 15 - nByte);
+}
+
+static void TryBC7(RDOBlockSearch& search, const CMP_BYTE* pBlock, const CMP_BYTE* pPrev)
+{
+    CMP_BYTE candidate[16];
+
+    // With the same mode and partition the index fields and anchors line up, so the endpoints of either block can take the indices of the other
+    int nMode = BC7Mode(pBlock);
+    if(nMode >= 0 && nMode == BC7Mode(pPrev) && BC7Partition(pBlock, nMode) == BC7Partition(pPrev, nMode))
+    {
+        int nIndexStart = BC7IndexStart(nMode);
+
+        memcpy(candidate, pBlock, 16);
+        BC7SpliceIndices(candidate, pPrev, nIndexStart);
+        search.Try(candidate);
+
+        memcpy(candidate, pPrev, 16);
+        BC7SpliceIndices(candidate, pBlock, nIndexStart);
+        search.Try(candidate);
+    }
+
+    // Runs of the other block's bytes, whatever fields they cut through the decode tells what they cost
+    for(int nLength = 4; nLength < 16; nLength += 4)
+    {
+        for(int nOffset = 0; nOffset + nLength <= 16; nOffset += 4)
+        {
+            memcpy(candidate, pBlock, 16);
+            memcpy(candidate + nOffset, pPrev + nOffset, nLength);
+            search.Try(candidate);
+        }
+    }
+}
+
+// Block rows dwFirstRow up to dwEndRow of a level, they are stored one after another
+static void RDOStrip(const RDOContext& ctx, const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture,
+                     CMP_DWORD dwBlocksX, CMP_DWORD dwFirstRow, CMP_DWORD dwEndRow)
+{
+    CCodecBuffer* pSrcBuffer = CreateCodecBuffer(GetCodecBufferType(pSourceTexture->format), 4, 4, 1,
+                                                 pSourceTexture->dwWidth, pSourceTexture->dwHeight, pSourceTexture->dwPitch, pSourceTexture->pData);
+    if(pSrcBuffer == NULL)
+        return;
+
+    CMP_DWORD dwBlockBytes = ctx.dwBlockBytes;
+    CMP_BYTE* pStrip       = pDestTexture->pData + (size_t) dwFirstRow * dwBlocksX * dwBlockBytes;
+    RDOMatchModel model(pStrip, ctx.dwWindow * dwBlockBytes);
+
+    CMP_DWORD dwBlock = 0;
+    for(CMP_DWORD by = dwFirstRow; by < dwEndRow; by++)
+    {
+        for(CMP_DWORD bx = 0; bx < dwBlocksX; bx++, dwBlock++)
+        {
+            CMP_BYTE source[BLOCK_SIZE_4X4X4];
+            memset(source, 0, sizeof(source));
+            pSrcBuffer->ReadBlockRGBA(bx * 4, by * 4, 4, 4, source);
+
+            CMP_DWORD dwTexelMask = 0;
+            for(CMP_DWORD y = 0; y < 4; y++)
+                for(CMP_DWORD x = 0; x < 4; x++)
+                    if(bx * 4 + x < pSourceTexture->dwWidth && by * 4 + y < pSourceTexture->dwHeight)
+                        dwTexelMask |= 1 << (y * 4 + x);
+
+            CMP_DWORD dwFirst = dwBlock > ctx.dwWindow ? dwBlock - ctx.dwWindow : 0;
+            CMP_DWORD dwBase  = dwBlock * dwBlockBytes;
+            CMP_BYTE* pBlock  = pStrip + dwBase;
+
+            CMP_BYTE original[16];
+            memcpy(original, pBlock, dwBlockBytes);
+
+            RDOBlockSearch search(ctx, model, pStrip, dwBase, dwFirst * dwBlockBytes, source, dwTexelMask);
+            for(CMP_DWORD dwPrev = dwBlock; dwPrev-- > dwFirst;)
+            {
+                const CMP_BYTE* pPrev = pStrip + dwPrev * dwBlockBytes;
+
+                // Runs of equal blocks are common, only the nearest one is tried
+                if(dwPrev + 1 < dwBlock && memcmp(pPrev, pPrev + dwBlockBytes, dwBlockBytes) == 0)
+                    continue;
+
+                search.Try(pPrev);
+                switch(ctx.format)
+                {
+                case RDO_BC1:   TryBC1(ctx, search, original, pPrev, source);   break;
+                case RDO_BC3:   TryBC3(ctx, search, original, pPrev, source);   break;
+                default:        TryBC7(search, original, pPrev);                break;
+                }
+            }
+
+            memcpy(pBlock, search.GetBest(), dwBlockBytes);
+            model.Insert(dwBase + dwBlockBytes);
+        }
+    }
+
+    SAFE_DELETE(pSrcBuffer);
+}
+
+CMP_ERROR RDOTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions)
+{
+    RDOContext ctx;
+    switch(GetCodecType(pDestTexture->format))
+    {
+    case CT_DXT1:   ctx.format = RDO_BC1;   ctx.dwBlockBytes = 8;   break;
+    case CT_DXT5:   ctx.format = RDO_BC3;   ctx.dwBlockBytes = 16;  break;
+    case CT_BC7:    ctx.format = RDO_BC7;   ctx.dwBlockBytes = 16;  break;
+    default:
+        // Nothing to do for the other formats, their blocks are left as the codec wrote them
+        return CMP_OK;
+    }
+
+    if(pSourceTexture->dwWidth != pDestTexture->dwWidth || pSourceTexture->dwHeight != pDestTexture->dwHeight)
+        return CMP_ERR_SIZE_MISMATCH;
+
+    CMP_TRACE_SCOPE("Compress", "RDO");
+
+    ctx.fLambda         = pOptions->fRDOLambda;
+    ctx.dwWindow        = pOptions->dwRDOWindow ? pOptions->dwRDOWindow : RDO_DEFAULT_WINDOW;
+    if(ctx.dwWindow > RDO_MAX_WINDOW)
+        ctx.dwWindow = RDO_MAX_WINDOW;
+    ctx.bDXT1UseAlpha   = pOptions->bDXT1UseAlpha ? true : false;
+    ctx.nAlphaThreshold = pOptions->nAlphaThreshold;
+    ctx.nRed            = 2;
+    ctx.nBlue           = 0;
+
+    // The DXTC codecs swap the endpoint channels on request, the decode here has to as well
+    int maxCmds = pOptions->NumCmds > AMD_MAX_CMDS ? AMD_MAX_CMDS : pOptions->NumCmds;
+    for(int i = 0; i < maxCmds; i++)
+    {
+        if(strcmp(pOptions->CmdSet[i].strCommand, "SwizzleChannels") == 0 && atoi(pOptions->CmdSet[i].strParameter) > 0)
+        {
+            ctx.nRed  = 0;
+            ctx.nBlue = 2;
+        }
+    }
+
+    CMP_DWORD dwBlocksX = (pDestTexture->dwWidth  + 3) / 4;
+    CMP_DWORD dwBlocksY = (pDestTexture->dwHeight + 3) / 4;
+
+    CMP_DWORD dwStrips = 1;
+    if(!pOptions->bDisableMultiThreading)
+    {
+        dwStrips = min(f_dwProcessorCount, MAX_THREADS);
+        if(dwStrips > dwBlocksY / RDO_MIN_STRIP_ROWS)
+            dwStrips = dwBlocksY / RDO_MIN_STRIP_ROWS;
+        if(dwStrips < 1)
+            dwStrips = 1;
+    }
+
+    std::vector<std::thread> threads;
+    for(CMP_DWORD dwStrip = 1; dwStrip < dwStrips; dwStrip++)
+    {
+        CMP_DWORD dwFirstRow = dwBlocksY * dwStrip / dwStrips;
+        CMP_DWORD dwEndRow   = dwBlocksY * (dwStrip + 1) / dwStrips;
+        try
+        {
+            threads.push_back(std::thread(RDOStrip, std::cref(ctx), pSourceTexture, pDestTexture, dwBlocksX, dwFirstRow, dwEndRow));
+        }
+        catch(...)
+        {
+            RDOStrip(ctx, pSourceTexture, pDestTexture, dwBlocksX, dwFirstRow, dwEndRow);
+        }
+    }
+
+    RDOStrip(ctx, pSourceTexture, pDestTexture, dwBlocksX, 0, dwBlocksY / dwStrips);
+
+    for(size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    return CMP_OK;
+}
@@ -0,0 +1,479 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   CMP_Trace.cpp
+//  Description: Per thread trace event recording, Chrome trace-event JSON output
+//               and a per scope summary
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Compressonator.h"
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(WIN32) || defined(_WIN64)
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+enum TracePhase
+{
+    TP_Complete,        // a scope with a duration
+    TP_Counter,         // a single value on a counter track
+    TP_Memory,          // working set and peak working set in MB
+};
+
+struct TraceEvent
+{
+    TracePhase          phase;
+    unsigned int        nThread;
+    const char*         pCategory;
+    const char*         pName;
+    std::string         detail;
+    unsigned long long  nStart;         // ns since the trace origin, plus 1 so that 0 means "not traced"
+    unsigned long long  nDuration;      // ns
+    double              fValue;
+    double              fPeak;
+};
+
+// Only the thread that owns the buffer appends to it. Its lock is uncontended except while the events
+// are collected or reset, the registry lock is only taken when a thread records its first event, names
+// itself or exits. The registry lock is always taken before a thread lock.
+struct TraceThread
+{
+    TraceThread() : nId(0) {}
+    ~TraceThread();
+
+    void Record(const TraceEvent& event)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        events.push_back(event);
+    }
+
+    unsigned int            nId;        // 0 until the thread records its first event
+    std::mutex              lock;
+    std::vector<TraceEvent> events;
+};
+
+struct TraceRegistry
+{
+    TraceRegistry() : nNextId(1) {}
+
+    std::mutex                          lock;
+    std::vector<TraceThread*>           live;
+    std::vector<TraceEvent>             retired;        // events of threads that have exited
+    std::vector<unsigned int>           freeIds;        // ids of exited threads, reused so worker pools keep their tracks
+    unsigned int                        nNextId;
+    std::map<unsigned int, std::string> threadNames;
+};
+
+TraceRegistry& Registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+std::atomic<bool>                               g_bTraceEnabled(false);
+const std::chrono::steady_clock::time_point     g_TraceOrigin = std::chrono::steady_clock::now();
+thread_local TraceThread                        t_TraceThread;
+
+unsigned long long TraceNow()
+{
+    return (unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_TraceOrigin).count() + 1;
+}
+
+TraceThread& CurrentThread()
+{
+    TraceThread& thread = t_TraceThread;
+    if (thread.nId == 0)
+    {
+        TraceRegistry& registry = Registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        if (!registry.freeIds.empty())
+        {
+            std::vector<unsigned int>::iterator it = std::min_element(registry.freeIds.begin(), registry.freeIds.end());
+            thread.nId = *it;
+            registry.freeIds.erase(it);
+        }
+        else
+            thread.nId = registry.nNextId++;
+        registry.live.push_back(&thread);
+    }
+    return thread;
+}
+
+TraceThread::~TraceThread()
+{
+    if (nId == 0)
+        return;
+
+    TraceRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.retired.insert(registry.retired.end(), events.begin(), events.end());
+    registry.live.erase(std::remove(registry.live.begin(), registry.live.end(), this), registry.live.end());
+    registry.freeIds.push_back(nId);
+}
+
+// Copies out every recorded event, the caller must hold the registry lock
+void CollectEvents(TraceRegistry& registry, std::vector<TraceEvent>& events)
+{
+    events = registry.retired;
+    for (size_t i = 0; i < registry.live.size(); i++)
+    {
+        TraceThread& thread = *registry.live[i];
+        std::lock_guard<std::mutex> guard(thread.lock);
+        events.insert(events.end(), thread.events.begin(), thread.events.end());
+    }
+}
+
+void WriteJSONString(FILE* pFile, const char* pString)
+{
+    fputc('"', pFile);
+    for (const unsigned char* p = (const unsigned char*) pString; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            fprintf(pFile, "\\%c", *p);
+        else if (*p < 0x20)
+            fprintf(pFile, "\\u%04x", *p);
+        else
+            fputc(*p, pFile);
+    }
+    fputc('"', pFile);
+}
+
+bool SortByStart(const TraceEvent& a, const TraceEvent& b)
+{
+    if (a.nThread != b.nThread)
+        return a.nThread < b.nThread;
+    if (a.nStart != b.nStart)
+        return a.nStart < b.nStart;
+    return a.nDuration > b.nDuration;       // parents before the children that start with them
+}
+
+struct TraceStat
+{
+    TraceStat() : nCalls(0), nTotal(0), nSelf(0), nMax(0) {}
+
+    unsigned int        nCalls;
+    unsigned long long  nTotal;
+    unsigned long long  nSelf;
+    unsigned long long  nMax;
+};
+
+bool SortByTotal(const std::pair<std::string, TraceStat>& a, const std::pair<std::string, TraceStat>& b)
+{
+    return a.second.nTotal > b.second.nTotal;
+}
+
+} // namespace
+
+void CMP_API CMP_TraceEnable(bool bEnable)
+{
+    g_bTraceEnabled.store(bEnable);
+}
+
+bool CMP_API CMP_TraceIsEnabled()
+{
+    return g_bTraceEnabled.load(std::memory_order_relaxed);
+}
+
+void CMP_API CMP_TraceReset()
+{
+    TraceRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.retired.clear();
+    for (size_t i = 0; i < registry.live.size(); i++)
+    {
+        TraceThread& thread = *registry.live[i];
+        std::lock_guard<std::mutex> guard(thread.lock);
+        thread.events.clear();
+    }
+}
+
+unsigned long long CMP_API CMP_TraceBegin()
+{
+    if (!g_bTraceEnabled.load(std::memory_order_relaxed))
+        return 0;
+
+    // Take a thread id before the scope starts, ids are only reused once their previous owner has exited
+    CurrentThread();
+    return TraceNow();
+}
+
+void CMP_API CMP_TraceEnd(const char* pCategory, const char* pName, const char* pDetail, unsigned long long nStart)
+{
+    if (nStart == 0)
+        return;
+
+    unsigned long long nEnd = TraceNow();
+    TraceThread& thread = CurrentThread();
+
+    TraceEvent event;
+    event.phase     = TP_Complete;
+    event.nThread   = thread.nId;
+    event.pCategory = pCategory ? pCategory : "";
+    event.pName     = pName ? pName : "";
+    if (pDetail)
+        event.detail = pDetail;
+    event.nStart    = nStart;
+    event.nDuration = nEnd - nStart;
+    event.fValue    = 0;
+    event.fPeak     = 0;
+    thread.Record(event);
+}
+
+void CMP_API CMP_TraceCounter(const char* pName, double fValue)
+{
+    if (!g_bTraceEnabled.load(std::memory_order_relaxed))
+        return;
+
+    TraceThread& thread = CurrentThread();
+
+    TraceEvent event;
+    event.phase     = TP_Counter;
+    event.nThread   = thread.nId;
+    event.pCategory = "Counter";
+    event.pName     = pName ? pName : "";
+    event.nStart    = TraceNow();
+    event.nDuration = 0;
+    event.fValue    = fValue;
+    event.fPeak     = 0;
+    thread.Record(event);
+}
+
+void CMP_API CMP_TraceMemory()
+{
+    if (!g_bTraceEnabled.load(std::memory_order_relaxed))
+        return;
+
+    double fWorkingSet = 0;
+    double fPeak       = 0;
+#if defined(WIN32) || defined(_WIN64)
+    PROCESS_MEMORY_COUNTERS memCounter;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &memCounter, sizeof(memCounter)))
+    {
+        fWorkingSet = memCounter.WorkingSetSize     / (1024.0 * 1024.0);
+        fPeak       = memCounter.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+        fPeak = usage.ru_maxrss / (1024.0 * 1024.0);    // bytes
+#else
+        fPeak = usage.ru_maxrss / 1024.0;               // KB
+#endif
+    }
+    fWorkingSet = fPeak;
+    FILE* pStatm = fopen("/proc/self/statm", "r");
+    if (pStatm)
+    {
+        unsigned long nPages, nResident;
+        if (fscanf(pStatm, "%lu %lu", &nPages, &nResident) == 2)
+            fWorkingSet = (double) nResident * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+        fclose(pStatm);
+    }
+#endif
+
+    TraceThread& thread = CurrentThread();
+
+    TraceEvent event;
+    event.phase     = TP_Memory;
+    event.nThread   = thread.nId;
+    event.pCategory = "Counter";
+    event.pName     = "Memory";
+    event.nStart    = TraceNow();
+    event.nDuration = 0;
+    event.fValue    = fWorkingSet;
+    event.fPeak     = fPeak;
+    thread.Record(event);
+}
+
+void CMP_API CMP_TraceSetThreadName(const char* pName)
+{
+    if (!pName)
+        return;
+
+    TraceThread& thread = CurrentThread();
+    TraceRegistry& registry = Registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.threadNames[thread.nId] = pName;
+}
+
+CMP_ERROR CMP_API CMP_TraceWriteJSON(const char* pFileName)
+{
+    if (!pFileName)
+        return CMP_ERR_GENERIC;
+
+    std::vector<TraceEvent> events;
+    std::map<unsigned int, std::string> threadNames;
+    {
+        TraceRegistry& registry = Registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        CollectEvents(registry, events);
+        threadNames = registry.threadNames;
+    }
+    std::sort(events.begin(), events.end(), SortByStart);
+
+    FILE* pFile = fopen(pFileName, "w");
+    if (!pFile)
+        return CMP_ERR_GENERIC;
+
+    fprintf(pFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(pFile, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Compressonator\"}}");
+    for (std::map<unsigned int, std::string>::const_iterator it = threadNames.begin(); it != threadNames.end(); ++it)
+    {
+        fprintf(pFile, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", it->first);
+        WriteJSONString(pFile, it->second.c_str());
+        fprintf(pFile, "}}");
+    }
+
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent& event = events[i];
+        double fStart = (event.nStart - 1) / 1000.0;
+        switch (event.phase)
+        {
+        case TP_Complete:
+            fprintf(pFile, ",\n{\"ph\":\"X\",\"cat\":");
+            WriteJSONString(pFile, event.pCategory);
+            fprintf(pFile, ",\"name\":");
+            WriteJSONString(pFile, event.pName);
+            fprintf(pFile, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f", event.nThread, fStart, event.nDuration / 1000.0);
+            if (!event.detail.empty())
+            {
+                fprintf(pFile, ",\"args\":{\"detail\":");
+                WriteJSONString(pFile, event.detail.c_str());
+                fprintf(pFile, "}");
+            }
+            fprintf(pFile, "}");
+            break;
+        case TP_Counter:
+            fprintf(pFile, ",\n{\"ph\":\"C\",\"name\":");
+            WriteJSONString(pFile, event.pName);
+            fprintf(pFile, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%g}}", event.nThread, fStart, event.fValue);
+            break;
+        case TP_Memory:
+            fprintf(pFile, ",\n{\"ph\":\"C\",\"name\":\"Memory\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"WorkingSetMB\":%.2f,\"PeakMB\":%.2f}}",
+                    event.nThread, fStart, event.fValue, event.fPeak);
+            break;
+        }
+    }
+    fprintf(pFile, "\n]}\n");
+
+    bool bFailed = ferror(pFile) != 0;
+    if (fclose(pFile) != 0)
+        bFailed = true;
+    return bFailed ? CMP_ERR_GENERIC : CMP_OK;
+}
+
+void CMP_API CMP_TracePrintSummary()
+{
+    std::vector<TraceEvent> events;
+    {
+        TraceRegistry& registry = Registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        CollectEvents(registry, events);
+    }
+    std::sort(events.begin(), events.end(), SortByStart);
+
+    std::map<std::string, TraceStat> stats;
+    std::vector<unsigned long long>  childTime(events.size(), 0);
+    std::vector<size_t>              stack;            // open scopes on the current thread
+    unsigned long long               nFirst  = 0;
+    unsigned long long               nLast   = 0;
+    unsigned int                     nThreads = 0;
+    unsigned int                     nThread = 0;
+    double                           fPeak   = 0;
+
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent& event = events[i];
+        if (event.phase == TP_Memory && event.fPeak > fPeak)
+            fPeak = event.fPeak;
+        if (event.phase != TP_Complete)
+            continue;
+
+        if (nThreads == 0 || event.nThread != nThread)
+        {
+            stack.clear();
+            nThread = event.nThread;
+            nThreads++;
+        }
+        while (!stack.empty() && events[stack.back()].nStart + events[stack.back()].nDuration <= event.nStart)
+            stack.pop_back();
+        if (!stack.empty())
+            childTime[stack.back()] += event.nDuration;
+        stack.push_back(i);
+
+        if (nFirst == 0 || event.nStart < nFirst)
+            nFirst = event.nStart;
+        if (event.nStart + event.nDuration > nLast)
+            nLast = event.nStart + event.nDuration;
+    }
+
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const TraceEvent& event = events[i];
+        if (event.phase != TP_Complete)
+            continue;
+
+        TraceStat& stat = stats[std::string(event.pCategory) + "/" + event.pName];
+        stat.nCalls++;
+        stat.nTotal += event.nDuration;
+        stat.nSelf  += event.nDuration > childTime[i] ? event.nDuration - childTime[i] : 0;
+        if (event.nDuration > stat.nMax)
+            stat.nMax = event.nDuration;
+    }
+
+    std::vector<std::pair<std::string, TraceStat> > sorted(stats.begin(), stats.end());
+    std::sort(sorted.begin(), sorted.end(), SortByTotal);
+
+    printf("\nTrace summary: %u scope(s) on %u thread(s) over %.3f ms, times summed over threads\n",
+           (unsigned int) sorted.size(), nThreads, nLast > nFirst ? (nLast - nFirst) / 1000000.0 : 0.0);
+    printf("%-40s %8s %12s %12s %12s %12s\n", "Scope", "Calls", "Total ms", "Self ms", "Avg ms", "Max ms");
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        const TraceStat& stat = sorted[i].second;
+        printf("%-40s %8u %12.3f %12.3f %12.3f %12.3f\n",
+               sorted[i].first.c_str(),
+               stat.nCalls,
+               stat.nTotal / 1000000.0,
+               stat.nSelf  / 1000000.0,
+               stat.nTotal / 1000000.0 / stat.nCalls,
+               stat.nMax   / 1000000.0);
+    }
+    if (fPeak > 0)
+        printf("Peak working set: %.1f MB\n", fPeak);
+}
@@ -0,0 +1,267 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   CMP_UpdateTexture.cpp
+//  Description: Re-encodes the dirty blocks of a compressed texture
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Compressonator.h"
+#include "Compress.h"
+#include "CMP_Trace.h"
+#include <string.h>
+#include <assert.h>
+#include <vector>
+
+extern CodecType GetCodecType(CMP_FORMAT format);
+extern CMP_ERROR CheckTexture(const CMP_Texture* pTexture, bool bSource);
+
+// Width in blocks of the scratch texture the dirty blocks are packed into
+#define UPDATE_ATLAS_BLOCKS 64
+
+static CMP_DWORD RowPitch(const CMP_Texture* pTexture)
+{
+    if(pTexture->dwPitch)
+        return pTexture->dwPitch;
+    return CalcBufferSize(pTexture->format, pTexture->dwWidth, 1, 0, pTexture->nBlockWidth, pTexture->nBlockHeight);
+}
+
+// Marks the blocks whose pixels differ between the two sources
+static void DiffBlocks(const CMP_Texture* pSource, const CMP_Texture* pPrevSource, CMP_DWORD dwPixelSize,
+                       CMP_DWORD dwBlockWidth, CMP_DWORD dwBlockHeight, CMP_DWORD dwBlocksX, CMP_DWORD dwBlocksY, std::vector<CMP_BYTE>& dirty)
+{
+    CMP_DWORD dwPitch     = RowPitch(pSource);
+    CMP_DWORD dwPrevPitch = RowPitch(pPrevSource);
+
+    for(CMP_DWORD by = 0; by < dwBlocksY; by++)
+    {
+        CMP_DWORD y0 = by * dwBlockHeight;
+        CMP_DWORD y1 = y0 + dwBlockHeight;
+        if(y1 > pSource->dwHeight)
+            y1 = pSource->dwHeight;
+
+        for(CMP_DWORD bx = 0; bx < dwBlocksX; bx++)
+        {
+            CMP_BYTE& bDirty = dirty[by * dwBlocksX + bx];
+            if(bDirty)
+                continue;
+
+            CMP_DWORD x0 = bx * dwBlockWidth;
+            CMP_DWORD x1 = x0 + dwBlockWidth;
+            if(x1 > pSource->dwWidth)
+                x1 = pSource->dwWidth;
+
+            for(CMP_DWORD y = y0; y < y1 && !bDirty; y++)
+            {
+                if(memcmp(pSource->pData + y * dwPitch + x0 * dwPixelSize,
+                          pPrevSource->pData + y * dwPrevPitch + x0 * dwPixelSize, (x1 - x0) * dwPixelSize) != 0)
+                    bDirty = 1;
+            }
+        }
+    }
+}
+
+// Copies a block into the scratch texture. Partial edge blocks are padded with PadLine and PadBlock,
+// as the codec buffers do when a full encode reads them, so an updated edge block matches a full re-encode.
+static void CopyBlock(const CMP_Texture* pSource, CMP_DWORD dwPixelSize, CMP_DWORD dwBlockWidth, CMP_DWORD dwBlockHeight,
+                      CMP_DWORD bx, CMP_DWORD by, CMP_BYTE* pDest, CMP_DWORD dwDestPitch, std::vector<CMP_BYTE>& block)
+{
+    CMP_DWORD dwPitch  = RowPitch(pSource);
+    CMP_DWORD x        = bx * dwBlockWidth;
+    CMP_DWORD y        = by * dwBlockHeight;
+    CMP_DWORD dwWidth  = pSource->dwWidth - x < dwBlockWidth ? pSource->dwWidth - x : dwBlockWidth;
+    CMP_DWORD dwLine   = dwBlockWidth * dwPixelSize;
+
+    CMP_DWORD j;
+    for(j = 0; j < dwBlockHeight && (y + j) < pSource->dwHeight; j++)
+    {
+        memcpy(&block[j * dwLine], pSource->pData + (y + j) * dwPitch + x * dwPixelSize, dwWidth * dwPixelSize);
+
+        if(dwWidth < dwBlockWidth)
+            PadLine(dwWidth, (CMP_BYTE) dwBlockWidth, (CMP_BYTE) dwPixelSize, &block[j * dwLine]);
+    }
+
+    if(j < dwBlockHeight)
+        PadBlock(j, (CMP_BYTE) dwBlockWidth, (CMP_BYTE) dwBlockHeight, (CMP_BYTE) dwPixelSize, &block[0]);
+
+    for(j = 0; j < dwBlockHeight; j++)
+        memcpy(pDest + j * dwDestPitch, &block[j * dwLine], dwLine);
+}
+
+CMP_ERROR CMP_API CMP_UpdateTexture(CMP_Texture* pSourceTexture, const CMP_Texture* pPrevSourceTexture, const CMP_Rect* pDirtyRects, CMP_DWORD dwNumRects,
+                                    const CMP_Texture* pPrevDestTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions,
+                                    CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CMP_DWORD* pdwBlocksEncoded)
+{
+    if(pdwBlocksEncoded)
+        *pdwBlocksEncoded = 0;
+
+    CMP_ERROR tc_err = CheckTexture(pSourceTexture, true);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    tc_err = CheckTexture(pDestTexture, false);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    tc_err = CheckTexture(pPrevDestTexture, false);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    if(GetCodecType(pSourceTexture->format) != CT_None)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    CodecType destType = GetCodecType(pDestTexture->format);
+    if(destType == CT_None || destType == CT_Unknown)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    if(pSourceTexture->dwWidth != pDestTexture->dwWidth || pSourceTexture->dwHeight != pDestTexture->dwHeight)
+        return CMP_ERR_SIZE_MISMATCH;
+
+    if(pPrevDestTexture->format != pDestTexture->format
+        || pPrevDestTexture->dwWidth != pDestTexture->dwWidth || pPrevDestTexture->dwHeight != pDestTexture->dwHeight
+        || pPrevDestTexture->nBlockWidth != pDestTexture->nBlockWidth || pPrevDestTexture->nBlockHeight != pDestTexture->nBlockHeight)
+        return CMP_ERR_SIZE_MISMATCH;
+
+    if(pPrevSourceTexture)
+    {
+        tc_err = CheckTexture(pPrevSourceTexture, true);
+        if(tc_err != CMP_OK)
+            return tc_err;
+
+        if(pPrevSourceTexture->format != pSourceTexture->format)
+            return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+        if(pPrevSourceTexture->dwWidth != pSourceTexture->dwWidth || pPrevSourceTexture->dwHeight != pSourceTexture->dwHeight)
+            return CMP_ERR_SIZE_MISMATCH;
+    }
+
+    CMP_TRACE_SCOPE("Convert", "CMP_UpdateTexture");
+
+    // Only ASTC has a variable block size
+    CMP_DWORD dwBlockWidth  = 4;
+    CMP_DWORD dwBlockHeight = 4;
+    if(destType == CT_ASTC)
+    {
+        if(pDestTexture->nBlockWidth)
+            dwBlockWidth = pDestTexture->nBlockWidth;
+        if(pDestTexture->nBlockHeight)
+            dwBlockHeight = pDestTexture->nBlockHeight;
+    }
+
+    CMP_DWORD dwBlocksX    = (pDestTexture->dwWidth  + dwBlockWidth  - 1) / dwBlockWidth;
+    CMP_DWORD dwBlocksY    = (pDestTexture->dwHeight + dwBlockHeight - 1) / dwBlockHeight;
+    CMP_DWORD dwBlockBytes = CalcBufferSize(destType, dwBlockWidth, dwBlockHeight, (CMP_BYTE) dwBlockWidth, (CMP_BYTE) dwBlockHeight);
+    CMP_DWORD dwPixelSize  = CalcBufferSize(pSourceTexture->format, 4, 1, 0, 0, 0) / 4;
+    if(dwBlockBytes == 0 || dwPixelSize == 0)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    // The splice below relies on every compressed format storing its blocks in linear row order,
+    // block (bx, by) at byte (by * dwBlocksX + bx) * dwBlockBytes with no row padding
+    assert(CMP_CalculateBufferSize(pDestTexture) == dwBlocksX * dwBlocksY * dwBlockBytes);
+
+    // Splice into a copy of the old data
+    if(pDestTexture->pData != pPrevDestTexture->pData)
+        memcpy(pDestTexture->pData, pPrevDestTexture->pData, CMP_CalculateBufferSize(pDestTexture));
+
+    std::vector<CMP_BYTE> dirty(dwBlocksX * dwBlocksY, 0);
+    if(!pPrevSourceTexture && (!pDirtyRects || dwNumRects == 0))
+    {
+        for(size_t i = 0; i < dirty.size(); i++)
+            dirty[i] = 1;
+    }
+
+    if(pDirtyRects)
+    {
+        for(CMP_DWORD r = 0; r < dwNumRects; r++)
+        {
+            const CMP_Rect& rect = pDirtyRects[r];
+            if(rect.dwWidth == 0 || rect.dwHeight == 0 || rect.x >= pSourceTexture->dwWidth || rect.y >= pSourceTexture->dwHeight)
+                continue;
+
+            CMP_DWORD x1 = rect.x + rect.dwWidth;
+            CMP_DWORD y1 = rect.y + rect.dwHeight;
+            if(x1 > pSourceTexture->dwWidth)
+                x1 = pSourceTexture->dwWidth;
+            if(y1 > pSourceTexture->dwHeight)
+                y1 = pSourceTexture->dwHeight;
+
+            for(CMP_DWORD by = rect.y / dwBlockHeight; by <= (y1 - 1) / dwBlockHeight; by++)
+                for(CMP_DWORD bx = rect.x / dwBlockWidth; bx <= (x1 - 1) / dwBlockWidth; bx++)
+                    dirty[by * dwBlocksX + bx] = 1;
+        }
+    }
+
+    if(pPrevSourceTexture)
+        DiffBlocks(pSourceTexture, pPrevSourceTexture, dwPixelSize, dwBlockWidth, dwBlockHeight, dwBlocksX, dwBlocksY, dirty);
+
+    std::vector<CMP_DWORD> dirtyBlocks;
+    for(CMP_DWORD i = 0; i < dirty.size(); i++)
+    {
+        if(dirty[i])
+            dirtyBlocks.push_back(i);
+    }
+
+    if(dirtyBlocks.empty())
+        return CMP_OK;
+
+    // Blocks are encoded independently, so the dirty ones are packed into a scratch texture
+    // and compressed with a single CMP_ConvertTexture call. Spare blocks in the last row repeat the last dirty block.
+    CMP_DWORD dwNumBlocks  = (CMP_DWORD) dirtyBlocks.size();
+    CMP_DWORD dwAtlasX     = dwNumBlocks < UPDATE_ATLAS_BLOCKS ? dwNumBlocks : UPDATE_ATLAS_BLOCKS;
+    CMP_DWORD dwAtlasY     = (dwNumBlocks + dwAtlasX - 1) / dwAtlasX;
+
+    CMP_Texture srcAtlas   = *pSourceTexture;
+    srcAtlas.dwWidth       = dwAtlasX * dwBlockWidth;
+    srcAtlas.dwHeight      = dwAtlasY * dwBlockHeight;
+    srcAtlas.dwPitch       = srcAtlas.dwWidth * dwPixelSize;
+    srcAtlas.dwDataSize    = srcAtlas.dwPitch * srcAtlas.dwHeight;
+
+    CMP_Texture destAtlas  = *pDestTexture;
+    destAtlas.dwWidth      = srcAtlas.dwWidth;
+    destAtlas.dwHeight     = srcAtlas.dwHeight;
+    destAtlas.dwPitch      = 0;
+    destAtlas.dwDataSize   = CMP_CalculateBufferSize(&destAtlas);
+
+    std::vector<CMP_BYTE> srcData(srcAtlas.dwDataSize);
+    std::vector<CMP_BYTE> destData(destAtlas.dwDataSize);
+    srcAtlas.pData  = &srcData[0];
+    destAtlas.pData = &destData[0];
+
+    std::vector<CMP_BYTE> block(dwBlockWidth * dwBlockHeight * dwPixelSize);
+    for(CMP_DWORD i = 0; i < dwAtlasX * dwAtlasY; i++)
+    {
+        CMP_DWORD dwBlock = dirtyBlocks[i < dwNumBlocks ? i : dwNumBlocks - 1];
+        CMP_BYTE* pDest   = srcAtlas.pData + (i / dwAtlasX) * dwBlockHeight * srcAtlas.dwPitch + (i % dwAtlasX) * dwBlockWidth * dwPixelSize;
+        CopyBlock(pSourceTexture, dwPixelSize, dwBlockWidth, dwBlockHeight, dwBlock % dwBlocksX, dwBlock / dwBlocksX, pDest, srcAtlas.dwPitch, block);
+    }
+
+    tc_err = CMP_ConvertTexture(&srcAtlas, &destAtlas, pOptions, pFeedbackProc, pUser1, pUser2);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    for(CMP_DWORD i = 0; i < dwNumBlocks; i++)
+        memcpy(pDestTexture->pData + (size_t) dirtyBlocks[i] * dwBlockBytes, destAtlas.pData + (size_t) i * dwBlockBytes, dwBlockBytes);
+
+    if(pdwBlocksEncoded)
+        *pdwBlocksEncoded = dwNumBlocks;
+
+    return CMP_OK;
+}
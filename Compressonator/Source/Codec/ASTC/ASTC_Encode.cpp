@@ -63,7 +63,7 @@ double ASTCBlockEncoder::CompressBlock_kernel(
     //ASTC_Encoder::fetch_imageblock(input_image, &pb, pixelcount, ASTCEncode);
 
     fetch_imageblock_cpu(
-        (const astc_codec_image_cpu *)input_image,
+        (const astc_source_image_cpu *)input_image,
         (imageblock_cpu *) &m_pb,
         ASTCEncode->m_xdim,
         ASTCEncode->m_ydim, 
@@ -1799,6 +1799,62 @@ void InitializeASTCSettingsForSetBlockSize(__global ASTC_Encode *ASTCEncode)
     float   bmc_autoset         = 0.0;
     int     maxiters_autoset    = 0;
 
+    // Named speed presets: each one bounds the partition search count, the block mode
+    // percentile cutoff, the refinement iterations and the target PSNR (dB) at which
+    // the block search exits early. When no preset is set the Quality setting is used.
+    if (ASTCEncode->m_Speed == ASTC_SPEED_FASTEST)
+    {
+        // Fastest
+        plimit_autoset = 2;
+        oplimit_autoset = 1.0;
+        mincorrel_autoset = 0.5;
+        dblimit_autoset_2d = MAX(70 - 35 * log10_texels_2d, 53 - 19 * log10_texels_2d);
+#ifdef ASTC_ENABLE_3D_SUPPORT
+        dblimit_autoset_3d = MAX(70 - 35 * log10_texels_3d, 53 - 19 * log10_texels_3d);
+#endif
+        bmc_autoset = 25;
+        maxiters_autoset = 1;
+    }
+    else if (ASTCEncode->m_Speed == ASTC_SPEED_FAST)
+    {
+        // Fast
+        plimit_autoset = 4;
+        oplimit_autoset = 1.0;
+        mincorrel_autoset = 0.5;
+        dblimit_autoset_2d = MAX(85 - 35 * log10_texels_2d, 63 - 19 * log10_texels_2d);
+#ifdef ASTC_ENABLE_3D_SUPPORT
+        dblimit_autoset_3d = MAX(85 - 35 * log10_texels_3d, 63 - 19 * log10_texels_3d);
+#endif
+        bmc_autoset = 50;
+        maxiters_autoset = 1;
+    }
+    else if (ASTCEncode->m_Speed == ASTC_SPEED_MEDIUM)
+    {
+        // Medium
+        plimit_autoset = 25;
+        oplimit_autoset = 1.2;
+        mincorrel_autoset = 0.75;
+        dblimit_autoset_2d = MAX(95 - 35 * log10_texels_2d, 70 - 19 * log10_texels_2d);
+#ifdef ASTC_ENABLE_3D_SUPPORT
+        dblimit_autoset_3d = MAX(95 - 35 * log10_texels_3d, 70 - 19 * log10_texels_3d);
+#endif
+        bmc_autoset = 75;
+        maxiters_autoset = 2;
+    }
+    else if (ASTCEncode->m_Speed == ASTC_SPEED_THOROUGH)
+    {
+        // Thorough
+        plimit_autoset = 100;
+        oplimit_autoset = 2.5;
+        mincorrel_autoset = 0.95;
+        dblimit_autoset_2d = MAX(105 - 35 * log10_texels_2d, 77 - 19 * log10_texels_2d);
+#ifdef ASTC_ENABLE_3D_SUPPORT
+        dblimit_autoset_3d = MAX(105 - 35 * log10_texels_3d, 77 - 19 * log10_texels_3d);
+#endif
+        bmc_autoset = 95;
+        maxiters_autoset = 4;
+    }
+    else
     // Codec Speed Setting Defaults based on Quality Settings
     if (ASTCEncode->m_Quality < 0.2)
     {
@@ -2741,9 +2797,9 @@ void update_imageblock_flags_cpu(imageblock_cpu * pb, int xdim, int ydim, int zd
     pb->grayscale = grayscale;
 }
 
-// fetch an imageblock from the input file.
+// fetch an imageblock directly from the source image.
 void fetch_imageblock_cpu(
-    const astc_codec_image_cpu * img,
+    const astc_source_image_cpu * img,
     imageblock_cpu * pb,	// picture-block to imitialize with image data
                             // block dimensions
     int xdim, int ydim, int zdim,
@@ -2752,9 +2808,9 @@ void fetch_imageblock_cpu(
 )
 {
     float *fptr = pb->orig_data;
-    int xsize = img->xsize + 2 * img->padding;
-    int ysize = img->ysize + 2 * img->padding;
-    int zsize = (img->zsize == 1) ? 1 : img->zsize + 2 * img->padding;
+    int xsize = img->xsize;
+    int ysize = img->ysize;
+    int zsize = img->zsize;
 
     int x, y, z, i;
 
@@ -2762,112 +2818,48 @@ void fetch_imageblock_cpu(
     pb->ypos = ypos;
     pb->zpos = zpos;
 
-    xpos += img->padding;
-    ypos += img->padding;
-    if (img->zsize > 1)
-        zpos += img->padding;
+    for (z = 0; z < zdim; z++)
+        for (y = 0; y < ydim; y++)
+        {
+            int yi = ypos + y;
+            int zi = zpos + z;
+            // clamp YZ coordinates to the picture.
+            if (yi >= ysize)
+                yi = ysize - 1;
+            if (zi >= zsize)
+                zi = zsize - 1;
 
-    float data[6];
-    data[4] = 0;
-    data[5] = 1;
+            const uint8_t *row = img->data + (size_t)(zi * ysize + yi) * img->pitch;
 
-    if (img->imagedata8)
-    {
-        for (z = 0; z < zdim; z++)
-            for (y = 0; y < ydim; y++)
-                for (x = 0; x < xdim; x++)
+            for (x = 0; x < xdim; x++)
+            {
+                int xi = xpos + x;
+                // clamp X coordinate to the picture.
+                if (xi >= xsize)
+                    xi = xsize - 1;
+
+                if (img->is_half)
                 {
-                    int xi = xpos + x;
-                    int yi = ypos + y;
-                    int zi = zpos + z;
-                    // clamp XY coordinates to the picture.
-                    if (xi < 0)
-                        xi = 0;
-                    if (yi < 0)
-                        yi = 0;
-                    if (zi < 0)
-                        zi = 0;
-                    if (xi >= xsize)
-                        xi = xsize - 1;
-                    if (yi >= ysize)
-                        yi = ysize - 1;
-                    if (zi >= zsize)
-                        zi = zsize - 1;
-
-                    int r = img->imagedata8[zi][yi][4 * xi];
-                    int g = img->imagedata8[zi][yi][4 * xi + 1];
-                    int b = img->imagedata8[zi][yi][4 * xi + 2];
-                    int a = img->imagedata8[zi][yi][4 * xi + 3];
-
-                    data[0] = r / 255.0f;
-                    data[1] = g / 255.0f;
-                    data[2] = b / 255.0f;
-                    data[3] = a / 255.0f;
-
-                    fptr[0] = data[0];
-                    fptr[1] = data[1];
-                    fptr[2] = data[2];
-                    fptr[3] = data[3];
-                    fptr += 4;
+                    const sf16 *texel = (const sf16 *)row + 4 * xi;
+
+                    // get rid of negative values, as in the HDR path of the ARM reference encoder
+                    fptr[0] = MAX(ASTC_Encoder::sf16_to_float(texel[0]), 1e-8f);
+                    fptr[1] = MAX(ASTC_Encoder::sf16_to_float(texel[1]), 1e-8f);
+                    fptr[2] = MAX(ASTC_Encoder::sf16_to_float(texel[2]), 1e-8f);
+                    fptr[3] = MAX(ASTC_Encoder::sf16_to_float(texel[3]), 1e-8f);
                 }
-    }
+                else
+                {
+                    const uint8_t *texel = row + 4 * xi;
 
-    //------------------------------------------
-    // HDR currently not supported in code
-    /*
-    else if (img->imagedata16)
-    {
-    for (z = 0; z < zdim; z++)
-    for (y = 0; y < ydim; y++)
-    for (x = 0; x < xdim; x++)
-    {
-    int xi = xpos + x;
-    int yi = ypos + y;
-    int zi = zpos + z;
-    // clamp XY coordinates to the picture.
-    if (xi < 0)
-    xi = 0;
-    if (yi < 0)
-    yi = 0;
-    if (zi < 0)
-    zi = 0;
-    if (xi >= xsize)
-    xi = xsize - 1;
-    if (yi >= ysize)
-    yi = ysize - 1;
-    if (zi >= ysize)
-    zi = zsize - 1;
-
-    int r = img->imagedata16[zi][yi][4 * xi];
-    int g = img->imagedata16[zi][yi][4 * xi + 1];
-    int b = img->imagedata16[zi][yi][4 * xi + 2];
-    int a = img->imagedata16[zi][yi][4 * xi + 3];
-
-    float rf = sf16_to_float((sf16)r);
-    float gf = sf16_to_float((sf16)g);
-    float bf = sf16_to_float((sf16)b);
-    float af = sf16_to_float((sf16)a);
-
-    // equalize the color components somewhat, and get rid of negative values.
-
-    rf = MAX(rf, 1e-8f);
-    gf = MAX(gf, 1e-8f);
-    bf = MAX(bf, 1e-8f);
-    af = MAX(af, 1e-8f);
-
-    data[0] = rf;
-    data[1] = gf;
-    data[2] = bf;
-    data[3] = af;
-
-    fptr[0] = data[0];
-    fptr[1] = data[1];
-    fptr[2] = data[2];
-    fptr[3] = data[3];
-    fptr += 4;
-    }
-    }
-    */
+                    fptr[0] = texel[0] / 255.0f;
+                    fptr[1] = texel[1] / 255.0f;
+                    fptr[2] = texel[2] / 255.0f;
+                    fptr[3] = texel[3] / 255.0f;
+                }
+                fptr += 4;
+            }
+        }
 
     int pixelcount = xdim * ydim * zdim;
 
@@ -37,6 +37,8 @@
 
 #include "ASTC\ARM\astc_codec_internals.h"
 #include "process.h"
+#include <vector>
+#include "CMP_Trace.h"
 
 #ifdef ASTC_COMPDEBUGGER
 #include "CompClient.h"
@@ -84,6 +86,8 @@ CCodec_ASTC::CCodec_ASTC() : CCodec_DXTC(CT_ASTC)
     m_zdim                  = 1;
     m_decoder               = NULL;
     m_Quality               = 0.05;
+    m_Speed                 = ASTC_SPEED_QUALITY;
+    m_HDRSource             = false;
 }
 
 
@@ -154,14 +158,14 @@ CCodec_ASTC::~CCodec_ASTC()
         }
 
 
-        if (m_decoder)
-        {
-            delete m_decoder;
-            m_decoder = NULL;
-        }
-
         m_LibraryInitialized = false;
     }
+    // The decoder can exist without the encoder threads when only decompressing
+    if (m_decoder)
+    {
+        delete m_decoder;
+        m_decoder = NULL;
+    }
 }
 
 
@@ -297,6 +301,16 @@ bool CCodec_ASTC::SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue)
             return false;
         }
     }
+    else
+    if (strcmp(pszParamName, "Speed") == 0)
+    {
+        if      (_stricmp(sValue, "fastest")  == 0) m_Speed = ASTC_SPEED_FASTEST;
+        else if (_stricmp(sValue, "fast")     == 0) m_Speed = ASTC_SPEED_FAST;
+        else if (_stricmp(sValue, "medium")   == 0) m_Speed = ASTC_SPEED_MEDIUM;
+        else if (_stricmp(sValue, "thorough") == 0) m_Speed = ASTC_SPEED_THOROUGH;
+        else
+            return false;
+    }
     else
         return CCodec_DXTC::SetParameter(pszParamName, sValue);
     return true;
@@ -308,6 +322,12 @@ bool CCodec_ASTC::SetParameter(const CMP_CHAR* pszParamName, CMP_DWORD dwValue)
     {
         m_NumThreads = (CMP_BYTE) dwValue;
     }
+    else
+    if (strcmp(pszParamName, "Speed") == 0)
+    {
+        if (dwValue > ASTC_SPEED_THOROUGH) return false;
+        m_Speed = (int)dwValue;
+    }
     else
         return CCodec_DXTC::SetParameter(pszParamName, dwValue);
     return true;
@@ -338,6 +358,8 @@ ASTC_Encoder::ASTC_Encode  g_ASTCEncode;
 unsigned int    _stdcall ASTCThreadProcEncode(void* param)
 {
     ASTCEncodeThreadParam *tp = (ASTCEncodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("ASTC Worker");
+    CMP_TRACE_SCOPE("Compress", "ASTC Worker");
 
     while (tp->exit == FALSE)
     {
@@ -364,20 +386,26 @@ unsigned int    _stdcall ASTCThreadProcEncode(void* param)
 }
 
 
+void CCodec_ASTC::InitializeASTCSettings()
+{
+    g_ASTCEncode.m_decode_mode              = ASTC_Encoder::DECODE_HDR;
+    g_ASTCEncode.m_rgb_force_use_of_hdr     = m_HDRSource ? 1 : 0;
+    g_ASTCEncode.m_alpha_force_use_of_hdr   = 0;
+    g_ASTCEncode.m_perform_srgb_transform   = 0;
+    g_ASTCEncode.m_Quality                  = (float)m_Quality;
+    g_ASTCEncode.m_Speed                    = m_Speed;
+    g_ASTCEncode.m_target_bitrate           = m_target_bitrate;
+    g_ASTCEncode.m_xdim = m_xdim;
+    g_ASTCEncode.m_ydim = m_ydim;
+    g_ASTCEncode.m_zdim = m_zdim;
+    ASTC_Encoder::init_ASTC(&g_ASTCEncode);
+}
+
 CodecError CCodec_ASTC::InitializeASTCLibrary()
 {
     if (!m_LibraryInitialized)
     {
-        g_ASTCEncode.m_decode_mode              = ASTC_Encoder::DECODE_HDR;
-        g_ASTCEncode.m_rgb_force_use_of_hdr     = 0;
-        g_ASTCEncode.m_alpha_force_use_of_hdr   = 0;
-        g_ASTCEncode.m_perform_srgb_transform   = 0;
-        g_ASTCEncode.m_Quality                  = (float)m_Quality;
-        g_ASTCEncode.m_target_bitrate           = m_target_bitrate;
-        g_ASTCEncode.m_xdim = m_xdim;
-        g_ASTCEncode.m_ydim = m_ydim;
-        g_ASTCEncode.m_zdim = m_zdim;
-        ASTC_Encoder::init_ASTC(&g_ASTCEncode);
+        InitializeASTCSettings();
 
         //====================== Threads
         for (DWORD i = 0; i < MAX_ASTC_THREADS; i++)
@@ -463,7 +491,8 @@ CodecError CCodec_ASTC::InitializeASTCLibrary()
         }
 
         // Create single decoder instance
-        m_decoder = new ASTCBlockDecoder();
+        if (!m_decoder)
+            m_decoder = new ASTCBlockDecoder();
 
         if (!m_decoder)
         {
@@ -562,6 +591,8 @@ CodecError CCodec_ASTC::FinishASTCEncoding(void)
 
     if (m_Use_MultiThreading)
     {
+        CMP_TRACE_SCOPE("Compress", "ASTC Wait Workers");
+
         // Wait for all the live threads to finish any current work
         for (DWORD i = 0; i < m_LiveThreads; i++)
         {
@@ -608,6 +639,58 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     m_ydim = bufferOut.GetBlockHeight();
     m_zdim = 1;
 
+    // Blocks are fetched directly from bufferIn when it is RGBA8888 or RGBA16F
+    astc_source_image_cpu input_image;
+    input_image.data    = bufferIn.GetData();
+    input_image.pitch   = bufferIn.GetPitch();
+    input_image.xsize   = xsize;
+    input_image.ysize   = ysize;
+    input_image.zsize   = zsize;
+
+    // Any other layout is converted with ReadBlockRGBA first, float sources to RGBA16F and the rest to RGBA8888
+    std::vector<CMP_BYTE> convertedImage;
+    switch (bufferIn.GetBufferType())
+    {
+    case CBT_RGBA8888:
+        input_image.is_half = 0;
+        break;
+    case CBT_RGBA16F:
+        input_image.is_half = 1;
+        break;
+    default:
+        {
+            input_image.is_half = bufferIn.IsFloat() ? 1 : 0;
+            int texelBytes      = input_image.is_half ? 4 * sizeof(half) : 4;
+            input_image.pitch   = xsize * texelBytes;
+            convertedImage.resize((size_t)input_image.pitch * ysize);
+
+            for (int by = 0; by < ysize; by += 4)
+            {
+                for (int bx = 0; bx < xsize; bx += 4)
+                {
+                    CMP_BYTE cBlock[BLOCK_SIZE_4X4X4];
+                    half     hBlock[BLOCK_SIZE_4X4X4];
+                    bool bRead = input_image.is_half ? bufferIn.ReadBlockRGBA(bx, by, 4, 4, hBlock) : bufferIn.ReadBlockRGBA(bx, by, 4, 4, cBlock);
+                    if (!bRead)
+                        return CE_Unknown;
+
+                    const CMP_BYTE* pBlock = input_image.is_half ? (const CMP_BYTE*)hBlock : cBlock;
+                    for (int y = by; y < by + 4 && y < ysize; y++)
+                        memcpy(&convertedImage[(size_t)y * input_image.pitch + bx * texelBytes], pBlock + (y - by) * 4 * texelBytes,
+                               (min(bx + 4, xsize) - bx) * texelBytes);
+                }
+            }
+            input_image.data = &convertedImage[0];
+        }
+        break;
+    }
+
+    // Half float sources are encoded as HDR, the encoder settings derived from it are
+    // set up again when it differs from the previous call
+    m_HDRSource = (input_image.is_half == 1);
+    if (m_LibraryInitialized && g_ASTCEncode.m_rgb_force_use_of_hdr != (m_HDRSource ? 1 : 0))
+        InitializeASTCSettings();
+
     CodecError err = InitializeASTCLibrary();
     if (err != CE_OK) return err;
 
@@ -631,65 +714,6 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
 #endif;
 
 
-    int bitness = 0; //todo: replace astc_codec_image with bufferIn and rewrite fetch_imageblock()
-    switch (bufferIn.GetBufferType())
-    {
-    case CBT_RGBA8888:
-    case CBT_BGRA8888:
-    case CBT_ARGB8888:
-    case CBT_RGB888:
-    case CBT_RG8:
-    case CBT_R8:
-        bitness = 8;
-        break;
-    case CBT_RGBA2101010:
-        break;
-    case CBT_RGBA16:
-    case CBT_RG16:
-    case CBT_R16:
-        break;
-    case CBT_RGBA32:
-    case CBT_RG32:
-    case CBT_R32:
-        break;
-    case CBT_RGBA16F:
-    case CBT_RG16F:
-    case CBT_R16F:
-        break;
-    case CBT_RGBA32F:
-    case CBT_RG32F:
-    case CBT_R32F:
-        break;
-    default:
-        break;
-    }
-
-    if (bitness != 8)
-        assert("Unsupported type of input buffer");
-
-    astc_codec_image_cpu *input_image = allocate_image_cpu(bitness, xsize, ysize, zsize, 0);
-
-    if (!input_image)
-        assert("Unable to allocate image buffer");
-
-    // Loop through the original input image and setup compression threads for each 
-    // block to encode  we will load the buffer to pass to ASTC code as 8 bit 4x4 blocks
-    // the fill in source image. ASTC code will then use the adaptive sizes for process on the input
-    BYTE *pData = bufferIn.GetData();
-    int ii = 0;
-    for (int y = 0; y < ysize; y++) {
-        for (int x = 0; x < xsize; x++) {
-            input_image->imagedata8[0][y][4*x      ] = pData[ii];      // Red
-            ii++;
-            input_image->imagedata8[0][y][4 * x + 1] = pData[ii];      // Green
-            ii++;
-            input_image->imagedata8[0][y][4 * x + 2] = pData[ii];      // Blue
-            ii++;
-            input_image->imagedata8[0][y][4 * x + 3] = pData[ii];      // Alpha
-            ii++;
-        }
-    }
-
     m_NumEncodingThreads = min(m_NumThreads, MAX_ASTC_THREADS);
     if (m_NumEncodingThreads == 0) m_NumEncodingThreads = 1;
 
@@ -716,7 +740,7 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
             {
                 int offset = ((z * yblocks + y) * xblocks + x) * 16;
                 uint8_t *bp = bufferOutput + offset;
-                EncodeASTCBlock((astc_codec_image *)input_image, bp, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim);
+                EncodeASTCBlock((astc_codec_image *)&input_image, bp, xdim, ydim, zdim, x * xdim, y * ydim, z * zdim);
                 processingBlock++;
             }
 
@@ -738,8 +762,6 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     if (result != CE_Aborted)
         result = EncodeResult;
 
-    destroy_image_cpu(input_image);
-
 #ifdef ASTC_COMPDEBUGGER
     g_CompClient.disconnect();
 #endif
@@ -747,49 +769,38 @@ CodecError CCodec_ASTC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut
     return result;
 }
 
-// notes:
-// Slow CPU based decompression : Should look into also using HW based decompression with this interface
-//
-CodecError CCodec_ASTC::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+struct ASTCDecodeThreadParam
 {
-    m_xdim = bufferIn.GetBlockWidth();
-    m_ydim = bufferIn.GetBlockHeight();
-    m_zdim = 1;
-
-    CodecError err = InitializeASTCLibrary();
-    if (err != CE_OK) return err;
-
-    // Our Compressed data Blocks are always 128 bit long (4x4 blocks)
-    const CMP_DWORD imageWidth  = bufferIn.GetWidth();
-    const CMP_DWORD imageHeight = bufferIn.GetHeight();
-    const CMP_DWORD imageDepth  = 1;
-    const BYTE      bitness     = 8;
-
-    const CMP_DWORD CompBlockX  = bufferIn.GetBlockWidth();
-    const CMP_DWORD CompBlockY  = bufferIn.GetBlockHeight();
-    CMP_BYTE  Block_Width       = bufferIn.GetBlockWidth();
-    CMP_BYTE  Block_Height      = bufferIn.GetBlockHeight();
-
-    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + (CompBlockX - 1)) / CompBlockX);
-    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight()+ (CompBlockY - 1)) / CompBlockY);
-    const CMP_DWORD dwBlocksZ = 1;
-    const CMP_DWORD dwBufferInDepth = 1;
-
-    // Override the current input buffer Pitch size  (Since it will be set according to the Compressed Block Sizes
-    // and not to the Compressed Codec data which is for ASTC 16 Bytes per block x Number of blocks per row
-    bufferIn.SetPitch(16 * dwBlocksX);
-
-    // Output data size Pitch
-    CMP_DWORD  dwPitch = bufferOut.GetPitch();
-
-    // Output Buffer
-    BYTE *pDataOut      = bufferOut.GetData();
-
-    const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
+    ASTCBlockDecoder   *decoder;
+    CCodecBuffer       *bufferIn;
+    BYTE               *pDataOut;
+    CMP_DWORD           dwPitch;
+    CMP_DWORD           imageWidth;
+    CMP_DWORD           imageHeight;
+    CMP_DWORD           dwBlocksX;
+    CMP_BYTE            Block_Width;
+    CMP_BYTE            Block_Height;
+    BYTE                bitness;
+
+    // Block rows [rowStart, rowEnd) are decoded by this thread
+    CMP_DWORD           rowStart;
+    CMP_DWORD           rowEnd;
+
+    volatile LONG      *rowsDone;          // shared by all threads, used for progress
+    volatile BOOL      *abort;             // shared by all threads, set on cancel
+};
 
-    for(CMP_DWORD cmpRowY = 0; cmpRowY < dwBlocksY; cmpRowY++)        // Compressed images row = height
+//
+// Decodes a band of block rows. Each thread owns its decoder, the block size
+// descriptor and g_ASTCEncode tables are set up before the threads start.
+//
+static void ASTCDecodeRows(ASTCDecodeThreadParam *tp)
+{
+    for(CMP_DWORD cmpRowY = tp->rowStart; cmpRowY < tp->rowEnd; cmpRowY++)        // Compressed images row = height
     {
-        for(CMP_DWORD cmpColX = 0; cmpColX < dwBlocksX; cmpColX++)    // Compressed images Col = width
+        if (*tp->abort) return;
+
+        for(CMP_DWORD cmpColX = 0; cmpColX < tp->dwBlocksX; cmpColX++)          // Compressed images Col = width
         {
             union FBLOCKS
             {
@@ -804,30 +815,30 @@ CodecError CCodec_ASTC::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
                 BYTE            in[16];
             } CompData;
 
-            bufferIn.ReadBlock(cmpColX*4, cmpRowY*4, CompData.compressedBlock, 4);
+            tp->bufferIn->ReadBlock(cmpColX*4, cmpRowY*4, CompData.compressedBlock, 4);
 
             // Encode to the appropriate location in the compressed image
-            m_decoder->DecompressBlock(Block_Width, Block_Height, bitness, DecData.decodedBlock,CompData.in);
+            tp->decoder->DecompressBlock(tp->Block_Width, tp->Block_Height, tp->bitness, DecData.decodedBlock,CompData.in);
             
             // Now that we have a decoded block lets copy that data over to the target image buffer
-            CMP_DWORD outCol = cmpColX*Block_Width;
-            CMP_DWORD outRow = cmpRowY*Block_Height;
+            CMP_DWORD outCol = cmpColX*tp->Block_Width;
+            CMP_DWORD outRow = cmpRowY*tp->Block_Height;
             CMP_DWORD outImgRow = outRow;
             CMP_DWORD outImgCol = outCol;
 
-            for (int row = 0; row < Block_Height; row++)
+            for (int row = 0; row < tp->Block_Height; row++)
             {
-                CMP_DWORD  nextRowCol  = (outRow+row)*dwPitch + (outCol * 4);
-                CMP_BYTE*  pData       = (CMP_BYTE*)(pDataOut + nextRowCol);
-                if ((outImgRow + row) < imageHeight)
+                CMP_DWORD  nextRowCol  = (outRow+row)*tp->dwPitch + (outCol * 4);
+                CMP_BYTE*  pData       = (CMP_BYTE*)(tp->pDataOut + nextRowCol);
+                if ((outImgRow + row) < tp->imageHeight)
                 {
                     outImgCol = outCol;
-                    for (int col = 0; col < Block_Width; col++)
+                    for (int col = 0; col < tp->Block_Width; col++)
                     {
                         int w = outImgCol + col;
-                        if (w < imageWidth)
+                        if (w < tp->imageWidth)
                         {
-                            int index = row*Block_Width + col;
+                            int index = row*tp->Block_Width + col;
                             *pData++ = (CMP_BYTE)DecData.decodedBlock[index][BC_COMP_RED];
                             *pData++ = (CMP_BYTE)DecData.decodedBlock[index][BC_COMP_GREEN];
                             *pData++ = (CMP_BYTE)DecData.decodedBlock[index][BC_COMP_BLUE];
@@ -839,16 +850,157 @@ CodecError CCodec_ASTC::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
             }
         }
 
-        if (pFeedbackProc)
+        InterlockedIncrement(tp->rowsDone);
+    }
+}
+
+unsigned int    _stdcall ASTCThreadProcDecode(void* param)
+{
+    ASTCDecodeThreadParam *tp = (ASTCDecodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("ASTC Decode Worker");
+    CMP_TRACE_SCOPE("Decompress", "ASTC Rows");
+    ASTCDecodeRows(tp);
+    return 0;
+}
+
+// notes:
+// CPU based decompression, block rows are split across m_NumThreads decode threads
+//
+CodecError CCodec_ASTC::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    m_xdim = bufferIn.GetBlockWidth();
+    m_ydim = bufferIn.GetBlockHeight();
+    m_zdim = 1;
+
+    // Decoding only needs the shared tables and a decoder, the encoder threads are not started
+    if (!m_decoder)
+    {
+        InitializeASTCSettings();
+        m_decoder = new ASTCBlockDecoder();
+        if (!m_decoder) return CE_Unknown;
+    }
+
+    // Our Compressed data Blocks are always 128 bit long (4x4 blocks)
+    const CMP_DWORD imageWidth  = bufferIn.GetWidth();
+    const CMP_DWORD imageHeight = bufferIn.GetHeight();
+    const BYTE      bitness     = 8;
+
+    const CMP_DWORD CompBlockX  = bufferIn.GetBlockWidth();
+    const CMP_DWORD CompBlockY  = bufferIn.GetBlockHeight();
+    CMP_BYTE  Block_Width       = bufferIn.GetBlockWidth();
+    CMP_BYTE  Block_Height      = bufferIn.GetBlockHeight();
+
+    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + (CompBlockX - 1)) / CompBlockX);
+    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight()+ (CompBlockY - 1)) / CompBlockY);
+
+    // Override the current input buffer Pitch size  (Since it will be set according to the Compressed Block Sizes
+    // and not to the Compressed Codec data which is for ASTC 16 Bytes per block x Number of blocks per row
+    bufferIn.SetPitch(16 * dwBlocksX);
+
+    // The block size descriptor is created on first use and that is not thread safe
+    get_block_size_descriptor_cpu(Block_Width, Block_Height, 1);
+
+    volatile LONG rowsDone = 0;
+    volatile BOOL abort    = FALSE;
+
+    // WaitForMultipleObjects takes at most MAXIMUM_WAIT_OBJECTS handles
+    DWORD numThreads = min(m_NumThreads, MAX_ASTC_THREADS);
+    if (numThreads > MAXIMUM_WAIT_OBJECTS) numThreads = MAXIMUM_WAIT_OBJECTS;
+    if (numThreads > dwBlocksY) numThreads = dwBlocksY;
+    if (numThreads == 0) numThreads = 1;
+
+    ASTCDecodeThreadParam  param[MAX_ASTC_THREADS];
+    ASTCBlockDecoder       *decoder[MAX_ASTC_THREADS];
+    HANDLE                 hThread[MAX_ASTC_THREADS];
+
+    CMP_DWORD rowStart = 0;
+    for (DWORD i = 0; i < numThreads; i++)
+    {
+        // Thread 0 uses the codecs decoder, the others get their own
+        decoder[i] = (i == 0) ? m_decoder : new ASTCBlockDecoder();
+
+        param[i].decoder        = decoder[i];
+        param[i].bufferIn       = &bufferIn;
+        param[i].pDataOut       = bufferOut.GetData();
+        param[i].dwPitch        = bufferOut.GetPitch();
+        param[i].imageWidth     = imageWidth;
+        param[i].imageHeight    = imageHeight;
+        param[i].dwBlocksX      = dwBlocksX;
+        param[i].Block_Width    = Block_Width;
+        param[i].Block_Height   = Block_Height;
+        param[i].bitness        = bitness;
+        param[i].rowStart       = rowStart;
+        param[i].rowEnd         = rowStart + (dwBlocksY - rowStart) / (numThreads - i);
+        param[i].rowsDone       = &rowsDone;
+        param[i].abort          = &abort;
+        rowStart = param[i].rowEnd;
+    }
+
+    if (numThreads == 1)
+    {
+        // Single thread, decode a row at a time so progress can be reported in between
+        for (CMP_DWORD cmpRowY = 0; cmpRowY < dwBlocksY; cmpRowY++)
         {
-            float fProgress = 100.f * (cmpRowY * dwBlocksX) / dwBlocksXY;
-            if (pFeedbackProc(fProgress, pUser1, pUser2))
+            param[0].rowStart = cmpRowY;
+            param[0].rowEnd   = cmpRowY + 1;
+            ASTCDecodeRows(&param[0]);
+
+            if (pFeedbackProc)
             {
-                return CE_Aborted;
+                float fProgress = 100.f * (cmpRowY + 1) / dwBlocksY;
+                if (pFeedbackProc(fProgress, pUser1, pUser2))
+                {
+                    return CE_Aborted;
+                }
             }
         }
+        return CE_OK;
     }
 
-    return CE_OK;
-}
+    DWORD liveThreads = 0;
+    for (DWORD i = 0; i < numThreads; i++)
+    {
+        hThread[liveThreads] = (HANDLE)_beginthreadex(NULL, 0, ASTCThreadProcDecode, (void*)&param[i], 0, NULL);
+        if (hThread[liveThreads])
+            liveThreads++;
+        else
+            ASTCDecodeRows(&param[i]);      // Could not start a thread, decode the band here
+    }
+
+    // Report progress while the threads run, the callers feedback proc can cancel the decode
+    bool waitFailed = false;
+    while (liveThreads > 0)
+    {
+        DWORD dwWait = WaitForMultipleObjects(liveThreads, hThread, true, 100);
+        if (dwWait != WAIT_TIMEOUT)
+        {
+            waitFailed = (dwWait == WAIT_FAILED);
+            break;
+        }
+
+        if (pFeedbackProc && !abort)
+        {
+            float fProgress = 100.f * rowsDone / dwBlocksY;
+            if (pFeedbackProc(fProgress, pUser1, pUser2))
+                abort = TRUE;
+        }
+    }
+
+    // The threads use param[] and decoder[], they must all have exited before either goes away
+    if (waitFailed)
+    {
+        abort = TRUE;
+        for (DWORD i = 0; i < liveThreads; i++)
+            WaitForSingleObject(hThread[i], INFINITE);
+    }
+
+    for (DWORD i = 0; i < liveThreads; i++)
+        CloseHandle(hThread[i]);
+
+    for (DWORD i = 1; i < numThreads; i++)
+        delete decoder[i];
 
+    if (waitFailed)
+        return CE_Unknown;
+    return abort ? CE_Aborted : CE_OK;
+}
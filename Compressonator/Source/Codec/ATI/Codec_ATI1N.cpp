@@ -30,6 +30,7 @@
 
 #include "Common.h"
 #include "Codec_ATI1N.h"
+#include "Codec_DXTC_Decode.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -147,31 +148,43 @@ CodecError CCodec_ATI1N::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& buffer
     const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
 
     bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8 && !m_bUseFloat);
+    // 8 bit R and RGBA destinations are decoded a whole block row at a time
+    bool bDecodeRows = bUseFixed && (bufferOut.GetBufferType() == CBT_R8 || bufferOut.GetBufferType() == CBT_RGBA8888);
 
     for(CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+        if(bDecodeRows)
         {
-            CMP_DWORD compressedBlock[2];
-            bufferIn.ReadBlock(i*4, j*4, compressedBlock, 2);
-        
-            if(bUseFixed)
-            {
-                CMP_BYTE alphaBlock[BLOCK_SIZE_4X4];
-                DecompressAlphaBlock(alphaBlock, compressedBlock);
-                bufferOut.WriteBlockR(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockG(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockB(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockA(i*4, j*4, 4, 4, alphaBlock);
-            }
-            else
+            DXTCDecodeRowBC4(bufferIn.GetData() + (j * bufferIn.GetPitch()), dwBlocksX,
+                             bufferOut.GetData() + (j * 4 * bufferOut.GetPitch()), bufferOut.GetPitch(),
+                             bufferOut.GetWidth(), bufferOut.GetHeight() - (j * 4),
+                             (bufferOut.GetBufferType() == CBT_R8) ? DXTC_DECODE_R8 : DXTC_DECODE_RGBA8888);
+        }
+        else
+        {
+            for(CMP_DWORD i = 0; i < dwBlocksX; i++)
             {
-                float alphaBlock[BLOCK_SIZE_4X4];
-                DecompressAlphaBlock(alphaBlock, compressedBlock);
-                bufferOut.WriteBlockR(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockG(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockB(i*4, j*4, 4, 4, alphaBlock);
-                bufferOut.WriteBlockA(i*4, j*4, 4, 4, alphaBlock);
+                CMP_DWORD compressedBlock[2];
+                bufferIn.ReadBlock(i*4, j*4, compressedBlock, 2);
+        
+                if(bUseFixed)
+                {
+                    CMP_BYTE alphaBlock[BLOCK_SIZE_4X4];
+                    DecompressAlphaBlock(alphaBlock, compressedBlock);
+                    bufferOut.WriteBlockR(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockG(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockB(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockA(i*4, j*4, 4, 4, alphaBlock);
+                }
+                else
+                {
+                    float alphaBlock[BLOCK_SIZE_4X4];
+                    DecompressAlphaBlock(alphaBlock, compressedBlock);
+                    bufferOut.WriteBlockR(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockG(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockB(i*4, j*4, 4, 4, alphaBlock);
+                    bufferOut.WriteBlockA(i*4, j*4, 4, 4, alphaBlock);
+                }
             }
         }
 
@@ -30,6 +30,7 @@
 
 #include "Common.h"
 #include "Codec_ATI2N.h"
+#include "Codec_DXTC_Decode.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -172,6 +173,8 @@ CodecError CCodec_ATI2N::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& buffer
 
 
     bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8 && !m_bUseFloat);
+    // 8 bit RG and RGBA destinations are decoded a whole block row at a time
+    bool bDecodeRows = bUseFixed && (bufferOut.GetBufferType() == CBT_RG8 || bufferOut.GetBufferType() == CBT_RGBA8888);
     
    CMP_BYTE alphaBlockA[BLOCK_SIZE_4X4];
    CMP_BYTE alphaBlockR[BLOCK_SIZE_4X4];
@@ -191,27 +194,37 @@ CodecError CCodec_ATI2N::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& buffer
    
    for(CMP_DWORD j = 0; j < dwBlocksY; j++)
    {
-       for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+       if(bDecodeRows)
        {
-           bufferIn.ReadBlock(i*4, j*4, compressedBlock, 4);
-   
-           if(bUseFixed)
-           {
-               DecompressAlphaBlock(alphaBlockR, &compressedBlock[dwXOffset]);
-               DecompressAlphaBlock(alphaBlockG, &compressedBlock[dwYOffset]);
-               bufferOut.WriteBlockR(i * 4, j * 4, 4, 4, alphaBlockR);
-               bufferOut.WriteBlockG(i * 4, j * 4, 4, 4, alphaBlockG);
-               bufferOut.WriteBlockB(i * 4, j * 4, 4, 4, alphaBlockB);
-               bufferOut.WriteBlockA(i * 4, j * 4, 4, 4, alphaBlockA);
-           }
-           else
+           DXTCDecodeRowBC5(bufferIn.GetData() + (j * bufferIn.GetPitch()), dwBlocksX,
+                            bufferOut.GetData() + (j * 4 * bufferOut.GetPitch()), bufferOut.GetPitch(),
+                            bufferOut.GetWidth(), bufferOut.GetHeight() - (j * 4), dwXOffset,
+                            (bufferOut.GetBufferType() == CBT_RG8) ? DXTC_DECODE_RG8 : DXTC_DECODE_RGBA8888);
+       }
+       else
+       {
+           for(CMP_DWORD i = 0; i < dwBlocksX; i++)
            {
-               DecompressAlphaBlock(falphaBlockR, &compressedBlock[dwXOffset]);
-               DecompressAlphaBlock(falphaBlockG, &compressedBlock[dwYOffset]);
-               bufferOut.WriteBlockR(i * 4, j * 4, 4, 4, falphaBlockR);
-               bufferOut.WriteBlockG(i * 4, j * 4, 4, 4, falphaBlockG);
-               bufferOut.WriteBlockB(i * 4, j * 4, 4, 4, falphaBlockB);
-               bufferOut.WriteBlockA(i * 4, j * 4, 4, 4, falphaBlockA);
+               bufferIn.ReadBlock(i*4, j*4, compressedBlock, 4);
+   
+               if(bUseFixed)
+               {
+                   DecompressAlphaBlock(alphaBlockR, &compressedBlock[dwXOffset]);
+                   DecompressAlphaBlock(alphaBlockG, &compressedBlock[dwYOffset]);
+                   bufferOut.WriteBlockR(i * 4, j * 4, 4, 4, alphaBlockR);
+                   bufferOut.WriteBlockG(i * 4, j * 4, 4, 4, alphaBlockG);
+                   bufferOut.WriteBlockB(i * 4, j * 4, 4, 4, alphaBlockB);
+                   bufferOut.WriteBlockA(i * 4, j * 4, 4, 4, alphaBlockA);
+               }
+               else
+               {
+                   DecompressAlphaBlock(falphaBlockR, &compressedBlock[dwXOffset]);
+                   DecompressAlphaBlock(falphaBlockG, &compressedBlock[dwYOffset]);
+                   bufferOut.WriteBlockR(i * 4, j * 4, 4, 4, falphaBlockR);
+                   bufferOut.WriteBlockG(i * 4, j * 4, 4, 4, falphaBlockG);
+                   bufferOut.WriteBlockB(i * 4, j * 4, 4, 4, falphaBlockB);
+                   bufferOut.WriteBlockA(i * 4, j * 4, 4, 4, falphaBlockA);
+               }
            }
        }
 
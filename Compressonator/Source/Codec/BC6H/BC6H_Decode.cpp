@@ -42,6 +42,11 @@
 #include "half.h"
 #pragma warning(default:4244)
 
+#if defined(USE_SSE2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define BC6H_DECODE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 
 #ifdef BC6H_DECODE_DEBUG
 int  g_dblock = 0;
@@ -441,7 +446,7 @@ AMD_BC6H_Format extract_format(BYTE in[COMPRESSED_BLOCK_SIZE])
                 bc6h_format.bw = header.getvalue(25,10) |             //11:   bw[9:0]
                                 (header.getvalue(60,1) << 10);        //      bw[10]
                 bc6h_format.bx = header.getvalue(55,5);               //5:    bx[4:0]
-                bc6h_format.by = header.getvalue(61,4);               //5:    by[3:0]
+                bc6h_format.by = header.getvalue(61,4) |              //5:    by[3:0]
                                 (header.getvalue(40,1) << 4);         //      by[4]
                 bc6h_format.bz = header.getvalue(50,1) |              //5:    bz[0]
                                 (header.getvalue(69,1) << 1) |        //      bz[1]
@@ -645,11 +650,26 @@ AMD_BC6H_Format extract_format(BYTE in[COMPRESSED_BLOCK_SIZE])
                 bc6h_format.tBits[C_GREEN]  = 4;
                 bc6h_format.tBits[C_BLUE]   = 4;
                 bc6h_format.rw = header.getvalue(5,10) |                // 16:   rw[9:0] 
-                                 (header.getvalue(39,6) << 10);         //       rw[15:10]
+                                 (header.getvalue(39,1) << 15) |        //       rw[15:10] reversed
+                                 (header.getvalue(40,1) << 14) |
+                                 (header.getvalue(41,1) << 13) |
+                                 (header.getvalue(42,1) << 12) |
+                                 (header.getvalue(43,1) << 11) |
+                                 (header.getvalue(44,1) << 10);
                 bc6h_format.gw = header.getvalue(15,10) |               // 16:   gw[9:0]
-                                 (header.getvalue(49,6) << 10);         //       gw[15:10]
+                                 (header.getvalue(49,1) << 15) |        //       gw[15:10] reversed
+                                 (header.getvalue(50,1) << 14) |
+                                 (header.getvalue(51,1) << 13) |
+                                 (header.getvalue(52,1) << 12) |
+                                 (header.getvalue(53,1) << 11) |
+                                 (header.getvalue(54,1) << 10);
                 bc6h_format.bw = header.getvalue(25,10) |               // 16:   bw[9:0]
-                                 (header.getvalue(59,6) << 10);         //       bw[15:10]
+                                 (header.getvalue(59,1) << 15) |        //       bw[15:10] reversed
+                                 (header.getvalue(60,1) << 14) |
+                                 (header.getvalue(61,1) << 13) |
+                                 (header.getvalue(62,1) << 12) |
+                                 (header.getvalue(63,1) << 11) |
+                                 (header.getvalue(64,1) << 10);
                 bc6h_format.rx = header.getvalue(35,4);                 // 4:    rx[3:0]
                 bc6h_format.gx = header.getvalue(45,4);                 // 4:    gx[3:0]
                 bc6h_format.bx = header.getvalue(55,4);                 // 4:    bx[3:0]
@@ -714,6 +734,11 @@ AMD_BC6H_Format extract_format(BYTE in[COMPRESSED_BLOCK_SIZE])
 
 //---------------------------------------------------------------------------------------------------------------------------------------
 
+static inline unsigned short BC6HHalfBits(int q)
+{
+    return (unsigned short)((q < 0) ? (0x8000 | -q) : q);
+}
+
 void BC6HBlockDecoder::DecompressBlock( float out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],BYTE in[COMPRESSED_BLOCK_SIZE])
 {
     // now determine the mode type and extract the coded endpoints data 
@@ -722,6 +747,7 @@ void BC6HBlockDecoder::DecompressBlock( float out[MAX_SUBSET_SIZE][MAX_DIMENSION
         bc6h_format.format = UNSIGNED_F16;
     else
         bc6h_format.format = SIGNED_F16;
+    bc6h_format.issigned = bc6signed;
 
     if(bc6h_format.region == BC6_ONE)
     {
@@ -762,10 +788,10 @@ void BC6HBlockDecoder::DecompressBlock( float out[MAX_SUBSET_SIZE][MAX_DIMENSION
         // this result is validated ok for region = BC6_ONE , BC6_TWO To be determined 
         data = bc6h_format.Palete[region][paleteIndex];
     
-        // Int to Half
-        rgb[0].setBits((unsigned short) data.x);
-        rgb[1].setBits((unsigned short) data.y);
-        rgb[2].setBits((unsigned short) data.z);
+        // Int to Half, signed palette values are negated magnitudes and become sign magnitude half bits
+        rgb[0].setBits(BC6HHalfBits(data.x));
+        rgb[1].setBits(BC6HHalfBits(data.y));
+        rgb[2].setBits(BC6HHalfBits(data.z));
 
         out[indexPos][0]  = (float) rgb[0];    // r;
         out[indexPos][1]  = (float) rgb[1]; // g;
@@ -781,3 +807,313 @@ void BC6HBlockDecoder::DecompressBlock( float out[MAX_SUBSET_SIZE][MAX_DIMENSION
 
 }
 
+//---------------------------------------------------------------------------------------------------------------------------------------
+// Table driven integer decoder
+//
+// Each mode is described by the runs of block bits that make up its endpoint fields. Endpoints are unquantized and
+// interpolated in integer space as given in the D3D11 BC6H specification and the results are written out as IEEE half
+// bits, so RGBA16F destinations never go through float.
+//---------------------------------------------------------------------------------------------------------------------------------------
+
+#define BC6H_MAX_FIELD_RUNS     24
+#define BC6H_HALF_ONE           0x3C00
+
+// Endpoint fields: field = endpoint * 3 + channel, endpoints w,x are region 0 and y,z are region 1
+enum { BC6H_RW, BC6H_GW, BC6H_BW, BC6H_RX, BC6H_GX, BC6H_BX, BC6H_RY, BC6H_GY, BC6H_BY, BC6H_RZ, BC6H_GZ, BC6H_BZ, BC6H_NUM_FIELDS };
+
+typedef struct
+{
+    BYTE    field;          // BC6H_RW .. BC6H_BZ
+    BYTE    shift;          // field bit the run starts at
+    BYTE    pos;            // block bit the run starts at
+    BYTE    count;          // number of bits in the run
+} BC6HFieldRun;
+
+typedef struct
+{
+    BYTE            regions;
+    BYTE            transformed;
+    BYTE            wBits;
+    BYTE            tBits[NCHANNELS];
+    BYTE            numRuns;
+    BC6HFieldRun    runs[BC6H_MAX_FIELD_RUNS];
+} BC6HModeLayout;
+
+static const BC6HModeLayout g_BC6HModeLayout[14] =
+{
+    // Mode 1 (0x00)
+    { 2, 1, 10, {5,5,5}, 19,
+      { {BC6H_GY,4,2,1}, {BC6H_BY,4,3,1}, {BC6H_BZ,4,4,1}, {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10},
+        {BC6H_RX,0,35,5}, {BC6H_GZ,4,40,1}, {BC6H_GY,0,41,4}, {BC6H_GX,0,45,5}, {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4},
+        {BC6H_BX,0,55,5}, {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,5}, {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,5},
+        {BC6H_BZ,3,76,1} } },
+    // Mode 2 (0x01)
+    { 2, 1, 7, {6,6,6}, 23,
+      { {BC6H_GY,5,2,1}, {BC6H_GZ,4,3,1}, {BC6H_GZ,5,4,1}, {BC6H_RW,0,5,7}, {BC6H_BZ,0,12,1}, {BC6H_BZ,1,13,1},
+        {BC6H_BY,4,14,1}, {BC6H_GW,0,15,7}, {BC6H_BY,5,22,1}, {BC6H_BZ,2,23,1}, {BC6H_GY,4,24,1}, {BC6H_BW,0,25,7},
+        {BC6H_BZ,3,32,1}, {BC6H_BZ,5,33,1}, {BC6H_BZ,4,34,1}, {BC6H_RX,0,35,6}, {BC6H_GY,0,41,4}, {BC6H_GX,0,45,6},
+        {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,6}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,6}, {BC6H_RZ,0,71,6} } },
+    // Mode 3 (0x02)
+    { 2, 1, 11, {5,4,4}, 18,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,5}, {BC6H_RW,10,40,1}, {BC6H_GY,0,41,4},
+        {BC6H_GX,0,45,4}, {BC6H_GW,10,49,1}, {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,4}, {BC6H_BW,10,59,1},
+        {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,5}, {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,5}, {BC6H_BZ,3,76,1} } },
+    // Mode 4 (0x06)
+    { 2, 1, 11, {4,5,4}, 20,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,4}, {BC6H_RW,10,39,1}, {BC6H_GZ,4,40,1},
+        {BC6H_GY,0,41,4}, {BC6H_GX,0,45,5}, {BC6H_GW,10,50,1}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,4}, {BC6H_BW,10,59,1},
+        {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,4}, {BC6H_BZ,0,69,1}, {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,4},
+        {BC6H_GY,4,75,1}, {BC6H_BZ,3,76,1} } },
+    // Mode 5 (0x0A)
+    { 2, 1, 11, {4,4,5}, 20,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,4}, {BC6H_RW,10,39,1}, {BC6H_BY,4,40,1},
+        {BC6H_GY,0,41,4}, {BC6H_GX,0,45,4}, {BC6H_GW,10,49,1}, {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,5},
+        {BC6H_BW,10,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,4}, {BC6H_BZ,1,69,1}, {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,4},
+        {BC6H_BZ,4,75,1}, {BC6H_BZ,3,76,1} } },
+    // Mode 6 (0x0E)
+    { 2, 1, 9, {5,5,5}, 19,
+      { {BC6H_RW,0,5,9}, {BC6H_BY,4,14,1}, {BC6H_GW,0,15,9}, {BC6H_GY,4,24,1}, {BC6H_BW,0,25,9}, {BC6H_BZ,4,34,1},
+        {BC6H_RX,0,35,5}, {BC6H_GZ,4,40,1}, {BC6H_GY,0,41,4}, {BC6H_GX,0,45,5}, {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4},
+        {BC6H_BX,0,55,5}, {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,5}, {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,5},
+        {BC6H_BZ,3,76,1} } },
+    // Mode 7 (0x12)
+    { 2, 1, 8, {6,5,5}, 19,
+      { {BC6H_RW,0,5,8}, {BC6H_GZ,4,13,1}, {BC6H_BY,4,14,1}, {BC6H_GW,0,15,8}, {BC6H_BZ,2,23,1}, {BC6H_GY,4,24,1},
+        {BC6H_BW,0,25,8}, {BC6H_BZ,3,33,1}, {BC6H_BZ,4,34,1}, {BC6H_RX,0,35,6}, {BC6H_GY,0,41,4}, {BC6H_GX,0,45,5},
+        {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,5}, {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,6},
+        {BC6H_RZ,0,71,6} } },
+    // Mode 8 (0x16)
+    { 2, 1, 8, {5,6,5}, 21,
+      { {BC6H_RW,0,5,8}, {BC6H_BZ,0,13,1}, {BC6H_BY,4,14,1}, {BC6H_GW,0,15,8}, {BC6H_GY,5,23,1}, {BC6H_GY,4,24,1},
+        {BC6H_BW,0,25,8}, {BC6H_GZ,5,33,1}, {BC6H_BZ,4,34,1}, {BC6H_RX,0,35,5}, {BC6H_GZ,4,40,1}, {BC6H_GY,0,41,4},
+        {BC6H_GX,0,45,6}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,5}, {BC6H_BZ,1,60,1}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,5},
+        {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,5}, {BC6H_BZ,3,76,1} } },
+    // Mode 9 (0x1A)
+    { 2, 1, 8, {5,5,6}, 21,
+      { {BC6H_RW,0,5,8}, {BC6H_BZ,1,13,1}, {BC6H_BY,4,14,1}, {BC6H_GW,0,15,8}, {BC6H_BY,5,23,1}, {BC6H_GY,4,24,1},
+        {BC6H_BW,0,25,8}, {BC6H_BZ,5,33,1}, {BC6H_BZ,4,34,1}, {BC6H_RX,0,35,5}, {BC6H_GZ,4,40,1}, {BC6H_GY,0,41,4},
+        {BC6H_GX,0,45,5}, {BC6H_BZ,0,50,1}, {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,6}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,5},
+        {BC6H_BZ,2,70,1}, {BC6H_RZ,0,71,5}, {BC6H_BZ,3,76,1} } },
+    // Mode 10 (0x1E)
+    { 2, 0, 6, {6,6,6}, 23,
+      { {BC6H_RW,0,5,6}, {BC6H_GZ,4,11,1}, {BC6H_BZ,0,12,1}, {BC6H_BZ,1,13,1}, {BC6H_BY,4,14,1}, {BC6H_GW,0,15,6},
+        {BC6H_GY,5,21,1}, {BC6H_BY,5,22,1}, {BC6H_BZ,2,23,1}, {BC6H_GY,4,24,1}, {BC6H_BW,0,25,6}, {BC6H_GZ,5,31,1},
+        {BC6H_BZ,3,32,1}, {BC6H_BZ,5,33,1}, {BC6H_BZ,4,34,1}, {BC6H_RX,0,35,6}, {BC6H_GY,0,41,4}, {BC6H_GX,0,45,6},
+        {BC6H_GZ,0,51,4}, {BC6H_BX,0,55,6}, {BC6H_BY,0,61,4}, {BC6H_RY,0,65,6}, {BC6H_RZ,0,71,6} } },
+    // Mode 11 (0x03)
+    { 1, 0, 10, {10,10,10}, 6,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,10}, {BC6H_GX,0,45,10}, {BC6H_BX,0,55,10} } },
+    // Mode 12 (0x07)
+    { 1, 1, 11, {9,9,9}, 9,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,9}, {BC6H_RW,10,44,1}, {BC6H_GX,0,45,9},
+        {BC6H_GW,10,54,1}, {BC6H_BX,0,55,9}, {BC6H_BW,10,64,1} } },
+    // Mode 13 (0x0B)
+    { 1, 1, 12, {8,8,8}, 12,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,8}, {BC6H_RW,11,43,1}, {BC6H_RW,10,44,1},
+        {BC6H_GX,0,45,8}, {BC6H_GW,11,53,1}, {BC6H_GW,10,54,1}, {BC6H_BX,0,55,8}, {BC6H_BW,11,63,1}, {BC6H_BW,10,64,1} } },
+    // Mode 14 (0x0F)
+    { 1, 1, 16, {4,4,4}, 24,
+      { {BC6H_RW,0,5,10}, {BC6H_GW,0,15,10}, {BC6H_BW,0,25,10}, {BC6H_RX,0,35,4}, {BC6H_RW,15,39,1}, {BC6H_RW,14,40,1},
+        {BC6H_RW,13,41,1}, {BC6H_RW,12,42,1}, {BC6H_RW,11,43,1}, {BC6H_RW,10,44,1}, {BC6H_GX,0,45,4}, {BC6H_GW,15,49,1},
+        {BC6H_GW,14,50,1}, {BC6H_GW,13,51,1}, {BC6H_GW,12,52,1}, {BC6H_GW,11,53,1}, {BC6H_GW,10,54,1}, {BC6H_BX,0,55,4},
+        {BC6H_BW,15,59,1}, {BC6H_BW,14,60,1}, {BC6H_BW,13,61,1}, {BC6H_BW,12,62,1}, {BC6H_BW,11,63,1}, {BC6H_BW,10,64,1} } },
+};
+
+// Layout index for the low five bits of the first byte, -1 for the reserved modes
+static const signed char g_BC6HModeIndex[32] = { 0, 1, 2, 10, 0, 1, 3, 11, 0, 1, 4, 12, 0, 1, 5, 13, 0, 1, 6, -1, 0, 1, 7, -1, 0, 1, 8, -1, 0, 1, 9, -1 };
+
+// Interpolation weights as (64 - w, w) pairs
+static const short g_BC6HWeightPairs3[8][2]  = { {64,0}, {55,9}, {46,18}, {37,27}, {27,37}, {18,46}, {9,55}, {0,64} };
+static const short g_BC6HWeightPairs4[16][2] = { {64,0}, {60,4}, {55,9}, {51,13}, {47,17}, {43,21}, {38,26}, {34,30},
+                                                 {30,34}, {26,38}, {21,43}, {17,47}, {13,51}, {9,55}, {4,60}, {0,64} };
+
+static inline int BC6HGetBits(const unsigned long long bits[2], int pos, int count)
+{
+    unsigned long long v;
+    if (pos >= 64)
+        v = bits[1] >> (pos - 64);
+    else if (pos + count > 64)
+        v = (bits[0] >> pos) | (bits[1] << (64 - pos));
+    else
+        v = bits[0] >> pos;
+    return (int)(v & ((1ULL << count) - 1));
+}
+
+static inline int BC6HSignExtend(int v, int bits)
+{
+    return (v & (1 << (bits - 1))) ? (v | ~MASK(bits)) : v;
+}
+
+static inline int BC6HUnquantize(int q, int prec, bool bSigned)
+{
+    if (!bSigned)
+    {
+        if (prec >= 15)                 return q;
+        if (q == 0)                     return 0;
+        if (q == MASK(prec))            return U16MAX;
+        return ((q << 16) + 0x8000) >> prec;
+    }
+
+    if (prec >= 16)
+        return q;
+
+    int s = 0, unq;
+    if (q < 0) { s = 1; q = -q; }
+
+    if (q == 0)
+        unq = 0;
+    else if (q >= MASK(prec - 1))
+        unq = S16MAX;
+    else
+        unq = ((q << 15) + 0x4000) >> (prec - 1);
+
+    return s ? -unq : unq;
+}
+
+// Interpolates a channel of one region and scales the result to half bits, sign magnitude for signed formats
+static void BC6HInterpolate(int a, int b, int numIndices, bool bSigned, unsigned short palette[16])
+{
+    const short (*weights)[2] = (numIndices == 16) ? g_BC6HWeightPairs4 : g_BC6HWeightPairs3;
+
+#ifdef BC6H_DECODE_USE_SSE2
+    // The endpoints go through pmaddwd as 16 bit pairs, unsigned values are biased by 0x8000 to fit
+    const int bias = bSigned ? 0 : 0x8000;
+    const __m128i pair  = _mm_set1_epi32((int)(((unsigned int)(b - bias) << 16) | ((unsigned int)(a - bias) & 0xFFFF)));
+    const __m128i round = _mm_set1_epi32((bias << 6) + 32);
+
+    for (int i = 0; i < numIndices; i += 4)
+    {
+        __m128i w = _mm_loadu_si128((const __m128i *)weights[i]);
+        __m128i q = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(pair, w), round), 6);
+        __m128i h;
+
+        if (bSigned)
+        {
+            __m128i s = _mm_srai_epi32(q, 31);
+            __m128i m = _mm_sub_epi32(_mm_xor_si128(q, s), s);
+            m = _mm_srli_epi32(_mm_sub_epi32(_mm_slli_epi32(m, 5), m), 5);
+            h = _mm_or_si128(m, _mm_and_si128(s, _mm_set1_epi32(0x8000)));
+        }
+        else
+            h = _mm_srli_epi32(_mm_sub_epi32(_mm_slli_epi32(q, 5), q), 6);
+
+        // Values are at most 16 bits, shift in sign bits so signed saturation keeps them as is
+        h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+        _mm_storel_epi64((__m128i *)&palette[i], _mm_packs_epi32(h, h));
+    }
+#else
+    for (int i = 0; i < numIndices; i++)
+    {
+        int q = (a * weights[i][0] + b * weights[i][1] + 32) >> 6;
+
+        if (bSigned)
+            palette[i] = (unsigned short)((q < 0) ? (0x8000 | (((-q) * 31) >> 5)) : ((q * 31) >> 5));
+        else
+            palette[i] = (unsigned short)((q * 31) >> 6);
+    }
+#endif
+}
+
+void BC6HBlockDecoder::DecompressBlock(unsigned short out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG], BYTE in[COMPRESSED_BLOCK_SIZE])
+{
+    unsigned long long bits[2] = { 0, 0 };
+    for (int i = 0; i < 8; i++)
+    {
+        bits[0] |= (unsigned long long)in[i]     << (i * 8);
+        bits[1] |= (unsigned long long)in[i + 8] << (i * 8);
+    }
+
+    int modeIndex = g_BC6HModeIndex[in[0] & 0x1F];
+    if (modeIndex < 0)
+    {
+        // Reserved modes decode to zero
+        for (int i = 0; i < MAX_SUBSET_SIZE; i++)
+        {
+            out[i][0] = out[i][1] = out[i][2] = 0;
+            out[i][3] = BC6H_HALF_ONE;
+        }
+        return;
+    }
+
+    const BC6HModeLayout &layout = g_BC6HModeLayout[modeIndex];
+
+    int fields[BC6H_NUM_FIELDS] = { 0 };
+    for (int i = 0; i < layout.numRuns; i++)
+    {
+        const BC6HFieldRun &run = layout.runs[i];
+        fields[run.field] |= BC6HGetBits(bits, run.pos, run.count) << run.shift;
+    }
+
+    // Recover the endpoints, deltas are relative to w
+    int numEndpoints = layout.regions * 2;
+    for (int c = 0; c < NCHANNELS; c++)
+    {
+        int w = fields[c];
+
+        if (bc6signed)
+            fields[c] = BC6HSignExtend(w, layout.wBits);
+
+        for (int e = 1; e < numEndpoints; e++)
+        {
+            int f = fields[e * NCHANNELS + c];
+
+            if (layout.transformed)
+            {
+                f = (BC6HSignExtend(f, layout.tBits[c]) + w) & MASK(layout.wBits);
+                if (bc6signed)
+                    f = BC6HSignExtend(f, layout.wBits);
+            }
+            else if (bc6signed)
+                f = BC6HSignExtend(f, layout.tBits[c]);
+
+            fields[e * NCHANNELS + c] = f;
+        }
+    }
+
+    // Build the palettes
+    int numIndices = (layout.regions == 1) ? 16 : 8;
+    unsigned short palette[2][NCHANNELS][16];
+    for (int r = 0; r < layout.regions; r++)
+    {
+        for (int c = 0; c < NCHANNELS; c++)
+        {
+            int a = BC6HUnquantize(fields[(r * 2)     * NCHANNELS + c], layout.wBits, bc6signed);
+            int b = BC6HUnquantize(fields[(r * 2 + 1) * NCHANNELS + c], layout.wBits, bc6signed);
+            BC6HInterpolate(a, b, numIndices, bc6signed, palette[r][c]);
+        }
+    }
+
+    // Indices follow the endpoints, the anchor index of each region is one bit shorter
+    if (layout.regions == 1)
+    {
+        int pos = ONE_REGION_INDEX_OFFSET;
+        for (int i = 0; i < MAX_SUBSET_SIZE; i++)
+        {
+            int nbits = (i == 0) ? 3 : 4;
+            int index = BC6HGetBits(bits, pos, nbits);
+            pos += nbits;
+
+            out[i][0] = palette[0][0][index];
+            out[i][1] = palette[0][1][index];
+            out[i][2] = palette[0][2][index];
+            out[i][3] = BC6H_HALF_ONE;
+        }
+    }
+    else
+    {
+        int shape = BC6HGetBits(bits, 77, 5);
+        int pos   = TWO_REGION_INDEX_OFFSET;
+        for (int i = 0; i < MAX_SUBSET_SIZE; i++)
+        {
+            int nbits  = (i == 0 || g_indexfixups[shape] == i) ? 2 : 3;
+            int index  = BC6HGetBits(bits, pos, nbits);
+            int region = PARTITIONS[1][shape][i];
+            pos += nbits;
+
+            out[i][0] = palette[region][0][index];
+            out[i][1] = palette[region][1][index];
+            out[i][2] = palette[region][2][index];
+            out[i][3] = BC6H_HALF_ONE;
+        }
+    }
+}
@@ -348,11 +348,26 @@ void SaveDataBlock(AMD_BC6H_Format bc6h_format, BYTE out[BC6H_COMPRESSED_BLOCK_S
             header.setvalue(15, 10, bc6h_format.gw);            // 16:   gw[9:0]
             header.setvalue(25, 10, bc6h_format.bw);            // 16:   bw[9:0]
             header.setvalue(35, 4, bc6h_format.rx);            //  4:   rx[3:0]
-            header.setvalue(39, 6, bc6h_format.rw, 10);         //       rw[15:10]
+            header.setvalue(39, 1, bc6h_format.rw, 15);         //       rw[15:10] reversed
+            header.setvalue(40, 1, bc6h_format.rw, 14);
+            header.setvalue(41, 1, bc6h_format.rw, 13);
+            header.setvalue(42, 1, bc6h_format.rw, 12);
+            header.setvalue(43, 1, bc6h_format.rw, 11);
+            header.setvalue(44, 1, bc6h_format.rw, 10);
             header.setvalue(45, 4, bc6h_format.gx);            //  4:   gx[3:0]
-            header.setvalue(49, 6, bc6h_format.gw, 10);         //       gw[15:10]
+            header.setvalue(49, 1, bc6h_format.gw, 15);         //       gw[15:10] reversed
+            header.setvalue(50, 1, bc6h_format.gw, 14);
+            header.setvalue(51, 1, bc6h_format.gw, 13);
+            header.setvalue(52, 1, bc6h_format.gw, 12);
+            header.setvalue(53, 1, bc6h_format.gw, 11);
+            header.setvalue(54, 1, bc6h_format.gw, 10);
             header.setvalue(55, 4, bc6h_format.bx);            //  4:   bx[3:0]
-            header.setvalue(59, 6, bc6h_format.bw, 10);         //       bw[15:10]
+            header.setvalue(59, 1, bc6h_format.bw, 15);         //       bw[15:10] reversed
+            header.setvalue(60, 1, bc6h_format.bw, 14);
+            header.setvalue(61, 1, bc6h_format.bw, 13);
+            header.setvalue(62, 1, bc6h_format.bw, 12);
+            header.setvalue(63, 1, bc6h_format.bw, 11);
+            header.setvalue(64, 1, bc6h_format.bw, 10);
             break;
         default: // Need to indicate error!
             return;
@@ -1368,6 +1383,73 @@ float    BC6HBlockEncoder::EncodePattern(AMD_BC6H_Format &BC6H_data, float  erro
     return error;
 }
 
+//==================================================================================
+// RankShapes
+// Scores each two region shape by the summed luminance variance of its regions, 
+// a low score means the shape splits the block into two flat areas that will fit
+// well on two end point lines. Returns the number of shapes to fully encode in 
+// shapeOrder[], best first.
+//==================================================================================
+
+int BC6HBlockEncoder::RankShapes(AMD_BC6H_Format &BC6H_data, int shapeOrder[BC6H_MAX_PARTITIONS])
+{
+    // At full quality keep the original search order so results are unchanged
+    if (m_ShapesKept >= BC6H_MAX_PARTITIONS)
+    {
+        for (int shape = 0; shape < BC6H_MAX_PARTITIONS; shape++)
+            shapeOrder[shape] = shape;
+        return BC6H_MAX_PARTITIONS;
+    }
+
+    float luma[BC6H_MAX_SUBSET_SIZE];
+    for (int i = 0; i < BC6H_MAX_SUBSET_SIZE; i++)
+    {
+        luma[i] = BC6H_LUMA_RED   * BC6H_data.din[i][0] +
+                  BC6H_LUMA_GREEN * BC6H_data.din[i][1] +
+                  BC6H_LUMA_BLUE  * BC6H_data.din[i][2];
+    }
+
+    float score[BC6H_MAX_PARTITIONS];
+    int   numRanked = 0;
+
+    for (int shape = 0; shape < BC6H_MAX_PARTITIONS; shape++)
+    {
+        float sum[BC6H_MAX_SUBSETS]  = { 0.0f, 0.0f };
+        float sum2[BC6H_MAX_SUBSETS] = { 0.0f, 0.0f };
+        int   count[BC6H_MAX_SUBSETS] = { 0, 0 };
+
+        for (int i = 0; i < BC6H_MAX_SUBSET_SIZE; i++)
+        {
+            int subset = PARTITIONS[1][shape][i];
+            sum[subset]  += luma[i];
+            sum2[subset] += luma[i] * luma[i];
+            count[subset]++;
+        }
+
+        // Sum of squared deviations from each region mean
+        float shapeScore = 0.0f;
+        for (int subset = 0; subset < BC6H_MAX_SUBSETS; subset++)
+        {
+            if (count[subset] > 0)
+                shapeScore += sum2[subset] - (sum[subset] * sum[subset]) / count[subset];
+        }
+
+        // Insertion sort on the score, equal scores keep the lower shape first
+        int pos = numRanked;
+        while ((pos > 0) && (score[pos - 1] > shapeScore))
+        {
+            score[pos]      = score[pos - 1];
+            shapeOrder[pos] = shapeOrder[pos - 1];
+            pos--;
+        }
+        score[pos]      = shapeScore;
+        shapeOrder[pos] = shape;
+        numRanked++;
+    }
+
+    return m_ShapesKept;
+}
+
 //==================================================================================
 // CompressBlock 
 // in[]  is half float32 data  [0..1] for unsigned and [-1..+1] for signed
@@ -1498,9 +1580,13 @@ float BC6HBlockEncoder::CompressBlock(float in[MAX_SUBSET_SIZE][MAX_DIMENSION_BI
                 memcpy(&best_BC6H_data,&BC6H_data,sizeof(BC6H_data));
         }
     
-        // now run through all two regions shapes to find the best pattern
-        for (int shape=0; shape<32; shape++)
+        // now run through the best ranked two regions shapes to find the best pattern
+        int shapeOrder[BC6H_MAX_PARTITIONS];
+        int numShapes = RankShapes(BC6H_data, shapeOrder);
+
+        for (int s=0; s<numShapes; s++)
         {
+            int shape = shapeOrder[s];
             Error = FindBestPattern(BC6H_data,true,shape);
             if (Error <= bestError)
             {
@@ -26,6 +26,7 @@
 #include "BC6H_Encode.h"
 #include "BC6H_Decode.h"
 #include "Compressonator.h"
+#include "BlockBatch.h"
 
 
 extern BOOL    g_LibraryInitialized;
@@ -77,6 +78,79 @@ extern "C" BC_ERROR CMP_EncodeBC6HBlock( BC6HBlockEncoder* encoder, float  in[BC
 }
 
 
+//
+// Batch encoder, each worker gets its own copy of the callers BC6HBlockEncoder
+//
+class BC6HBatchEncoder : public CBlockBatchEncoder
+{
+public:
+    BC6HBatchEncoder(const BC6HBlockEncoder& encoder) : m_encoder(encoder) {};
+
+    CBlockBatchEncoder* Clone() const
+    {
+        return new BC6HBatchEncoder(m_encoder);
+    }
+
+    void EncodeBlock(const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD dwRowStride, BYTE* pOut)
+    {
+        float in[BC6H_BLOCK_PIXELS][MAX_DIMENSION_BIG];
+
+        BlockBatch_ReadBlock(pIn, layout, dwRowStride, in);
+        if(layout == CMP_BLOCK_LAYOUT_RGBA8)
+        {
+            for(int i = 0; i < BC6H_BLOCK_PIXELS; i++)
+                for(int c = 0; c < BC_COMPONENT_COUNT; c++)
+                    in[i][c] /= 255.0f;
+        }
+
+        m_encoder.CompressBlock(in, pOut);
+    }
+
+private:
+    BC6HBlockEncoder m_encoder;
+};
+
+//
+// Submit a run of blocks for encoding on the worker threads
+//
+//
+//
+extern "C" BC_ERROR CMP_EncodeBC6HBlocks( BC6HBlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                          CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads )
+{
+    if(!g_LibraryInitialized)
+    {
+        return BC_ERROR_LIBRARY_NOT_INITIALIZED;
+    }
+
+    if( !encoder || !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    BC6HBatchEncoder batchEncoder(*encoder);
+    return BlockBatch_Encode(batchEncoder, "BC6H Blocks", in, layout, blockStride, rowStride, numBlocks, out, numThreads);
+}
+
+extern "C" BC_ERROR CMP_EncodeBC6HBlocksAsync( BC6HBlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                               CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                               CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job )
+{
+    if(!g_LibraryInitialized)
+    {
+        return BC_ERROR_LIBRARY_NOT_INITIALIZED;
+    }
+
+    if( !encoder || !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    return BlockBatch_EncodeAsync(new BC6HBatchEncoder(*encoder), "BC6H Blocks", in, layout, blockStride, rowStride, numBlocks, out, numThreads,
+                                  pCallback, pUser, job);
+}
+
+
 //
 // Decode a block and write it to the output
 //
@@ -99,6 +173,32 @@ extern "C" BC_ERROR CMP_DecodeBC6HBlock( BYTE *in, float  out[BC_BLOCK_PIXELS][M
 }
 
 
+//
+// Decode a run of contiguous blocks straight to RGBA16F
+//
+// Uses the integer decoder which needs no library state, so unlike
+// CMP_DecodeBC6HBlock this can be called without initializing the library
+//
+extern "C" BC_ERROR CMP_DecodeBC6HBlocks( BYTE *in, CMP_DWORD numBlocks, CMP_HALF *out, BOOL isSigned )
+{
+    if( !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    BC6HBlockDecoder decoder;
+    decoder.bc6signed = isSigned ? true : false;
+
+    for(CMP_DWORD i = 0; i < numBlocks; i++)
+    {
+        decoder.DecompressBlock((unsigned short (*)[MAX_DIMENSION_BIG])out, in);
+        in  += COMPRESSED_BLOCK_SIZE;
+        out += BC_BLOCK_PIXELS * MAX_DIMENSION_BIG;
+    }
+    return BC_ERROR_NONE;
+}
+
+
 //
 // Destroys encoder object
 //
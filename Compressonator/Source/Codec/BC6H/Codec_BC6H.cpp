@@ -33,6 +33,7 @@
 #include "BC6H_library.h"
 #include "BC6H_Definitions.h"
 #include "process.h"
+#include "CMP_Trace.h"
 #include "HDR_Encode.h"
 
 using namespace HDR_Encode;
@@ -66,6 +67,8 @@ struct BC6HEncodeThreadParam
 unsigned int    _stdcall BC6HThreadProcEncode(void* param)
 {
     BC6HEncodeThreadParam *tp = (BC6HEncodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("BC6H Worker");
+    CMP_TRACE_SCOPE("Compress", "BC6H Worker");
 
     while(tp->exit == FALSE)
     {
@@ -107,6 +110,7 @@ CCodec_BC6H::CCodec_BC6H(CodecType codecType) : CCodec_DXTC(codecType)
 
     // Internal setting
     m_LibraryInitialized    = false;
+    m_decoder               = NULL;
     m_NumEncodingThreads    = 1;
     m_EncodingThreadHandle  = NULL;
     m_LiveThreads           = 0;
@@ -261,14 +265,14 @@ CCodec_BC6H::~CCodec_BC6H()
             }
         }
 
-        if (m_decoder)
-        {
-            delete m_decoder;
-            m_decoder = NULL;
-        }
-
         m_LibraryInitialized = false;
     }
+    // The decoder can exist without the encoder library when only decompressing
+    if (m_decoder)
+    {
+        delete m_decoder;
+        m_decoder = NULL;
+    }
 }
 
 
@@ -368,7 +372,8 @@ CodecError CCodec_BC6H::CInitializeBC6HLibrary()
 
 
         // Create single decoder instance
-        m_decoder = new BC6HBlockDecoder();
+        if (!m_decoder)
+            m_decoder = new BC6HBlockDecoder();
         if(!m_decoder)
         {
             for(DWORD j=0; j<m_NumEncodingThreads; j++)
@@ -451,6 +456,8 @@ CodecError CCodec_BC6H::CFinishBC6HEncoding(void)
 
 if (m_Use_MultiThreading)
 {
+    CMP_TRACE_SCOPE("Compress", "BC6H Wait Workers");
+
     // Wait for all the live threads to finish any current work
     for(DWORD i=0; i < m_LiveThreads; i++)
     {
@@ -633,8 +640,10 @@ CodecError CCodec_BC6H::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
     assert(bufferIn.GetWidth() == bufferOut.GetWidth());
     assert(bufferIn.GetHeight() == bufferOut.GetHeight());
     
-    CodecError err = CInitializeBC6HLibrary();
-    if (err != CE_OK) return err;
+    // Decoding only needs the block decoder, the encoder threads are not started
+    if (!m_decoder)
+        m_decoder = new BC6HBlockDecoder();
+    if (!m_decoder) return CE_Unknown;
     
     if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
         return CE_Unknown;
@@ -643,56 +652,52 @@ CodecError CCodec_BC6H::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
     const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
     const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
 
+    // Half output goes straight into RGBA16F buffers, other buffers get the halves widened to float
+    const bool bHalfOut = (bufferOut.GetBufferType() == CBT_RGBA16F);
+
+    m_decoder->bc6signed = (m_CodecType == CT_BC6H_SF);
+
     for(CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
         for(CMP_DWORD i = 0; i < dwBlocksX; i++)
         {
-            union FBLOCKS
-            {
-                float decodedBlock[16][4];
-                float destBlock[BLOCK_SIZE_4X4X4];
-            } DecData;
-
             union BBLOCKS
             {
                 CMP_DWORD    compressedBlock[4];
-                BYTE            out[16];
                 BYTE            in[16];
             } CompData;
 
-            CMP_FLOAT destBlock[BLOCK_SIZE_4X4X4];
-            
-            bufferIn.ReadBlock(i*4, j*4, CompData.compressedBlock, 4);
+            unsigned short decodedBlock[BLOCK_SIZE_4X4][4];
 
-            // Encode to the appropriate location in the compressed image
-            if (m_CodecType == CT_BC6H_SF)
-                m_decoder->bc6signed = true;
-            else
-                m_decoder->bc6signed = false;
+            bufferIn.ReadBlock(i*4, j*4, CompData.compressedBlock, 4);
 
-            m_decoder->DecompressBlock(DecData.decodedBlock,CompData.in);
+            m_decoder->DecompressBlock(decodedBlock, CompData.in);
 
-            // Create the block for decoding
-            float R,G,B,A;
-            int srcIndex = 0;
-            for(int row=0; row < BLOCK_SIZE_4; row++)
+            if (bHalfOut)
             {
-                for(int col=0; col<BLOCK_SIZE_4; col++)
+                half destBlock[BLOCK_SIZE_4X4X4];
+                for (int k = 0; k < BLOCK_SIZE_4X4; k++)
                 {
-                    R = (CMP_FLOAT)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC6H_COMP_RED];         
-                    G = (CMP_FLOAT)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC6H_COMP_GREEN];     
-                    B = (CMP_FLOAT)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC6H_COMP_BLUE];     
-                    A = (CMP_FLOAT)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC6H_COMP_ALPHA];     
-                    destBlock[srcIndex]   = R;         
-                    destBlock[srcIndex+1] = G;     
-                    destBlock[srcIndex+2] = B;     
-                    destBlock[srcIndex+3] = A;     
-                    srcIndex+=4;
+                    destBlock[k*4].setBits(decodedBlock[k][BC6H_COMP_RED]);
+                    destBlock[k*4+1].setBits(decodedBlock[k][BC6H_COMP_GREEN]);
+                    destBlock[k*4+2].setBits(decodedBlock[k][BC6H_COMP_BLUE]);
+                    destBlock[k*4+3].setBits(decodedBlock[k][BC6H_COMP_ALPHA]);
                 }
+                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+            }
+            else
+            {
+                CMP_FLOAT destBlock[BLOCK_SIZE_4X4X4];
+                half h;
+                for (int k = 0; k < BLOCK_SIZE_4X4; k++)
+                {
+                    h.setBits(decodedBlock[k][BC6H_COMP_RED]);   destBlock[k*4]   = (float)h;
+                    h.setBits(decodedBlock[k][BC6H_COMP_GREEN]); destBlock[k*4+1] = (float)h;
+                    h.setBits(decodedBlock[k][BC6H_COMP_BLUE]);  destBlock[k*4+2] = (float)h;
+                    h.setBits(decodedBlock[k][BC6H_COMP_ALPHA]); destBlock[k*4+3] = (float)h;
+                }
+                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
             }
-
-            bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, (float *) destBlock);
-
         }
 
         if (pFeedbackProc)
@@ -360,3 +360,213 @@ void BC7BlockDecoder::DecompressBlock(double  out[MAX_SUBSET_SIZE][MAX_DIMENSION
         }
     }
 }
+
+
+//
+// Table driven integer decoder
+//
+// The block is held as a 128 bit word and fields are pulled off the bottom
+// with a mask and shift. Endpoints are expanded and interpolated in integer
+// space using the BC7 weights, which is exact against the double ramps above.
+//
+
+// Field layout for each block mode
+typedef struct
+{
+    BYTE    partitionBits;
+    BYTE    rotationBits;
+    BYTE    indexModeBits;
+    BYTE    subsetCount;
+    BYTE    colourBits;             // Per component of one endpoint, excluding P bits
+    BYTE    alphaBits;              // 0 when the mode has no alpha
+    BYTE    pBits;                  // 0 none, 1 shared by both endpoints of a subset, 2 one per endpoint
+    BYTE    indexBits[2];
+} BC7_MODE_LAYOUT;
+
+static const BC7_MODE_LAYOUT g_BC7ModeLayout[NUM_BLOCK_TYPES] =
+{
+    {4, 0, 0, 3, 4, 0, 2, {3, 0}},  // Mode 0
+    {6, 0, 0, 2, 6, 0, 1, {3, 0}},  // Mode 1
+    {6, 0, 0, 3, 5, 0, 0, {2, 0}},  // Mode 2
+    {6, 0, 0, 2, 7, 0, 2, {2, 0}},  // Mode 3
+    {0, 2, 1, 1, 5, 6, 0, {2, 3}},  // Mode 4
+    {0, 2, 0, 1, 7, 8, 0, {2, 2}},  // Mode 5
+    {0, 0, 0, 1, 7, 7, 2, {4, 0}},  // Mode 6
+    {6, 0, 0, 2, 5, 5, 2, {2, 0}},  // Mode 7
+};
+
+// rampLerpWeights scaled by 64
+static const BYTE g_BC7Weights[5][1<<MAX_INDEX_BITS] =
+{
+    {0},
+    {0, 64},
+    {0, 21, 43, 64},
+    {0, 9, 18, 27, 37, 46, 55, 64},
+    {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64}
+};
+
+class BC7BitStream
+{
+public:
+    BC7BitStream(const BYTE in[COMPRESSED_BLOCK_SIZE])
+    {
+        m_lo = m_hi = 0;
+        for(int i = 7; i >= 0; i--)
+        {
+            m_lo = (m_lo << 8) | in[i];
+            m_hi = (m_hi << 8) | in[i + 8];
+        }
+    }
+
+    inline DWORD Read(DWORD bits)
+    {
+        if(bits == 0)
+            return 0;
+        DWORD value = (DWORD)(m_lo & ((1ULL << bits) - 1));
+        m_lo = (m_lo >> bits) | (m_hi << (64 - bits));
+        m_hi >>= bits;
+        return value;
+    }
+
+private:
+    unsigned long long m_lo;
+    unsigned long long m_hi;
+};
+
+static inline BYTE BC7Interpolate(DWORD e0, DWORD e1, DWORD weight)
+{
+    return (BYTE)((((64 - weight) * e0) + (weight * e1) + 32) >> 6);
+}
+
+void BC7BlockDecoder::DecompressBlock(BYTE  out[MAX_SUBSET_SIZE][MAX_DIMENSION_BIG],
+                                      BYTE  in[COMPRESSED_BLOCK_SIZE])
+{
+    DWORD   mode = 0;
+    while(mode < NUM_BLOCK_TYPES && !(in[0] & (1 << mode)))
+        mode++;
+
+    if(mode >= NUM_BLOCK_TYPES)
+    {
+        // Reserved mode, decodes to transparent black
+        memset(out, 0, MAX_SUBSET_SIZE * MAX_DIMENSION_BIG);
+        return;
+    }
+
+    const BC7_MODE_LAYOUT&  layout = g_BC7ModeLayout[mode];
+    BC7BitStream            bits(in);
+
+    bits.Read(mode + 1);
+    DWORD partition = bits.Read(layout.partitionBits);
+    DWORD rotation  = bits.Read(layout.rotationBits);
+    DWORD indexSwap = bits.Read(layout.indexModeBits);
+
+    // Endpoints are stored in the following order RRRR GGGG BBBB (AAAA) (PPPP)
+    DWORD   endpoint[MAX_SUBSETS][2][MAX_DIMENSION_BIG];
+    DWORD   subset, ep, component;
+    DWORD   subsets = layout.subsetCount;
+
+    for(component = 0; component < MAX_DIMENSION_BIG; component++)
+    {
+        DWORD componentBits = (component == COMP_ALPHA) ? layout.alphaBits : layout.colourBits;
+        for(subset = 0; subset < subsets; subset++)
+            for(ep = 0; ep < 2; ep++)
+                endpoint[subset][ep][component] = bits.Read(componentBits);
+    }
+
+    DWORD   colourBits = layout.colourBits;
+    DWORD   alphaBits  = layout.alphaBits;
+    if(layout.pBits)
+    {
+        for(subset = 0; subset < subsets; subset++)
+        {
+            DWORD pBit[2];
+            pBit[0] = bits.Read(1);
+            pBit[1] = (layout.pBits == 2) ? bits.Read(1) : pBit[0];
+            for(ep = 0; ep < 2; ep++)
+                for(component = 0; component < MAX_DIMENSION_BIG; component++)
+                    endpoint[subset][ep][component] = (endpoint[subset][ep][component] << 1) | pBit[ep];
+        }
+        colourBits++;
+        if(alphaBits)
+            alphaBits++;
+    }
+
+    // Expand each endpoint component to 8 bits by replicating the high bits into the low bits
+    for(subset = 0; subset < subsets; subset++)
+    {
+        for(ep = 0; ep < 2; ep++)
+        {
+            for(component = 0; component < MAX_DIMENSION_BIG; component++)
+            {
+                DWORD componentBits = (component == COMP_ALPHA) ? alphaBits : colourBits;
+                if(componentBits)
+                {
+                    DWORD v = endpoint[subset][ep][component] << (8 - componentBits);
+                    endpoint[subset][ep][component] = v | (v >> componentBits);
+                }
+                else
+                    endpoint[subset][ep][component] = 255;
+            }
+        }
+    }
+
+    DWORD   i;
+    if(layout.indexBits[1])
+    {
+        // Separate colour and alpha index sets, only pixel 0 is an anchor
+        DWORD   blockIndices[2][MAX_SUBSET_SIZE];
+        for(DWORD set = 0; set < 2; set++)
+        {
+            blockIndices[set][0] = bits.Read(layout.indexBits[set] - 1);
+            for(i = 1; i < MAX_SUBSET_SIZE; i++)
+                blockIndices[set][i] = bits.Read(layout.indexBits[set]);
+        }
+
+        const BYTE* colourWeights = g_BC7Weights[layout.indexBits[indexSwap]];
+        const BYTE* alphaWeights  = g_BC7Weights[layout.indexBits[indexSwap ^ 1]];
+        DWORD       (*e)[MAX_DIMENSION_BIG] = endpoint[0];
+
+        for(i = 0; i < MAX_SUBSET_SIZE; i++)
+        {
+            DWORD cw = colourWeights[blockIndices[indexSwap][i]];
+            DWORD aw = alphaWeights[blockIndices[indexSwap ^ 1][i]];
+            out[i][COMP_RED]   = BC7Interpolate(e[0][COMP_RED],   e[1][COMP_RED],   cw);
+            out[i][COMP_GREEN] = BC7Interpolate(e[0][COMP_GREEN], e[1][COMP_GREEN], cw);
+            out[i][COMP_BLUE]  = BC7Interpolate(e[0][COMP_BLUE],  e[1][COMP_BLUE],  cw);
+            out[i][COMP_ALPHA] = BC7Interpolate(e[0][COMP_ALPHA], e[1][COMP_ALPHA], aw);
+
+            // Resolve the component rotation
+            if(rotation)
+            {
+                BYTE swap = out[i][COMP_ALPHA];
+                out[i][COMP_ALPHA] = out[i][rotation - 1];
+                out[i][rotation - 1] = swap;
+            }
+        }
+        return;
+    }
+
+    DWORD   fixup[MAX_SUBSETS] = {0, 0, 0};
+    if(subsets == 3)
+    {
+        fixup[1] = BC7_FIXUPINDICES[2][partition][1];
+        fixup[2] = BC7_FIXUPINDICES[2][partition][2];
+    }
+    else if(subsets == 2)
+        fixup[1] = BC7_FIXUPINDICES[1][partition][1];
+
+    const DWORD*    partitionTable = BC7_PARTITIONS[subsets - 1][partition];
+    const BYTE*     weights = g_BC7Weights[layout.indexBits[0]];
+
+    for(i = 0; i < MAX_SUBSET_SIZE; i++)
+    {
+        DWORD   p = partitionTable[i];
+        DWORD   w = weights[bits.Read(layout.indexBits[0] - ((i == fixup[p]) ? 1 : 0))];
+        DWORD   (*e)[MAX_DIMENSION_BIG] = endpoint[p];
+
+        out[i][COMP_RED]   = BC7Interpolate(e[0][COMP_RED],   e[1][COMP_RED],   w);
+        out[i][COMP_GREEN] = BC7Interpolate(e[0][COMP_GREEN], e[1][COMP_GREEN], w);
+        out[i][COMP_BLUE]  = BC7Interpolate(e[0][COMP_BLUE],  e[1][COMP_BLUE],  w);
+        out[i][COMP_ALPHA] = BC7Interpolate(e[0][COMP_ALPHA], e[1][COMP_ALPHA], w);
+    }
+}
@@ -29,6 +29,7 @@
 #include "shake.h"
 #include "Compressonator.h"
 #include "HDR_Encode.h"
+#include "BlockBatch.h"
 
 
 BOOL    g_LibraryInitialized = FALSE;
@@ -98,6 +99,88 @@ extern "C" BC_ERROR CMP_EncodeBC7Block( BC7BlockEncoder* encoder, double  in[BC_
 }
 
 
+//
+// Batch encoder, each worker gets its own copy of the callers BC7BlockEncoder
+//
+class BC7BatchEncoder : public CBlockBatchEncoder
+{
+public:
+    BC7BatchEncoder(const BC7BlockEncoder& encoder) : m_encoder(encoder) {};
+
+    CBlockBatchEncoder* Clone() const
+    {
+        return new BC7BatchEncoder(m_encoder);
+    }
+
+    void EncodeBlock(const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD dwRowStride, BYTE* pOut)
+    {
+        CMP_FLOAT block[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT];
+        double    in[BC_BLOCK_PIXELS][MAX_DIMENSION_BIG];
+
+        BlockBatch_ReadBlock(pIn, layout, dwRowStride, block);
+        for(int i = 0; i < BC_BLOCK_PIXELS; i++)
+        {
+            for(int c = 0; c < BC_COMPONENT_COUNT; c++)
+            {
+                double v = block[i][c];
+                if(layout != CMP_BLOCK_LAYOUT_RGBA8)
+                {
+                    // Float input is clamped to 0..1 and scaled to the encoders 0..255 range
+                    v = (v < 0.0) ? 0.0 : (v > 1.0) ? 1.0 : v;
+                    v *= 255.0;
+                }
+                in[i][c] = v;
+            }
+        }
+
+        m_encoder.CompressBlock(in, pOut);
+    }
+
+private:
+    BC7BlockEncoder m_encoder;
+};
+
+//
+// Submit a run of blocks for encoding on the worker threads
+//
+//
+//
+extern "C" BC_ERROR CMP_EncodeBC7Blocks( BC7BlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                         CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads )
+{
+    if(!g_LibraryInitialized)
+    {
+        return BC_ERROR_LIBRARY_NOT_INITIALIZED;
+    }
+
+    if( !encoder || !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    BC7BatchEncoder batchEncoder(*encoder);
+    return BlockBatch_Encode(batchEncoder, "BC7 Blocks", in, layout, blockStride, rowStride, numBlocks, out, numThreads);
+}
+
+extern "C" BC_ERROR CMP_EncodeBC7BlocksAsync( BC7BlockEncoder* encoder, const void* in, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                                              CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                              CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job )
+{
+    if(!g_LibraryInitialized)
+    {
+        return BC_ERROR_LIBRARY_NOT_INITIALIZED;
+    }
+
+    if( !encoder || !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    return BlockBatch_EncodeAsync(new BC7BatchEncoder(*encoder), "BC7 Blocks", in, layout, blockStride, rowStride, numBlocks, out, numThreads,
+                                  pCallback, pUser, job);
+}
+
+
 //
 // Decode a block and write it to the output
 //
@@ -120,6 +203,29 @@ extern "C" BC_ERROR CMP_DecodeBC7Block( BYTE *in, double  out[BC_BLOCK_PIXELS][M
 }
 
 
+//
+// Decode a run of contiguous blocks straight to RGBA8
+//
+// Uses the integer decoder which needs no library state, so unlike
+// CMP_DecodeBC7Block this can be called without initializing the library
+//
+extern "C" BC_ERROR CMP_DecodeBC7Blocks( BYTE *in, CMP_DWORD numBlocks, BYTE *out )
+{
+    if( !in || !out )
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    for(CMP_DWORD i = 0; i < numBlocks; i++)
+    {
+        g_Decoder.DecompressBlock((BYTE (*)[MAX_DIMENSION_BIG])out, in);
+        in  += COMPRESSED_BLOCK_SIZE;
+        out += BC_BLOCK_PIXELS * MAX_DIMENSION_BIG;
+    }
+    return BC_ERROR_NONE;
+}
+
+
 //
 // Destroys encoder object
 //
@@ -31,6 +31,7 @@
 #include "Codec_BC7.h"
 #include "BC7_library.h"
 #include "process.h"
+#include "CMP_Trace.h"
 
 
 #ifdef BC7_COMPDEBUGGER
@@ -61,6 +62,8 @@ struct BC7EncodeThreadParam
 unsigned int    _stdcall BC7ThreadProcEncode(void* param)
 {
     BC7EncodeThreadParam *tp = (BC7EncodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("BC7 Worker");
+    CMP_TRACE_SCOPE("Compress", "BC7 Worker");
 
     while(tp->exit == FALSE)
     {
@@ -86,6 +89,7 @@ static BC7EncodeThreadParam *g_EncodeParameterStorage = NULL;
 CCodec_BC7::CCodec_BC7() : CCodec_DXTC(CT_BC7)
 {
     m_LibraryInitialized   = false;
+    m_decoder              = NULL;
 
     m_Use_MultiThreading   = true;
     m_ModeMask             = 0xCF;  // If you reset this default: seach for comments with dwmodeMask and change the values also
@@ -255,16 +259,16 @@ CCodec_BC7::~CCodec_BC7()
             }
         }
 
-        if (m_decoder)
-        {
-            delete m_decoder;
-            m_decoder = NULL;
-        }
-
         Quant_DeInit();
 
         m_LibraryInitialized = false;
     }
+    // The decoder can exist without the encoder library when only decompressing
+    if (m_decoder)
+    {
+        delete m_decoder;
+        m_decoder = NULL;
+    }
 }
 
 
@@ -368,7 +372,8 @@ CodecError CCodec_BC7::InitializeBC7Library()
 
 
         // Create single decoder instance
-        m_decoder = new BC7BlockDecoder();
+        if (!m_decoder)
+            m_decoder = new BC7BlockDecoder();
         if(!m_decoder)
         {
             for(DWORD j=0; j<m_NumEncodingThreads; j++)
@@ -460,6 +465,8 @@ CodecError CCodec_BC7::FinishBC7Encoding(void)
 
 if (m_Use_MultiThreading)
 {
+    CMP_TRACE_SCOPE("Compress", "BC7 Wait Workers");
+
     // Wait for all the live threads to finish any current work
     for(DWORD i=0; i < m_LiveThreads; i++)
     {
@@ -608,8 +615,10 @@ CodecError CCodec_BC7::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOu
     assert(bufferIn.GetWidth() == bufferOut.GetWidth());
     assert(bufferIn.GetHeight() == bufferOut.GetHeight());
     
-    CodecError err = InitializeBC7Library();
-    if (err != CE_OK) return err;
+    // Decoding only needs the block decoder, the encoder threads are not started
+    if (!m_decoder)
+        m_decoder = new BC7BlockDecoder();
+    if (!m_decoder) return CE_Unknown;
     
     if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
         return CE_Unknown;
@@ -622,12 +631,6 @@ CodecError CCodec_BC7::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOu
     {
         for(CMP_DWORD i = 0; i < dwBlocksX; i++)
         {
-            union FBLOCKS
-            {
-                double decodedBlock[16][4];
-                double destBlock[BLOCK_SIZE_4X4X4];
-            } DecData;
-
             union BBLOCKS
             {
                 CMP_DWORD    compressedBlock[4];
@@ -635,28 +638,18 @@ CodecError CCodec_BC7::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOu
                 BYTE            in[16];
             } CompData;
 
-            CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
-            
+            union DBLOCKS
+            {
+                BYTE            decodedBlock[16][4];
+                CMP_BYTE        destBlock[BLOCK_SIZE_4X4X4];
+            } DecData;
+
             bufferIn.ReadBlock(i*4, j*4, CompData.compressedBlock, 4);
 
-            // Encode to the appropriate location in the compressed image
+            // Decode straight to RGBA8 with the integer decoder
             m_decoder->DecompressBlock(DecData.decodedBlock,CompData.in);
 
-            // Create the block for decoding
-            int srcIndex = 0;
-            for(int row=0; row < BLOCK_SIZE_4; row++)
-            {
-                for(int col=0; col<BLOCK_SIZE_4; col++)
-                {
-                    destBlock[srcIndex]   = (CMP_BYTE)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC_COMP_RED];
-                    destBlock[srcIndex+1] = (CMP_BYTE)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC_COMP_GREEN];
-                    destBlock[srcIndex+2] = (CMP_BYTE)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC_COMP_BLUE];
-                    destBlock[srcIndex+3] = (CMP_BYTE)DecData.decodedBlock[row*BLOCK_SIZE_4+col][BC_COMP_ALPHA];
-                    srcIndex+=4;
-                }
-            }
-
-            bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+            bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, DecData.destBlock);
 
         }
 
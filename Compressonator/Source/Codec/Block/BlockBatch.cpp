@@ -0,0 +1,284 @@
+//===============================================================================
+// Copyright (c) 2016  Advanced Micro Devices, Inc. All rights reserved.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// File : BlockBatch.cpp
+//
+// Threaded batch encoding of 4x4 blocks for the BC7 and BC6H block APIs
+//
+//-----------------------------------------------------------------------------
+
+#include "BlockBatch.h"
+#include "CMP_Trace.h"
+#include "half.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Blocks taken by a worker at a time, keeps the shared counter out of the inner loop
+#define BLOCKBATCH_CHUNK    16
+
+struct _CMP_BLOCK_JOB
+{
+    CBlockBatchEncoder* pEncoder;
+    const char*         pszName;
+    const void*         in;
+    CMP_BLOCK_LAYOUT    layout;
+    CMP_DWORD           blockStride;
+    CMP_DWORD           rowStride;
+    CMP_DWORD           numBlocks;
+    BYTE*               out;
+    CMP_DWORD           numThreads;
+    CMP_BlockJob_Proc   pCallback;
+    void*               pUser;
+    bool                bDetached;
+    BC_ERROR            result;
+    std::atomic<bool>   done;
+    std::thread         thread;
+};
+
+static CMP_DWORD PixelSize(CMP_BLOCK_LAYOUT layout)
+{
+    switch(layout)
+    {
+        case CMP_BLOCK_LAYOUT_RGBA8:    return 4 * sizeof(CMP_BYTE);
+        case CMP_BLOCK_LAYOUT_RGBA16F:  return 4 * sizeof(CMP_HALF);
+        case CMP_BLOCK_LAYOUT_RGBA32F:  return 4 * sizeof(CMP_FLOAT);
+    }
+    return 0;
+}
+
+void BlockBatch_ReadBlock(const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD dwRowStride, CMP_FLOAT block[BC_BLOCK_PIXELS][BC_COMPONENT_COUNT])
+{
+    for(int row = 0; row < 4; row++)
+    {
+        const CMP_BYTE* pRow = pIn + row * dwRowStride;
+        for(int col = 0; col < 4; col++)
+        {
+            CMP_FLOAT* pPixel = block[row * 4 + col];
+            for(int c = 0; c < BC_COMPONENT_COUNT; c++)
+            {
+                switch(layout)
+                {
+                    case CMP_BLOCK_LAYOUT_RGBA8:
+                        pPixel[c] = (CMP_FLOAT) pRow[col * 4 + c];
+                        break;
+                    case CMP_BLOCK_LAYOUT_RGBA16F:
+                    {
+                        half h;
+                        h.setBits(((const unsigned short*) pRow)[col * 4 + c]);
+                        pPixel[c] = (CMP_FLOAT) h;
+                        break;
+                    }
+                    case CMP_BLOCK_LAYOUT_RGBA32F:
+                        pPixel[c] = ((const CMP_FLOAT*) pRow)[col * 4 + c];
+                        break;
+                }
+            }
+        }
+    }
+}
+
+static void EncodeRange(CBlockBatchEncoder& encoder, const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                        CMP_DWORD numBlocks, BYTE* out, std::atomic<CMP_DWORD>& nextBlock)
+{
+    for(;;)
+    {
+        CMP_DWORD first = nextBlock.fetch_add(BLOCKBATCH_CHUNK);
+        if(first >= numBlocks)
+            break;
+
+        CMP_DWORD last = first + BLOCKBATCH_CHUNK;
+        if(last > numBlocks)
+            last = numBlocks;
+
+        for(CMP_DWORD i = first; i < last; i++)
+            encoder.EncodeBlock(pIn + (size_t) i * blockStride, layout, rowStride, out + (size_t) i * BC_BLOCK_BYTES);
+    }
+}
+
+static void WorkerProc(const CBlockBatchEncoder* pPrototype, const CMP_BYTE* pIn, CMP_BLOCK_LAYOUT layout, CMP_DWORD blockStride, CMP_DWORD rowStride,
+                       CMP_DWORD numBlocks, BYTE* out, std::atomic<CMP_DWORD>* pNextBlock)
+{
+    CMP_TRACE_THREAD_NAME("Block Batch Worker");
+    CMP_TRACE_SCOPE("Compress", "Block Batch Worker");
+
+    CBlockBatchEncoder* pEncoder = pPrototype->Clone();
+    EncodeRange(*pEncoder, pIn, layout, blockStride, rowStride, numBlocks, out, *pNextBlock);
+    delete pEncoder;
+}
+
+BC_ERROR BlockBatch_Encode(const CBlockBatchEncoder& encoder, const char* pszName, const void* in, CMP_BLOCK_LAYOUT layout,
+                           CMP_DWORD blockStride, CMP_DWORD rowStride, CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads)
+{
+    CMP_DWORD dwPixelSize = PixelSize(layout);
+    if(!in || !out || dwPixelSize == 0)
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    if(rowStride == 0)
+        rowStride = 4 * dwPixelSize;
+    if(blockStride == 0)
+        blockStride = BC_BLOCK_PIXELS * dwPixelSize;
+
+    CMP_TRACE_SCOPE("Compress", pszName);
+
+    if(numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+
+    // No point in waking more workers than there are chunks to hand out
+    CMP_DWORD numChunks = (numBlocks + BLOCKBATCH_CHUNK - 1) / BLOCKBATCH_CHUNK;
+    if(numThreads > numChunks)
+        numThreads = numChunks;
+    if(numThreads > MAX_BLOCKBATCH_THREADS)
+        numThreads = MAX_BLOCKBATCH_THREADS;
+    if(numThreads < 1)
+        numThreads = 1;
+
+    const CMP_BYTE* pIn = (const CMP_BYTE*) in;
+    std::atomic<CMP_DWORD> nextBlock(0);
+
+    // The calling thread is one of the workers
+    std::vector<std::thread> workers;
+    for(CMP_DWORD i = 1; i < numThreads; i++)
+    {
+        try
+        {
+            workers.push_back(std::thread(WorkerProc, &encoder, pIn, layout, blockStride, rowStride, numBlocks, out, &nextBlock));
+        }
+        catch(...)
+        {
+            // Carry on with the workers we have
+            break;
+        }
+    }
+
+    CBlockBatchEncoder* pEncoder = encoder.Clone();
+    EncodeRange(*pEncoder, pIn, layout, blockStride, rowStride, numBlocks, out, nextBlock);
+    delete pEncoder;
+
+    for(size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+
+    return BC_ERROR_NONE;
+}
+
+static void JobProc(CMP_BLOCK_JOB* pJob)
+{
+    CMP_TRACE_THREAD_NAME("Block Batch Job");
+
+    pJob->result = BlockBatch_Encode(*pJob->pEncoder, pJob->pszName, pJob->in, pJob->layout, pJob->blockStride, pJob->rowStride,
+                                     pJob->numBlocks, pJob->out, pJob->numThreads);
+    delete pJob->pEncoder;
+    pJob->pEncoder = NULL;
+
+    if(pJob->pCallback)
+        pJob->pCallback(pJob->result, pJob->pUser);
+
+    // Nobody will wait on a detached job, so it cleans itself up
+    if(pJob->bDetached)
+    {
+        delete pJob;
+        return;
+    }
+    pJob->done = true;
+}
+
+BC_ERROR BlockBatch_EncodeAsync(CBlockBatchEncoder* pEncoder, const char* pszName, const void* in, CMP_BLOCK_LAYOUT layout,
+                                CMP_DWORD blockStride, CMP_DWORD rowStride, CMP_DWORD numBlocks, BYTE* out, CMP_DWORD numThreads,
+                                CMP_BlockJob_Proc pCallback, void* pUser, CMP_BLOCK_JOB** job)
+{
+    if(!pEncoder)
+    {
+        return BC_ERROR_OUT_OF_MEMORY;
+    }
+
+    if(!in || !out || PixelSize(layout) == 0)
+    {
+        delete pEncoder;
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    CMP_BLOCK_JOB* pJob = new CMP_BLOCK_JOB;
+    pJob->pEncoder      = pEncoder;
+    pJob->pszName       = pszName;
+    pJob->in            = in;
+    pJob->layout        = layout;
+    pJob->blockStride   = blockStride;
+    pJob->rowStride     = rowStride;
+    pJob->numBlocks     = numBlocks;
+    pJob->out           = out;
+    pJob->numThreads    = numThreads;
+    pJob->pCallback     = pCallback;
+    pJob->pUser         = pUser;
+    pJob->bDetached     = (job == NULL);
+    pJob->result        = BC_ERROR_NONE;
+    pJob->done          = false;
+
+    std::thread thread;
+    try
+    {
+        thread = std::thread(JobProc, pJob);
+    }
+    catch(...)
+    {
+        delete pJob->pEncoder;
+        delete pJob;
+        return BC_ERROR_OUT_OF_MEMORY;
+    }
+
+    // A detached job may already have finished and deleted itself, so pJob is not touched again
+    if(job)
+    {
+        pJob->thread.swap(thread);
+        *job = pJob;
+    }
+    else
+        thread.detach();
+
+    return BC_ERROR_NONE;
+}
+
+extern "C" bool CMP_IsBlockJobDone(CMP_BLOCK_JOB* job)
+{
+    if(!job)
+    {
+        return true;
+    }
+    return job->done;
+}
+
+extern "C" BC_ERROR CMP_WaitBlockJob(CMP_BLOCK_JOB* job)
+{
+    if(!job)
+    {
+        return BC_ERROR_INVALID_PARAMETERS;
+    }
+
+    if(job->thread.joinable())
+        job->thread.join();
+
+    BC_ERROR result = job->result;
+    delete job;
+    return result;
+}
@@ -73,14 +73,12 @@ CCodecBuffer_Block::CCodecBuffer_Block(CodecBufferType nCodecBufferType,
 
     CMP_DWORD dwBlocksX = ((GetWidth() + m_dwBlockWidth - 1) / m_dwBlockWidth);
     CMP_DWORD dwBlocksY = ((GetHeight() + m_dwBlockHeight - 1) / m_dwBlockHeight);
-    CMP_DWORD dwBlocks = dwBlocksX * dwBlocksY;
     m_dwBlockSize = m_dwBlockWidth * m_dwBlockHeight * m_dwBlockBPP / 8;
     m_dwPitch = dwBlocksX * m_dwBlockSize;
 
     if(m_pData == NULL)
     {
-        CMP_DWORD dwSize = dwBlocks * m_dwBlockSize;
-        m_pData = (CMP_BYTE*) malloc(dwSize);
+        m_pData = AllocData(m_dwPitch, dwBlocksY);
     }
 }
 
@@ -48,8 +48,7 @@ CCodecBuffer_RGBA16F::CCodecBuffer_RGBA16F(
 
     if(m_pData == NULL)
     {
-        CMP_DWORD dwSize = m_dwPitch * GetHeight();
-        m_pData = (CMP_BYTE*) malloc(dwSize);
+        m_pData = AllocData(m_dwPitch, GetHeight());
     }
 }
 
@@ -48,8 +48,7 @@ CCodecBuffer_RGBA8888::CCodecBuffer_RGBA8888(
 
     if(m_pData == NULL)
     {
-        CMP_DWORD dwSize = m_dwPitch * GetHeight();
-        m_pData = (CMP_BYTE*) malloc(dwSize);
+        m_pData = AllocData(m_dwPitch, GetHeight());
     }
 }
 
@@ -240,6 +240,14 @@ CCodecBuffer::~CCodecBuffer()
     }
 }
 
+CMP_BYTE* CCodecBuffer::AllocData(CMP_DWORD dwPitch, CMP_DWORD dwRows)
+{
+    size_t nSize;
+    if(!CMP_MulSize(dwPitch, dwRows, &nSize) || (CMP_DWORD) nSize != nSize)
+        return NULL;
+    return (CMP_BYTE*) malloc(nSize);
+}
+
 void CCodecBuffer::Copy(CCodecBuffer& srcBuffer)
 {
 #ifdef USE_DBGTRACE
@@ -46,6 +46,8 @@
 #include "Codec_ATC_RGBA_Interpolated.h"
 #include "Codec_ETC_RGB.h"
 #include "Codec_ETC2_RGB.h"
+#include "Codec_ETC2_RGBA.h"
+#include "Codec_ETC2_EAC.h"
 #include "Codec_BC6H.h"
 #include "Codec_BC7.h"
 #include "ASTC\Codec_ASTC.h"
@@ -133,6 +135,11 @@ CCodec* CreateCodec(CodecType nCodecType)
         case CT_ATC_RGBA_Interpolated:      return new CCodec_ATC_RGBA_Interpolated;
         case CT_ETC_RGB:                    return new CCodec_ETC_RGB;
         case CT_ETC2_RGB:                   return new CCodec_ETC2_RGB;
+        case CT_ETC2_RGBA:                  return new CCodec_ETC2_RGBA;
+        case CT_EAC_R11:                    return new CCodec_ETC2_EAC(CT_EAC_R11);
+        case CT_EAC_R11_SIGNED:             return new CCodec_ETC2_EAC(CT_EAC_R11_SIGNED);
+        case CT_EAC_RG11:                   return new CCodec_ETC2_EAC(CT_EAC_RG11);
+        case CT_EAC_RG11_SIGNED:            return new CCodec_ETC2_EAC(CT_EAC_RG11_SIGNED);
         case CT_BC6H:                       return new CCodec_BC6H(CT_BC6H);
         case CT_BC6H_SF:                    return new CCodec_BC6H(CT_BC6H_SF);
         case CT_BC7:                        return new CCodec_BC7;
@@ -145,14 +152,64 @@ CCodec* CreateCodec(CodecType nCodecType)
     }
 }
 
+// Returns a static name for the codec, used as the trace scope name of its Compress and Decompress calls
+const char* GetCodecName(CodecType nCodecType)
+{
+    switch(nCodecType)
+    {
+        case CT_None:                       return "None";
+        case CT_DXT1:                       return "DXT1";
+        case CT_DXT3:                       return "DXT3";
+        case CT_DXT5:                       return "DXT5";
+        case CT_DXT5_xGBR:                  return "DXT5_xGBR";
+        case CT_DXT5_RxBG:                  return "DXT5_RxBG";
+        case CT_DXT5_RBxG:                  return "DXT5_RBxG";
+        case CT_DXT5_xRBG:                  return "DXT5_xRBG";
+        case CT_DXT5_RGxB:                  return "DXT5_RGxB";
+        case CT_DXT5_xGxR:                  return "DXT5_xGxR";
+        case CT_ATI1N:                      return "ATI1N";
+        case CT_ATI2N:                      return "ATI2N";
+        case CT_ATI2N_XY:                   return "ATI2N_XY";
+        case CT_ATI2N_DXT5:                 return "ATI2N_DXT5";
+        case CT_ATC_RGB:                    return "ATC_RGB";
+        case CT_ATC_RGBA_Explicit:          return "ATC_RGBA_Explicit";
+        case CT_ATC_RGBA_Interpolated:      return "ATC_RGBA_Interpolated";
+        case CT_ETC_RGB:                    return "ETC_RGB";
+        case CT_ETC2_RGB:                   return "ETC2_RGB";
+        case CT_ETC2_RGBA:                  return "ETC2_RGBA";
+        case CT_EAC_R11:                    return "EAC_R11";
+        case CT_EAC_R11_SIGNED:             return "EAC_R11_SIGNED";
+        case CT_EAC_RG11:                   return "EAC_RG11";
+        case CT_EAC_RG11_SIGNED:            return "EAC_RG11_SIGNED";
+        case CT_BC6H:                       return "BC6H";
+        case CT_BC6H_SF:                    return "BC6H_SF";
+        case CT_BC7:                        return "BC7";
+        case CT_ASTC:                       return "ASTC";
+        case CT_GT:                         return "GT";
+        case CT_Unknown:
+        default:
+            return "Unknown";
+    }
+}
+
 CMP_DWORD CalcBufferSize(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight)
+{
+    size_t buffsize;
+    if(!CalcBufferSize64(nCodecType, dwWidth, dwHeight, nBlockWidth, nBlockHeight, &buffsize) || (CMP_DWORD) buffsize != buffsize)
+        return 0;
+    return (CMP_DWORD) buffsize;
+}
+
+bool CalcBufferSize64(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, size_t* pSize)
 {
 #ifdef USE_DBGTRACE
     DbgTrace(("IN: nCodecType %d, dwWidth %d, dwHeight %d",nCodecType,dwWidth,dwHeight));
 #endif
-    CMP_DWORD dwChannels;
-    CMP_DWORD dwBitsPerChannel;
-    CMP_DWORD buffsize = 0;
+    // Sizes are counted in blocks so that widths and heights near 4G do not wrap when rounded up
+    size_t nBlocksX = ((size_t) dwWidth + 3) / 4;
+    size_t nBlocksY = ((size_t) dwHeight + 3) / 4;
+    size_t nBlockBytes;
+    size_t nMinSize = 0;
 
     switch(nCodecType)
     {
@@ -161,11 +218,9 @@ CMP_DWORD CalcBufferSize(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHe
         case CT_ATC_RGB:
         case CT_ETC_RGB:
         case CT_ETC2_RGB:
-            dwChannels       = 1;
-            dwBitsPerChannel = 4;
-            dwWidth = ((dwWidth + 3) / 4) * 4;
-            dwHeight = ((dwHeight + 3) / 4) * 4;
-            buffsize = (dwWidth * dwHeight * dwChannels * dwBitsPerChannel) / 8;
+        case CT_EAC_R11:
+        case CT_EAC_R11_SIGNED:
+            nBlockBytes = 8;
             break;
 
         case CT_DXT3:
@@ -181,47 +236,46 @@ CMP_DWORD CalcBufferSize(CodecType nCodecType, CMP_DWORD dwWidth, CMP_DWORD dwHe
         case CT_ATI2N_DXT5:
         case CT_ATC_RGBA_Explicit:
         case CT_ATC_RGBA_Interpolated:
-            dwChannels       = 2;
-            dwBitsPerChannel = 4;
-            dwWidth = ((dwWidth + 3) / 4) * 4;
-            dwHeight = ((dwHeight + 3) / 4) * 4;
-            buffsize = (dwWidth * dwHeight * dwChannels * dwBitsPerChannel) / 8;
+        case CT_ETC2_RGBA:
+        case CT_EAC_RG11:
+        case CT_EAC_RG11_SIGNED:
+            nBlockBytes = 16;
             break;
         case CT_BC6H:
         case CT_BC6H_SF:    
-            dwWidth  = ((dwWidth + 3) / 4) * 4;
-            dwHeight = ((dwHeight + 3) / 4) * 4;
-            buffsize = dwWidth * dwHeight; 
-            if (buffsize < BC6H_BLOCK_BYTES) buffsize = BC6H_BLOCK_BYTES; 
+            nBlockBytes = 16;
+            nMinSize    = BC6H_BLOCK_BYTES;
             break;
         case CT_BC7:    
-            // Fix: July 25 2014 was 4x larger than it should be
-            // Aug 1: Added increas in buffer size so that its divisable by 4
-            dwWidth  = ((dwWidth + 3) / 4) * 4;
-            dwHeight = ((dwHeight + 3) / 4) * 4;
-            buffsize = dwWidth * dwHeight; 
-            if (buffsize < BC7_BLOCK_BYTES) buffsize = BC7_BLOCK_BYTES; 
+            nBlockBytes = 16;
+            nMinSize    = BC7_BLOCK_BYTES;
             break;
         case CT_ASTC: 
-            dwWidth  = ((dwWidth + nBlockWidth - 1) / nBlockWidth) * 4;
-            dwHeight = ((dwHeight + nBlockHeight - 1) / nBlockHeight) * 4;
-            buffsize = dwWidth * dwHeight; 
+            if(nBlockWidth == 0 || nBlockHeight == 0)
+                return false;
+            nBlocksX    = ((size_t) dwWidth + nBlockWidth - 1) / nBlockWidth;
+            nBlocksY    = ((size_t) dwHeight + nBlockHeight - 1) / nBlockHeight;
+            nBlockBytes = 16;
             break;
         case CT_GT:
-            // Aug 1: Added increas in buffer size so that its divisable by 4
-            dwWidth = ((dwWidth + 3) / 4) * 4;
-            dwHeight = ((dwHeight + 3) / 4) * 4;
-            buffsize = dwWidth * dwHeight;
-            if (buffsize < (4*4)) buffsize = 4*4;
+            nBlockBytes = 16;
+            nMinSize    = 4*4;
             break;
         default:
-            return 0;
+            return false;
     }
 
+    size_t buffsize;
+    if(!CMP_MulSize(nBlocksX, nBlocksY, &buffsize) || !CMP_MulSize(buffsize, nBlockBytes, &buffsize))
+        return false;
+    if(buffsize < nMinSize)
+        buffsize = nMinSize;
+
 #ifdef USE_DBGTRACE
     DbgTrace(("OUT: %d",buffsize));
 #endif
 
-    return buffsize;
+    *pSize = buffsize;
+    return true;
 }
 
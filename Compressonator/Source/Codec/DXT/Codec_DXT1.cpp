@@ -30,6 +30,7 @@
 
 #include "Common.h"
 #include "Codec_DXT1.h"
+#include "Codec_DXTC_Decode.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -213,24 +214,35 @@ CodecError CCodec_DXT1::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
     const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
 
     bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8 && !m_bUseFloat);
+    // 8 bit RGBA destinations are decoded a whole block row at a time
+    bool bDecodeRows = bUseFixed && bufferOut.GetBufferType() == CBT_RGBA8888;
 
     for(CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+        if(bDecodeRows)
         {
-            CMP_DWORD compressedBlock[2];
-            bufferIn.ReadBlock(i*4, j*4, compressedBlock, 2);
-            if(bUseFixed)
-            {
-                CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
-                DecompressRGBBlock(destBlock, compressedBlock, true);
-                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
-            }
-            else
+            DXTCDecodeRowBC1(bufferIn.GetData() + (j * bufferIn.GetPitch()), dwBlocksX,
+                             bufferOut.GetData() + (j * 4 * bufferOut.GetPitch()), bufferOut.GetPitch(),
+                             bufferOut.GetWidth(), bufferOut.GetHeight() - (j * 4), m_bSwizzleChannels);
+        }
+        else
+        {
+            for(CMP_DWORD i = 0; i < dwBlocksX; i++)
             {
-                float destBlock[BLOCK_SIZE_4X4X4];
-                DecompressRGBBlock(destBlock, compressedBlock, true);
-                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                CMP_DWORD compressedBlock[2];
+                bufferIn.ReadBlock(i*4, j*4, compressedBlock, 2);
+                if(bUseFixed)
+                {
+                    CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
+                    DecompressRGBBlock(destBlock, compressedBlock, true);
+                    bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                }
+                else
+                {
+                    float destBlock[BLOCK_SIZE_4X4X4];
+                    DecompressRGBBlock(destBlock, compressedBlock, true);
+                    bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                }
             }
         }
 
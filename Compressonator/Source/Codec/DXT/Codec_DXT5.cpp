@@ -30,6 +30,7 @@
 
 #include "Common.h"
 #include "Codec_DXT5.h"
+#include "Codec_DXTC_Decode.h"
 
 #ifdef DXT5_COMPDEBUGGER
 #include "debug.h"
@@ -224,24 +225,35 @@ CodecError CCodec_DXT5::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferO
     const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
 
     bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8 && !m_bUseFloat);
+    // 8 bit RGBA destinations are decoded a whole block row at a time
+    bool bDecodeRows = bUseFixed && bufferOut.GetBufferType() == CBT_RGBA8888;
 
     for(CMP_DWORD j = 0; j < dwBlocksY; j++)
     {
-        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+        if(bDecodeRows)
         {
-            CMP_DWORD compressedBlock[4];
-            bufferIn.ReadBlock(i*4, j*4, compressedBlock, 4);
-            if(bUseFixed)
-            {
-                CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
-                DecompressRGBABlock(destBlock, compressedBlock);
-                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
-            }
-            else
+            DXTCDecodeRowBC3(bufferIn.GetData() + (j * bufferIn.GetPitch()), dwBlocksX,
+                             bufferOut.GetData() + (j * 4 * bufferOut.GetPitch()), bufferOut.GetPitch(),
+                             bufferOut.GetWidth(), bufferOut.GetHeight() - (j * 4), m_bSwizzleChannels);
+        }
+        else
+        {
+            for(CMP_DWORD i = 0; i < dwBlocksX; i++)
             {
-                float destBlock[BLOCK_SIZE_4X4X4];
-                DecompressRGBABlock(destBlock, compressedBlock);
-                bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                CMP_DWORD compressedBlock[4];
+                bufferIn.ReadBlock(i*4, j*4, compressedBlock, 4);
+                if(bUseFixed)
+                {
+                    CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
+                    DecompressRGBABlock(destBlock, compressedBlock);
+                    bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                }
+                else
+                {
+                    float destBlock[BLOCK_SIZE_4X4X4];
+                    DecompressRGBABlock(destBlock, compressedBlock);
+                    bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+                }
             }
         }
 
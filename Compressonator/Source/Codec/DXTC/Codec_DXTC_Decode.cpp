@@ -0,0 +1,713 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//
+//  File Name:   Codec_DXTC_Decode.cpp
+//  Description: row batch decoders for the BC1 - BC5 block formats
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Common.h"
+#include "CodecBuffer.h"
+#include "Codec_DXTC_Decode.h"
+#include <atomic>
+
+#if defined(USE_SSE2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define DXTC_DECODE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// MSVC accepts AVX2 intrinsics without /arch:AVX2 so the path is picked at runtime,
+// other compilers only get it when the whole build targets AVX2
+#if defined(DXTC_DECODE_USE_SSE2) && (defined(_MSC_VER) || defined(__AVX2__))
+#define DXTC_DECODE_USE_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef DXTC_DECODE_USE_SSE2
+#define DXTC_SSE2_PROC(proc) proc
+#else
+#define DXTC_SSE2_PROC(proc) NULL
+#endif
+
+#ifdef DXTC_DECODE_USE_AVX2
+#define DXTC_AVX2_PROC(proc) proc
+#else
+#define DXTC_AVX2_PROC(proc) NULL
+#endif
+
+#define DXTC_BC1_BLOCK_DWORDS 2
+#define DXTC_BC3_BLOCK_DWORDS 4
+
+#define RGB_MASK 0x00ffffff
+
+struct DXTCDecodeParams
+{
+    bool             bSwizzle;
+    CMP_DWORD        dwROffset;
+    DXTCDecodeFormat format;
+};
+
+// Decodes one 4x4 block into 4 scanlines of the destination
+typedef void (*DXTCDecodeBlockProc)(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params);
+
+//
+// Palette setup, shared by every path so they all match the block decoders in CCodec_DXTC
+//
+static void GetColourPalette(CMP_DWORD dwColours, bool bDXT1, bool bSwizzle, CMP_DWORD palette[4])
+{
+    CMP_DWORD n0 = dwColours & 0xffff;
+    CMP_DWORD n1 = (dwColours >> 16) & 0xffff;
+
+    CMP_DWORD r0 = ((n0 & 0xf800) >> 8);
+    CMP_DWORD g0 = ((n0 & 0x07e0) >> 3);
+    CMP_DWORD b0 = ((n0 & 0x001f) << 3);
+
+    CMP_DWORD r1 = ((n1 & 0xf800) >> 8);
+    CMP_DWORD g1 = ((n1 & 0x07e0) >> 3);
+    CMP_DWORD b1 = ((n1 & 0x001f) << 3);
+
+    if(bSwizzle)
+    {
+        SWAP_DWORDS(r0, b0);
+        SWAP_DWORDS(r1, b1);
+    }
+
+    // Apply the lower bit replication to give full dynamic range
+    r0 += (r0>>5); r1 += (r1>>5);
+    g0 += (g0>>6); g1 += (g1>>6);
+    b0 += (b0>>5); b1 += (b1>>5);
+
+    palette[0] = 0xff000000 | (r0<<16) | (g0<<8) | b0;
+    palette[1] = 0xff000000 | (r1<<16) | (g1<<8) | b1;
+
+    if(!bDXT1 || n0 > n1)
+    {
+        palette[2] = 0xff000000 | (((2*r0+r1+1)/3)<<16) | (((2*g0+g1+1)/3)<<8) | (((2*b0+b1+1)/3));
+        palette[3] = 0xff000000 | (((2*r1+r0+1)/3)<<16) | (((2*g1+g0+1)/3)<<8) | (((2*b1+b0+1)/3));
+    }
+    else
+    {
+        // Transparent decode
+        palette[2] = 0xff000000 | (((r0+r1)/2)<<16) | (((g0+g1)/2)<<8) | (((b0+b1)/2));
+        palette[3] = 0x00000000;
+    }
+}
+
+static void GetAlphaPalette(const CMP_DWORD compressedBlock[2], CMP_BYTE alpha[8])
+{
+    alpha[0] = (CMP_BYTE)(compressedBlock[0] & 0xff);
+    alpha[1] = (CMP_BYTE)((compressedBlock[0]>>8) & 0xff);
+
+    if (alpha[0] > alpha[1])
+    {
+        alpha[2] = static_cast<CMP_BYTE>((6 * alpha[0] + 1 * alpha[1] + 3) / 7);
+        alpha[3] = static_cast<CMP_BYTE>((5 * alpha[0] + 2 * alpha[1] + 3) / 7);
+        alpha[4] = static_cast<CMP_BYTE>((4 * alpha[0] + 3 * alpha[1] + 3) / 7);
+        alpha[5] = static_cast<CMP_BYTE>((3 * alpha[0] + 4 * alpha[1] + 3) / 7);
+        alpha[6] = static_cast<CMP_BYTE>((2 * alpha[0] + 5 * alpha[1] + 3) / 7);
+        alpha[7] = static_cast<CMP_BYTE>((1 * alpha[0] + 6 * alpha[1] + 3) / 7);
+    }
+    else
+    {
+        alpha[2] = static_cast<CMP_BYTE>((4 * alpha[0] + 1 * alpha[1] + 2) / 5);
+        alpha[3] = static_cast<CMP_BYTE>((3 * alpha[0] + 2 * alpha[1] + 2) / 5);
+        alpha[4] = static_cast<CMP_BYTE>((2 * alpha[0] + 3 * alpha[1] + 2) / 5);
+        alpha[5] = static_cast<CMP_BYTE>((1 * alpha[0] + 4 * alpha[1] + 2) / 5);
+        alpha[6] = 0;
+        alpha[7] = 255;
+    }
+}
+
+// The 48 index bits of an alpha block split into two 24 bit halves, pixels 0-7 and 8-15
+static inline CMP_DWORD GetAlphaIndicesLo(const CMP_DWORD compressedBlock[2])
+{
+    return ((compressedBlock[0] >> 16) | (compressedBlock[1] << 16)) & 0xffffff;
+}
+
+static inline CMP_DWORD GetAlphaIndicesHi(const CMP_DWORD compressedBlock[2])
+{
+    return (compressedBlock[1] >> 8) & 0xffffff;
+}
+
+static inline CMP_DWORD GetAlphaIndex(CMP_DWORD dwLo, CMP_DWORD dwHi, int i)
+{
+    return (i < 8) ? ((dwLo >> (3 * i)) & 0x7) : ((dwHi >> (3 * (i - 8))) & 0x7);
+}
+
+static inline CMP_BYTE GetExplicitAlpha(const CMP_DWORD compressedBlock[2], int i)
+{
+    CMP_BYTE cAlpha = (CMP_BYTE) ((compressedBlock[i / 8] >> ((i % 8) * 4)) & 0xf);
+    return (CMP_BYTE) ((cAlpha << 4) | cAlpha);
+}
+
+//
+// Scalar reference path
+//
+static void DecodeColourScalar(const CMP_DWORD compressedBlock[2], bool bDXT1, const CMP_BYTE* pAlpha, CMP_BYTE* pDest, CMP_DWORD dwPitch, bool bSwizzle)
+{
+    CMP_DWORD palette[4];
+    GetColourPalette(compressedBlock[0], bDXT1, bSwizzle, palette);
+
+    for(int y = 0; y < 4; y++)
+    {
+        CMP_DWORD* pData = (CMP_DWORD*) (pDest + y * dwPitch);
+        for(int x = 0; x < 4; x++)
+        {
+            int i = (y * 4) + x;
+            CMP_DWORD dwColour = palette[(compressedBlock[1] >> (2 * i)) & 3];
+            if(pAlpha)
+                dwColour = (pAlpha[i] << RGBA8888_OFFSET_A) | (dwColour & RGB_MASK);
+            pData[x] = dwColour;
+        }
+    }
+}
+
+static void DecodeBC1Scalar(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    DecodeColourScalar(pBlock, true, NULL, pDest, dwPitch, params.bSwizzle);
+}
+
+static void DecodeBC2Scalar(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_BYTE alpha[BLOCK_SIZE_4X4];
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        alpha[i] = GetExplicitAlpha(pBlock, i);
+
+    DecodeColourScalar(&pBlock[2], false, alpha, pDest, dwPitch, params.bSwizzle);
+}
+
+static void DecodeBC3Scalar(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_BYTE palette[8];
+    GetAlphaPalette(pBlock, palette);
+    CMP_DWORD dwLo = GetAlphaIndicesLo(pBlock);
+    CMP_DWORD dwHi = GetAlphaIndicesHi(pBlock);
+
+    CMP_BYTE alpha[BLOCK_SIZE_4X4];
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        alpha[i] = palette[GetAlphaIndex(dwLo, dwHi, i)];
+
+    DecodeColourScalar(&pBlock[2], false, alpha, pDest, dwPitch, params.bSwizzle);
+}
+
+static void DecodeSingleChannelScalar(const CMP_DWORD compressedBlock[2], CMP_BYTE value[BLOCK_SIZE_4X4])
+{
+    CMP_BYTE palette[8];
+    GetAlphaPalette(compressedBlock, palette);
+    CMP_DWORD dwLo = GetAlphaIndicesLo(compressedBlock);
+    CMP_DWORD dwHi = GetAlphaIndicesHi(compressedBlock);
+
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        value[i] = palette[GetAlphaIndex(dwLo, dwHi, i)];
+}
+
+static void DecodeBC4Scalar(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_BYTE value[BLOCK_SIZE_4X4];
+    DecodeSingleChannelScalar(pBlock, value);
+
+    for(int y = 0; y < 4; y++)
+    {
+        CMP_BYTE* pRow = pDest + y * dwPitch;
+        for(int x = 0; x < 4; x++)
+        {
+            CMP_BYTE v = value[(y * 4) + x];
+            if(params.format == DXTC_DECODE_R8)
+                pRow[x] = v;
+            else
+                ((CMP_DWORD*) pRow)[x] = MAKE_RGBA8888(v, v, v, (CMP_DWORD) v);
+        }
+    }
+}
+
+static void DecodeBC5Scalar(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_BYTE red[BLOCK_SIZE_4X4];
+    CMP_BYTE green[BLOCK_SIZE_4X4];
+    DecodeSingleChannelScalar(&pBlock[params.dwROffset], red);
+    DecodeSingleChannelScalar(&pBlock[params.dwROffset ^ 2], green);
+
+    for(int y = 0; y < 4; y++)
+    {
+        CMP_BYTE* pRow = pDest + y * dwPitch;
+        for(int x = 0; x < 4; x++)
+        {
+            CMP_DWORD r = red[(y * 4) + x];
+            CMP_DWORD g = green[(y * 4) + x];
+            if(params.format == DXTC_DECODE_RG8)
+                ((CMP_WORD*) pRow)[x] = (CMP_WORD) ((r << 8) | g);
+            else
+                ((CMP_DWORD*) pRow)[x] = MAKE_RGBA8888(r, g, 0, (CMP_DWORD) BYTE_MAXVAL);
+        }
+    }
+}
+
+#ifdef DXTC_DECODE_USE_SSE2
+//
+// SSE2 path
+//
+// Picks one of four palette entries for each pixel of a scanline
+static inline __m128i SelectColoursSSE2(CMP_DWORD dwRowIndices, const __m128i palette[4])
+{
+    const __m128i mask = _mm_setr_epi32(0x03, 0x0c, 0x30, 0xc0);
+    const __m128i one  = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+    const __m128i two  = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+
+    __m128i idx = _mm_and_si128(_mm_set1_epi32((int) dwRowIndices), mask);
+    __m128i c = _mm_and_si128(_mm_cmpeq_epi32(idx, _mm_setzero_si128()), palette[0]);
+    c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(idx, one), palette[1]));
+    c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(idx, two), palette[2]));
+    c = _mm_or_si128(c, _mm_and_si128(_mm_cmpeq_epi32(idx, mask), palette[3]));
+    return c;
+}
+
+// pAlpha holds the 16 alpha values already shifted into the top byte
+static void DecodeColourSSE2(const CMP_DWORD compressedBlock[2], bool bDXT1, const CMP_DWORD* pAlpha, CMP_BYTE* pDest, CMP_DWORD dwPitch, bool bSwizzle)
+{
+    CMP_DWORD dwPalette[4];
+    GetColourPalette(compressedBlock[0], bDXT1, bSwizzle, dwPalette);
+
+    __m128i palette[4];
+    for(int k = 0; k < 4; k++)
+        palette[k] = _mm_set1_epi32((int) dwPalette[k]);
+
+    const __m128i rgbMask = _mm_set1_epi32(RGB_MASK);
+    for(int y = 0; y < 4; y++)
+    {
+        __m128i c = SelectColoursSSE2(compressedBlock[1] >> (8 * y), palette);
+        if(pAlpha)
+            c = _mm_or_si128(_mm_and_si128(c, rgbMask), _mm_loadu_si128((const __m128i*) &pAlpha[y * 4]));
+        _mm_storeu_si128((__m128i*) (pDest + y * dwPitch), c);
+    }
+}
+
+static void DecodeBC1SSE2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    DecodeColourSSE2(pBlock, true, NULL, pDest, dwPitch, params.bSwizzle);
+}
+
+static void DecodeBC2SSE2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_DWORD alpha[BLOCK_SIZE_4X4];
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        alpha[i] = (CMP_DWORD) GetExplicitAlpha(pBlock, i) << RGBA8888_OFFSET_A;
+
+    DecodeColourSSE2(&pBlock[2], false, alpha, pDest, dwPitch, params.bSwizzle);
+}
+
+static void DecodeBC3SSE2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    CMP_BYTE palette[8];
+    GetAlphaPalette(pBlock, palette);
+    CMP_DWORD dwLo = GetAlphaIndicesLo(pBlock);
+    CMP_DWORD dwHi = GetAlphaIndicesHi(pBlock);
+
+    CMP_DWORD alpha[BLOCK_SIZE_4X4];
+    for(int i = 0; i < BLOCK_SIZE_4X4; i++)
+        alpha[i] = (CMP_DWORD) palette[GetAlphaIndex(dwLo, dwHi, i)] << RGBA8888_OFFSET_A;
+
+    DecodeColourSSE2(&pBlock[2], false, alpha, pDest, dwPitch, params.bSwizzle);
+}
+
+// Expands the 16 three bit indices of a BC4 style block to bytes. SSE2 has no variable shifts, so each 16 bit
+// lane takes a window of the index bits and a multiply by a power of two moves its index to the top bits
+static inline __m128i GetAlphaIndicesSSE2(const CMP_DWORD compressedBlock[2])
+{
+    const __m128i shifts = _mm_setr_epi16(1 << 13, 1 << 10, 1 << 7, 1 << 4, 1 << 1, 1 << 6, 1 << 3, 1 << 0);
+
+    // Of each 24 bit half, pixels 0-4 lie in the low 16 bits and pixels 5-7 in the high 16 bits
+    CMP_DWORD dwLo = GetAlphaIndicesLo(compressedBlock);
+    CMP_DWORD dwHi = GetAlphaIndicesHi(compressedBlock);
+    short lo0 = (short) (dwLo & 0xffff), lo1 = (short) (dwLo >> 8);
+    short hi0 = (short) (dwHi & 0xffff), hi1 = (short) (dwHi >> 8);
+
+    __m128i lo = _mm_setr_epi16(lo0, lo0, lo0, lo0, lo0, lo1, lo1, lo1);
+    __m128i hi = _mm_setr_epi16(hi0, hi0, hi0, hi0, hi0, hi1, hi1, hi1);
+    lo = _mm_srli_epi16(_mm_mullo_epi16(lo, shifts), 13);
+    hi = _mm_srli_epi16(_mm_mullo_epi16(hi, shifts), 13);
+    return _mm_packus_epi16(lo, hi);
+}
+
+// Picks one of the eight palette entries for each of the 16 pixels
+static inline __m128i SelectAlphasSSE2(__m128i idx, const CMP_BYTE palette[8])
+{
+    __m128i v = _mm_setzero_si128();
+    for(int k = 0; k < 8; k++)
+        v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi8(idx, _mm_set1_epi8((char) k)), _mm_set1_epi8((char) palette[k])));
+    return v;
+}
+
+static inline __m128i DecodeSingleChannelSSE2(const CMP_DWORD compressedBlock[2])
+{
+    CMP_BYTE palette[8];
+    GetAlphaPalette(compressedBlock, palette);
+    return SelectAlphasSSE2(GetAlphaIndicesSSE2(compressedBlock), palette);
+}
+
+static void DecodeBC4SSE2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    __m128i v = DecodeSingleChannelSSE2(pBlock);
+
+    if(params.format == DXTC_DECODE_R8)
+    {
+        for(int y = 0; y < 4; y++)
+        {
+            int row = _mm_cvtsi128_si32(v);
+            memcpy(pDest + y * dwPitch, &row, 4);
+            v = _mm_srli_si128(v, 4);
+        }
+    }
+    else
+    {
+        // The value replicated to all four bytes of each pixel
+        __m128i lo = _mm_unpacklo_epi8(v, v);
+        __m128i hi = _mm_unpackhi_epi8(v, v);
+        _mm_storeu_si128((__m128i*) pDest, _mm_unpacklo_epi16(lo, lo));
+        _mm_storeu_si128((__m128i*) (pDest + dwPitch), _mm_unpackhi_epi16(lo, lo));
+        _mm_storeu_si128((__m128i*) (pDest + 2 * dwPitch), _mm_unpacklo_epi16(hi, hi));
+        _mm_storeu_si128((__m128i*) (pDest + 3 * dwPitch), _mm_unpackhi_epi16(hi, hi));
+    }
+}
+
+static void DecodeBC5SSE2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    __m128i red   = DecodeSingleChannelSSE2(&pBlock[params.dwROffset]);
+    __m128i green = DecodeSingleChannelSSE2(&pBlock[params.dwROffset ^ 2]);
+
+    if(params.format == DXTC_DECODE_RG8)
+    {
+        // (r << 8) | g per WORD
+        __m128i rows[2] = { _mm_unpacklo_epi8(green, red), _mm_unpackhi_epi8(green, red) };
+        for(int h = 0; h < 2; h++)
+        {
+            _mm_storel_epi64((__m128i*) (pDest + 2 * h * dwPitch), rows[h]);
+            _mm_storel_epi64((__m128i*) (pDest + (2 * h + 1) * dwPitch), _mm_srli_si128(rows[h], 8));
+        }
+    }
+    else
+    {
+        const __m128i zero  = _mm_setzero_si128();
+        const __m128i alpha = _mm_set1_epi32((int) (BYTE_MASK << RGBA8888_OFFSET_A));
+        __m128i redWords[2]   = { _mm_unpacklo_epi8(red, zero),   _mm_unpackhi_epi8(red, zero) };
+        __m128i greenWords[2] = { _mm_unpacklo_epi8(green, zero), _mm_unpackhi_epi8(green, zero) };
+        for(int y = 0; y < 4; y++)
+        {
+            __m128i r = (y & 1) ? _mm_unpackhi_epi16(redWords[y >> 1], zero)   : _mm_unpacklo_epi16(redWords[y >> 1], zero);
+            __m128i g = (y & 1) ? _mm_unpackhi_epi16(greenWords[y >> 1], zero) : _mm_unpacklo_epi16(greenWords[y >> 1], zero);
+            __m128i c = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, RGBA8888_OFFSET_R), _mm_slli_epi32(g, RGBA8888_OFFSET_G)), alpha);
+            _mm_storeu_si128((__m128i*) (pDest + y * dwPitch), c);
+        }
+    }
+}
+#endif // DXTC_DECODE_USE_SSE2
+
+#ifdef DXTC_DECODE_USE_AVX2
+//
+// AVX2 path, each step expands two scanlines (8 pixels) with a single permute
+//
+static inline __m256i SelectColoursAVX2(CMP_DWORD dwIndices, __m256i palette)
+{
+    const __m256i shifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    __m256i idx = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int) dwIndices), shifts), _mm256_set1_epi32(0x3));
+    return _mm256_permutevar8x32_epi32(palette, idx);
+}
+
+static inline __m256i SelectAlphasAVX2(CMP_DWORD dwIndices, __m256i palette)
+{
+    const __m256i shifts = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    __m256i idx = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int) dwIndices), shifts), _mm256_set1_epi32(0x7));
+    return _mm256_permutevar8x32_epi32(palette, idx);
+}
+
+// Widens the 8 entry alpha palette to DWORDs, each value multiplied by dwScale
+static inline __m256i LoadAlphaPaletteAVX2(const CMP_DWORD compressedBlock[2], CMP_DWORD dwScale)
+{
+    CMP_BYTE alpha[8];
+    GetAlphaPalette(compressedBlock, alpha);
+    return _mm256_setr_epi32((int) (alpha[0] * dwScale), (int) (alpha[1] * dwScale), (int) (alpha[2] * dwScale), (int) (alpha[3] * dwScale),
+                             (int) (alpha[4] * dwScale), (int) (alpha[5] * dwScale), (int) (alpha[6] * dwScale), (int) (alpha[7] * dwScale));
+}
+
+static inline void StoreRowsAVX2(CMP_BYTE* pDest, CMP_DWORD dwPitch, __m256i c)
+{
+    _mm_storeu_si128((__m128i*) pDest, _mm256_castsi256_si128(c));
+    _mm_storeu_si128((__m128i*) (pDest + dwPitch), _mm256_extracti128_si256(c, 1));
+}
+
+static inline __m256i LoadColourPaletteAVX2(CMP_DWORD dwColours, bool bDXT1, bool bSwizzle)
+{
+    CMP_DWORD p[4];
+    GetColourPalette(dwColours, bDXT1, bSwizzle, p);
+    return _mm256_setr_epi32((int) p[0], (int) p[1], (int) p[2], (int) p[3], (int) p[0], (int) p[1], (int) p[2], (int) p[3]);
+}
+
+static void DecodeBC1AVX2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    __m256i palette = LoadColourPaletteAVX2(pBlock[0], true, params.bSwizzle);
+    StoreRowsAVX2(pDest, dwPitch, SelectColoursAVX2(pBlock[1], palette));
+    StoreRowsAVX2(pDest + 2 * dwPitch, dwPitch, SelectColoursAVX2(pBlock[1] >> 16, palette));
+    _mm256_zeroupper();
+}
+
+static void DecodeBC2AVX2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    const __m256i shifts  = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    const __m256i rgbMask = _mm256_set1_epi32(RGB_MASK);
+    __m256i palette = LoadColourPaletteAVX2(pBlock[2], false, params.bSwizzle);
+
+    for(int h = 0; h < 2; h++)
+    {
+        // 4 bit alpha replicated into the top byte
+        __m256i a = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int) pBlock[h]), shifts), _mm256_set1_epi32(0xf));
+        a = _mm256_or_si256(_mm256_slli_epi32(a, 28), _mm256_slli_epi32(a, 24));
+
+        __m256i c = SelectColoursAVX2(pBlock[3] >> (16 * h), palette);
+        StoreRowsAVX2(pDest + 2 * h * dwPitch, dwPitch, _mm256_or_si256(_mm256_and_si256(c, rgbMask), a));
+    }
+    _mm256_zeroupper();
+}
+
+static void DecodeBC3AVX2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    const __m256i rgbMask = _mm256_set1_epi32(RGB_MASK);
+    __m256i palette = LoadColourPaletteAVX2(pBlock[2], false, params.bSwizzle);
+    __m256i alphaPalette = LoadAlphaPaletteAVX2(pBlock, 1 << RGBA8888_OFFSET_A);
+    CMP_DWORD dwAlphaIndices[2] = { GetAlphaIndicesLo(pBlock), GetAlphaIndicesHi(pBlock) };
+
+    for(int h = 0; h < 2; h++)
+    {
+        __m256i a = SelectAlphasAVX2(dwAlphaIndices[h], alphaPalette);
+        __m256i c = SelectColoursAVX2(pBlock[3] >> (16 * h), palette);
+        StoreRowsAVX2(pDest + 2 * h * dwPitch, dwPitch, _mm256_or_si256(_mm256_and_si256(c, rgbMask), a));
+    }
+    _mm256_zeroupper();
+}
+
+static void DecodeBC4AVX2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    bool bR8 = (params.format == DXTC_DECODE_R8);
+    __m256i palette = LoadAlphaPaletteAVX2(pBlock, bR8 ? 0x1 : 0x01010101);
+    CMP_DWORD dwIndices[2] = { GetAlphaIndicesLo(pBlock), GetAlphaIndicesHi(pBlock) };
+
+    // Gathers the low byte of each DWORD into the bottom of each 128 bit lane
+    const __m256i packR8 = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    for(int h = 0; h < 2; h++)
+    {
+        __m256i v = SelectAlphasAVX2(dwIndices[h], palette);
+        CMP_BYTE* pRow = pDest + 2 * h * dwPitch;
+        if(bR8)
+        {
+            v = _mm256_shuffle_epi8(v, packR8);
+            int row0 = _mm_cvtsi128_si32(_mm256_castsi256_si128(v));
+            int row1 = _mm_cvtsi128_si32(_mm256_extracti128_si256(v, 1));
+            memcpy(pRow, &row0, 4);
+            memcpy(pRow + dwPitch, &row1, 4);
+        }
+        else
+            StoreRowsAVX2(pRow, dwPitch, v);
+    }
+    _mm256_zeroupper();
+}
+
+static void DecodeBC5AVX2(const CMP_DWORD* pBlock, CMP_BYTE* pDest, CMP_DWORD dwPitch, const DXTCDecodeParams& params)
+{
+    bool bRG8 = (params.format == DXTC_DECODE_RG8);
+    const CMP_DWORD* pRed   = &pBlock[params.dwROffset];
+    const CMP_DWORD* pGreen = &pBlock[params.dwROffset ^ 2];
+
+    __m256i redPalette   = LoadAlphaPaletteAVX2(pRed,   bRG8 ? 0x100 : (1 << RGBA8888_OFFSET_R));
+    __m256i greenPalette = LoadAlphaPaletteAVX2(pGreen, bRG8 ? 0x1   : (1 << RGBA8888_OFFSET_G));
+    __m256i alpha        = _mm256_set1_epi32(bRG8 ? 0 : (int) (BYTE_MASK << RGBA8888_OFFSET_A));
+    CMP_DWORD dwRedIndices[2]   = { GetAlphaIndicesLo(pRed),   GetAlphaIndicesHi(pRed) };
+    CMP_DWORD dwGreenIndices[2] = { GetAlphaIndicesLo(pGreen), GetAlphaIndicesHi(pGreen) };
+
+    for(int h = 0; h < 2; h++)
+    {
+        __m256i v = _mm256_or_si256(SelectAlphasAVX2(dwRedIndices[h], redPalette), SelectAlphasAVX2(dwGreenIndices[h], greenPalette));
+        CMP_BYTE* pRow = pDest + 2 * h * dwPitch;
+        if(bRG8)
+        {
+            // Values fit in 16 bits so the unsigned pack is exact
+            v = _mm256_packus_epi32(v, v);
+            _mm_storel_epi64((__m128i*) pRow, _mm256_castsi256_si128(v));
+            _mm_storel_epi64((__m128i*) (pRow + dwPitch), _mm256_extracti128_si256(v, 1));
+        }
+        else
+            StoreRowsAVX2(pRow, dwPitch, _mm256_or_si256(v, alpha));
+    }
+    _mm256_zeroupper();
+}
+
+static bool CPUSupportsAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7)
+        return false;
+
+    // AVX and OSXSAVE, then make sure the OS preserves the YMM state
+    __cpuid(info, 1);
+    if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+        return false;
+    if((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    // Only built when the compiler already targets AVX2
+    return true;
+#endif
+}
+#endif // DXTC_DECODE_USE_AVX2
+
+//
+// Path selection
+//
+static DXTCDecodePath DetectDecodePath()
+{
+#ifdef DXTC_DECODE_USE_AVX2
+    if(CPUSupportsAVX2())
+        return DXTC_DECODE_AVX2;
+#endif
+#ifdef DXTC_DECODE_USE_SSE2
+    return DXTC_DECODE_SSE2;
+#else
+    return DXTC_DECODE_SCALAR;
+#endif
+}
+
+// Detected once, the initialization of a function local static is thread safe
+static DXTCDecodePath GetBestDecodePath()
+{
+    static const DXTCDecodePath best = DetectDecodePath();
+    return best;
+}
+
+// -1 until DXTCSetDecodePath overrides the detected path
+static std::atomic<int> g_nDecodePathOverride(-1);
+
+DXTCDecodePath DXTCGetDecodePath()
+{
+    int nOverride = g_nDecodePathOverride.load(std::memory_order_relaxed);
+    return (nOverride < 0) ? GetBestDecodePath() : (DXTCDecodePath) nOverride;
+}
+
+void DXTCSetDecodePath(DXTCDecodePath path)
+{
+    DXTCDecodePath best = GetBestDecodePath();
+    g_nDecodePathOverride.store((path > best) ? best : path, std::memory_order_relaxed);
+}
+
+// Falls back to the next path down when a format has no kernel for the selected one
+static DXTCDecodeBlockProc SelectDecoder(DXTCDecodeBlockProc pScalar, DXTCDecodeBlockProc pSSE2, DXTCDecodeBlockProc pAVX2)
+{
+    DXTCDecodePath path = DXTCGetDecodePath();
+    if(path >= DXTC_DECODE_AVX2 && pAVX2)
+        return pAVX2;
+    if(path >= DXTC_DECODE_SSE2 && pSSE2)
+        return pSSE2;
+    return pScalar;
+}
+
+static void DecodeRow(DXTCDecodeBlockProc pDecodeBlock, const CMP_BYTE* pSrc, CMP_DWORD dwBlockSize, CMP_DWORD dwPixelSize,
+                      CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight,
+                      const DXTCDecodeParams& params)
+{
+    assert(pDecodeBlock);
+    assert(pSrc);
+    assert(pDest);
+
+    CMP_DWORD dwRows = (dwHeight < 4) ? dwHeight : 4;
+
+    for(CMP_DWORD i = 0; i < dwBlocks && (i * 4) < dwWidth; i++)
+    {
+        const CMP_DWORD* pBlock = (const CMP_DWORD*) (pSrc + (i * dwBlockSize * sizeof(CMP_DWORD)));
+        CMP_BYTE* pBlockDest = pDest + (i * 4 * dwPixelSize);
+        CMP_DWORD dwColumns = dwWidth - (i * 4);
+        if(dwColumns > 4)
+            dwColumns = 4;
+
+        if(dwColumns == 4 && dwRows == 4)
+        {
+            pDecodeBlock(pBlock, pBlockDest, dwPitch, params);
+        }
+        else
+        {
+            // Edge block, decode aside and copy the part that fits
+            CMP_DWORD block[BLOCK_SIZE_4X4];
+            pDecodeBlock(pBlock, (CMP_BYTE*) block, 4 * dwPixelSize, params);
+            for(CMP_DWORD y = 0; y < dwRows; y++)
+                memcpy(pBlockDest + (y * dwPitch), ((CMP_BYTE*) block) + (y * 4 * dwPixelSize), dwColumns * dwPixelSize);
+        }
+    }
+}
+
+void DXTCDecodeRowBC1(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle)
+{
+    DXTCDecodeParams params = { bSwizzle, 0, DXTC_DECODE_RGBA8888 };
+    DecodeRow(SelectDecoder(DecodeBC1Scalar, DXTC_SSE2_PROC(DecodeBC1SSE2), DXTC_AVX2_PROC(DecodeBC1AVX2)),
+              pSrc, DXTC_BC1_BLOCK_DWORDS, sizeof(CMP_DWORD), dwBlocks, pDest, dwPitch, dwWidth, dwHeight, params);
+}
+
+void DXTCDecodeRowBC2(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle)
+{
+    DXTCDecodeParams params = { bSwizzle, 0, DXTC_DECODE_RGBA8888 };
+    DecodeRow(SelectDecoder(DecodeBC2Scalar, DXTC_SSE2_PROC(DecodeBC2SSE2), DXTC_AVX2_PROC(DecodeBC2AVX2)),
+              pSrc, DXTC_BC3_BLOCK_DWORDS, sizeof(CMP_DWORD), dwBlocks, pDest, dwPitch, dwWidth, dwHeight, params);
+}
+
+void DXTCDecodeRowBC3(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, bool bSwizzle)
+{
+    DXTCDecodeParams params = { bSwizzle, 0, DXTC_DECODE_RGBA8888 };
+    DecodeRow(SelectDecoder(DecodeBC3Scalar, DXTC_SSE2_PROC(DecodeBC3SSE2), DXTC_AVX2_PROC(DecodeBC3AVX2)),
+              pSrc, DXTC_BC3_BLOCK_DWORDS, sizeof(CMP_DWORD), dwBlocks, pDest, dwPitch, dwWidth, dwHeight, params);
+}
+
+void DXTCDecodeRowBC4(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, DXTCDecodeFormat format)
+{
+    assert(format == DXTC_DECODE_R8 || format == DXTC_DECODE_RGBA8888);
+
+    DXTCDecodeParams params = { false, 0, format };
+    DecodeRow(SelectDecoder(DecodeBC4Scalar, DXTC_SSE2_PROC(DecodeBC4SSE2), DXTC_AVX2_PROC(DecodeBC4AVX2)),
+              pSrc, DXTC_BC1_BLOCK_DWORDS, (format == DXTC_DECODE_R8) ? 1 : sizeof(CMP_DWORD),
+              dwBlocks, pDest, dwPitch, dwWidth, dwHeight, params);
+}
+
+void DXTCDecodeRowBC5(const CMP_BYTE* pSrc, CMP_DWORD dwBlocks, CMP_BYTE* pDest, CMP_DWORD dwPitch, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwROffset, DXTCDecodeFormat format)
+{
+    assert(format == DXTC_DECODE_RG8 || format == DXTC_DECODE_RGBA8888);
+    assert(dwROffset == 0 || dwROffset == 2);
+
+    DXTCDecodeParams params = { false, dwROffset, format };
+    DecodeRow(SelectDecoder(DecodeBC5Scalar, DXTC_SSE2_PROC(DecodeBC5SSE2), DXTC_AVX2_PROC(DecodeBC5AVX2)),
+              pSrc, DXTC_BC3_BLOCK_DWORDS, (format == DXTC_DECODE_RG8) ? sizeof(CMP_WORD) : sizeof(CMP_DWORD),
+              dwBlocks, pDest, dwPitch, dwWidth, dwHeight, params);
+}
@@ -32,6 +32,8 @@
 #include "Compressonator_tc.h"
 #include "etcpack.h"
 #include "CompressonatorXCodec.h"
+#include "process.h"
+#include "CMP_Trace.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -40,12 +42,52 @@
 CCodec_ETC2::CCodec_ETC2(CodecType codecType) :
 CCodec_Block_4x4(codecType)
 {
+    m_fQuality   = AMD_CODEC_QUALITY_DEFAULT;
+    m_NumThreads = 8;
 }
 
 CCodec_ETC2::~CCodec_ETC2()
 {
 }
 
+bool CCodec_ETC2::SetParameter(const CMP_CHAR* pszParamName, CMP_CHAR* sValue)
+{
+    if (sValue == NULL) return false;
+
+    if(strcmp(pszParamName, "NumThreads") == 0)
+        m_NumThreads = (CMP_DWORD) std::stoi(sValue);
+    else
+    if(strcmp(pszParamName, "Quality") == 0)
+    {
+        m_fQuality = std::stof(sValue);
+        if ((m_fQuality < 0) || (m_fQuality > 1.0))
+        {
+            return false;
+        }
+    }
+    else
+        return CCodec_Block_4x4::SetParameter(pszParamName, sValue);
+    return true;
+}
+
+bool CCodec_ETC2::SetParameter(const CMP_CHAR* pszParamName, CMP_DWORD dwValue)
+{
+    if(strcmp(pszParamName, "NumThreads") == 0)
+        m_NumThreads = dwValue;
+    else
+        return CCodec_Block_4x4::SetParameter(pszParamName, dwValue);
+    return true;
+}
+
+bool CCodec_ETC2::SetParameter(const CMP_CHAR* pszParamName, CODECFLOAT fValue)
+{
+    if(strcmp(pszParamName, "Quality") == 0)
+        m_fQuality = fValue;
+    else
+        return CCodec_Block_4x4::SetParameter(pszParamName, fValue);
+    return true;
+}
+
 #define SWIZZLE_DWORD(i) ((((i >> 24) & BYTE_MASK)) | (((i >> 16) & BYTE_MASK) << 8) | (((i >> 8) & BYTE_MASK) << 16) | ((i & BYTE_MASK) << 24))
 
 
@@ -99,7 +141,8 @@ CodecError CCodec_ETC2::CompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CM
     }
 
     unsigned int uiCompressedBlockHi, uiCompressedBlockLo;
-    atiEncodeRGBBlockETC2((unsigned char *)&srcRGB, &uiCompressedBlockHi, &uiCompressedBlockLo);
+    // etcpack keeps no per call state, so blocks can be encoded from several threads at once
+    atiEncodeRGBBlockETC2((unsigned char *)&srcRGB, &uiCompressedBlockHi, &uiCompressedBlockLo, m_fQuality < ETC_QUALITY_EXHAUSTIVE);
 
     compressedBlock[0] = SWIZZLE_DWORD(uiCompressedBlockHi);
     compressedBlock[1] = SWIZZLE_DWORD(uiCompressedBlockLo);
@@ -128,3 +171,142 @@ void CCodec_ETC2::DecompressRGBBlock(CMP_BYTE rgbBlock[BLOCK_SIZE_4X4X4], CMP_DW
         }
     }
 }
+
+struct CCodec_ETC2::EncodeThreadParam
+{
+    CCodec_ETC2        *codec;
+    CCodecBuffer       *bufferIn;
+    CCodecBuffer       *bufferOut;
+    CMP_DWORD           dwBlocksX;
+    CMP_DWORD           dwBlocksY;
+
+    volatile LONG      *nextRow;           // shared by all threads, the next block row to encode
+    volatile LONG      *rowsDone;          // shared by all threads, used for progress
+    volatile BOOL      *abort;             // shared by all threads, set on cancel
+};
+
+//
+// Encodes block rows until none are left. Rows are handed out one at a time because
+// the exhaustive search time varies a lot between blocks, fixed bands would leave threads idle.
+//
+void CCodec_ETC2::CompressRows(EncodeThreadParam *tp)
+{
+    for(;;)
+    {
+        if (*tp->abort) return;
+
+        CMP_DWORD j = (CMP_DWORD)(InterlockedIncrement(tp->nextRow) - 1);
+        if (j >= tp->dwBlocksY) return;
+
+        for(CMP_DWORD i = 0; i < tp->dwBlocksX; i++)
+            CompressBlock(*tp->bufferIn, *tp->bufferOut, i, j);
+
+        InterlockedIncrement(tp->rowsDone);
+    }
+}
+
+unsigned int _stdcall CCodec_ETC2::ThreadProcEncode(void* param)
+{
+    EncodeThreadParam *tp = (EncodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("ETC2 Worker");
+    CMP_TRACE_SCOPE("Compress", "ETC2 Rows");
+    tp->codec->CompressRows(tp);
+    return 0;
+}
+
+//
+// Encodes all block rows through CompressBlock. Rows are spread over m_NumThreads threads
+// when bThreadSafeRead is set, that is when CompressBlock can read the source from several threads.
+//
+CodecError CCodec_ETC2::CompressBlockRows(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, bool bThreadSafeRead, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + 3) >> 2);
+    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
+
+    volatile LONG nextRow  = 0;
+    volatile LONG rowsDone = 0;
+    volatile BOOL abort    = FALSE;
+
+    EncodeThreadParam param;
+    param.codec     = this;
+    param.bufferIn  = &bufferIn;
+    param.bufferOut = &bufferOut;
+    param.dwBlocksX = dwBlocksX;
+    param.dwBlocksY = dwBlocksY;
+    param.nextRow   = &nextRow;
+    param.rowsDone  = &rowsDone;
+    param.abort     = &abort;
+
+    // WaitForMultipleObjects takes at most MAXIMUM_WAIT_OBJECTS handles
+    DWORD numThreads = min(m_NumThreads, MAX_ETC_THREADS);
+    if (numThreads > MAXIMUM_WAIT_OBJECTS) numThreads = MAXIMUM_WAIT_OBJECTS;
+    if (numThreads > dwBlocksY) numThreads = dwBlocksY;
+    if (numThreads == 0 || !bThreadSafeRead) numThreads = 1;
+
+    if (numThreads == 1)
+    {
+        // Single thread, encode a row at a time so progress can be reported in between
+        for(CMP_DWORD j = 0; j < dwBlocksY; j++)
+        {
+            nextRow         = j;
+            param.dwBlocksY = j + 1;
+            CompressRows(&param);
+
+            if(pFeedbackProc)
+            {
+                float fProgress = 100.f * (j * dwBlocksX) / (dwBlocksX * dwBlocksY);
+                if(pFeedbackProc(fProgress, pUser1, pUser2))
+                    return CE_Aborted;
+            }
+        }
+        return CE_OK;
+    }
+
+    HANDLE hThread[MAX_ETC_THREADS];
+    DWORD  liveThreads = 0;
+
+    for (DWORD i = 0; i < numThreads; i++)
+    {
+        hThread[liveThreads] = (HANDLE)_beginthreadex(NULL, 0, ThreadProcEncode, (void*)&param, 0, NULL);
+        if (hThread[liveThreads])
+            liveThreads++;
+    }
+
+    // Report progress while the threads run, the callers feedback proc can cancel the encode
+    bool waitFailed = false;
+    while (liveThreads > 0)
+    {
+        DWORD dwWait = WaitForMultipleObjects(liveThreads, hThread, true, 100);
+        if (dwWait != WAIT_TIMEOUT)
+        {
+            waitFailed = (dwWait == WAIT_FAILED);
+            break;
+        }
+
+        if (pFeedbackProc && !abort)
+        {
+            float fProgress = 100.f * rowsDone / dwBlocksY;
+            if (pFeedbackProc(fProgress, pUser1, pUser2))
+                abort = TRUE;
+        }
+    }
+
+    // The threads use param and the counters on this stack, they must all have exited before returning
+    if (waitFailed)
+    {
+        abort = TRUE;
+        for (DWORD i = 0; i < liveThreads; i++)
+            WaitForSingleObject(hThread[i], INFINITE);
+    }
+
+    for (DWORD i = 0; i < liveThreads; i++)
+        CloseHandle(hThread[i]);
+
+    if (waitFailed)
+        return CE_Unknown;
+
+    // Rows not taken by a thread, all of them if none could be started, are encoded here
+    CompressRows(&param);
+
+    return abort ? CE_Aborted : CE_OK;
+}
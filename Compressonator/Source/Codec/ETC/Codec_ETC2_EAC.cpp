@@ -0,0 +1,181 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   Codec_ETC2_EAC.cpp
+//  Description: implementation of the CCodec_ETC2_EAC class
+//
+//////////////////////////////////////////////////////////////////////////////
+#pragma warning(disable:4100)
+
+#include "Common.h"
+#include "Codec_ETC2_EAC.h"
+#include "Compressonator_tc.h"
+#include "etc2_eac.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////////////
+
+CCodec_ETC2_EAC::CCodec_ETC2_EAC(CodecType codecType) :
+CCodec_ETC2(codecType)
+{
+    m_bSigned     = (codecType == CT_EAC_R11_SIGNED) || (codecType == CT_EAC_RG11_SIGNED);
+    m_nChannels   = ((codecType == CT_EAC_RG11) || (codecType == CT_EAC_RG11_SIGNED)) ? 2 : 1;
+    m_bByteSource = false;
+}
+
+CCodec_ETC2_EAC::~CCodec_ETC2_EAC()
+{
+
+}
+
+CCodecBuffer* CCodec_ETC2_EAC::CreateBuffer(
+    CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, CMP_BYTE nBlockDepth,
+    CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwPitch, CMP_BYTE* pData) const
+{
+    return CreateCodecBuffer((m_nChannels == 2) ? CBT_4x4Block_8BPP : CBT_4x4Block_4BPP, 4,4,1,dwWidth, dwHeight, dwPitch, pData);
+}
+
+void CCodec_ETC2_EAC::CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j)
+{
+    CMP_WORD  channelBlock[2][BLOCK_SIZE_4X4];
+    CMP_DWORD compressedBlock[4];
+
+    if(m_bByteSource)
+    {
+        // The RGBA8888 channel reads go straight to the buffer and are safe on the encode threads
+        CMP_BYTE cBlock[BLOCK_SIZE_4X4];
+        for(int c = 0; c < m_nChannels; c++)
+        {
+            if(c == 0)
+                bufferIn.ReadBlockR(i*4, j*4, 4, 4, cBlock);
+            else
+                bufferIn.ReadBlockG(i*4, j*4, 4, 4, cBlock);
+            for(int k = 0; k < BLOCK_SIZE_4X4; k++)
+                channelBlock[c][k] = CONVERT_BYTE_TO_WORD(cBlock[k]);
+        }
+    }
+    else
+    {
+        bufferIn.ReadBlockR(i*4, j*4, 4, 4, channelBlock[0]);
+        if(m_nChannels == 2)
+            bufferIn.ReadBlockG(i*4, j*4, 4, 4, channelBlock[1]);
+    }
+
+    // RG11 stores the red block followed by the green block
+    bool bFast = m_fQuality < ETC_QUALITY_EAC_THOROUGH;
+    for(int c = 0; c < m_nChannels; c++)
+        atiEncodeEAC11Block(channelBlock[c], m_bSigned, (CMP_BYTE*)&compressedBlock[c*2], bFast);
+
+    bufferOut.WriteBlock(i*4, j*4, compressedBlock, m_nChannels * 2);
+}
+
+// notes:
+// block rows are encoded by m_NumThreads threads when the source is an RGBA8888 buffer,
+// other buffer types convert through shared scratch space and are encoded on this thread.
+// The signed formats map the unsigned source range to -1.0 .. 1.0
+//
+CodecError CCodec_ETC2_EAC::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    assert(bufferIn.GetWidth() == bufferOut.GetWidth());
+    assert(bufferIn.GetHeight() == bufferOut.GetHeight());
+
+    if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
+        return CE_Unknown;
+
+    m_bByteSource = (bufferIn.GetBufferType() == CBT_RGBA8888);
+
+    return CompressBlockRows(bufferIn, bufferOut, m_bByteSource, pFeedbackProc, pUser1, pUser2);
+}
+
+CodecError CCodec_ETC2_EAC::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    assert(bufferIn.GetWidth() == bufferOut.GetWidth());
+    assert(bufferIn.GetHeight() == bufferOut.GetHeight());
+
+    if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
+        return CE_Unknown;
+
+    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + 3) >> 2);
+    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
+    const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
+
+    bool bUseFixed = (!bufferOut.IsFloat() && bufferOut.GetChannelDepth() == 8);
+
+    // As for ATI1N and ATI2N, R11 is replicated to RGB and RG11 has a zero blue channel
+    CMP_WORD channelBlock[2][BLOCK_SIZE_4X4];
+    CMP_WORD zeroBlock[BLOCK_SIZE_4X4];
+    CMP_WORD opaqueBlock[BLOCK_SIZE_4X4];
+    memset(zeroBlock, 0, sizeof(zeroBlock));
+    for(int k = 0; k < BLOCK_SIZE_4X4; k++)
+        opaqueBlock[k] = 0xFFFF;
+
+    CMP_DWORD compressedBlock[4];
+    for(CMP_DWORD j = 0; j < dwBlocksY; j++)
+    {
+        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+        {
+            bufferIn.ReadBlock(i*4, j*4, compressedBlock, m_nChannels * 2);
+            for(int c = 0; c < m_nChannels; c++)
+                atiDecodeEAC11Block(channelBlock[c], m_bSigned, (CMP_BYTE*)&compressedBlock[c*2]);
+
+            CMP_WORD *pR = channelBlock[0];
+            CMP_WORD *pG = (m_nChannels == 2) ? channelBlock[1] : channelBlock[0];
+            CMP_WORD *pB = (m_nChannels == 2) ? zeroBlock       : channelBlock[0];
+
+            if(bUseFixed)
+            {
+                CMP_BYTE cBlock[4][BLOCK_SIZE_4X4];
+                for(int k = 0; k < BLOCK_SIZE_4X4; k++)
+                {
+                    cBlock[0][k] = CONVERT_WORD_TO_BYTE(pR[k]);
+                    cBlock[1][k] = CONVERT_WORD_TO_BYTE(pG[k]);
+                    cBlock[2][k] = CONVERT_WORD_TO_BYTE(pB[k]);
+                    cBlock[3][k] = 0xFF;
+                }
+                bufferOut.WriteBlockR(i*4, j*4, 4, 4, cBlock[0]);
+                bufferOut.WriteBlockG(i*4, j*4, 4, 4, cBlock[1]);
+                bufferOut.WriteBlockB(i*4, j*4, 4, 4, cBlock[2]);
+                bufferOut.WriteBlockA(i*4, j*4, 4, 4, cBlock[3]);
+            }
+            else
+            {
+                bufferOut.WriteBlockR(i*4, j*4, 4, 4, pR);
+                bufferOut.WriteBlockG(i*4, j*4, 4, 4, pG);
+                bufferOut.WriteBlockB(i*4, j*4, 4, 4, pB);
+                bufferOut.WriteBlockA(i*4, j*4, 4, 4, opaqueBlock);
+            }
+        }
+
+        if (pFeedbackProc)
+        {
+            float fProgress = 100.f * (j * dwBlocksX) / dwBlocksXY;
+            if (pFeedbackProc(fProgress, pUser1, pUser2))
+            {
+                return CE_Aborted;
+            }
+        }
+    }
+
+    return CE_OK;
+}
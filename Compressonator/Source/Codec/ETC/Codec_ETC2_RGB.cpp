@@ -55,6 +55,20 @@ CCodecBuffer* CCodec_ETC2_RGB::CreateBuffer(
     return CreateCodecBuffer(CBT_4x4Block_4BPP, 4,4,1,dwWidth, dwHeight, dwPitch, pData);
 }
 
+void CCodec_ETC2_RGB::CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j)
+{
+    CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
+    CMP_DWORD compressedBlock[2];
+
+    bufferIn.ReadBlockRGBA(i*4, j*4, 4, 4, srcBlock);
+    CompressRGBBlock(srcBlock, compressedBlock);
+    bufferOut.WriteBlock(i*4, j*4, compressedBlock, 2);
+}
+
+// notes:
+// block rows are encoded by m_NumThreads threads when the source is an RGBA8888 buffer,
+// other buffer types convert through shared scratch space in ReadBlockRGBA and are encoded on this thread
+//
 CodecError CCodec_ETC2_RGB::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
 {
     assert(bufferIn.GetWidth() == bufferOut.GetWidth());
@@ -63,30 +77,7 @@ CodecError CCodec_ETC2_RGB::Compress(CCodecBuffer& bufferIn, CCodecBuffer& buffe
     if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
         return CE_Unknown;
 
-    readCompressParams();
-
-    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + 3) >> 2);
-    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
-
-    CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
-    CMP_DWORD compressedBlock[2];
-    for(CMP_DWORD j = 0; j < dwBlocksY; j++)
-    {
-        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
-        {
-            bufferIn.ReadBlockRGBA(i*4, j*4, 4, 4, srcBlock);
-            CompressRGBBlock(srcBlock, compressedBlock);
-            bufferOut.WriteBlock(i*4, j*4, compressedBlock, 2);
-        }
-        if(pFeedbackProc)
-        {
-            float fProgress = 100.f * (j * dwBlocksX) / (dwBlocksX * dwBlocksY);
-            if(pFeedbackProc(fProgress, pUser1, pUser2))
-                return CE_Aborted;
-        }
-    }
-
-    return CE_OK;
+    return CompressBlockRows(bufferIn, bufferOut, bufferIn.GetBufferType() == CBT_RGBA8888, pFeedbackProc, pUser1, pUser2);
 }
 
 CodecError CCodec_ETC2_RGB::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
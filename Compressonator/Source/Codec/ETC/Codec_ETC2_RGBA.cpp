@@ -0,0 +1,127 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   Codec_ETC2_RGBA.cpp
+//  Description: implementation of the CCodec_ETC2_RGBA class
+//
+//////////////////////////////////////////////////////////////////////////////
+#pragma warning(disable:4100)
+
+#include "Common.h"
+#include "Codec_ETC2_RGBA.h"
+#include "Compressonator_tc.h"
+#include "etc2_eac.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Construction/Destruction
+//////////////////////////////////////////////////////////////////////////////
+
+CCodec_ETC2_RGBA::CCodec_ETC2_RGBA() :
+CCodec_ETC2(CT_ETC2_RGBA)
+{
+
+}
+
+CCodec_ETC2_RGBA::~CCodec_ETC2_RGBA()
+{
+
+}
+
+CCodecBuffer* CCodec_ETC2_RGBA::CreateBuffer(
+    CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, CMP_BYTE nBlockDepth,
+    CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwPitch, CMP_BYTE* pData) const
+{
+    return CreateCodecBuffer(CBT_4x4Block_8BPP, 4,4,1,dwWidth, dwHeight, dwPitch, pData);
+}
+
+void CCodec_ETC2_RGBA::CompressBlock(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, CMP_DWORD i, CMP_DWORD j)
+{
+    CMP_BYTE srcBlock[BLOCK_SIZE_4X4X4];
+    CMP_BYTE alphaBlock[BLOCK_SIZE_4X4];
+    CMP_DWORD compressedBlock[4];
+
+    bufferIn.ReadBlockRGBA(i*4, j*4, 4, 4, srcBlock);
+    for(int k = 0; k < BLOCK_SIZE_4X4; k++)
+        alphaBlock[k] = srcBlock[(k * 4) + RGBA8888_CHANNEL_A];
+
+    // The EAC alpha block comes first, both halves are stored as big endian bit streams
+    atiEncodeEACAlphaBlock(alphaBlock, (CMP_BYTE*)&compressedBlock[0], m_fQuality < ETC_QUALITY_EAC_THOROUGH);
+    CompressRGBBlock(srcBlock, &compressedBlock[2]);
+    bufferOut.WriteBlock(i*4, j*4, compressedBlock, 4);
+}
+
+// notes:
+// block rows are encoded by m_NumThreads threads when the source is an RGBA8888 buffer,
+// other buffer types convert through shared scratch space in ReadBlockRGBA and are encoded on this thread
+//
+CodecError CCodec_ETC2_RGBA::Compress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    assert(bufferIn.GetWidth() == bufferOut.GetWidth());
+    assert(bufferIn.GetHeight() == bufferOut.GetHeight());
+
+    if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
+        return CE_Unknown;
+
+    return CompressBlockRows(bufferIn, bufferOut, bufferIn.GetBufferType() == CBT_RGBA8888, pFeedbackProc, pUser1, pUser2);
+}
+
+CodecError CCodec_ETC2_RGBA::Decompress(CCodecBuffer& bufferIn, CCodecBuffer& bufferOut, Codec_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    assert(bufferIn.GetWidth() == bufferOut.GetWidth());
+    assert(bufferIn.GetHeight() == bufferOut.GetHeight());
+
+    if(bufferIn.GetWidth() != bufferOut.GetWidth() || bufferIn.GetHeight() != bufferOut.GetHeight())
+        return CE_Unknown;
+
+    const CMP_DWORD dwBlocksX = ((bufferIn.GetWidth() + 3) >> 2);
+    const CMP_DWORD dwBlocksY = ((bufferIn.GetHeight() + 3) >> 2);
+    const CMP_DWORD dwBlocksXY = dwBlocksX*dwBlocksY;
+
+    CMP_DWORD compressedBlock[4];
+    CMP_BYTE destBlock[BLOCK_SIZE_4X4X4];
+    CMP_BYTE alphaBlock[BLOCK_SIZE_4X4];
+    for(CMP_DWORD j = 0; j < dwBlocksY; j++)
+    {
+        for(CMP_DWORD i = 0; i < dwBlocksX; i++)
+        {
+            bufferIn.ReadBlock(i*4, j*4, compressedBlock, 4);
+            memset(destBlock, 0xFF, BLOCK_SIZE_4X4X4);
+            DecompressRGBBlock(destBlock, &compressedBlock[2]);
+            atiDecodeEACAlphaBlock(alphaBlock, (CMP_BYTE*)&compressedBlock[0]);
+            for(int k = 0; k < BLOCK_SIZE_4X4; k++)
+                destBlock[(k * 4) + RGBA8888_CHANNEL_A] = alphaBlock[k];
+            bufferOut.WriteBlockRGBA(i*4, j*4, 4, 4, destBlock);
+        }
+
+        if (pFeedbackProc)
+        {
+            float fProgress = 100.f * (j * dwBlocksX) / dwBlocksXY;
+            if (pFeedbackProc(fProgress, pUser1, pUser2))
+            {
+                return CE_Aborted;
+            }
+        }
+    }
+
+    return CE_OK;
+}
@@ -0,0 +1,319 @@
+//===============================================================================
+// Copyright (c) 2007-2016  Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (c) 2004-2006 ATI Technologies Inc.
+//===============================================================================
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+//  File Name:   etc2_eac.cpp
+//  Description: EAC block encoder and decoder used by the ETC2 RGBA8, R11 and RG11 codecs
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Common.h"
+#include "etc2_eac.h"
+#include <math.h>
+
+// Modifier tables from the ETC2 specification, the first four entries are the negative
+// modifiers and the last four the positive ones
+static const int EACModifierTable[16][8] =
+{
+    { -3,  -6,  -9, -15,  2,  5,  8, 14 },
+    { -3,  -7, -10, -13,  2,  6,  9, 12 },
+    { -2,  -5,  -8, -13,  1,  4,  7, 12 },
+    { -2,  -4,  -6, -13,  1,  3,  5, 12 },
+    { -3,  -6,  -8, -12,  2,  5,  7, 11 },
+    { -3,  -7,  -9, -11,  2,  6,  8, 10 },
+    { -4,  -7,  -8, -11,  3,  6,  7, 10 },
+    { -3,  -5,  -8, -11,  2,  4,  7, 10 },
+    { -2,  -6,  -8, -10,  1,  5,  7,  9 },
+    { -2,  -5,  -8, -10,  1,  4,  7,  9 },
+    { -2,  -4,  -8, -10,  1,  3,  7,  9 },
+    { -2,  -5,  -7, -10,  1,  4,  6,  9 },
+    { -3,  -4,  -7, -10,  2,  3,  6,  9 },
+    { -1,  -2,  -3, -10,  0,  1,  2,  9 },
+    { -4,  -6,  -8,  -9,  3,  5,  7,  8 },
+    { -3,  -5,  -7,  -9,  2,  4,  6,  8 }
+};
+
+typedef enum
+{
+    EAC_ALPHA8,         // 8 bit values, ETC2 RGBA8 alpha
+    EAC_UNSIGNED11,     // 11 bit values, R11 and RG11, returned as 16 bit
+    EAC_SIGNED11,       // 11 bit signed values, returned as 16 bit with 32768 as 0.0
+} EACFormat;
+
+// Range of the stored parameters for each format, multiplier 0 is not valid for ETC2 RGBA8 alpha
+static void EACParameterRange(EACFormat format, int &baseMin, int &baseMax, int &mulMin)
+{
+    baseMin = (format == EAC_SIGNED11) ? -127 : 0;
+    baseMax = (format == EAC_SIGNED11) ?  127 : 255;
+    mulMin  = (format == EAC_ALPHA8)   ?    1 : 0;
+}
+
+// Decoded value of one palette entry, matches get16bits11bits and get16bits11signed in etcpack
+static inline int EACValue(EACFormat format, int base, int mul, int modifier)
+{
+    if (format == EAC_ALPHA8)
+    {
+        int value = base + modifier*mul;
+        return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+    }
+
+    int elevenMod = mul ? modifier*mul*8 : modifier;
+    if (format == EAC_UNSIGNED11)
+    {
+        int value = base*8 + 4 + elevenMod;
+        value = (value < 0) ? 0 : ((value > 2047) ? 2047 : value);
+        return (value << 5) | (value >> 6);
+    }
+
+    int value = base*8 + elevenMod;
+    value = (value < -1023) ? -1023 : ((value > 1023) ? 1023 : value);
+    int magnitude = (value < 0) ? -value : value;
+    magnitude = (magnitude << 5) | (magnitude >> 5);
+    return ((value < 0) ? -magnitude : magnitude) + 32768;
+}
+
+static inline void EACPalette(EACFormat format, int base, int table, int mul, int palette[8])
+{
+    for (int i = 0; i < 8; i++)
+        palette[i] = EACValue(format, base, mul, EACModifierTable[table][i]);
+}
+
+// Sum of the squared distances from each pixel to its closest palette entry,
+// stops counting once the sum reaches best
+static long long EACBlockError(const int target[16], const int palette[8], long long best)
+{
+    long long error = 0;
+    for (int p = 0; p < 16; p++)
+    {
+        long long bestPixel = -1;
+        for (int i = 0; i < 8; i++)
+        {
+            long long d = target[p] - palette[i];
+            d *= d;
+            if (bestPixel < 0 || d < bestPixel)
+                bestPixel = d;
+        }
+        error += bestPixel;
+        if (error >= best)
+            return error;
+    }
+    return error;
+}
+
+// The base value that centres the table range on [minValue, maxValue] for this multiplier.
+// minValue and maxValue are in the 8 or 11 bit domain of the format.
+static int EACFitBase(EACFormat format, int table, int mul, double minValue, double maxValue)
+{
+    double step   = (format == EAC_ALPHA8) ? mul : (mul ? mul*8.0 : 1.0);
+    double centre = (minValue + maxValue) * 0.5 - (EACModifierTable[table][3] + EACModifierTable[table][7]) * 0.5 * step;
+
+    if (format == EAC_ALPHA8)
+        return (int)floor(centre + 0.5);
+    if (format == EAC_UNSIGNED11)
+        return (int)floor((centre - 4.0) / 8.0 + 0.5);
+    return (int)floor(centre / 8.0 + 0.5);
+}
+
+static void EACTryCandidate(EACFormat format, const int target[16], int base, int table, int mul,
+                            long long &bestError, int &bestBase, int &bestTable, int &bestMul)
+{
+    int palette[8];
+    EACPalette(format, base, table, mul, palette);
+    long long error = EACBlockError(target, palette, bestError);
+    if (error < bestError)
+    {
+        bestError = error;
+        bestBase  = base;
+        bestTable = table;
+        bestMul   = mul;
+    }
+}
+
+//
+// Finds the base, table and multiplier for a block and packs it with the closest index per pixel.
+//
+// The fast search fits each table to the block minimum and maximum, which gives a multiplier
+// estimate and a base that centres the table on the block. Only the two multipliers around the
+// estimate and the bases next to the fit are tried. The thorough search tries every multiplier
+// of every table with a wider base window around the fit.
+//
+static void EACEncodeBlock(EACFormat format, const int target[16], CMP_BYTE compressed[8], bool fast)
+{
+    int baseMin, baseMax, mulMin;
+    EACParameterRange(format, baseMin, baseMax, mulMin);
+
+    // Block range in the 8 or 11 bit domain the parameters are expressed in
+    double minValue = target[0], maxValue = target[0];
+    for (int p = 1; p < 16; p++)
+    {
+        if (target[p] < minValue) minValue = target[p];
+        if (target[p] > maxValue) maxValue = target[p];
+    }
+    if (format == EAC_UNSIGNED11)
+    {
+        minValue = minValue * 2047.0 / 65535.0;
+        maxValue = maxValue * 2047.0 / 65535.0;
+    }
+    else if (format == EAC_SIGNED11)
+    {
+        minValue = (minValue - 32768.0) * 1023.0 / 32767.0;
+        maxValue = (maxValue - 32768.0) * 1023.0 / 32767.0;
+    }
+
+    long long bestError = ((long long)1) << 62;
+    int bestBase  = 0;
+    int bestTable = 0;
+    int bestMul   = mulMin;
+
+    const int baseWindow = fast ? 1 : 4;
+
+    for (int table = 0; table < 16 && bestError > 0; table++)
+    {
+        int mulFirst, mulLast;
+        if (fast)
+        {
+            double span = (EACModifierTable[table][7] - EACModifierTable[table][3]) * ((format == EAC_ALPHA8) ? 1.0 : 8.0);
+            int mul  = (int)floor((maxValue - minValue) / span);
+            mulFirst = mul;
+            mulLast  = mul + 1;
+        }
+        else
+        {
+            mulFirst = mulMin;
+            mulLast  = 15;
+        }
+        if (mulFirst < mulMin) mulFirst = mulMin;
+        if (mulLast  > 15)     mulLast  = 15;
+        if (mulFirst > mulLast) mulFirst = mulLast;
+
+        for (int mul = mulFirst; mul <= mulLast; mul++)
+        {
+            int fit = EACFitBase(format, table, mul, minValue, maxValue);
+            for (int base = fit - baseWindow; base <= fit + baseWindow; base++)
+            {
+                if (base < baseMin || base > baseMax)
+                    continue;
+                EACTryCandidate(format, target, base, table, mul, bestError, bestBase, bestTable, bestMul);
+            }
+        }
+    }
+
+    // The fit can be off by more than the window for blocks with outliers, refine the base of the winner
+    for (int base = bestBase - 8; base <= bestBase + 8; base++)
+    {
+        if (base < baseMin || base > baseMax || base == bestBase)
+            continue;
+        EACTryCandidate(format, target, base, bestTable, bestMul, bestError, bestBase, bestTable, bestMul);
+    }
+
+    int palette[8];
+    EACPalette(format, bestBase, bestTable, bestMul, palette);
+
+    // Indices are stored column by column, most significant bit first
+    unsigned long long bits = 0;
+    for (int x = 0; x < 4; x++)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            int bestIndex = 0;
+            long long bestPixel = -1;
+            for (int i = 0; i < 8; i++)
+            {
+                long long d = target[y*4 + x] - palette[i];
+                d *= d;
+                if (bestPixel < 0 || d < bestPixel)
+                {
+                    bestPixel = d;
+                    bestIndex = i;
+                }
+            }
+            bits = (bits << 3) | (unsigned long long)bestIndex;
+        }
+    }
+
+    compressed[0] = (CMP_BYTE)(bestBase & 0xFF);        // signed bases are stored as two's complement
+    compressed[1] = (CMP_BYTE)((bestMul << 4) | bestTable);
+    for (int i = 0; i < 6; i++)
+        compressed[2 + i] = (CMP_BYTE)((bits >> (40 - 8*i)) & 0xFF);
+}
+
+static void EACDecodeBlock(EACFormat format, int values[16], const CMP_BYTE compressed[8])
+{
+    int base  = compressed[0];
+    int mul   = compressed[1] >> 4;
+    int table = compressed[1] & 0x0F;
+
+    if (format == EAC_SIGNED11)
+    {
+        base = (signed char)compressed[0];
+        if (base == -128)
+            base = -127;
+    }
+
+    int palette[8];
+    EACPalette(format, base, table, mul, palette);
+
+    unsigned long long bits = 0;
+    for (int i = 0; i < 6; i++)
+        bits = (bits << 8) | compressed[2 + i];
+
+    for (int x = 0; x < 4; x++)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            int k = x*4 + y;
+            values[y*4 + x] = palette[(bits >> (45 - 3*k)) & 7];
+        }
+    }
+}
+
+void atiEncodeEACAlphaBlock(const CMP_BYTE alpha[16], CMP_BYTE compressed[8], bool fast)
+{
+    int target[16];
+    for (int p = 0; p < 16; p++)
+        target[p] = alpha[p];
+    EACEncodeBlock(EAC_ALPHA8, target, compressed, fast);
+}
+
+void atiDecodeEACAlphaBlock(CMP_BYTE alpha[16], const CMP_BYTE compressed[8])
+{
+    int values[16];
+    EACDecodeBlock(EAC_ALPHA8, values, compressed);
+    for (int p = 0; p < 16; p++)
+        alpha[p] = (CMP_BYTE)values[p];
+}
+
+void atiEncodeEAC11Block(const CMP_WORD values[16], bool isSigned, CMP_BYTE compressed[8], bool fast)
+{
+    int target[16];
+    for (int p = 0; p < 16; p++)
+        target[p] = values[p];
+    EACEncodeBlock(isSigned ? EAC_SIGNED11 : EAC_UNSIGNED11, target, compressed, fast);
+}
+
+void atiDecodeEAC11Block(CMP_WORD values[16], bool isSigned, const CMP_BYTE compressed[8])
+{
+    int decoded[16];
+    EACDecodeBlock(isSigned ? EAC_SIGNED11 : EAC_UNSIGNED11, decoded, compressed);
+    for (int p = 0; p < 16; p++)
+        values[p] = (CMP_WORD)decoded[p];
+}
@@ -214,11 +214,10 @@ typedef short int16;
 
 
 // Global tables
-static uint8 table59T[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 59 bit T-mode
-static uint8 table58H[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 58 bit H-mode
-static int compressParams[16][4] = {{-8, -2,  2, 8}, {-8, -2,  2, 8}, {-17, -5, 5, 17}, {-17, -5, 5, 17}, {-29, -9, 9, 29}, {-29, -9, 9, 29}, {-42, -13, 13, 42}, {-42, -13, 13, 42}, {-60, -18, 18, 60}, {-60, -18, 18, 60}, {-80, -24, 24, 80}, {-80, -24, 24, 80}, {-106, -33, 33, 106}, {-106, -33, 33, 106}, {-183, -47, 47, 183}, {-183, -47, 47, 183}};
-static int unscramble[4] = {2, 3, 1, 0};
-int alphaTableInitialized = 0;
+static const uint8 table59T[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 59 bit T-mode
+static const uint8 table58H[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 58 bit H-mode
+static const int compressParams[16][4] = {{-8, -2,  2, 8}, {-8, -2,  2, 8}, {-17, -5, 5, 17}, {-17, -5, 5, 17}, {-29, -9, 9, 29}, {-29, -9, 9, 29}, {-42, -13, 13, 42}, {-42, -13, 13, 42}, {-60, -18, 18, 60}, {-60, -18, 18, 60}, {-80, -24, 24, 80}, {-80, -24, 24, 80}, {-106, -33, 33, 106}, {-106, -33, 33, 106}, {-183, -47, 47, 183}, {-183, -47, 47, 183}};
+static const int unscramble[4] = {2, 3, 1, 0};
 int alphaTable[256][8];
 int alphaBase[16][4] = {    
               {-15,-9,-6,-3},
@@ -249,12 +248,8 @@ int formatSigned = 0;
 
 // Code used to create the valtab
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
-void setupAlphaTable() 
+static bool buildAlphaTable() 
 {
-  if(alphaTableInitialized)
-    return;
-  alphaTableInitialized = 1;
-
     //read table used for alpha compression
     int buf;
     for(int i = 16; i<32; i++) 
@@ -281,6 +276,15 @@ void setupAlphaTable()
             //note: we don't do clamping here, though we could, because we'll be clamped afterwards anyway.
         }
     }
+    return true;
+}
+
+// Builds alphaTable the first time it is called. The function local static is
+// initialised once even when several encoder threads get here at the same time.
+void setupAlphaTable() 
+{
+    static const bool alphaTableInitialized = buildAlphaTable();
+    (void)alphaTableInitialized;
 }
 
 // Read a word in big endian style
@@ -54,6 +54,12 @@
 #include <sys/timeb.h>
 #include "etcimage.h"
 
+// The perceptual error searches evaluate several pixels or candidates per instruction when SSE2 is available
+#if defined(USE_SSE2) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ETC_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 // Typedefs
 typedef unsigned char uint8;
 typedef unsigned short uint16;
@@ -155,9 +161,9 @@ void setupAlphaTable();
 #define    TABLE_BITS_58H 3
 
 // Global tables
-static uint8 table59T[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 59 bit T-mode
-static uint8 table58H[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 58 bit H-mode
-uint8 weight[3] = {1,1,1};            // Color weight
+static const uint8 table59T[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 59 bit T-mode
+static const uint8 table58H[8] = {3,6,11,16,23,32,41,64};  // 3-bit table for the 58 bit H-mode
+const uint8 weight[3] = {1,1,1};            // Color weight
 
 // Enums
 static enum{PATTERN_H = 0, 
@@ -219,8 +225,8 @@ extern int formatSigned;
 int ktxFile=0;
 bool first_time_message = true;
 
-static int scramble[4] = {3, 2, 0, 1};
-static int unscramble[4] = {2, 3, 1, 0};
+static const int scramble[4] = {3, 2, 0, 1};
+static const int unscramble[4] = {2, 3, 1, 0};
 
 typedef struct KTX_header_t
 {
@@ -810,7 +816,15 @@ void readArguments(int argc,char *argv[],char* src,char *dst)
         format=ETC1_RGB_NO_MIPMAPS;
 }
 
-static int compressParams[16][4];
+// The table is constant so blocks can be compressed on several threads at once.
+static const int compressParams[16][4] = {{  -8,  -2,  2,   8}, {  -8,  -2,  2,   8},
+                                          { -17,  -5,  5,  17}, { -17,  -5,  5,  17},
+                                          { -29,  -9,  9,  29}, { -29,  -9,  9,  29},
+                                          { -42, -13, 13,  42}, { -42, -13, 13,  42},
+                                          { -60, -18, 18,  60}, { -60, -18, 18,  60},
+                                          { -80, -24, 24,  80}, { -80, -24, 24,  80},
+                                          {-106, -33, 33, 106}, {-106, -33, 33, 106},
+                                          {-183, -47, 47, 183}, {-183, -47, 47, 183}};
 const int compressParamsFast[32] = {  -8,  -2,  2,   8,
                                      -17,  -5,  5,  17,
                                      -29,  -9,  9,  29,
@@ -820,25 +834,9 @@ const int compressParamsFast[32] = {  -8,  -2,  2,   8,
                                     -106, -33, 33, 106,
                                     -183, -47, 47, 183};
 
+// compressParams is now initialised statically, this is kept for existing callers.
 bool readCompressParams(void)
 {
-    compressParams[0][0]  =  -8; compressParams[0][1]  =  -2; compressParams[0][2]  =  2; compressParams[0][3]  =   8;
-    compressParams[1][0]  =  -8; compressParams[1][1]  =  -2; compressParams[1][2]  =  2; compressParams[1][3]  =   8;
-    compressParams[2][0]  = -17; compressParams[2][1]  =  -5; compressParams[2][2]  =  5; compressParams[2][3]  =  17;
-    compressParams[3][0]  = -17; compressParams[3][1]  =  -5; compressParams[3][2]  =  5; compressParams[3][3]  =  17;
-    compressParams[4][0]  = -29; compressParams[4][1]  =  -9; compressParams[4][2]  =  9; compressParams[4][3]  =  29;
-    compressParams[5][0]  = -29; compressParams[5][1]  =  -9; compressParams[5][2]  =  9; compressParams[5][3]  =  29;
-    compressParams[6][0]  = -42; compressParams[6][1]  = -13; compressParams[6][2]  = 13; compressParams[6][3]  =  42;
-    compressParams[7][0]  = -42; compressParams[7][1]  = -13; compressParams[7][2]  = 13; compressParams[7][3]  =  42;
-     compressParams[8][0]  = -60; compressParams[8][1]  = -18; compressParams[8][2]  = 18; compressParams[8][3]  =  60;
-     compressParams[9][0]  = -60; compressParams[9][1]  = -18; compressParams[9][2]  = 18; compressParams[9][3]  =  60;
-    compressParams[10][0] = -80; compressParams[10][1] = -24; compressParams[10][2] = 24; compressParams[10][3] =  80;
-    compressParams[11][0] = -80; compressParams[11][1] = -24; compressParams[11][2] = 24; compressParams[11][3] =  80;
-    compressParams[12][0] =-106; compressParams[12][1] = -33; compressParams[12][2] = 33; compressParams[12][3] = 106;
-    compressParams[13][0] =-106; compressParams[13][1] = -33; compressParams[13][2] = 33; compressParams[13][3] = 106;
-    compressParams[14][0] =-183; compressParams[14][1] = -47; compressParams[14][2] = 47; compressParams[14][3] = 183;
-    compressParams[15][0] =-183; compressParams[15][1] = -47; compressParams[15][2] = 47; compressParams[15][3] = 183;
-    
     return true;
 }
 
@@ -951,6 +949,220 @@ int compressBlockWithTable2x4(uint8 *img,int width,int height,int startx,int sta
 
 #define MAXERR1000 1000*255*255*16
 
+#ifdef ETC_USE_SSE2
+// Adds the perceptually weighted squared differences of 8 pixels to err_lo (pixels 0-3) and err_hi (pixels 4-7).
+// The differences are within [-255, 255] so their squares fit in unsigned 16 bit lanes and
+// mullo/mulhi_epu16 give the exact 32 bit product with the weight.
+static inline void addSquaredErrorPercep1000SSE2(__m128i diff, int weight, __m128i &err_lo, __m128i &err_hi)
+{
+    __m128i sq = _mm_mullo_epi16(diff, diff);
+    __m128i w  = _mm_set1_epi16((short)weight);
+    __m128i lo = _mm_mullo_epi16(sq, w);
+    __m128i hi = _mm_mulhi_epu16(sq, w);
+    err_lo = _mm_add_epi32(err_lo, _mm_unpacklo_epi16(lo, hi));
+    err_hi = _mm_add_epi32(err_hi, _mm_unpackhi_epi16(lo, hi));
+}
+
+// Calculates the perceptual error of 8 pixels against one color
+static inline void calcColorErrorPercep1000SSE2(const __m128i orig[3], const int color[3], __m128i &err_lo, __m128i &err_hi)
+{
+    err_lo = _mm_setzero_si128();
+    err_hi = _mm_setzero_si128();
+    addSquaredErrorPercep1000SSE2(_mm_sub_epi16(orig[R], _mm_set1_epi16((short)color[R])), PERCEPTUAL_WEIGHT_R_SQUARED_TIMES1000, err_lo, err_hi);
+    addSquaredErrorPercep1000SSE2(_mm_sub_epi16(orig[G], _mm_set1_epi16((short)color[G])), PERCEPTUAL_WEIGHT_G_SQUARED_TIMES1000, err_lo, err_hi);
+    addSquaredErrorPercep1000SSE2(_mm_sub_epi16(orig[B], _mm_set1_epi16((short)color[B])), PERCEPTUAL_WEIGHT_B_SQUARED_TIMES1000, err_lo, err_hi);
+}
+
+// Selects bits from a where mask is set and from b elsewhere
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Finds the closest of four candidate colors for 8 pixels using the perceptual metric.
+// orig holds the red, green and blue values of the pixels as 16 bit lanes. On equal error the
+// lowest candidate is kept, which is the same choice the scalar loops make.
+// Returns the sum of the smallest errors, best receives the chosen candidate of each pixel.
+static unsigned int findBestColorsPercep1000SSE2(const __m128i orig[3], const int colors[4][3], int best[8])
+{
+    __m128i min_lo   = _mm_setzero_si128(), min_hi = _mm_setzero_si128();
+    __m128i best_lo  = _mm_setzero_si128(), best_hi = _mm_setzero_si128();
+
+    for(int c = 0; c < 4; c++)
+    {
+        __m128i err_lo, err_hi;
+        calcColorErrorPercep1000SSE2(orig, colors[c], err_lo, err_hi);
+
+        if(c == 0)
+        {
+            min_lo = err_lo;
+            min_hi = err_hi;
+        }
+        else
+        {
+            // Errors are below 2^31 so the signed compare is safe
+            __m128i lt_lo = _mm_cmplt_epi32(err_lo, min_lo);
+            __m128i lt_hi = _mm_cmplt_epi32(err_hi, min_hi);
+            __m128i index = _mm_set1_epi32(c);
+            min_lo  = selectSSE2(lt_lo, err_lo, min_lo);
+            min_hi  = selectSSE2(lt_hi, err_hi, min_hi);
+            best_lo = selectSSE2(lt_lo, index, best_lo);
+            best_hi = selectSSE2(lt_hi, index, best_hi);
+        }
+    }
+
+    unsigned int min_error[8];
+    _mm_storeu_si128((__m128i*)&min_error[0], min_lo);
+    _mm_storeu_si128((__m128i*)&min_error[4], min_hi);
+    _mm_storeu_si128((__m128i*)&best[0], best_lo);
+    _mm_storeu_si128((__m128i*)&best[4], best_hi);
+
+    unsigned int sum_error = 0;
+    for(int i = 0; i < 8; i++)
+        sum_error += min_error[i];
+    return sum_error;
+}
+
+// Loads pixel i of an image area into lane i of orig. The pixels are listed as x and y offsets from (startx, starty).
+static inline void loadPixelsSSE2(uint8 *img, int width, int startx, int starty, const int offsets[8][2], __m128i orig[3])
+{
+    short rgb[3][8];
+    for(int i = 0; i < 8; i++)
+    {
+        int x = startx + offsets[i][0];
+        int y = starty + offsets[i][1];
+        rgb[R][i] = RED(img,width,x,y);
+        rgb[G][i] = GREEN(img,width,x,y);
+        rgb[B][i] = BLUE(img,width,x,y);
+    }
+    orig[R] = _mm_loadu_si128((__m128i*)rgb[R]);
+    orig[G] = _mm_loadu_si128((__m128i*)rgb[G]);
+    orig[B] = _mm_loadu_si128((__m128i*)rgb[B]);
+}
+
+// Pixel order of the 2x4 and 4x2 halves, matching the bit order of the pixel indices
+static const int offsets2x4[8][2] = {{0,0},{0,1},{0,2},{0,3},{1,0},{1,1},{1,2},{1,3}};
+static const int offsets4x2[8][2] = {{0,0},{0,1},{1,0},{1,1},{2,0},{2,1},{3,0},{3,1}};
+// Pixel order of the two halves of a 4x4 block in row order, used by the T and H modes
+static const int offsets4x4[2][8][2] = {{{0,0},{1,0},{2,0},{3,0},{0,1},{1,1},{2,1},{3,1}},
+                                        {{0,2},{1,2},{2,2},{3,2},{0,3},{1,3},{2,3},{3,3}}};
+
+// Loads 8 pixels, starting at pixel first, of a block stored with 4 bytes per pixel as used by the exhaustive searches.
+static inline void loadBlockPixelsSSE2(uint8 *block, int first, __m128i orig[3])
+{
+    short rgb[3][8];
+    for(int i = 0; i < 8; i++)
+    {
+        rgb[R][i] = block[4*(first+i) + R];
+        rgb[G][i] = block[4*(first+i) + G];
+        rgb[B][i] = block[4*(first+i) + B];
+    }
+    orig[R] = _mm_loadu_si128((__m128i*)rgb[R]);
+    orig[G] = _mm_loadu_si128((__m128i*)rgb[G]);
+    orig[B] = _mm_loadu_si128((__m128i*)rgb[B]);
+}
+
+// Stores the smallest error of each of the 16 block pixels over numColors candidate colors.
+// This fills one distance of the T and H mode precalc tables.
+static void precalcMinErrorPercep1000SSE2(const __m128i orig[2][3], const int colors[][3], int numColors, unsigned int *precalc_err)
+{
+    for(int half = 0; half < 2; half++)
+    {
+        __m128i min_lo, min_hi;
+        calcColorErrorPercep1000SSE2(orig[half], colors[0], min_lo, min_hi);
+        for(int c = 1; c < numColors; c++)
+        {
+            __m128i err_lo, err_hi;
+            calcColorErrorPercep1000SSE2(orig[half], colors[c], err_lo, err_hi);
+            min_lo = selectSSE2(_mm_cmplt_epi32(err_lo, min_lo), err_lo, min_lo);
+            min_hi = selectSSE2(_mm_cmplt_epi32(err_hi, min_hi), err_hi, min_hi);
+        }
+        _mm_storeu_si128((__m128i*)&precalc_err[half*8],     min_lo);
+        _mm_storeu_si128((__m128i*)&precalc_err[half*8 + 4], min_hi);
+    }
+}
+
+// Sums, for each of the 8 distances, the smaller of the two precalculated errors of every pixel
+// and returns the lowest sum. err0 holds 16 errors per distance, err1 advances err1_step per distance.
+// The scalar versions stop adding once a sum reaches the best error so far, those partial sums
+// are never below it, so the full sums give the caller the same result.
+static unsigned int calcMinErrorFromPrecalcSSE2(const unsigned int *err0, const unsigned int *err1, int err1_step)
+{
+    unsigned int error = MAXERR1000;
+    for(int d = 0; d < 8; d++)
+    {
+        const unsigned int *a = &err0[d*16];
+        const unsigned int *b = &err1[d*err1_step];
+        __m128i sum = _mm_setzero_si128();
+        for(int i = 0; i < 16; i += 4)
+        {
+            __m128i va = _mm_loadu_si128((__m128i*)&a[i]);
+            __m128i vb = _mm_loadu_si128((__m128i*)&b[i]);
+            sum = _mm_add_epi32(sum, selectSSE2(_mm_cmplt_epi32(va, vb), va, vb));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1,0,3,2)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2,3,0,1)));
+        unsigned int block_error = (unsigned int)_mm_cvtsi128_si32(sum);
+        if(block_error < error)
+            error = block_error;
+    }
+    return error;
+}
+
+// Computes the index bits and error of a 2x4 or 4x2 half block for one modifier table.
+static unsigned int compressBlockWithTablePercep1000SSE2(uint8 *img, int width, int startx, int starty, const int offsets[8][2], const int bitpos[8], uint8 *avg_color, int table, unsigned int *pixel_indices_MSBp, unsigned int *pixel_indices_LSBp)
+{
+    __m128i orig[3];
+    int colors[4][3];
+    int best[8];
+    unsigned int pixel_indices_MSB=0, pixel_indices_LSB=0, pixel_indices;
+
+    loadPixelsSSE2(img, width, startx, starty, offsets, orig);
+    for(int q = 0; q < 4; q++)
+    {
+        colors[q][R] = CLAMP(0, avg_color[0]+compressParams[table][q],255);
+        colors[q][G] = CLAMP(0, avg_color[1]+compressParams[table][q],255);
+        colors[q][B] = CLAMP(0, avg_color[2]+compressParams[table][q],255);
+    }
+
+    unsigned int sum_error = findBestColorsPercep1000SSE2(orig, colors, best);
+
+    for(int i = 0; i < 8; i++)
+    {
+        pixel_indices = scramble[best[i]];
+        PUTBITS( pixel_indices_MSB, (pixel_indices >> 1), 1, bitpos[i]);
+        PUTBITS( pixel_indices_LSB, (pixel_indices & 1) , 1, bitpos[i]);
+    }
+
+    *pixel_indices_MSBp = pixel_indices_MSB;
+    *pixel_indices_LSBp = pixel_indices_LSB;
+
+    return sum_error;
+}
+
+// Computes the error and the pixel indices of a whole block for four paint colors, as used by the T and H modes.
+// The indices are packed two bits per pixel with the first pixel in the highest bits.
+static unsigned int calcBlockErrorPercep1000SSE2(const __m128i orig[2][3], uint8 (possible_colors)[4][3], unsigned int &pixel_colors)
+{
+    int colors[4][3];
+    int best[2][8];
+    for(int c = 0; c < 4; c++)
+    {
+        colors[c][R] = possible_colors[c][R];
+        colors[c][G] = possible_colors[c][G];
+        colors[c][B] = possible_colors[c][B];
+    }
+
+    unsigned int block_error = findBestColorsPercep1000SSE2(orig[0], colors, best[0]);
+    block_error += findBestColorsPercep1000SSE2(orig[1], colors, best[1]);
+
+    pixel_colors = 0;
+    for(int i = 0; i < 16; i++)
+        pixel_colors = (pixel_colors << 2) | best[i >> 3][i & 7];
+    return block_error;
+}
+#endif
+
 // Finds all pixel indices for a 2x4 block using perceptual weighting of error.
 // Done using fixed poinit arithmetics where weights are multiplied by 1000.
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
@@ -959,6 +1171,10 @@ unsigned int compressBlockWithTable2x4percep1000(uint8 *img,int width,int height
 
     UNREFERENCED_PARAMETER(height);
 
+#ifdef ETC_USE_SSE2
+    static const int bitpos[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    return compressBlockWithTablePercep1000SSE2(img, width, startx, starty, offsets2x4, bitpos, avg_color, table, pixel_indices_MSBp, pixel_indices_LSBp);
+#else
     uint8 orig[3],approx[3];
     unsigned int pixel_indices_MSB=0, pixel_indices_LSB=0, pixel_indices = 0;
     unsigned int sum_error=0;
@@ -1016,6 +1232,7 @@ unsigned int compressBlockWithTable2x4percep1000(uint8 *img,int width,int height
     *pixel_indices_LSBp = pixel_indices_LSB;
 
     return sum_error;
+#endif
 }
 
 // Finds all pixel indices for a 2x4 block using perceptual weighting of error.
@@ -1152,6 +1369,10 @@ unsigned int compressBlockWithTable4x2percep1000(uint8 *img,int width,int height
 
     UNREFERENCED_PARAMETER(height);
 
+#ifdef ETC_USE_SSE2
+    static const int bitpos[8] = {0, 1, 4, 5, 8, 9, 12, 13};
+    return compressBlockWithTablePercep1000SSE2(img, width, startx, starty, offsets4x2, bitpos, avg_color, table, pixel_indices_MSBp, pixel_indices_LSBp);
+#else
     uint8 orig[3],approx[3];
     unsigned int pixel_indices_MSB=0, pixel_indices_LSB=0, pixel_indices = 0;
     unsigned int sum_error=0;
@@ -1207,6 +1428,7 @@ unsigned int compressBlockWithTable4x2percep1000(uint8 *img,int width,int height
     *pixel_indices_LSBp = pixel_indices_LSB;
 
     return sum_error;
+#endif
 }
 
 // Finds all pixel indices for a 4x2 block using perceptual weighting of error.
@@ -4268,6 +4490,79 @@ unsigned int calcErrorPlanarOnlyBluePerceptual(uint8 *block, int colorO, int col
     return error;
 }
 
+#ifdef ETC_USE_SSE2
+// Adds the weighted squared error of one D pixel for 8 values of colorV.
+// The pixel is at column x and row y of the block and colorOHterm is x*(colorH-colorO) + 4*colorO + 2.
+static inline void addPlanarPixelErrorSSE2(int pixel, int colorOHterm, int y, __m128i colorVminusO, int weight, __m128i &err_lo, __m128i &err_hi)
+{
+    __m128i yterm = colorVminusO;
+    if(y > 1)
+        yterm = _mm_add_epi16(yterm, colorVminusO);
+    if(y > 2)
+        yterm = _mm_add_epi16(yterm, colorVminusO);
+
+    // Same as clamp_table[ ((colorOHterm + y*(colorV-colorO))>>2) + 255]
+    __m128i value = _mm_srai_epi16(_mm_add_epi16(_mm_set1_epi16((short)colorOHterm), yterm), 2);
+    value = _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), _mm_set1_epi16(255));
+
+    addSquaredErrorPercep1000SSE2(_mm_sub_epi16(_mm_set1_epi16((short)pixel), value), weight, err_lo, err_hi);
+}
+
+// Calculates calcErrorPlanarOnly{Red,Green,Blue}Perceptual for the 8 encoded values colorV .. colorV+7.
+// channel selects the color component and bits its precision (6 or 7). BBBvalues and CCCvalues point
+// at the precalculated entries for the first colorV. The early outs of the scalar functions are
+// reproduced per lane so the returned errors are identical.
+static void calcErrorPlanarOnlyPerceptual8SSE2(uint8 *block, int channel, int bits, int colorO, int colorH, int colorV, unsigned int lowest_possible_error, const unsigned int *BBBvalues, const unsigned int *CCCvalues, unsigned int best_error_sofar, int weight, unsigned int errors[8])
+{
+    colorO = (colorO << (8-bits)) | (colorO >> (2*bits-8));
+    colorH = (colorH << (8-bits)) | (colorH >> (2*bits-8));
+
+
+    // All errors stay below 2^31, limiting the threshold keeps the signed compares valid
+    __m128i sofar = _mm_set1_epi32((int)JAS_MIN(best_error_sofar, 0x7fffffffu));
+    __m128i lpe   = _mm_set1_epi32((int)lowest_possible_error);
+    __m128i err_lo = _mm_add_epi32(lpe, _mm_add_epi32(_mm_loadu_si128((__m128i*)&BBBvalues[0]), _mm_loadu_si128((__m128i*)&CCCvalues[0])));
+    __m128i err_hi = _mm_add_epi32(lpe, _mm_add_epi32(_mm_loadu_si128((__m128i*)&BBBvalues[4]), _mm_loadu_si128((__m128i*)&CCCvalues[4])));
+
+    // Most candidates are already worse than the best error before the D pixels are added
+    if((_mm_movemask_epi8(_mm_cmpgt_epi32(err_lo, sofar)) & _mm_movemask_epi8(_mm_cmpgt_epi32(err_hi, sofar))) == 0xffff)
+    {
+        _mm_storeu_si128((__m128i*)&errors[0], err_lo);
+        _mm_storeu_si128((__m128i*)&errors[4], err_hi);
+        return;
+    }
+
+    short colorVminusO[8];
+    for(int i = 0; i < 8; i++)
+    {
+        int v = colorV + i;
+        colorVminusO[i] = (short)(((v << (8-bits)) | (v >> (2*bits-8))) - colorO);
+    }
+    __m128i vo = _mm_loadu_si128((__m128i*)colorVminusO);
+
+    // Second and third column terms: D1 D2 D3 and D4 D5 D6 as in the scalar code
+    __m128i part1_lo = _mm_setzero_si128(), part1_hi = _mm_setzero_si128();
+    __m128i part2_lo = _mm_setzero_si128(), part2_hi = _mm_setzero_si128();
+    int xterm1 = (colorH-colorO) + 4*colorO + 2;
+    int xterm2 = ((colorH-colorO) << 1) + 4*colorO + 2;
+    int xterm3 = 3*(colorH-colorO) + 4*colorO + 2;
+    addPlanarPixelErrorSSE2(block[4*4 + 4 + channel],       xterm1, 1, vo, weight, part1_lo, part1_hi);
+    addPlanarPixelErrorSSE2(block[4*4*2 + 4 + channel],     xterm1, 2, vo, weight, part1_lo, part1_hi);
+    addPlanarPixelErrorSSE2(block[4*4 + 4*2 + channel],     xterm2, 1, vo, weight, part1_lo, part1_hi);
+    addPlanarPixelErrorSSE2(block[4*4*3 + 4*2 + channel],   xterm2, 3, vo, weight, part2_lo, part2_hi);
+    addPlanarPixelErrorSSE2(block[4*4*2 + 4*3 + channel],   xterm3, 2, vo, weight, part2_lo, part2_hi);
+    addPlanarPixelErrorSSE2(block[4*4*3 + 4*3 + channel],   xterm3, 3, vo, weight, part2_lo, part2_hi);
+
+    err_lo = _mm_add_epi32(err_lo, _mm_andnot_si128(_mm_cmpgt_epi32(err_lo, sofar), part1_lo));
+    err_hi = _mm_add_epi32(err_hi, _mm_andnot_si128(_mm_cmpgt_epi32(err_hi, sofar), part1_hi));
+    err_lo = _mm_add_epi32(err_lo, _mm_andnot_si128(_mm_cmpgt_epi32(err_lo, sofar), part2_lo));
+    err_hi = _mm_add_epi32(err_hi, _mm_andnot_si128(_mm_cmpgt_epi32(err_hi, sofar), part2_hi));
+
+    _mm_storeu_si128((__m128i*)&errors[0], err_lo);
+    _mm_storeu_si128((__m128i*)&errors[4], err_hi);
+}
+#endif
+
 // Calculating the minimum error for the block (in planar mode) if we know the blue component for O, V and H.
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 unsigned int calcErrorPlanarOnlyBlue(uint8 *block, int colorO, int colorH, int colorV, unsigned int lowest_possible_error, unsigned int BBBvalue, unsigned int CCCvalue, unsigned int best_error_sofar)
@@ -6094,15 +6389,23 @@ unsigned int calculateError59Tperceptual1000(uint8* srcimg, int width, int start
 {
 
     unsigned int block_error = 0, 
-           best_block_error = MAXERR1000,
-           pixel_error, 
-           best_pixel_error;
+           best_block_error = MAXERR1000;
+#ifndef ETC_USE_SSE2
+    unsigned int pixel_error, best_pixel_error;
     int diff[3];
+#endif
     uint8 best_sw;
     unsigned int pixel_colors;
     uint8 colors[2][3];
     uint8 possible_colors[4][3];
 
+#ifdef ETC_USE_SSE2
+    // The pixels are the same for every distance, load them once
+    __m128i orig[2][3];
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[0], orig[0]);
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[1], orig[1]);
+#endif
+
     // First use the colors as they are, then swap them
     for (uint8 sw = 0; sw <2; ++sw) 
     { 
@@ -6117,6 +6420,9 @@ unsigned int calculateError59Tperceptual1000(uint8* srcimg, int width, int start
         {
             calculatePaintColors59T(d,PATTERN_T, colors, possible_colors);
             
+#ifdef ETC_USE_SSE2
+            block_error = calcBlockErrorPercep1000SSE2(orig, possible_colors, pixel_colors);
+#else
             block_error = 0;    
             pixel_colors = 0;
 
@@ -6151,6 +6457,7 @@ unsigned int calculateError59Tperceptual1000(uint8* srcimg, int width, int start
                     block_error += best_pixel_error;
                 }
             }
+#endif
             if (block_error < best_block_error) 
             {
                 best_block_error = block_error;
@@ -6265,14 +6572,22 @@ unsigned int calculateError59TnoSwapPerceptual1000(uint8* srcimg, int width, int
 {
 
     unsigned int block_error = 0, 
-           best_block_error = MAXERR1000,
-           pixel_error, 
-           best_pixel_error;
+           best_block_error = MAXERR1000;
+#ifndef ETC_USE_SSE2
+    unsigned int pixel_error, best_pixel_error;
     int diff[3];
+    int thebestintheworld;
+#endif
     unsigned int pixel_colors;
     uint8 colors[2][3];
     uint8 possible_colors[4][3];
-    int thebestintheworld;
+
+#ifdef ETC_USE_SSE2
+    // The pixels are the same for every distance, load them once
+    __m128i orig[2][3];
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[0], orig[0]);
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[1], orig[1]);
+#endif
 
     // First use the colors as they are, then swap them
         decompressColor(R_BITS59T, G_BITS59T, B_BITS59T, colorsRGB444, colors);
@@ -6282,6 +6597,9 @@ unsigned int calculateError59TnoSwapPerceptual1000(uint8* srcimg, int width, int
         {
             calculatePaintColors59T(d,PATTERN_T, colors, possible_colors);
             
+#ifdef ETC_USE_SSE2
+            block_error = calcBlockErrorPercep1000SSE2(orig, possible_colors, pixel_colors);
+#else
             block_error = 0;    
             pixel_colors = 0;
 
@@ -6317,6 +6635,7 @@ unsigned int calculateError59TnoSwapPerceptual1000(uint8* srcimg, int width, int
                     block_error += best_pixel_error;
                 }
             }
+#endif
             if (block_error < best_block_error) 
             {
                 best_block_error = block_error;
@@ -6702,14 +7021,22 @@ double compressBlockTHUMB59TFast(uint8 *img,int width,int height,int startx,int
 unsigned int calculateErrorAndCompress58Hperceptual1000(uint8* srcimg, int width, int startx, int starty, uint8 (colorsRGB444)[2][3], uint8 &distance, unsigned int &pixel_indices) 
 {
     unsigned int block_error = 0, 
-                   best_block_error = MAXERR1000, 
-                             pixel_error, 
-                             best_pixel_error;
+                   best_block_error = MAXERR1000;
+#ifndef ETC_USE_SSE2
+    unsigned int pixel_error, best_pixel_error;
     int diff[3];
+#endif
     unsigned int pixel_colors;
     uint8 possible_colors[4][3];
     uint8 colors[2][3];
 
+#ifdef ETC_USE_SSE2
+    // The pixels are the same for every distance, load them once
+    __m128i orig[2][3];
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[0], orig[0]);
+    loadPixelsSSE2(srcimg, width, startx, starty, offsets4x4[1], orig[1]);
+#endif
+
     decompressColor(R_BITS58H, G_BITS58H, B_BITS58H, colorsRGB444, colors);
 
     // Test all distances
@@ -6717,6 +7044,9 @@ unsigned int calculateErrorAndCompress58Hperceptual1000(uint8* srcimg, int width
     {
         calculatePaintColors58H(d, PATTERN_H, colors, possible_colors);
 
+#ifdef ETC_USE_SSE2
+        block_error = calcBlockErrorPercep1000SSE2(orig, possible_colors, pixel_colors);
+#else
         block_error = 0;    
         pixel_colors = 0;
 
@@ -6750,6 +7080,7 @@ unsigned int calculateErrorAndCompress58Hperceptual1000(uint8* srcimg, int width
                 block_error += best_pixel_error;
             }
         }
+#endif
         
         if (block_error < best_block_error) 
         {
@@ -8540,12 +8871,10 @@ extern int alphaBase[16][4];
 // Note also that it its contents will depend on the value of formatSigned.
 int *valtab;
 
-void setupAlphaTableAndValtab()
+// Builds the valtab contents for unsigned or signed data.
+static int *buildValtab(bool isSigned)
 {
-  setupAlphaTable();
-
-    //fix precomputation table..!
-    valtab = new int[1024*512];
+    int *table = new int[1024*512];
     int16 val16;
     int count=0;
     for(int base=0; base<256; base++) 
@@ -8556,18 +8885,36 @@ void setupAlphaTableAndValtab()
             {
                 for(int index=0; index<8; index++) 
                 {
-                    if(formatSigned)
+                    if(isSigned)
                     {
                         val16=get16bits11signed(base,tab,mul,index);
-                        valtab[count] = val16 + 256*128;
+                        table[count] = val16 + 256*128;
                     }
                     else
-                        valtab[count]=get16bits11bits(base,tab,mul,index);
+                        table[count]=get16bits11bits(base,tab,mul,index);
                     count++;
                 }
             }
         }
     }
+    return table;
+}
+
+// Each table is built once and then shared, previously a new table was allocated on every call.
+void setupAlphaTableAndValtab()
+{
+    setupAlphaTable();
+
+    if(formatSigned)
+    {
+        static int *valtabSigned = buildValtab(true);
+        valtab = valtabSigned;
+    }
+    else
+    {
+        static int *valtabUnsigned = buildValtab(false);
+        valtab = valtabUnsigned;
+    }
 }
 
 // Reads alpha data
@@ -10407,11 +10754,95 @@ inline void tryalltables_3bittable_all_subblocks_using_precalc(uint8 *block_2x2,
 } 
 #endif
 
+#if EXHAUSTIVE_CODE_ACTIVE
+#ifdef ETC_USE_SSE2
+// Returns the smaller of a and b in each lane, the values must be below 2^31
+static inline __m128i minSSE2(__m128i a, __m128i b)
+{
+    return selectSSE2(_mm_cmplt_epi32(a, b), a, b);
+}
+
+// Error of one 2x2 area for one table. Each pixel takes the smallest of its four precalculated
+// red and green errors plus the blue error of the same candidate, the result is summed over the area.
+// blue01 and blue23 hold the blue value of pixels 0, 1 and 2, 3 four times each, approx holds the
+// four candidate blue values twice.
+static inline unsigned int calcAreaErrorPercep1000SSE2(const unsigned int *precalc_err_RG, __m128i blue01, __m128i blue23, __m128i approx)
+{
+    const __m128i weight = _mm_set1_epi16(PERCEPTUAL_WEIGHT_B_SQUARED_TIMES1000);
+    const __m128i zero   = _mm_setzero_si128();
+
+    // The weighted difference still fits in 16 bits, pmaddwd on (d,0) pairs gives the 32 bit product
+    __m128i d01 = _mm_sub_epi16(approx, blue01);
+    __m128i d23 = _mm_sub_epi16(approx, blue23);
+    __m128i w01 = _mm_mullo_epi16(d01, weight);
+    __m128i w23 = _mm_mullo_epi16(d23, weight);
+
+    // One vector per pixel with the errors of the four candidates
+    __m128i e0 = _mm_add_epi32(_mm_loadu_si128((__m128i*)&precalc_err_RG[0]),  _mm_madd_epi16(_mm_unpacklo_epi16(d01, zero), _mm_unpacklo_epi16(w01, zero)));
+    __m128i e1 = _mm_add_epi32(_mm_loadu_si128((__m128i*)&precalc_err_RG[4]),  _mm_madd_epi16(_mm_unpackhi_epi16(d01, zero), _mm_unpackhi_epi16(w01, zero)));
+    __m128i e2 = _mm_add_epi32(_mm_loadu_si128((__m128i*)&precalc_err_RG[8]),  _mm_madd_epi16(_mm_unpacklo_epi16(d23, zero), _mm_unpacklo_epi16(w23, zero)));
+    __m128i e3 = _mm_add_epi32(_mm_loadu_si128((__m128i*)&precalc_err_RG[12]), _mm_madd_epi16(_mm_unpackhi_epi16(d23, zero), _mm_unpackhi_epi16(w23, zero)));
+
+    // Transpose so each vector holds one candidate for the four pixels, then take the minimum
+    __m128i t0 = _mm_unpacklo_epi32(e0, e1);
+    __m128i t1 = _mm_unpacklo_epi32(e2, e3);
+    __m128i t2 = _mm_unpackhi_epi32(e0, e1);
+    __m128i t3 = _mm_unpackhi_epi32(e2, e3);
+    __m128i best = minSSE2(minSSE2(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1)),
+                           minSSE2(_mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)));
+
+    best = _mm_add_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1,0,3,2)));
+    best = _mm_add_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2,3,0,1)));
+    return (unsigned int)_mm_cvtsi128_si32(best);
+}
+#endif
+#endif
+
 #if EXHAUSTIVE_CODE_ACTIVE
 // Tries all index-tables, used when compressing a block exhaustively using perceptual error measure
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 inline void tryalltables_3bittable_all_subblocks_using_precalc_perceptual1000(uint8 *block_2x2,uint8 *color_quant1, unsigned int *precalc_err_UL_RG, unsigned int *precalc_err_UR_RG, unsigned int *precalc_err_LL_RG, unsigned int *precalc_err_LR_RG, unsigned int &err_upper, unsigned int &err_lower, unsigned int &err_left, unsigned int &err_right, unsigned int best_err)
 {
+#ifdef ETC_USE_SSE2
+    unsigned int err_UL, err_UR, err_LL, err_LR;
+    int approx[4];
+
+    // Blue values of the pixels in pairs, see calcAreaErrorPercep1000SSE2
+    __m128i blue[8];
+    for(int pair = 0; pair < 8; pair++)
+        blue[pair] = _mm_unpacklo_epi64(_mm_set1_epi16(block_2x2[(2*pair)*4+2]), _mm_set1_epi16(block_2x2[(2*pair+1)*4+2]));
+
+    err_upper = MAXERR1000;    
+    err_lower = MAXERR1000;    
+    err_left = MAXERR1000;    
+    err_right =MAXERR1000;    
+
+    for(int table_nbr = 0; table_nbr < 8; table_nbr++)
+    {
+        for(int q = 0; q < 4; q++)
+            approx[q] = CLAMP(0, color_quant1[2]+compressParamsFast[table_nbr*4+q], 255);
+        __m128i approx16 = _mm_setr_epi16((short)approx[0], (short)approx[1], (short)approx[2], (short)approx[3], (short)approx[0], (short)approx[1], (short)approx[2], (short)approx[3]);
+
+        err_UL = calcAreaErrorPercep1000SSE2(&precalc_err_UL_RG[table_nbr*4*4], blue[0], blue[1], approx16);
+        err_LR = calcAreaErrorPercep1000SSE2(&precalc_err_LR_RG[table_nbr*4*4], blue[6], blue[7], approx16);
+
+        // The other two areas are only needed when this table can be part of the best solution, as in the scalar code
+        if((err_UL<best_err)||(err_LR<best_err))
+        {
+            err_UR = calcAreaErrorPercep1000SSE2(&precalc_err_UR_RG[table_nbr*4*4], blue[2], blue[3], approx16);
+            err_LL = calcAreaErrorPercep1000SSE2(&precalc_err_LL_RG[table_nbr*4*4], blue[4], blue[5], approx16);
+
+            if(err_UL + err_UR < err_upper)
+                err_upper = err_UL + err_UR;
+            if(err_LL + err_LR < err_lower)
+                err_lower = err_LL + err_LR;
+            if(err_UL + err_LL < err_left)
+                err_left = err_UL + err_LL;
+            if(err_UR + err_LR < err_right)
+                err_right = err_UR + err_LR;
+        }
+    }
+#else
     unsigned int err_this_table_upper;
     unsigned int err_this_table_lower;
     unsigned int err_this_table_left;
@@ -10558,6 +10989,7 @@ inline void tryalltables_3bittable_all_subblocks_using_precalc_perceptual1000(ui
         ONE_TABLE_3_PERCEP(6);
         ONE_TABLE_3_PERCEP(7);
     /*end unroll loop*/
+#endif
 } 
 #endif
 
@@ -11993,6 +12425,23 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
             lowest_possible_error = calcLowestPossibleRedOHperceptual(block, colorO_enc[0], colorH_enc[0], best_error_red_sofar);
             if(lowest_possible_error <= best_error_red_sofar)
             {
+#ifdef ETC_USE_SSE2
+                for(colorV_enc[0] = 0; colorV_enc[0]<64; colorV_enc[0]+=8)
+                {
+                    unsigned int errors[8];
+                    calcErrorPlanarOnlyPerceptual8SSE2(block, 0, 6, colorO_enc[0], colorH_enc[0], colorV_enc[0], lowest_possible_error, &BBBtable[colorO_enc[0]*64+colorV_enc[0]], &CCCtable[colorH_enc[0]*64+colorV_enc[0]], best_error_red_sofar, PERCEPTUAL_WEIGHT_R_SQUARED_TIMES1000, errors);
+                    for(int v = 0; v < 8; v++)
+                    {
+                        if(errors[v] < best_error)
+                        {
+                            best_error = errors[v];
+                            best_colorO_enc[0] = colorO_enc[0];
+                            best_colorH_enc[0] = colorH_enc[0];
+                            best_colorV_enc[0] = colorV_enc[0] + v;
+                        }
+                    }
+                }
+#else
                 for(colorV_enc[0] = 0; colorV_enc[0]<64; colorV_enc[0]++)
                 {
                     error = calcErrorPlanarOnlyRedPerceptual(block, colorO_enc[0], colorH_enc[0], colorV_enc[0], lowest_possible_error, BBBtable[colorO_enc[0]*64+colorV_enc[0]], CCCtable[colorH_enc[0]*64+colorV_enc[0]], best_error_red_sofar);
@@ -12004,6 +12453,7 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
                         best_colorV_enc[0] = colorV_enc[0];
                     }
                 }
+#endif
             }
         }
     }
@@ -12066,6 +12516,23 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
             lowest_possible_error = calcLowestPossibleGreenOHperceptual(block, colorO_enc[1], colorH_enc[1], best_error_green_sofar);
             if(lowest_possible_error <= best_error_green_sofar)
             {
+#ifdef ETC_USE_SSE2
+                for(colorV_enc[1] = 0; colorV_enc[1]<128; colorV_enc[1]+=8)
+                {
+                    unsigned int errors[8];
+                    calcErrorPlanarOnlyPerceptual8SSE2(block, 1, 7, colorO_enc[1], colorH_enc[1], colorV_enc[1], lowest_possible_error, &BBBtable[colorO_enc[1]*128+colorV_enc[1]], &CCCtable[colorH_enc[1]*128+colorV_enc[1]], best_error_green_sofar, PERCEPTUAL_WEIGHT_G_SQUARED_TIMES1000, errors);
+                    for(int v = 0; v < 8; v++)
+                    {
+                        if(errors[v] < best_error)
+                        {
+                            best_error = errors[v];
+                            best_colorO_enc[1] = colorO_enc[1];
+                            best_colorH_enc[1] = colorH_enc[1];
+                            best_colorV_enc[1] = colorV_enc[1] + v;
+                        }
+                    }
+                }
+#else
                 for(colorV_enc[1] = 0; colorV_enc[1]<128; colorV_enc[1]++)
                 {
                     error = calcErrorPlanarOnlyGreenPerceptual(block, colorO_enc[1], colorH_enc[1], colorV_enc[1], lowest_possible_error, BBBtable[colorO_enc[1]*128+colorV_enc[1]], CCCtable[colorH_enc[1]*128+colorV_enc[1]], best_error_green_sofar);
@@ -12077,6 +12544,7 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
                         best_colorV_enc[1] = colorV_enc[1];
                     }
                 }
+#endif
             }
         }
     }
@@ -12138,6 +12606,23 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
             lowest_possible_error = calcLowestPossibleBlueOHperceptual(block, colorO_enc[2], colorH_enc[2], best_error_blue_sofar);
             if(lowest_possible_error <= best_error_blue_sofar)
             {
+#ifdef ETC_USE_SSE2
+                for(colorV_enc[2] = 0; colorV_enc[2]<64; colorV_enc[2]+=8)
+                {
+                    unsigned int errors[8];
+                    calcErrorPlanarOnlyPerceptual8SSE2(block, 2, 6, colorO_enc[2], colorH_enc[2], colorV_enc[2], lowest_possible_error, &BBBtable[colorO_enc[2]*64+colorV_enc[2]], &CCCtable[colorH_enc[2]*64+colorV_enc[2]], best_error_blue_sofar, PERCEPTUAL_WEIGHT_B_SQUARED_TIMES1000, errors);
+                    for(int v = 0; v < 8; v++)
+                    {
+                        if(errors[v] < best_error)
+                        {
+                            best_error = errors[v];
+                            best_colorO_enc[2] = colorO_enc[2];
+                            best_colorH_enc[2] = colorH_enc[2];
+                            best_colorV_enc[2] = colorV_enc[2] + v;
+                        }
+                    }
+                }
+#else
                 for(colorV_enc[2] = 0; colorV_enc[2]<64; colorV_enc[2]++)
                 {
                     error = calcErrorPlanarOnlyBluePerceptual(block, colorO_enc[2], colorH_enc[2], colorV_enc[2], lowest_possible_error, BBBtable[colorO_enc[2]*64+colorV_enc[2]], CCCtable[colorH_enc[2]*64+colorV_enc[2]], best_error_blue_sofar);
@@ -12149,6 +12634,7 @@ void compressBlockPlanar57ExhaustivePerceptual(uint8 *img, int width,int height,
                         best_colorV_enc[2] = colorV_enc[2];
                     }
                 }
+#endif
             }
         }
     }
@@ -12699,6 +13185,30 @@ void precalcError59T_col1_RG(uint8* block, int colorRGB444_packed, unsigned int
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 void precalcError59T_col0_RGBpercep1000(uint8* block, int colorRGB444_packed, unsigned int *precalc_err_col0_RGB)
 {
+#ifdef ETC_USE_SSE2
+    __m128i orig[2][3];
+    int color[3];
+    int possible_colors[3][3];
+
+    loadBlockPixelsSSE2(block, 0, orig[0]);
+    loadBlockPixelsSSE2(block, 8, orig[1]);
+
+    color[R] = (((colorRGB444_packed >> 8) ) << 4) | ((colorRGB444_packed >> 8) ) ;
+    color[G] = (((colorRGB444_packed >> 4) & 0xf) << 4) | ((colorRGB444_packed >> 4) & 0xf) ;
+    color[B] = (((colorRGB444_packed) & 0xf) << 4) | ((colorRGB444_packed) & 0xf) ;
+
+    // Test all distances
+    for (int d = 0; d < 8; d++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            possible_colors[0][c] = CLAMP(0, color[c] - table59T[d], 255);
+            possible_colors[1][c] = color[c];
+            possible_colors[2][c] = CLAMP(0, color[c] + table59T[d], 255);
+        }
+        precalcMinErrorPercep1000SSE2(orig, possible_colors, 3, &precalc_err_col0_RGB[(colorRGB444_packed*8 + d)*16]);
+    }
+#else
     unsigned int // block_error = 0, 
                  // best_block_error = MAXERR1000,
                  pixel_error, 
@@ -12775,6 +13285,7 @@ void precalcError59T_col0_RGBpercep1000(uint8* block, int colorRGB444_packed, un
         ONETABLE59RGB_PERCEP(6)
         ONETABLE59RGB_PERCEP(7)
     }
+#endif
 }
 #endif
 
@@ -13296,6 +13807,11 @@ unsigned int calculateError59TusingPrecalcRG(uint8* block, int *colorsRGB444_pac
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 unsigned int calculateError59TusingPrecalcRGBperceptual1000(uint8* block, int *colorsRGB444_packed, unsigned int *precalc_err_col0_RGB, unsigned int *precalc_err_col1_RGB, unsigned int best_error_so_far) 
 {
+#ifdef ETC_USE_SSE2
+    UNREFERENCED_PARAMETER(block);
+    UNREFERENCED_PARAMETER(best_error_so_far);
+    return calcMinErrorFromPrecalcSSE2(&precalc_err_col0_RGB[(colorsRGB444_packed[0]*8)*16], &precalc_err_col1_RGB[(colorsRGB444_packed[1])*16], 0);
+#else
     unsigned int    block_error = 0, 
                           best_block_error = MAXERR1000;
     unsigned int *pixel_error_col0_adr, *pixel_error_col1_adr;
@@ -13379,6 +13895,7 @@ unsigned int calculateError59TusingPrecalcRGBperceptual1000(uint8* block, int *c
         ONETABLE59T_PERCEP(7)
     }
     return best_block_error;
+#endif
 }
 #endif
 
@@ -14067,6 +14584,29 @@ void precalcErrorRG_58H(uint8* srcimg, int width, int startx, int starty, uint8
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 void precalcError58Hperceptual1000(uint8* block, uint8 (colorsRGB444)[2][3],int colorRGB444_packed, unsigned int *precalc_err) 
 {
+#ifdef ETC_USE_SSE2
+    __m128i orig[2][3];
+    int color[3];
+    int possible_colors[2][3];
+
+    loadBlockPixelsSSE2(block, 0, orig[0]);
+    loadBlockPixelsSSE2(block, 8, orig[1]);
+
+    color[R] = (colorsRGB444[0][R] << 4) | colorsRGB444[0][R];
+    color[G] = (colorsRGB444[0][G] << 4) | colorsRGB444[0][G];
+    color[B] = (colorsRGB444[0][B] << 4) | colorsRGB444[0][B];
+
+    // Test all distances
+    for (int d = 0; d < 8; d++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            possible_colors[0][c] = CLAMP(0, color[c] - table58H[d], 255);
+            possible_colors[1][c] = CLAMP(0, color[c] + table58H[d], 255);
+        }
+        precalcMinErrorPercep1000SSE2(orig, possible_colors, 2, &precalc_err[((colorRGB444_packed*8)+d)*16]);
+    }
+#else
     unsigned int pixel_error, 
            best_pixel_error;
     int possible_colors[2][3];
@@ -14136,6 +14676,7 @@ void precalcError58Hperceptual1000(uint8* block, uint8 (colorsRGB444)[2][3],int
         PRECALC_ONE_TABLE_58H_PERCEP(7)
 
     /* end unroll loop */
+#endif
 }
 #endif
 
@@ -14610,6 +15151,10 @@ unsigned int calculateErrorFromPrecalcRG58H(int *colorsRGB444_packed, unsigned i
 // NO WARRANTY --- SEE STATEMENT IN TOP OF FILE (C) Ericsson AB 2005-2013. All Rights Reserved.
 unsigned int calculateErrorFromPrecalc58Hperceptual1000(int *colorsRGB444_packed, unsigned int *precalc_err, unsigned int total_best_err) 
 {
+#ifdef ETC_USE_SSE2
+    UNREFERENCED_PARAMETER(total_best_err);
+    return calcMinErrorFromPrecalcSSE2(&precalc_err[colorsRGB444_packed[0]*8*16], &precalc_err[colorsRGB444_packed[1]*8*16], 16);
+#else
     unsigned int block_error;\
     unsigned int *precalc_col1, *precalc_col2;\
     unsigned int *precalc_col1tab, *precalc_col2tab;\
@@ -14693,7 +15238,8 @@ unsigned int calculateErrorFromPrecalc58Hperceptual1000(int *colorsRGB444_packed
     /* end unroll loop */\
 
     CALCULATE_ERROR_FROM_PRECALC_RGB58H_PERCEP
-    return error;\
+    return error;
+#endif
 }
 #endif
 
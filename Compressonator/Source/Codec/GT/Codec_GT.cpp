@@ -30,6 +30,7 @@
 #include "Common.h"
 #include "Codec_GT.h"
 #include "process.h"
+#include "CMP_Trace.h"
 
 
 //======================================================================================
@@ -55,6 +56,8 @@ struct GTEncodeThreadParam
 unsigned int    _stdcall GTThreadProcEncode(void* param)
 {
     GTEncodeThreadParam *tp = (GTEncodeThreadParam*)param;
+    CMP_TRACE_THREAD_NAME("GT Worker");
+    CMP_TRACE_SCOPE("Compress", "GT Worker");
 
     while(tp->exit == FALSE)
     {
@@ -376,6 +379,8 @@ CodecError CCodec_GT::FinishGTEncoding(void)
 
 if (m_Use_MultiThreading)
 {
+    CMP_TRACE_SCOPE("Compress", "GT Wait Workers");
+
     // Wait for all the live threads to finish any current work
     for(DWORD i=0; i < m_LiveThreads; i++)
     {
@@ -98,9 +98,6 @@ inline int NBits(_In_ int n, _In_ bool bIsSigned)
      if (prec <= 1) return 0;
      bool negvalue = false;
 
-     // move data to use extra bits for processing
-     int ivalue = value;
-
      if (signedfloat16)
      {
          if (value < 0)
@@ -117,6 +114,9 @@ inline int NBits(_In_ int n, _In_ bool bIsSigned)
              value = 0;
      }
 
+     // move data to use extra bits for processing, the sign is put back on the quantized magnitude
+     int ivalue = value;
+
      int iQuantized;
      int bias = (prec > 10) ? ((1 << (prec - 1)) - 1) : 0;
 
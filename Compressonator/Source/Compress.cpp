@@ -30,6 +30,7 @@
         
 #include "Compressonator.h"
 #include "Compress.h"
+#include "CMP_Trace.h"
 #include <tchar.h>
 #include <assert.h>    
 
@@ -86,6 +87,11 @@ CodecType GetCodecType(CMP_FORMAT format)
         case CMP_FORMAT_ATC_RGBA_Interpolated:   return CT_ATC_RGBA_Interpolated;
         case CMP_FORMAT_ETC_RGB:                 return CT_ETC_RGB;
         case CMP_FORMAT_ETC2_RGB:                return CT_ETC2_RGB;
+        case CMP_FORMAT_ETC2_RGBA:               return CT_ETC2_RGBA;
+        case CMP_FORMAT_EAC_R11:                 return CT_EAC_R11;
+        case CMP_FORMAT_EAC_R11_SIGNED:          return CT_EAC_R11_SIGNED;
+        case CMP_FORMAT_EAC_RG11:                return CT_EAC_RG11;
+        case CMP_FORMAT_EAC_RG11_SIGNED:         return CT_EAC_RG11_SIGNED;
         case CMP_FORMAT_GT:                      return CT_GT;
         default: assert(0);                            return CT_Unknown;
     }
@@ -469,8 +475,22 @@ CMP_ERROR CompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestT
                 pCodec->SetParameter("AlphaRestrict", (CMP_DWORD) pOptions->brestrictAlpha);
                 pCodec->SetParameter("Quality", (CODECFLOAT) pOptions->fquality);
                 break;
+        case CT_ETC2_RGB:
+        case CT_ETC2_RGBA:
+        case CT_EAC_R11:
+        case CT_EAC_R11_SIGNED:
+        case CT_EAC_RG11:
+        case CT_EAC_RG11_SIGNED:
+                if (!pOptions->bDisableMultiThreading)
+                    pCodec->SetParameter("NumThreads", (CMP_DWORD) pOptions->dwnumThreads);
+                else
+                    pCodec->SetParameter("NumThreads", (CMP_DWORD) 1);
+
+                pCodec->SetParameter("Quality", (CODECFLOAT) pOptions->fquality);
+                break;
         case CT_ASTC:
                 pCodec->SetParameter("Quality", (CODECFLOAT)pOptions->fquality);
+                pCodec->SetParameter("Speed", (CMP_DWORD)pOptions->nASTCSpeed);
                 break;
         case CT_GT:
         case CT_BC6H:
@@ -515,9 +535,13 @@ CMP_ERROR CompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestT
         return CMP_ERR_GENERIC;
     }
 
-    DISABLE_FP_EXCEPTIONS;
-    CodecError err = pCodec->Compress(*pSrcBuffer, *pDestBuffer, pFeedbackProc, pUser1, pUser2);
-    RESTORE_FP_EXCEPTIONS;
+    CodecError err;
+    {
+        CMP_TRACE_SCOPE("Compress", GetCodecName(destType));
+        DISABLE_FP_EXCEPTIONS;
+        err = pCodec->Compress(*pSrcBuffer, *pDestBuffer, pFeedbackProc, pUser1, pUser2);
+        RESTORE_FP_EXCEPTIONS;
+    }
 
     SAFE_DELETE(pCodec);
     SAFE_DELETE(pSrcBuffer);
@@ -557,6 +581,8 @@ CATICompressThreadData::~CATICompressThreadData()
 DWORD WINAPI ThreadedCompressProc(LPVOID lpParameter)
 {
     CATICompressThreadData *pThreadData = (CATICompressThreadData*) lpParameter;
+    CMP_TRACE_THREAD_NAME("Compress Worker");
+    CMP_TRACE_SCOPE("Compress", GetCodecName(pThreadData->m_pCodec->GetType()));
     DISABLE_FP_EXCEPTIONS;
     CodecError err = pThreadData->m_pCodec->Compress(*pThreadData->m_pSrcBuffer, *pThreadData->m_pDestBuffer, pThreadData->m_pFeedbackProc, pThreadData->m_pUser1, pThreadData->m_pUser2);
     RESTORE_FP_EXCEPTIONS;
@@ -701,5 +727,183 @@ CMP_ERROR ThreadedCompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture
 
     return GetError(err);
 }
+
+class CATIDecompressThreadData
+{
+public:
+    CATIDecompressThreadData();
+    ~CATIDecompressThreadData();
+
+    CCodec* m_pCodec;
+    CCodecBuffer* m_pSrcBuffer;
+    CCodecBuffer* m_pDestBuffer;
+    volatile float m_fProgress;         // Progress of this band of block rows 0..100
+    volatile bool* m_pAbort;            // Shared by all bands, set when the caller asks to cancel
+};
+
+CATIDecompressThreadData::CATIDecompressThreadData() : m_pCodec(NULL), m_pSrcBuffer(NULL), m_pDestBuffer(NULL), 
+                                                       m_fProgress(0.0f), m_pAbort(NULL)
+{
+}
+
+CATIDecompressThreadData::~CATIDecompressThreadData()
+{
+    SAFE_DELETE(m_pCodec);
+    SAFE_DELETE(m_pSrcBuffer);
+    SAFE_DELETE(m_pDestBuffer);
+}
+
+// Called by each band's codec, records its progress and passes back any cancel request.
+// The caller's feedback proc is only ever called from the thread that started the decode.
+bool CMP_API ThreadedDecompressFeedback(float fProgress, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    CATIDecompressThreadData *pThreadData = (CATIDecompressThreadData*) pUser1;
+    pThreadData->m_fProgress = fProgress;
+    return *pThreadData->m_pAbort;
+}
+
+DWORD WINAPI ThreadedDecompressProc(LPVOID lpParameter)
+{
+    CATIDecompressThreadData *pThreadData = (CATIDecompressThreadData*) lpParameter;
+    CMP_TRACE_THREAD_NAME("Decompress Worker");
+    CMP_TRACE_SCOPE("Decompress", GetCodecName(pThreadData->m_pCodec->GetType()));
+    DISABLE_FP_EXCEPTIONS;
+    CodecError err = pThreadData->m_pCodec->Decompress(*pThreadData->m_pSrcBuffer, *pThreadData->m_pDestBuffer, ThreadedDecompressFeedback, (DWORD_PTR) pThreadData, NULL);
+    RESTORE_FP_EXCEPTIONS;
+    pThreadData->m_fProgress = 100.0f;
+    return err;
+}
+
+CMP_ERROR ThreadedDecompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CodecType srcType)
+{
+    // Note function should not be called for the following Codecs....
+    if (srcType == CT_ASTC) return CMP_ABORTED;      // ASTC decodes its block rows on its own threads
+
+    DWORD dwMaxThreadCount = min(f_dwProcessorCount, MAX_THREADS);
+    DWORD dwLinesRemaining = pDestTexture->dwHeight;
+    CMP_BYTE* pSourceData = pSourceTexture->pData;
+    CMP_BYTE* pDestData = pDestTexture->pData;
+    CodecBufferType destBufferType = GetCodecBufferType(pDestTexture->format);
+
+    CATIDecompressThreadData aThreadData[MAX_THREADS];
+    HANDLE ahThread[MAX_THREADS];
+    volatile bool bAbort = false;
+
+    // Each thread gets its own codec and decodes a band of whole block rows
+    DWORD dwBandCount = 0;
+    for(DWORD dwThread = 0; dwThread < dwMaxThreadCount; dwThread++)
+    {
+        CATIDecompressThreadData& threadData = aThreadData[dwBandCount];
+
+        threadData.m_pCodec = CreateCodec(srcType);
+        assert(threadData.m_pCodec);
+        if(threadData.m_pCodec == NULL)
+            return CMP_ERR_UNABLE_TO_INIT_CODEC;
+
+        DWORD dwThreadsRemaining = dwMaxThreadCount - dwThread;
+        DWORD dwHeight = 0;
+        if(dwThreadsRemaining > 1)
+        {
+            DWORD dwBlockHeight = pSourceTexture->nBlockHeight ? pSourceTexture->nBlockHeight : threadData.m_pCodec->GetBlockHeight();
+            dwHeight = dwLinesRemaining / dwThreadsRemaining;
+            dwHeight = min(((dwHeight + dwBlockHeight - 1) / dwBlockHeight) * dwBlockHeight, dwLinesRemaining); // Round by block height
+            dwLinesRemaining -= dwHeight;
+        }
+        else
+            dwHeight = dwLinesRemaining;
+
+        if(dwHeight > 0)
+        {
+            threadData.m_pSrcBuffer = threadData.m_pCodec->CreateBuffer(
+                                                        pSourceTexture->nBlockWidth, pSourceTexture->nBlockHeight, pSourceTexture->nBlockDepth,
+                                                        pSourceTexture->dwWidth, dwHeight, pSourceTexture->dwPitch, pSourceData);
+            threadData.m_pDestBuffer = CreateCodecBuffer(destBufferType, 
+                                                        pSourceTexture->nBlockWidth, pSourceTexture->nBlockHeight, pSourceTexture->nBlockDepth,
+                                                        pDestTexture->dwWidth, dwHeight, pDestTexture->dwPitch, pDestData);
+
+            assert(threadData.m_pSrcBuffer);
+            assert(threadData.m_pDestBuffer);
+            if(threadData.m_pSrcBuffer == NULL || threadData.m_pDestBuffer == NULL)
+                return CMP_ERR_GENERIC;
+
+            threadData.m_pSrcBuffer->SetBlockHeight(pSourceTexture->nBlockHeight);
+            threadData.m_pSrcBuffer->SetBlockWidth (pSourceTexture->nBlockWidth );
+            threadData.m_pSrcBuffer->SetBlockDepth (pSourceTexture->nBlockDepth );
+
+            pSourceData += CalcBufferSize(pSourceTexture->format, pSourceTexture->dwWidth, dwHeight, pSourceTexture->dwPitch, pSourceTexture->nBlockWidth, pSourceTexture->nBlockHeight);
+            pDestData += CalcBufferSize(pDestTexture->format, pDestTexture->dwWidth, dwHeight, pDestTexture->dwPitch, pSourceTexture->nBlockWidth, pSourceTexture->nBlockHeight);
+
+            threadData.m_pAbort = &bAbort;
+            dwBandCount++;
+        }
+        else
+            SAFE_DELETE(threadData.m_pCodec);
+    }
+
+    // Only handles of threads that started are waited on, a band without a thread is decoded here
+    CodecError err = CE_OK;
+    DWORD dwThreadCount = 0;
+    for(DWORD dwBand = 0; dwBand < dwBandCount; dwBand++)
+    {
+        DWORD dwThreadID;
+        ahThread[dwThreadCount] = CreateThread(NULL, 0, ThreadedDecompressProc, &aThreadData[dwBand], 0, &dwThreadID);
+        if(ahThread[dwThreadCount])
+            dwThreadCount++;
+        else
+        {
+            CodecError bandErr = (CodecError) ThreadedDecompressProc(&aThreadData[dwBand]);
+            if(err == CE_OK)
+                err = bandErr;
+        }
+    }
+
+    // Report the combined progress of all bands while waiting, so the caller's
+    // feedback proc can still cancel the decode
+    bool bWaitFailed = false;
+    while(dwThreadCount > 0)
+    {
+        DWORD dwWait = WaitForMultipleObjects(dwThreadCount, ahThread, true, 100);
+        if(dwWait != WAIT_TIMEOUT)
+        {
+            bWaitFailed = (dwWait >= WAIT_OBJECT_0 + dwThreadCount);
+            break;
+        }
+
+        if(pFeedbackProc && !bAbort)
+        {
+            float fProgress = 0.0f;
+            for(DWORD dwBand = 0; dwBand < dwBandCount; dwBand++)
+                fProgress += aThreadData[dwBand].m_fProgress * aThreadData[dwBand].m_pDestBuffer->GetHeight() / pDestTexture->dwHeight;
+
+            if(pFeedbackProc(fProgress, pUser1, pUser2))
+                bAbort = true;
+        }
+    }
+
+    // The threads use aThreadData, they must all have exited before it goes out of scope
+    if(bWaitFailed)
+    {
+        bAbort = true;
+        for(DWORD dwThread = 0; dwThread < dwThreadCount; dwThread++)
+            WaitForSingleObject(ahThread[dwThread], INFINITE);
+    }
+
+    for(DWORD dwThread = 0; dwThread < dwThreadCount; dwThread++)
+    {
+        DWORD dwExitCode;
+
+        if(err == CE_OK && !bWaitFailed && GetExitCodeThread(ahThread[dwThread], &dwExitCode))
+            err = (CodecError) dwExitCode;
+
+        CloseHandle(ahThread[dwThread]);
+    }
+
+    if(bWaitFailed)
+        return CMP_ERR_GENERIC;
+    if(bAbort)
+        return CMP_ABORTED;
+
+    return GetError(err);
+}
 #endif // THREADED_COMPRESS
 
@@ -33,6 +33,7 @@
 
 #include "Compressonator.h"  // User shared: Keep priviate code out of this header
 #include "Compress.h"
+#include "CMP_Trace.h"
 #include <assert.h>
 #include "debug.h"
 
@@ -46,6 +47,8 @@ extern CMP_ERROR Float2Byte(CMP_BYTE cBlock[], CMP_FLOAT* fBlock, CMP_Texture* s
 extern CMP_ERROR CheckTexture(const CMP_Texture* pTexture, bool bSource);
 extern CMP_ERROR CompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CodecType destType);
 extern CMP_ERROR ThreadedCompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CodecType destType);
+extern CMP_ERROR ThreadedDecompressTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2, CodecType srcType);
+extern CMP_ERROR RDOTexture(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, const CMP_CompressOptions* pOptions);
 
 #ifdef _LOCAL_DEBUG
 char    DbgTracer::buff[MAX_DBGBUFF_SIZE];
@@ -82,61 +85,91 @@ CMP_DWORD CMP_API CMP_CalculateBufferSize(const CMP_Texture* pTexture)
 }
 
 CMP_DWORD CalcBufferSize(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, CMP_DWORD dwPitch, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight)
+{
+    size_t nSize;
+    if(!CalcBufferSize64(format, dwWidth, dwHeight, dwPitch, nBlockWidth, nBlockHeight, &nSize) || (CMP_DWORD) nSize != nSize)
+        return 0;
+    return (CMP_DWORD) nSize;
+}
+
+bool CalcBufferSize64(CMP_FORMAT format, CMP_DWORD dwWidth, CMP_DWORD dwHeight, size_t nPitch, CMP_BYTE nBlockWidth, CMP_BYTE nBlockHeight, size_t* pSize)
 {
 #ifdef USE_DBGTRACE
-    DbgTrace(("format %d dwWidth %d dwHeight %d dwPitch %d",format, dwWidth, dwHeight, dwPitch));
+    DbgTrace(("format %d dwWidth %d dwHeight %d nPitch %d",format, dwWidth, dwHeight, nPitch));
 #endif
 
+    size_t nPixelSize;
     switch(format)
     {
         case CMP_FORMAT_RGBA_8888:
         case CMP_FORMAT_BGRA_8888:
         case CMP_FORMAT_ARGB_8888:
         case CMP_FORMAT_ARGB_2101010:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 4 * dwHeight));
+            nPixelSize = 4;
+            break;
 
         case CMP_FORMAT_RGB_888:
-            return ((dwPitch) ? (dwPitch * dwHeight) : ((((dwWidth * 3) + 3) >> 2) * 4 * dwHeight));
+            // Rows are padded to a multiple of 4 bytes
+            if(nPitch == 0)
+            {
+                if(!CMP_MulSize(dwWidth, 3, &nPitch))
+                    return false;
+                nPitch = ((nPitch + 3) >> 2) * 4;
+            }
+            nPixelSize = 3;
+            break;
 
         case CMP_FORMAT_RG_8:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 2 * dwHeight));
+            nPixelSize = 2;
+            break;
 
         case CMP_FORMAT_R_8:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * dwHeight));
+            nPixelSize = 1;
+            break;
 
         case CMP_FORMAT_ARGB_16:
         case CMP_FORMAT_ARGB_16F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 4 * sizeof(CMP_WORD) * dwHeight));
+            nPixelSize = 4 * sizeof(CMP_WORD);
+            break;
 
         case CMP_FORMAT_RG_16:
         case CMP_FORMAT_RG_16F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 4 * sizeof(CMP_WORD) * dwHeight));
+            nPixelSize = 4 * sizeof(CMP_WORD);
+            break;
 
         case CMP_FORMAT_R_16:
         case CMP_FORMAT_R_16F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 4 * sizeof(CMP_WORD) * dwHeight));
+            nPixelSize = 4 * sizeof(CMP_WORD);
+            break;
 
 #ifdef ARGB_32_SUPPORT
         case CMP_FORMAT_ARGB_32:
 #endif // ARGB_32_SUPPORT
         case CMP_FORMAT_ARGB_32F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 4 * sizeof(float) * dwHeight));
+            nPixelSize = 4 * sizeof(float);
+            break;
 
 #ifdef ARGB_32_SUPPORT
         case CMP_FORMAT_RG_32:
 #endif // ARGB_32_SUPPORT
         case CMP_FORMAT_RG_32F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 2 * sizeof(float) * dwHeight));
+            nPixelSize = 2 * sizeof(float);
+            break;
 
 #ifdef ARGB_32_SUPPORT
         case CMP_FORMAT_R_32:
 #endif // ARGB_32_SUPPORT
         case CMP_FORMAT_R_32F:
-            return ((dwPitch) ? (dwPitch * dwHeight) : (dwWidth * 1 * sizeof(float) * dwHeight));
+            nPixelSize = 1 * sizeof(float);
+            break;
 
         default:
-            return CalcBufferSize(GetCodecType(format), dwWidth, dwHeight, nBlockWidth, nBlockHeight);
+            return CalcBufferSize64(GetCodecType(format), dwWidth, dwHeight, nBlockWidth, nBlockHeight, pSize);
     }
+
+    if(nPitch == 0 && !CMP_MulSize(dwWidth, nPixelSize, &nPitch))
+        return false;
+    return CMP_MulSize(nPitch, dwHeight, pSize);
 }
 
 #ifndef USE_OLD_SWIZZLE
@@ -230,6 +263,11 @@ void CMP_PrepareSourceForCMP_Destination(CMP_Texture* pTexture, CMP_FORMAT  Dest
         case CMP_FORMAT_GT:
         case CMP_FORMAT_ETC_RGB:
         case CMP_FORMAT_ETC2_RGB:
+        case CMP_FORMAT_ETC2_RGBA:
+        case CMP_FORMAT_EAC_R11:
+        case CMP_FORMAT_EAC_R11_SIGNED:
+        case CMP_FORMAT_EAC_RG11:
+        case CMP_FORMAT_EAC_RG11_SIGNED:
         {
             newSrcFormat = CMP_FORMAT_RGBA_8888;
             CMP_Map_Bytes(pData, dwWidth, dwHeight, { 2, 1, 0, 3 },4);
@@ -274,6 +312,11 @@ void CMP_PrepareSourceForCMP_Destination(CMP_Texture* pTexture, CMP_FORMAT  Dest
         case CMP_FORMAT_BC7:
         case CMP_FORMAT_ETC_RGB:
         case CMP_FORMAT_ETC2_RGB:
+        case CMP_FORMAT_ETC2_RGBA:
+        case CMP_FORMAT_EAC_R11:
+        case CMP_FORMAT_EAC_R11_SIGNED:
+        case CMP_FORMAT_EAC_RG11:
+        case CMP_FORMAT_EAC_RG11_SIGNED:
         case CMP_FORMAT_GT:
         {
             // format is correct
@@ -317,6 +360,11 @@ void CMP_PrepareSourceForCMP_Destination(CMP_Texture* pTexture, CMP_FORMAT  Dest
         case CMP_FORMAT_BC7:
         case CMP_FORMAT_ETC_RGB:
         case CMP_FORMAT_ETC2_RGB:
+        case CMP_FORMAT_ETC2_RGBA:
+        case CMP_FORMAT_EAC_R11:
+        case CMP_FORMAT_EAC_R11_SIGNED:
+        case CMP_FORMAT_EAC_RG11:
+        case CMP_FORMAT_EAC_RG11_SIGNED:
         case CMP_FORMAT_GT:
         {
             newSrcFormat = CMP_FORMAT_RGBA_8888;
@@ -395,6 +443,11 @@ void CMP_PrepareCMPSourceForIMG_Destination(CMP_Texture* pDstTexture, CMP_FORMAT
     case CMP_FORMAT_GT:
     case CMP_FORMAT_ETC_RGB:
     case CMP_FORMAT_ETC2_RGB:
+    case CMP_FORMAT_ETC2_RGBA:
+    case CMP_FORMAT_EAC_R11:
+    case CMP_FORMAT_EAC_R11_SIGNED:
+    case CMP_FORMAT_EAC_RG11:
+    case CMP_FORMAT_EAC_RG11_SIGNED:
     {
         switch (newDstFormat)
         {
@@ -417,6 +470,8 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
 #ifdef USE_DBGTRACE
     DbgTrace(("-------> pSourceTexture [%x] pDestTexture [%x] pOptions [%x]",pSourceTexture, pDestTexture, pOptions));
 #endif
+    CMP_TRACE_SCOPE("Convert", "CMP_ConvertTexture");
+
     CMP_ERROR tc_err = CheckTexture(pSourceTexture, true);
     if(tc_err != CMP_OK)
         return tc_err;
@@ -431,8 +486,10 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
     bool destFloat = IsFloatFormat(pDestTexture->format);
     
     bool newBuffer = false;
-    if (srcFloat && !destFloat)
+    // ASTC reads half float sources directly and encodes them as HDR
+    if (srcFloat && !destFloat && !(pSourceTexture->format == CMP_FORMAT_ARGB_16F && pDestTexture->format == CMP_FORMAT_ASTC))
     {
+        CMP_TRACE_SCOPE("Convert", "Float2Byte");
         CMP_DWORD size = pSourceTexture->dwWidth * pSourceTexture->dwHeight;
         CMP_FLOAT*pfData = new CMP_FLOAT[pSourceTexture->dwDataSize] ;
         
@@ -452,6 +509,7 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
 
     else if (!srcFloat && destFloat)
     {
+        CMP_TRACE_SCOPE("Convert", "Byte2Float");
         CMP_DWORD size = pSourceTexture->dwWidth * pSourceTexture->dwHeight;
         CMP_BYTE *pbData = pSourceTexture->pData;
         CMP_HALF *hfloatData = new CMP_HALF[size * 4];
@@ -506,6 +564,7 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
                 return CMP_ERR_GENERIC;
             }
 
+            CMP_TRACE_SCOPE("Convert", "Copy");
             DISABLE_FP_EXCEPTIONS;
             pDestBuffer->Copy(*pSrcBuffer);
             RESTORE_FP_EXCEPTIONS;
@@ -526,7 +585,7 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
 #ifdef THREADED_COMPRESS
         // Note: 
         // BC7/BC6H has issues with this setting - we already set multithreading via numThreads so
-        // this call is disabled for BC7/BC6H ASTC Codecs.
+        // this call is disabled for BC7/BC6H ASTC and ETC2 Codecs.
         // if the use has set DiableMultiThreading then numThreads will be set to 1 (regradless of its original value)
         if(
             ((!pOptions || !pOptions->bDisableMultiThreading) && f_dwProcessorCount > 1) 
@@ -535,9 +594,17 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
             && (destType != CT_BC6H)
             && (destType != CT_BC6H_SF)
             && (destType != CT_GT)
+            && (destType != CT_ETC2_RGB)
+            && (destType != CT_ETC2_RGBA)
+            && (destType != CT_EAC_R11)
+            && (destType != CT_EAC_R11_SIGNED)
+            && (destType != CT_EAC_RG11)
+            && (destType != CT_EAC_RG11_SIGNED)
             )
         {
             tc_err = ThreadedCompressTexture(pSourceTexture, pDestTexture, pOptions, pFeedbackProc, pUser1, pUser2, destType);
+            if(tc_err == CMP_OK && pOptions && pOptions->dwSize == sizeof(CMP_CompressOptions) && pOptions->fRDOLambda > 0)
+                tc_err = RDOTexture(pSourceTexture, pDestTexture, pOptions);
 #ifdef ENABLE_MAKE_COMPATIBLE_API
             if (pSourceTexture->pData && newBuffer)
             {
@@ -551,6 +618,8 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
 #endif // THREADED_COMPRESS
         {
             tc_err =  CompressTexture(pSourceTexture, pDestTexture, pOptions, pFeedbackProc, pUser1, pUser2, destType);
+            if(tc_err == CMP_OK && pOptions && pOptions->dwSize == sizeof(CMP_CompressOptions) && pOptions->fRDOLambda > 0)
+                tc_err = RDOTexture(pSourceTexture, pDestTexture, pOptions);
 #ifdef ENABLE_MAKE_COMPATIBLE_API
             if (pSourceTexture->pData && newBuffer)
             {
@@ -565,6 +634,36 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
     {
         // Decompressing
 
+#ifdef THREADED_COMPRESS
+        // Every codec except ASTC is decoded in bands of block rows, one codec per thread.
+        // ASTC threads its own block rows inside CCodec_ASTC::Decompress
+        if(
+            ((!pOptions || !pOptions->bDisableMultiThreading) && f_dwProcessorCount > 1)
+            && (srcType != CT_ASTC)
+            )
+        {
+            pDestTexture->nBlockWidth  = pSourceTexture->nBlockWidth;
+            pDestTexture->nBlockHeight = pSourceTexture->nBlockHeight;
+            pDestTexture->nBlockDepth  = pSourceTexture->nBlockDepth;
+
+            tc_err = ThreadedDecompressTexture(pSourceTexture, pDestTexture, pFeedbackProc, pUser1, pUser2, srcType);
+
+#ifndef  USE_OLD_SWIZZLE
+            if (tc_err == CMP_OK)
+                CMP_PrepareCMPSourceForIMG_Destination(pDestTexture, pSourceTexture->format);
+#endif
+
+#ifdef ENABLE_MAKE_COMPATIBLE_API
+            if (pSourceTexture->pData && newBuffer)
+            {
+                free(pSourceTexture->pData);
+                pSourceTexture->pData = NULL;
+            }
+#endif
+            return tc_err;
+        }
+#endif // THREADED_COMPRESS
+
 
         CCodec* pCodec = CreateCodec(srcType);
         assert(pCodec);
@@ -610,6 +709,7 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
             return CMP_ERR_GENERIC;
         }
 
+        CMP_TRACE_SCOPE("Decompress", GetCodecName(srcType));
         DISABLE_FP_EXCEPTIONS;
 
         pSrcBuffer->SetBlockHeight(pSourceTexture->nBlockHeight);
@@ -689,9 +789,14 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
         }
 
         DISABLE_FP_EXCEPTIONS;
-        CodecError err2 = pCodecIn->Decompress(*pSrcBuffer, *pTempBuffer, pFeedbackProc, pUser1, pUser2);
+        CodecError err2;
+        {
+            CMP_TRACE_SCOPE("Decompress", GetCodecName(srcType));
+            err2 = pCodecIn->Decompress(*pSrcBuffer, *pTempBuffer, pFeedbackProc, pUser1, pUser2);
+        }
         if(err2 == CE_OK)
         {
+            CMP_TRACE_SCOPE("Compress", GetCodecName(destType));
             err2 = pCodecOut->Compress(*pTempBuffer, *pDestBuffer, pFeedbackProc, pUser1, pUser2);
         }
         RESTORE_FP_EXCEPTIONS;
@@ -706,3 +811,171 @@ CMP_ERROR CMP_API CMP_ConvertTexture(CMP_Texture* pSourceTexture, CMP_Texture* p
         return GetError(err2);
     }
 }
+
+CMP_ERROR CMP_API CMP_CalculateBufferSize64(const CMP_Texture64* pTexture, size_t* pSize)
+{
+    assert(pTexture && pSize);
+    if(pTexture == NULL || pSize == NULL)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    if(pTexture->dwSize != sizeof(CMP_Texture64) || pTexture->dwWidth == 0 || pTexture->dwHeight == 0)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    if(pTexture->format < CMP_FORMAT_ARGB_8888 || pTexture->format > CMP_FORMAT_MAX)
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    if(!CalcBufferSize64(pTexture->format, pTexture->dwWidth, pTexture->dwHeight, pTexture->nPitch, pTexture->nBlockWidth, pTexture->nBlockHeight, pSize))
+        return CMP_ERR_INVALID_SOURCE_TEXTURE;
+
+    return CMP_OK;
+}
+
+// Largest band CMP_ConvertTexture64 hands to CMP_ConvertTexture, the codec buffers use 32 bit offsets
+#define CONVERT64_BAND_BYTES    (256 * 1024 * 1024)
+
+typedef struct
+{
+    CMP_Feedback_Proc   pFeedbackProc;
+    DWORD_PTR           pUser1;
+    DWORD_PTR           pUser2;
+    float               fBase;              // Progress at the start of the current band
+    float               fScale;             // Share of the whole texture taken by the current band
+} BandFeedback;
+
+// Maps the progress of one band onto the whole texture
+static bool CMP_API BandFeedbackProc(float fProgress, DWORD_PTR pUser1, DWORD_PTR /*pUser2*/)
+{
+    BandFeedback* pFeedback = (BandFeedback*) pUser1;
+    return pFeedback->pFeedbackProc(pFeedback->fBase + fProgress * pFeedback->fScale, pFeedback->pUser1, pFeedback->pUser2);
+}
+
+static CMP_ERROR CheckTexture64(const CMP_Texture64* pTexture, bool bSource)
+{
+    CMP_ERROR err = bSource ? CMP_ERR_INVALID_SOURCE_TEXTURE : CMP_ERR_INVALID_DEST_TEXTURE;
+
+    size_t nSize;
+    if(CMP_CalculateBufferSize64(pTexture, &nSize) != CMP_OK)
+        return err;
+
+    if(pTexture->pData == NULL || pTexture->nDataSize < nSize)
+        return err;
+
+    // Every band of an uncompressed texture shares its pitch, it has to fit the 32 bit descriptor
+    if((CMP_DWORD) pTexture->nPitch != pTexture->nPitch)
+        return err;
+
+    return CMP_OK;
+}
+
+CMP_ERROR CMP_API CMP_ConvertTexture64(CMP_Texture64* pSourceTexture, CMP_Texture64* pDestTexture, const CMP_CompressOptions* pOptions, CMP_Feedback_Proc pFeedbackProc, DWORD_PTR pUser1, DWORD_PTR pUser2)
+{
+    CMP_TRACE_SCOPE("Convert", "CMP_ConvertTexture64");
+
+    CMP_ERROR tc_err = CheckTexture64(pSourceTexture, true);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    tc_err = CheckTexture64(pDestTexture, false);
+    if(tc_err != CMP_OK)
+        return tc_err;
+
+    if(pSourceTexture->dwWidth != pDestTexture->dwWidth || pSourceTexture->dwHeight != pDestTexture->dwHeight)
+        return CMP_ERR_SIZE_MISMATCH;
+
+    CodecType srcType = GetCodecType(pSourceTexture->format);
+    if(srcType == CT_Unknown)
+        return CMP_ERR_UNSUPPORTED_SOURCE_FORMAT;
+
+    CodecType destType = GetCodecType(pDestTexture->format);
+    if(destType == CT_Unknown)
+        return CMP_ERR_UNSUPPORTED_DEST_FORMAT;
+
+    // Bands are cut on block rows of whichever side is compressed, only ASTC has a variable block size
+    CMP_DWORD dwBlockHeight = 1;
+    if(srcType != CT_None || destType != CT_None)
+    {
+        const CMP_Texture64* pCompressed = (srcType != CT_None) ? pSourceTexture : pDestTexture;
+        dwBlockHeight = 4;
+        if(GetCodecType(pCompressed->format) == CT_ASTC && pCompressed->nBlockHeight)
+            dwBlockHeight = pCompressed->nBlockHeight;
+    }
+
+    size_t nSrcBlockRow, nDestBlockRow;
+    if(!CalcBufferSize64(pSourceTexture->format, pSourceTexture->dwWidth, dwBlockHeight, pSourceTexture->nPitch, pSourceTexture->nBlockWidth, pSourceTexture->nBlockHeight, &nSrcBlockRow) ||
+       !CalcBufferSize64(pDestTexture->format, pDestTexture->dwWidth, dwBlockHeight, pDestTexture->nPitch, pDestTexture->nBlockWidth, pDestTexture->nBlockHeight, &nDestBlockRow))
+        return CMP_ERR_GENERIC;
+
+    size_t nLargestBlockRow = (nSrcBlockRow > nDestBlockRow) ? nSrcBlockRow : nDestBlockRow;
+    size_t nBandBlockRows   = CONVERT64_BAND_BYTES / nLargestBlockRow;
+    if(nBandBlockRows == 0)
+    {
+        // A single block row larger than the band size is converted on its own if it still fits the codec buffers
+        if((CMP_DWORD) nLargestBlockRow != nLargestBlockRow)
+            return CMP_ERR_GENERIC;
+        nBandBlockRows = 1;
+    }
+
+    CMP_DWORD dwBandRows = pSourceTexture->dwHeight;
+    if(nBandBlockRows < (pSourceTexture->dwHeight + (size_t) dwBlockHeight - 1) / dwBlockHeight)
+        dwBandRows = (CMP_DWORD) (nBandBlockRows * dwBlockHeight);
+
+    BandFeedback feedback;
+    feedback.pFeedbackProc  = pFeedbackProc;
+    feedback.pUser1         = pUser1;
+    feedback.pUser2         = pUser2;
+    feedback.fBase          = 0.0f;
+    feedback.fScale         = 1.0f;
+
+    CMP_Texture srcBand;
+    srcBand.dwSize          = sizeof(srcBand);
+    srcBand.dwWidth         = pSourceTexture->dwWidth;
+    srcBand.dwPitch         = (CMP_DWORD) pSourceTexture->nPitch;
+    srcBand.format          = pSourceTexture->format;
+    srcBand.nBlockWidth     = pSourceTexture->nBlockWidth;
+    srcBand.nBlockHeight    = pSourceTexture->nBlockHeight;
+    srcBand.nBlockDepth     = pSourceTexture->nBlockDepth;
+
+    CMP_Texture destBand;
+    destBand.dwSize         = sizeof(destBand);
+    destBand.dwWidth        = pDestTexture->dwWidth;
+    destBand.dwPitch        = (CMP_DWORD) pDestTexture->nPitch;
+    destBand.format         = pDestTexture->format;
+    destBand.nBlockWidth    = pDestTexture->nBlockWidth;
+    destBand.nBlockHeight   = pDestTexture->nBlockHeight;
+    destBand.nBlockDepth    = pDestTexture->nBlockDepth;
+
+    size_t nSrcOffset  = 0;
+    size_t nDestOffset = 0;
+    CMP_DWORD dwRow    = 0;
+    while(dwRow < pSourceTexture->dwHeight)
+    {
+        CMP_DWORD dwRows = pSourceTexture->dwHeight - dwRow;
+        if(dwRows > dwBandRows)
+            dwRows = dwBandRows;
+
+        // The last band can end part way through a block row, the codecs pad it as usual
+        srcBand.dwHeight     = dwRows;
+        srcBand.dwDataSize   = CalcBufferSize(srcBand.format, srcBand.dwWidth, dwRows, srcBand.dwPitch, srcBand.nBlockWidth, srcBand.nBlockHeight);
+        srcBand.pData        = pSourceTexture->pData + nSrcOffset;
+        destBand.dwHeight    = dwRows;
+        destBand.dwDataSize  = CalcBufferSize(destBand.format, destBand.dwWidth, dwRows, destBand.dwPitch, destBand.nBlockWidth, destBand.nBlockHeight);
+        destBand.pData       = pDestTexture->pData + nDestOffset;
+
+        if(srcBand.dwDataSize == 0 || destBand.dwDataSize == 0)
+            return CMP_ERR_GENERIC;
+
+        feedback.fBase  = 100.0f * dwRow / pSourceTexture->dwHeight;
+        feedback.fScale = (float) dwRows / pSourceTexture->dwHeight;
+
+        tc_err = CMP_ConvertTexture(&srcBand, &destBand, pOptions, pFeedbackProc ? BandFeedbackProc : NULL, (DWORD_PTR) &feedback, NULL);
+        if(tc_err != CMP_OK)
+            return tc_err;
+
+        // Only the last band is partial, every other band is a whole number of block rows
+        nSrcOffset  += srcBand.dwDataSize;
+        nDestOffset += destBand.dwDataSize;
+        dwRow       += dwRows;
+    }
+
+    return CMP_OK;
+}
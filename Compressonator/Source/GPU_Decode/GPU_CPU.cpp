@@ -0,0 +1,152 @@
+//=====================================================================
+// Copyright (c) 2016    Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+/// \file GPU_CPU.cpp
+//
+//=====================================================================
+
+#include "TC_PluginAPI.h"
+#include "TC_PluginInternal.h"
+#include "MIPS.h"
+#include "GPU_CPU.h"
+
+using namespace GPU_Decode;
+
+static const GUID  g_GUID_CPU = { 0x5b0c3f2e, 0x7d41, 0x4a8e,{ 0x9c, 0x26, 0x1f, 0x83, 0x4b, 0xd2, 0x60, 0xa7 } };
+
+#define TC_PLUGIN_VERSION_MAJOR    1
+#define TC_PLUGIN_VERSION_MINOR    0
+
+GPU_CPU::GPU_CPU(CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback)
+{
+    // No render window is needed, the decode runs on the CPU codecs
+    (void)Width;
+    (void)Height;
+    (void)callback;
+}
+
+GPU_CPU::~GPU_CPU()
+{
+
+}
+
+// The BCn, ATIxN and ATC CPU decoders write BGRA while the GPU plugins read back RGBA
+static bool IsBGRADecode(CMP_FORMAT format)
+{
+    switch (format)
+    {
+    case CMP_FORMAT_ATI1N:
+    case CMP_FORMAT_ATI2N:
+    case CMP_FORMAT_ATI2N_XY:
+    case CMP_FORMAT_ATI2N_DXT5:
+    case CMP_FORMAT_ATC_RGB:
+    case CMP_FORMAT_ATC_RGBA_Explicit:
+    case CMP_FORMAT_ATC_RGBA_Interpolated:
+    case CMP_FORMAT_BC1:
+    case CMP_FORMAT_BC2:
+    case CMP_FORMAT_BC3:
+    case CMP_FORMAT_BC4:
+    case CMP_FORMAT_BC5:
+    case CMP_FORMAT_DXT1:
+    case CMP_FORMAT_DXT3:
+    case CMP_FORMAT_DXT5:
+        return true;
+    default:
+        return false;
+    }
+}
+
+CMP_ERROR WINAPI GPU_CPU::Decompress(
+    const CMP_Texture* pSourceTexture,
+    CMP_Texture* pDestTexture
+) const
+{
+    // No options: CMP_ConvertTexture decodes block rows on all cores
+    CMP_ERROR result = CMP_ConvertTexture((CMP_Texture*)pSourceTexture, pDestTexture, NULL, NULL, NULL, NULL);
+    if (result != CMP_OK)
+        return result;
+
+    if ((pDestTexture->format == CMP_FORMAT_ARGB_8888) && IsBGRADecode(pSourceTexture->format))
+    {
+        CMP_DWORD dwPitch = pDestTexture->dwPitch ? pDestTexture->dwPitch : pDestTexture->dwWidth * 4;
+        for (CMP_DWORD y = 0; y < pDestTexture->dwHeight; y++)
+        {
+            CMP_BYTE *pData = pDestTexture->pData + y * dwPitch;
+            for (CMP_DWORD x = 0; x < pDestTexture->dwWidth; x++, pData += 4)
+            {
+                CMP_BYTE r = pData[0];
+                pData[0] = pData[2];
+                pData[2] = r;
+            }
+        }
+    }
+
+    return CMP_OK;
+}
+
+//====================================================================================
+
+Plugin_CCPU::Plugin_CCPU()
+{
+    m_pGPUDecode = NULL;
+}
+
+Plugin_CCPU::~Plugin_CCPU()
+{
+    if (m_pGPUDecode)
+        delete m_pGPUDecode;
+}
+
+int Plugin_CCPU::TC_PluginGetVersion(TC_PluginVersion* pPluginVersion)
+{
+    pPluginVersion->guid                    = g_GUID_CPU;
+    pPluginVersion->dwAPIVersionMajor       = TC_API_VERSION_MAJOR;
+    pPluginVersion->dwAPIVersionMinor       = TC_API_VERSION_MINOR;
+    pPluginVersion->dwPluginVersionMajor    = TC_PLUGIN_VERSION_MAJOR;
+    pPluginVersion->dwPluginVersionMinor    = TC_PLUGIN_VERSION_MINOR;
+    return 0;
+}
+
+int Plugin_CCPU::TC_Init(CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback)
+{
+    m_pGPUDecode = new GPU_CPU(Width, Height, callback);
+    if (m_pGPUDecode == NULL)
+        return -1;
+    return 0;
+}
+
+CMP_ERROR Plugin_CCPU::TC_Decompress(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture)
+{
+    CMP_ERROR result = CMP_OK;
+    if (m_pGPUDecode)
+        result = m_pGPUDecode->Decompress(pSourceTexture, pDestTexture);
+    return result;
+}
+
+int Plugin_CCPU::TC_Close()
+{
+    if (m_pGPUDecode)
+    {
+        delete m_pGPUDecode;
+        m_pGPUDecode = NULL;
+    }
+    return 0;
+}
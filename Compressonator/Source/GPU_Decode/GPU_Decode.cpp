@@ -26,7 +26,11 @@
 
 #include "GPU_DecodeBase.h"
 #include "GPU_Decode.h"
+#include "GPU_CPU.h"
 #include "PluginInterface.h"
+#include "MIPS.h"
+#include "CMP_Trace.h"
+#include <chrono>
 
 extern PluginManager    g_pluginManager;
 
@@ -34,20 +38,42 @@ using namespace GPU_Decode;
 
 PluginInterface_GPUDecode   *g_GPUDecode_plugin = NULL;
 
-static CMP_GPUDecode DecodeType = GPUDecode_INVALID;
+static CMP_GPUDecode ActiveDecodeType = GPUDecode_INVALID;  // Backend actually in use, GPUDecode_CPU after a fallback
+static bool          ReportedFallback = false;
 
 //
-// CMP_InitializeDecompessLibrary - Initialize the DeCompression library based in GPU Driver support types
+// UseCPUDecode - Replace the current plugin with the built in CPU decoder
+// Called when the requested GPU plugin is missing or its driver cannot be initialized
 //
-CMP_ERROR CMP_API CMP_InitializeDecompessLibrary(CMP_GPUDecode GPUDecodeType, CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback)
+static CMP_ERROR UseCPUDecode(CMP_GPUDecode GPUDecodeType, CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback)
 {
-    if (g_GPUDecode_plugin && (DecodeType == GPUDecodeType)) return CMP_OK;
+    if (g_GPUDecode_plugin)
+    {
+        g_GPUDecode_plugin->TC_Close();
+        delete g_GPUDecode_plugin;
+    }
 
-    if (GPUDecodeType != DecodeType)
+    if ((GPUDecodeType != GPUDecode_CPU) && !ReportedFallback)
     {
-        CMP_ShutdownDecompessLibrary();
+        PrintInfo("GPU decode is not available, using CPU decode\n");
+        ReportedFallback = true;
     }
 
+    g_GPUDecode_plugin = new Plugin_CCPU;
+    if (g_GPUDecode_plugin->TC_Init(Width, Height, callback) != 0)
+        return CMP_ERR_UNABLE_TO_INIT_DECOMPRESSLIB;
+
+    ActiveDecodeType = GPUDecode_CPU;
+    return CMP_OK;
+}
+
+//
+// CMP_InitializeDecompessLibrary - Initialize the DeCompression library based in GPU Driver support types
+//
+CMP_ERROR CMP_API CMP_InitializeDecompessLibrary(CMP_GPUDecode GPUDecodeType, CMP_DWORD Width, CMP_DWORD Height, WNDPROC callback)
+{
+    CMP_ShutdownDecompessLibrary();
+
     switch (GPUDecodeType)
     {
     case GPUDecode_DIRECTX:
@@ -59,6 +85,8 @@ CMP_ERROR CMP_API CMP_InitializeDecompessLibrary(CMP_GPUDecode GPUDecodeType, CM
     case GPUDecode_VULKAN:
                             g_GPUDecode_plugin = reinterpret_cast<PluginInterface_GPUDecode *>(g_pluginManager.GetPlugin("GPUDECODE", "VULKAN"));
                             break;
+    case GPUDecode_CPU:
+                            return UseCPUDecode(GPUDecodeType, Width, Height, callback);
     default:
                             return CMP_ERR_UNABLE_TO_INIT_DECOMPRESSLIB;
     }
@@ -66,10 +94,11 @@ CMP_ERROR CMP_API CMP_InitializeDecompessLibrary(CMP_GPUDecode GPUDecodeType, CM
     if (g_GPUDecode_plugin)
     {
         if (g_GPUDecode_plugin->TC_Init(Width, Height, callback) != 0)
-            return CMP_ERR_UNABLE_TO_INIT_DECOMPRESSLIB;
+            return UseCPUDecode(GPUDecodeType, Width, Height, callback);
     }
-    else return CMP_ERR_UNABLE_TO_INIT_DECOMPRESSLIB;
+    else return UseCPUDecode(GPUDecodeType, Width, Height, callback);
 
+    ActiveDecodeType = GPUDecodeType;
     return CMP_OK;
 }
 
@@ -86,9 +115,44 @@ CMP_ERROR CMP_API CMP_ShutdownDecompessLibrary()
         g_GPUDecode_plugin = NULL;
     }
 
+    ActiveDecodeType = GPUDecode_INVALID;
     return CMP_OK;
 }
 
+// Trace scope name of a decode backend
+static const char* DecodeTypeName(CMP_GPUDecode GPUDecodeType)
+{
+    switch (GPUDecodeType)
+    {
+    case GPUDecode_OPENGL:  return "OpenGL";
+    case GPUDecode_DIRECTX: return "DirectX";
+    case GPUDecode_VULKAN:  return "Vulkan";
+    case GPUDecode_CPU:     return "CPU";
+    default:                return "Unknown";
+    }
+}
+
+//
+// DecodeWithPlugin - Decode using the current plugin, a GPU plugin that fails to
+// start its driver (for example OpenGL on a headless node) falls back to the CPU decoder
+//
+static CMP_ERROR DecodeWithPlugin(const CMP_Texture* pSourceTexture, CMP_Texture* pDestTexture, CMP_GPUDecode GPUDecodeType)
+{
+    CMP_ERROR result;
+    {
+        CMP_TRACE_SCOPE("GPUDecode", DecodeTypeName(ActiveDecodeType));
+        result = g_GPUDecode_plugin->TC_Decompress(pSourceTexture, pDestTexture);
+    }
+    if ((result == CMP_ERR_UNABLE_TO_INIT_DECOMPRESSLIB) && (ActiveDecodeType != GPUDecode_CPU))
+    {
+        CMP_TRACE_SCOPE("GPUDecode", "CPU");
+        result = UseCPUDecode(GPUDecodeType, pSourceTexture->dwWidth, pSourceTexture->dwHeight, NULL);
+        if (result != CMP_OK) return (result);
+        result = g_GPUDecode_plugin->TC_Decompress(pSourceTexture, pDestTexture);
+    }
+    return result;
+}
+
 
 CMP_ERROR CMP_API CMP_DecompressTexture(
     const CMP_Texture* pSourceTexture,
@@ -98,12 +162,15 @@ CMP_ERROR CMP_API CMP_DecompressTexture(
     CMP_ERROR result;
 
     // This is temporary code we should move this into CLI and GUI
-    result = CMP_InitializeDecompessLibrary(GPUDecodeType, pSourceTexture->dwWidth, pSourceTexture->dwHeight, NULL);
+    {
+        CMP_TRACE_SCOPE("GPUDecode", "Initialize");
+        result = CMP_InitializeDecompessLibrary(GPUDecodeType, pSourceTexture->dwWidth, pSourceTexture->dwHeight, NULL);
+    }
     if (result  != CMP_OK) return (result);
 
     if (g_GPUDecode_plugin)
     {
-        result = g_GPUDecode_plugin->TC_Decompress(pSourceTexture, pDestTexture);
+        result = DecodeWithPlugin(pSourceTexture, pDestTexture, GPUDecodeType);
         if (result != CMP_OK) return (result);
     }
     else return CMP_ABORTED;
@@ -112,3 +179,43 @@ CMP_ERROR CMP_API CMP_DecompressTexture(
     return CMP_OK;
 }
 
+//
+// CMP_BenchmarkDecompressTexture - Time repeated decodes of one texture with the given backend
+// Library initialization and one warm up decode are excluded from the timing
+//
+CMP_ERROR CMP_API CMP_BenchmarkDecompressTexture(
+    const CMP_Texture* pSourceTexture,
+          CMP_Texture* pDestTexture,
+          CMP_GPUDecode GPUDecodeType,
+          CMP_DWORD nIterations,
+          CMP_DecodeBenchmark* pBenchmark)
+{
+    CMP_ERROR result;
+
+    if (!pBenchmark || (nIterations == 0)) return CMP_ERR_GENERIC;
+
+    memset(pBenchmark, 0, sizeof(CMP_DecodeBenchmark));
+
+    result = CMP_InitializeDecompessLibrary(GPUDecodeType, pSourceTexture->dwWidth, pSourceTexture->dwHeight, NULL);
+    if (result != CMP_OK) return (result);
+
+    result = DecodeWithPlugin(pSourceTexture, pDestTexture, GPUDecodeType);
+    if (result != CMP_OK) return (result);
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (CMP_DWORD i = 0; i < nIterations; i++)
+    {
+        result = g_GPUDecode_plugin->TC_Decompress(pSourceTexture, pDestTexture);
+        if (result != CMP_OK) return (result);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    pBenchmark->DecodeType      = ActiveDecodeType;
+    pBenchmark->nIterations     = nIterations;
+    pBenchmark->fTotalTime      = elapsed.count();
+    if (pBenchmark->fTotalTime > 0)
+        pBenchmark->fMPixelsPerSec = ((double)pSourceTexture->dwWidth * pSourceTexture->dwHeight * nIterations) / (pBenchmark->fTotalTime * 1000000.0);
+
+    return CMP_OK;
+}
+